@@ -0,0 +1,865 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/date_time.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "typedefs.h"
+#include "model/ClassRoom.h"
+#include "model/ClassRoomTypeFactory.h"
+#include "model/GroupLesson.h"
+#include "model/IndividualLesson.h"
+#include "model/Person.h"
+#include "model/WeeklyOccupancy.h"
+#include "concurrency/TaskPool.h"
+#include "concurrency/Executor.h"
+#include "repositories/LessonRepository.h"
+#include "repositories/PersonRepository.h"
+#include "repositories/ClassRoomRepository.h"
+#include "managers/LessonManager.h"
+#include "managers/RoomAssignmentManager.h"
+#include "managers/TimetableManager.h"
+#include "managers/ImportManager.h"
+#include "managers/PersonManager.h"
+#include "managers/LessonService.h"
+#include "storages/Flusher.h"
+#include "storages/ThreadPoolFileIO.h"
+#include "storages/UringFileIO.h"
+#include "storages/PersonFilesStorage.h"
+#include "storages/LessonFilesStorage.h"
+#include "storages/FileIO.h"
+
+namespace pt = boost::posix_time;
+
+struct LessonBenchmarkFixture {
+    static constexpr int lessonsCount = 1000000;
+    std::vector<LessonPtr> lessons;
+    pt::ptime now = pt::second_clock::local_time();
+
+    LessonBenchmarkFixture() {
+        const auto teacher = std::make_shared<Person>("Jan", "Kowalski", 1);
+        const auto student = std::make_shared<Person>("Anna", "Nowak", 2);
+        const auto classRoom = std::make_shared<ClassRoom>(1, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10));
+
+        lessons.reserve(lessonsCount);
+        for (int i = 0; i < lessonsCount; i++) {
+            const pt::ptime begin = now + pt::minutes(i % 20000 - 10000);
+            if (i % 2 == 0) {
+                lessons.push_back(std::make_shared<GroupLesson>(teacher, begin, begin + pt::hours(1), 100, "Matematyka", classRoom));
+            } else {
+                lessons.push_back(std::make_shared<IndividualLesson>(teacher, begin, begin + pt::hours(1), 100, "Matematyka", classRoom, student));
+            }
+        }
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(LessonBenchmark, LessonBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(LessonScanBenchmark) {
+    long due = 0;
+    long cost = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < 10; round++) {
+        for (const LessonPtr &lesson : lessons) {
+            if (!lesson->isStarted() && lesson->getBeginTime() < now) due++;
+            cost += lesson->getBaseCost() + lesson->getID();
+        }
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    BOOST_TEST(due == 10L * lessonsCount / 2);
+    BOOST_TEST_MESSAGE("Scan of " << lessonsCount << " lessons: " << elapsed / 10 << " ms per pass, "
+                       << elapsed * 1e5 / lessonsCount << " ns per lesson (cost checksum " << cost << ")");
+}
+
+BOOST_AUTO_TEST_CASE(LessonScheduleScanBenchmark) {
+    LessonRepository repository;
+    for (const LessonPtr &lesson : lessons) {
+        repository.add(lesson, true);
+    }
+
+    std::size_t due = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < 10; round++) {
+        due += repository.findToStart(now).size();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    BOOST_TEST(due == 10u * lessonsCount / 2);
+    BOOST_TEST_MESSAGE("Schedule scan of " << lessonsCount << " lessons: " << elapsed / 10 << " ms per pass, "
+                       << elapsed * 1e5 / lessonsCount << " ns per lesson, "
+                       << sizeof(LessonRepository::ScheduleEntry) << " bytes per entry");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(LectureBenchmark)
+
+BOOST_AUTO_TEST_CASE(LargeLectureBenchmark) {
+    constexpr int studentsCount = 500;
+    constexpr int futureLessonsCount = 50;
+    constexpr int lecturesCount = 100;
+
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonManager lessonManager(lessonRepo, nullptr, personRepo, classRoomRepo);
+
+    const pt::ptime now = pt::second_clock::local_time();
+    const auto teacher = std::make_shared<Person>("Jan", "Kowalski", 0);
+    const auto classRoom = std::make_shared<ClassRoom>(1, true, studentsCount, 100.0, ClassRoomTypeFactory::getITClassRoom(10));
+    std::vector<PersonPtr> students;
+    std::vector<int> studentIds;
+    for (int i = 1; i <= studentsCount; i++) {
+        students.push_back(std::make_shared<Person>("Student", "Nr", i));
+        studentIds.push_back(i);
+        personRepo->add(students.back());
+    }
+    for (int i = 0; i < futureLessonsCount; i++) {
+        const auto other = std::make_shared<GroupLesson>(teacher, now + pt::hours(i + 1), now + pt::hours(i + 2), 100, "Inne", classRoom);
+        for (const PersonPtr &student : students) student->addFutureLesson(other);
+    }
+
+    double enrollMs = 0;
+    double startMs = 0;
+    for (int lecture = 0; lecture < lecturesCount; lecture++) {
+        const auto lesson = std::make_shared<GroupLesson>(teacher, now, now + pt::hours(1), 100, "Wyklad", classRoom);
+        lessonRepo->add(lesson, false);
+
+        auto begin = std::chrono::steady_clock::now();
+        const std::vector<int> results = lessonManager.enrollStudents(lesson->getID(), studentIds);
+        enrollMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        begin = std::chrono::steady_clock::now();
+        BOOST_TEST(lessonManager.startLesson(lesson->getID()));
+        startMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        BOOST_TEST(std::count(results.begin(), results.end(), 0) == studentsCount);
+
+        lesson->removeStudents(students);
+        BOOST_TEST(lessonRepo->remove(lesson) == 0);
+    }
+
+    BOOST_TEST(students.front()->getFutureLessons().size() == static_cast<std::size_t>(futureLessonsCount));
+    BOOST_TEST_MESSAGE("Lecture of " << studentsCount << " students with " << futureLessonsCount << " future lessons each: "
+                       << enrollMs / lecturesCount << " ms to enroll, " << startMs / lecturesCount << " ms to start");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(FreeSlotBenchmark)
+
+BOOST_AUTO_TEST_CASE(FreeClassRoomsBenchmark) {
+    constexpr int roomsCount = 2000;
+    constexpr int teachersCount = 500;
+    constexpr int semesterDays = 120;
+    constexpr int lessonsPerRoomDay = 2;
+    constexpr int queriesCount = 200;
+
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonManager lessonManager(lessonRepo, nullptr, personRepo, classRoomRepo);
+
+    std::vector<PersonPtr> teachers;
+    for (int i = 0; i < teachersCount; i++) {
+        teachers.push_back(std::make_shared<Person>("Nauczyciel", "Nr", i));
+        personRepo->add(teachers.back());
+    }
+    std::vector<ClassRoomPtr> rooms;
+    for (int i = 0; i < roomsCount; i++) {
+        rooms.push_back(std::make_shared<ClassRoom>(i, true, 10 + i % 40, 100.0, ClassRoomTypeFactory::getITClassRoom(10)));
+        classRoomRepo->add(rooms.back());
+    }
+
+    const pt::ptime semesterStart = pt::time_from_string("2030-02-01 08:00:00");
+    int lessonsCount = 0;
+    for (int day = 0; day < semesterDays; day++) {
+        for (int i = 0; i < roomsCount; i++) {
+            for (int slot = 0; slot < lessonsPerRoomDay; slot++) {
+                const pt::ptime begin = semesterStart + pt::hours(24 * day + 2 * slot + i % 4);
+                const auto lesson = std::make_shared<GroupLesson>(teachers[(i + slot) % teachersCount], begin, begin + pt::minutes(90), 100, "Zajecia", rooms[i]);
+                lessonRepo->add(lesson, true);
+                lessonsCount++;
+            }
+        }
+    }
+
+    std::size_t found = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < queriesCount; q++) {
+        const pt::ptime window = semesterStart + pt::hours(24 * (q % semesterDays) + q % 10);
+        found += lessonManager.findFreeClassRooms(window, window + pt::minutes(45), 30, "IT").size();
+        found += lessonManager.findFreeTeachers(window, window + pt::minutes(45)).size();
+    }
+    const double queryMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / queriesCount;
+
+    BOOST_TEST(found > 0);
+    BOOST_TEST_MESSAGE("Free rooms and teachers among " << roomsCount << " rooms, " << teachersCount << " teachers and "
+                       << lessonsCount << " lessons: " << queryMs << " ms per query pair");
+}
+
+BOOST_AUTO_TEST_CASE(CommonFreeSlotBenchmark) {
+    constexpr int participantsCount = 32;
+    constexpr int lessonsPerParticipant = 40;
+    constexpr int queriesCount = 10000;
+
+    std::vector<WeeklyOccupancy> grids(participantsCount);
+    const pt::ptime monday = pt::time_from_string("2030-02-04 08:00:00");
+    for (int p = 0; p < participantsCount; p++) {
+        for (int l = 0; l < lessonsPerParticipant; l++) {
+            const pt::ptime begin = monday + pt::hours(24 * (l % 5) + (l * 7 + p) % 10) + pt::minutes(15 * (p % 4));
+            grids[p].occupy(begin, begin + pt::minutes(45));
+        }
+    }
+    std::vector<const WeeklyOccupancy*> participants;
+    for (const WeeklyOccupancy &grid : grids) participants.push_back(&grid);
+
+    long long checksum = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < queriesCount; q++) {
+        checksum += WeeklyOccupancy::findCommonFreeSlot(participants, 9 + q % 12, q % WeeklyOccupancy::slotsPerWeek);
+    }
+    const double queryUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / queriesCount;
+
+    BOOST_TEST(checksum > 0);
+    BOOST_TEST_MESSAGE("Common free slot of " << participantsCount << " weekly grids: " << queryUs << " us per query");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(RoomAssignmentBenchmark)
+
+BOOST_AUTO_TEST_CASE(AssignRoomsBenchmark) {
+    constexpr int roomsCount = 500;
+    constexpr int lessonsCount = 10000;
+    constexpr int startHours = 50;
+
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    for (int i = 0; i < roomsCount; i++) {
+        const ClassRoomTypePtr type = i % 3 == 0 ? ClassRoomTypeFactory::getITClassRoom(10 + i % 20)
+                                    : i % 3 == 1 ? ClassRoomTypeFactory::getMathClassRoom(i % 2 == 0)
+                                                 : ClassRoomTypeFactory::getEngClassRoom(i % 2 == 0);
+        classRoomRepo->add(std::make_shared<ClassRoom>(i, true, 10 + (i * 7) % 51, 50.0 + (i * 13) % 101, type));
+    }
+
+    const char *types[] = {"IT", "MATH", "ENG", ""};
+    const pt::ptime monday = pt::time_from_string("2030-02-04 08:00:00");
+    std::vector<RoomAssignmentManager::Request> requests;
+    requests.reserve(lessonsCount);
+    for (int i = 0; i < lessonsCount; i++) {
+        const int hour = i % startHours;
+        const pt::ptime begin = monday + pt::hours(24 * (hour / 10) + hour % 10);
+        requests.push_back({begin, begin + pt::minutes(45 + (i * 17) % 46), 5 + (i * 11) % 46, types[i % 4]});
+    }
+
+    RoomAssignmentManager manager(classRoomRepo, lessonRepo);
+    const auto begin = std::chrono::steady_clock::now();
+    const std::vector<ClassRoomPtr> rooms = manager.assignRooms(requests);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    const int assigned = static_cast<int>(std::count_if(rooms.begin(), rooms.end(), [](const ClassRoomPtr &room) { return room != nullptr; }));
+    int wastedSeats = 0;
+    for (std::size_t i = 0; i < rooms.size(); i++) {
+        if (rooms[i] != nullptr) wastedSeats += rooms[i]->getSeatsNumber() - requests[i].headcount;
+    }
+
+    BOOST_TEST(assigned > lessonsCount * 9 / 10);
+    BOOST_TEST_MESSAGE("Assigned rooms to " << assigned << " of " << lessonsCount << " lessons over " << roomsCount << " rooms in "
+                       << seconds << " s, " << static_cast<double>(wastedSeats) / assigned << " wasted seats per lesson");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(TimetableBenchmark)
+
+BOOST_AUTO_TEST_CASE(GenerateTimetableBenchmark) {
+    constexpr int roomsCount = 20;
+    constexpr int teachersCount = 40;
+    constexpr int groupsCount = 20;
+    constexpr int coursesPerGroup = 5;
+
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    for (int i = 0; i < roomsCount; i++) {
+        const ClassRoomTypePtr type = i % 3 == 0 ? ClassRoomTypeFactory::getITClassRoom(10)
+                                    : i % 3 == 1 ? ClassRoomTypeFactory::getMathClassRoom(true)
+                                                 : ClassRoomTypeFactory::getEngClassRoom(true);
+        classRoomRepo->add(std::make_shared<ClassRoom>(i, true, 15 + (i * 7) % 21, 100.0, type));
+    }
+    for (int i = 0; i < teachersCount; i++) {
+        personRepo->add(std::make_shared<Person>("Nauczyciel", std::to_string(i), i));
+    }
+
+    const char *types[] = {"IT", "MATH", "ENG", ""};
+    std::vector<TimetableManager::Course> courses;
+    int studentId = teachersCount;
+    for (int group = 0; group < groupsCount; group++) {
+        std::vector<int> studentIds;
+        for (int k = 0; k < 10 + group % 3 * 5; k++) {
+            personRepo->add(std::make_shared<Person>("Uczen", std::to_string(studentId), studentId));
+            studentIds.push_back(studentId++);
+        }
+        for (int c = 0; c < coursesPerGroup; c++) {
+            courses.push_back({types[c % 4], (group * coursesPerGroup + c) % teachersCount, studentIds, 3, 90, 100, types[c % 4]});
+        }
+    }
+
+    TimetableManager::Options options;
+    options.weekStart = pt::time_from_string("2030-02-04 00:00:00");
+    options.iterations = 500000;
+    options.progressInterval = 100000;
+    options.onProgress = [](const TimetableManager::Progress &progress) {
+        BOOST_TEST_MESSAGE("Chain " << progress.thread << " after " << progress.iteration << " iterations: cost " << progress.cost
+                           << ", best " << progress.bestCost << " with " << progress.bestConflicts << " conflicts at "
+                           << progress.seconds << " s");
+    };
+
+    TimetableManager manager(personRepo, classRoomRepo);
+    const TimetableManager::Result result = manager.generate(courses, options);
+
+    BOOST_TEST(result.lessons.size() == static_cast<std::size_t>(groupsCount * coursesPerGroup * 3));
+    BOOST_TEST(result.conflicts == 0);
+    BOOST_TEST_MESSAGE("Placed " << result.lessons.size() << " lessons on " << std::max(1u, std::thread::hardware_concurrency())
+                       << " threads with cost " << result.cost << " and " << result.conflicts << " conflicts, "
+                       << result.bestOverTime.size() << " improvements, last at " << result.bestOverTime.back().seconds << " s");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ImportBenchmark)
+
+BOOST_AUTO_TEST_CASE(ImportLessonsBenchmark) {
+    constexpr int rowsCount = 1000000;
+    constexpr int roomsCount = 500;
+    constexpr int teachersCount = 1000;
+    constexpr int studentsCount = 2000;
+
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    auto lessonManager = std::make_shared<LessonManager>(lessonRepo, nullptr, personRepo, classRoomRepo);
+    ImportManager importer(personRepo, classRoomRepo, lessonManager);
+
+    std::stringstream persons;
+    for (int i = 0; i < teachersCount + studentsCount; i++) {
+        persons << "Osoba," << i << "," << i << "\n";
+    }
+    std::stringstream classRooms;
+    for (int i = 0; i < roomsCount; i++) {
+        classRooms << i << ",30,100," << (i % 2 == 0 ? "IT,10" : "MATH,1") << "\n";
+    }
+    BOOST_TEST(importer.importPersons(persons).imported == teachersCount + studentsCount);
+    BOOST_TEST(importer.importClassRooms(classRooms).imported == roomsCount);
+
+    // Every hour slot fills all rooms with distinct teachers; every 1000th row repeats the previous slot and is rejected.
+    const pt::ptime weekStart = pt::time_from_string("2030-02-04 00:00:00");
+    std::stringstream lessons;
+    lessons << "type,teacherId,classRoomNumber,beginTime,endTime,baseCost,subject,studentIds\n";
+    for (int i = 0; i < rowsCount; i++) {
+        const int slot = i / roomsCount - (i % 1000 == 999 ? 1 : 0);
+        const pt::ptime begin = weekStart + pt::hours(24 * (slot / 10) + 8 + slot % 10);
+        const int student = teachersCount + i % studentsCount;
+        lessons << (i % 2 == 0 ? "INDIVIDUAL," : "GROUP,") << i % teachersCount << "," << i % roomsCount << ","
+                << pt::to_iso_extended_string(begin).replace(10, 1, " ") << ","
+                << pt::to_iso_extended_string(begin + pt::hours(1)).replace(10, 1, " ") << ",100,Matematyka," << student;
+        if (i % 2 == 1) lessons << ";" << teachersCount + (i + 1) % studentsCount;
+        lessons << "\n";
+    }
+
+    const ImportManager::Report report = importer.importLessons(lessons);
+
+    BOOST_TEST(report.rows == rowsCount);
+    BOOST_TEST(report.rejected.size() == static_cast<std::size_t>(rowsCount / 1000));
+    BOOST_TEST(report.imported + static_cast<long>(report.rejected.size()) == rowsCount);
+    BOOST_TEST(lessonRepo->totalSize() == report.imported);
+    BOOST_TEST_MESSAGE("Imported " << report.imported << " of " << report.rows << " lessons in " << report.seconds << " s ("
+                       << report.rowsPerSecond() << " rows/s), rejected " << report.rejected.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ConcurrencyBenchmark)
+
+BOOST_AUTO_TEST_CASE(RepositoryReadWriteScalingBenchmark) {
+    constexpr int lessonsCount = 10000;
+    constexpr int roomsCount = 100;
+    constexpr long operationsCount = 400000;
+
+    auto personRepo = std::make_shared<PersonRepository>();
+    LessonRepository repository;
+    std::vector<PersonPtr> teachers;
+    std::vector<ClassRoomPtr> classRooms;
+    for (int i = 0; i < roomsCount; i++) {
+        teachers.push_back(std::make_shared<Person>("Nauczyciel", std::to_string(i), i));
+        classRooms.push_back(std::make_shared<ClassRoom>(i, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10)));
+        personRepo->add(teachers.back());
+    }
+
+    const pt::ptime base = pt::time_from_string("2030-02-04 08:00:00");
+    for (int i = 0; i < lessonsCount; i++) {
+        const pt::ptime begin = base + pt::hours(i / roomsCount);
+        repository.add(std::make_shared<GroupLesson>(teachers[i % roomsCount], begin, begin + pt::hours(1), 100, "Matematyka",
+                                                     classRooms[i % roomsCount]), false);
+    }
+
+    // 95% lookups (free-slot checks and person lookups), 5% add-then-remove of a lesson after the existing ones.
+    for (const int threadsCount : {1, 2, 4, 8, 16, 32}) {
+        const long perThread = operationsCount / threadsCount;
+        const auto started = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadsCount; t++) {
+            threads.emplace_back([&, t] {
+                for (long i = 0; i < perThread; i++) {
+                    const int room = static_cast<int>((i * 31 + t) % roomsCount);
+                    const pt::ptime begin = base + pt::hours(i % (lessonsCount / roomsCount + 10));
+                    if (i % 20 == 0) {
+                        const auto lesson = std::make_shared<GroupLesson>(teachers[room], begin + pt::hours(lessonsCount), begin + pt::hours(lessonsCount + 1),
+                                                                          100, "Matematyka", classRooms[room]);
+                        repository.add(lesson, true);
+                        repository.remove(lesson);
+                    } else if (i % 2 == 0) {
+                        (void) repository.isClassRoomFree(room, begin, begin + pt::minutes(30));
+                    } else {
+                        (void) personRepo->findPersonById(room);
+                        (void) repository.isTeacherFree(room, begin, begin + pt::minutes(30));
+                    }
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        BOOST_TEST(repository.totalSize() == lessonsCount);
+        BOOST_TEST_MESSAGE(threadsCount << " threads: " << perThread * threadsCount / seconds << " ops/s");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(SnapshotBenchmark)
+
+BOOST_AUTO_TEST_CASE(ReportDuringWritesBenchmark) {
+    constexpr int personsCount = 20000;
+    constexpr int writesCount = 5000;
+
+    auto personRepo = std::make_shared<PersonRepository>();
+    PersonManager personManager(personRepo, nullptr);
+    for (int i = 0; i < personsCount; i++) {
+        personRepo->add(std::make_shared<Person>("Osoba", std::to_string(i), i));
+    }
+
+    // Measures the writer alone and then while another thread keeps printing full reports; the
+    // writer never waits for a report, because reports walk a snapshot.
+    auto measureWrites = [&personRepo](const int offset) {
+        std::vector<double> latencies;
+        latencies.reserve(writesCount);
+        const auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < writesCount; i++) {
+            const auto begin = std::chrono::steady_clock::now();
+            const auto person = std::make_shared<Person>("Nowa", "Osoba", offset + i);
+            personRepo->add(person);
+            personRepo->remove(person);
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        std::sort(latencies.begin(), latencies.end());
+        std::ostringstream summary;
+        summary << writesCount / seconds << " add+remove/s, p99 " << latencies[latencies.size() * 99 / 100] << " us, max "
+                << latencies.back() << " us";
+        return summary.str();
+    };
+
+    BOOST_TEST_MESSAGE("writer alone: " << measureWrites(personsCount));
+
+    std::atomic<bool> writing{true};
+    std::atomic<long> reports{0};
+    std::thread reporter([&] {
+        while (writing) {
+            BOOST_TEST(!personManager.report().empty());
+            reports++;
+        }
+    });
+    const std::string withReports = measureWrites(personsCount + writesCount);
+    writing = false;
+    reporter.join();
+
+    BOOST_TEST(personRepo->size() == personsCount);
+    BOOST_TEST_MESSAGE("writer with reports: " << withReports << "; " << reports << " reports of " << personsCount << " persons");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(TransactionBenchmark)
+
+BOOST_AUTO_TEST_CASE(ParallelStartFinishBenchmark) {
+    constexpr int lessonsCount = 8000;
+    constexpr int resourcesCount = 200;
+
+    // Every thread starts and finishes its own lessons; lessons of different threads share
+    // teachers and rooms now and then, which makes some transactions conflict and retry.
+    for (const int threadsCount : {1, 2, 4, 8}) {
+        auto personRepo = std::make_shared<PersonRepository>();
+        auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+        LessonManager manager(std::make_shared<LessonRepository>(), nullptr, personRepo, classRoomRepo);
+        for (int i = 0; i < resourcesCount; i++) {
+            personRepo->add(std::make_shared<Person>("Nauczyciel", std::to_string(i), i));
+            classRoomRepo->add(std::make_shared<ClassRoom>(i, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10)));
+        }
+
+        const pt::ptime base = pt::time_from_string("2030-02-04 08:00:00");
+        std::vector<int> ids;
+        for (int i = 0; i < lessonsCount; i++) {
+            const pt::ptime begin = base + pt::hours(i / resourcesCount);
+            ids.push_back(manager.addGroupLesson(personRepo->findPersonById(i % resourcesCount), begin, begin + pt::hours(1), 100, "Matematyka",
+                                                 classRoomRepo->findClassRoomByNumber(i % resourcesCount), false)->getID());
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadsCount; t++) {
+            threads.emplace_back([&, t] {
+                for (std::size_t i = t; i < ids.size(); i += threadsCount) {
+                    (void) manager.startLesson(ids[i]);
+                    (void) manager.finishLesson(ids[i]);
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        BOOST_TEST(manager.getLessonRepo()->totalSize() == 0);
+        BOOST_TEST_MESSAGE(threadsCount << " threads: " << 2 * lessonsCount / seconds << " starts+finishes/s, "
+                           << manager.getTransactionConflicts() << " conflicts");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ShardingBenchmark)
+
+BOOST_AUTO_TEST_CASE(WriteScalingBenchmark) {
+    constexpr int writesCount = 40000;
+    constexpr int roomsCount = 100;
+
+    std::vector<PersonPtr> teachers;
+    std::vector<ClassRoomPtr> classRooms;
+    for (int i = 0; i < roomsCount; i++) {
+        teachers.push_back(std::make_shared<Person>("Nauczyciel", std::to_string(i), i));
+        classRooms.push_back(std::make_shared<ClassRoom>(i, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10)));
+    }
+    const pt::ptime base = pt::time_from_string("2030-02-04 08:00:00");
+
+    // Every thread adds and removes its own persons and lessons; with one shard all of them queue
+    // for one lock, with many shards they mostly take different locks.
+    for (const std::size_t shardsCount : {std::size_t{1}, Sharding::defaultShardsCount}) {
+        for (const int threadsCount : {1, 2, 4, 8}) {
+            PersonRepository personRepo(shardsCount);
+            LessonRepository lessonRepo(shardsCount);
+            const int perThread = writesCount / threadsCount;
+
+            const auto started = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (int t = 0; t < threadsCount; t++) {
+                threads.emplace_back([&, t] {
+                    for (int i = 0; i < perThread; i++) {
+                        const int room = (t * perThread + i) % roomsCount;
+                        const pt::ptime begin = base + pt::hours(t * perThread + i);
+                        const auto person = std::make_shared<Person>("Osoba", "Nowa", roomsCount + t * perThread + i);
+                        const auto lesson = std::make_shared<GroupLesson>(teachers[room], begin, begin + pt::hours(1), 100, "Matematyka",
+                                                                          classRooms[room]);
+                        personRepo.add(person);
+                        (void) lessonRepo.add(lesson, true);
+                        personRepo.remove(person);
+                        (void) lessonRepo.remove(lesson);
+                    }
+                });
+            }
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+            BOOST_TEST(personRepo.size() == 0);
+            BOOST_TEST(lessonRepo.totalSize() == 0);
+            BOOST_TEST_MESSAGE(shardsCount << " shards, " << threadsCount << " threads: " << 4 * perThread * threadsCount / seconds
+                               << " writes/s");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(TaskPoolBenchmark)
+
+BOOST_AUTO_TEST_CASE(SmallTasksBenchmark) {
+    constexpr int batchesCount = 2000;
+    constexpr int tasksPerBatch = 50;
+
+    // Every batch task queues its small tasks on its own worker; idle workers have to steal them.
+    for (const std::size_t threadsCount : {1, 2, 4, 8}) {
+        TaskPool pool(threadsCount);
+        std::atomic<long> sum{0};
+
+        const auto started = std::chrono::steady_clock::now();
+        for (int batch = 0; batch < batchesCount; batch++) {
+            pool.post([&pool, &sum] {
+                for (int i = 0; i < tasksPerBatch; i++) {
+                    pool.post([&sum, i] { sum += i; });
+                }
+            });
+        }
+        pool.waitIdle();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        const TaskPool::Statistics statistics = pool.getStatistics();
+        BOOST_TEST(sum == static_cast<long>(batchesCount) * tasksPerBatch * (tasksPerBatch - 1) / 2);
+        BOOST_TEST(statistics.completed == statistics.submitted);
+        BOOST_TEST_MESSAGE(threadsCount << " threads: " << statistics.completed / seconds << " tasks/s, " << statistics.stolen
+                           << " stolen, max queue " << statistics.maxQueueDepth << ", wait avg " << statistics.averageWaitMicroseconds
+                           << " us / max " << statistics.maxWaitMicroseconds << " us, run avg " << statistics.averageRunMicroseconds << " us");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(PersistenceBenchmark)
+
+BOOST_AUTO_TEST_CASE(BackgroundFlushBenchmark) {
+    constexpr int personsCount = 100000;
+    constexpr int filesCount = 3;
+
+    auto personRepo = std::make_shared<PersonRepository>();
+    for (int i = 0; i < personsCount; i++) {
+        personRepo->add(std::make_shared<Person>("Osoba", std::to_string(i), i));
+    }
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < filesCount; i++) {
+        fileNames.push_back("/tmp/learningcenter-bench-" + std::to_string(i) + ".txt");
+    }
+    auto elapsed = [](const std::chrono::steady_clock::time_point started) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    };
+
+    // The caller of a blocking save waits for every file in turn; the caller of a background save
+    // only serializes, and the files are written in parallel.
+    auto started = std::chrono::steady_clock::now();
+    for (const std::string &fileName : fileNames) {
+        BOOST_TEST(Flusher::writeFile(fileName, PersonFilesStorage::serialize(personRepo)));
+    }
+    const double blocking = elapsed(started);
+
+    const auto taskPool = std::make_shared<TaskPool>(filesCount);
+    Flusher flusher(std::make_shared<ThreadPoolFileIO>(taskPool));
+    started = std::chrono::steady_clock::now();
+    std::vector<std::shared_future<bool>> saved;
+    for (const std::string &fileName : fileNames) {
+        saved.push_back(flusher.flush(fileName, PersonFilesStorage::serialize(personRepo)));
+    }
+    const double handedOver = elapsed(started);
+    flusher.waitAll();
+    const double flushed = elapsed(started);
+
+    for (const std::shared_future<bool> &result : saved) {
+        BOOST_TEST(result.get());
+    }
+    for (const std::string &fileName : fileNames) {
+        std::remove(fileName.c_str());
+    }
+    BOOST_TEST_MESSAGE(filesCount << " files of " << personsCount << " persons: blocking saves " << blocking << " ms; background saves return after "
+                       << handedOver << " ms, flushed after " << flushed << " ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(FileIOBenchmark)
+
+BOOST_AUTO_TEST_CASE(BackendsBenchmark) {
+    constexpr int snapshotsCount = 16;
+    constexpr int appendsCount = 2000;
+    constexpr int requestsCount = 20000;
+
+    const std::string snapshot(1 << 20, 'x');
+    auto elapsed = [](const std::chrono::steady_clock::time_point started) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    };
+
+    const auto taskPool = std::make_shared<TaskPool>(2);
+    std::vector<FileIOPtr> backends{std::make_shared<ThreadPoolFileIO>(taskPool)};
+    if (FileIOPtr uring = UringFileIO::create(256)) backends.push_back(uring);
+
+    // Snapshot writes, archive appends and reads are handed over while the calling thread keeps
+    // handling requests; the figures show how long the I/O holds the caller and the pool back.
+    for (const FileIOPtr &fileIO : backends) {
+        const std::string prefix = "/tmp/learningcenter-bench-fileio-" + std::to_string(getpid());
+        std::atomic<int> pending{0};
+        std::atomic<int> failures{0};
+        auto written = [&pending, &failures](const bool saved) {
+            if (!saved) failures++;
+            pending--;
+        };
+
+        const auto started = std::chrono::steady_clock::now();
+        pending += snapshotsCount + appendsCount;
+        for (int i = 0; i < snapshotsCount; i++) {
+            fileIO->submitReplace(prefix + "-" + std::to_string(i) + ".txt", snapshot, written);
+        }
+        for (int i = 0; i < appendsCount; i++) {
+            fileIO->submitAppend(prefix + "-archive.txt", "Lekcja " + std::to_string(i) + "\n", written);
+        }
+        const double handedOver = elapsed(started);
+
+        auto personRepo = std::make_shared<PersonRepository>();
+        for (int i = 0; i < requestsCount; i++) {
+            personRepo->add(std::make_shared<Person>("Osoba", std::to_string(i), i));
+        }
+        const double requests = elapsed(started);
+
+        while (pending.load() > 0) std::this_thread::yield();
+        const double writtenAfter = elapsed(started);
+        std::vector<std::future<std::string>> reads;
+        for (int i = 0; i < snapshotsCount; i++) {
+            reads.push_back(fileIO->read(prefix + "-" + std::to_string(i) + ".txt"));
+        }
+        for (std::future<std::string> &read : reads) {
+            BOOST_TEST(read.get().size() == snapshot.size());
+        }
+        const double total = elapsed(started);
+
+        BOOST_TEST(failures.load() == 0);
+        for (int i = 0; i < snapshotsCount; i++) {
+            std::remove((prefix + "-" + std::to_string(i) + ".txt").c_str());
+        }
+        std::remove((prefix + "-archive.txt").c_str());
+        BOOST_TEST_MESSAGE(fileIO->getName() << ": " << snapshotsCount << " snapshots of 1 MiB and " << appendsCount << " appends handed over in "
+                           << handedOver << " ms, " << requestsCount << " requests done after " << requests << " ms, written after "
+                           << writtenAfter << " ms, read back after " << total << " ms");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ServiceBenchmark)
+
+/**
+ * @brief FileIO writing every file under /tmp instead of its own path, so the benchmark leaves the database alone.
+ */
+class TemporaryFileIO : public FileIO {
+private:
+    FileIOPtr fileIO;
+
+    static std::string redirect(const std::string &fileName) {
+        return "/tmp/learningcenter-bench-service-" + std::to_string(getpid()) + "-" + fileName.substr(fileName.find_last_of('/') + 1);
+    }
+
+public:
+    explicit TemporaryFileIO(FileIOPtr fileIO) : fileIO(std::move(fileIO)) {}
+
+    ~TemporaryFileIO() override {
+        std::remove(redirect(LessonFilesStorage::databaseFile).c_str());
+    }
+
+    void submitReplace(const std::string &fileName, std::string contents, WriteCallback done) override {
+        fileIO->submitReplace(redirect(fileName), std::move(contents), std::move(done));
+    }
+
+    void submitAppend(const std::string &fileName, std::string contents, WriteCallback done) override {
+        fileIO->submitAppend(redirect(fileName), std::move(contents), std::move(done));
+    }
+
+    void submitRead(const std::string &fileName, ReadCallback done) override {
+        fileIO->submitRead(redirect(fileName), std::move(done));
+    }
+
+    [[nodiscard]] std::string getName() const override {
+        return fileIO->getName();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(CoroutinesVersusThreadsBenchmark) {
+    constexpr int lessonsCount = 20;
+    constexpr int requestsCount = 2000;
+
+    // Every request enrolls one student and returns once the lessons are on disk. A thread per
+    // request blocks on the write; a coroutine suspends and leaves its loop to other requests.
+    for (const bool coroutines : {false, true}) {
+        auto personRepo = std::make_shared<PersonRepository>();
+        auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+        auto manager = std::make_shared<LessonManager>(std::make_shared<LessonRepository>(), nullptr, personRepo, classRoomRepo);
+        const auto taskPool = std::make_shared<TaskPool>(2);
+        const auto fileIO = std::make_shared<TemporaryFileIO>(FileIO::create(taskPool));
+        const auto flusher = std::make_shared<Flusher>(fileIO);
+        manager->setFlusher(flusher);
+
+        const pt::ptime base = pt::time_from_string("2030-02-04 08:00:00");
+        std::vector<int> lessonIds;
+        for (int i = 0; i < lessonsCount; i++) {
+            personRepo->add(std::make_shared<Person>("Nauczyciel", std::to_string(i), i));
+            classRoomRepo->add(std::make_shared<ClassRoom>(i, true, requestsCount, 100.0, ClassRoomTypeFactory::getITClassRoom(10)));
+            lessonIds.push_back(manager->addGroupLesson(personRepo->findPersonById(i), base, base + pt::hours(1), 100, "Matematyka",
+                                                        classRoomRepo->findClassRoomByNumber(i), false)->getID());
+        }
+        for (int i = 0; i < requestsCount; i++) {
+            personRepo->add(std::make_shared<Person>("Uczen", std::to_string(i), lessonsCount + i));
+        }
+
+        std::atomic<int> enrolled{0};
+        std::size_t threadsCount;
+        const auto started = std::chrono::steady_clock::now();
+        if (coroutines) {
+            const LessonService service(manager, flusher, fileIO);
+            Executor executor;
+            threadsCount = executor.getLoopsCount();
+            std::vector<std::future<std::vector<int>>> results;
+            for (int i = 0; i < requestsCount; i++) {
+                results.push_back(executor.spawn(service.enroll(lessonIds[i % lessonsCount], {lessonsCount + i})));
+            }
+            for (std::future<std::vector<int>> &result : results) {
+                if (result.get() == std::vector<int>({0})) enrolled++;
+            }
+        } else {
+            // The same lock as the service takes, released before the thread blocks on the write.
+            std::mutex mutex;
+            std::vector<std::thread> threads;
+            for (int i = 0; i < requestsCount; i++) {
+                threads.emplace_back([&, i] {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    const int personId = lessonsCount + i;
+                    const std::vector<int> result = manager->enrollStudents(lessonIds[i % lessonsCount], std::span<const int>(&personId, 1));
+                    const std::shared_future<bool> saved = manager->saveAsync();
+                    lock.unlock();
+                    (void) saved.get();
+                    if (result == std::vector<int>({0})) enrolled++;
+                });
+            }
+            threadsCount = threads.size();
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+        }
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        flusher->waitAll();
+
+        BOOST_TEST(enrolled.load() == requestsCount);
+        BOOST_TEST_MESSAGE((coroutines ? "coroutines" : "thread per request") << " (" << fileIO->getName() << ", " << threadsCount << " threads): "
+                           << requestsCount << " enrollments in " << elapsed << " ms, " << flusher->getWritten() << " writes, "
+                           << flusher->getCoalesced() << " coalesced");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
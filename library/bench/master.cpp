@@ -0,0 +1,6 @@
+#define BOOST_TEST_MODULE MasterBenchmarkSuite
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
@@ -0,0 +1,231 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include "concurrency/Task.h"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Runs coroutines on a few single-threaded loops, one per hardware thread.
+ *
+ * Each loop is one thread resuming the coroutines queued on it in turn. A coroutine spawned on a
+ * loop stays there: when it suspends on I/O it holds no thread, and the completion queues it back
+ * on the same loop, so its code never runs on two threads at once and thousands of requests are
+ * served by a handful of threads.
+ *
+ * The destructor waits for every spawned coroutine to finish.
+ */
+class Executor {
+private:
+    /**
+     * @brief A loop thread and the coroutines ready to run on it.
+     */
+    struct Loop {
+        std::deque<std::coroutine_handle<>> ready; /**< Coroutines waiting to be resumed, oldest first. */
+        std::mutex mutex; /**< Guards ready and stopping. */
+        std::condition_variable wakeUp; /**< Wakes the thread when a coroutine is queued or the executor stops. */
+        bool stopping = false; /**< Set by the destructor of the executor. */
+        std::thread thread; /**< The loop thread. */
+
+        /**
+         * @brief Queues a coroutine to be resumed by the thread.
+         *
+         * @param coroutine The coroutine.
+         */
+        void post(std::coroutine_handle<> coroutine);
+
+        /**
+         * @brief Body of the loop thread.
+         */
+        void run();
+    };
+
+    /**
+     * @brief Coroutine started by spawn(), destroying itself when it finishes.
+     */
+    struct Detached {
+        /**
+         * @brief Promise of a Detached coroutine.
+         */
+        struct promise_type {
+            /** @brief Creates the Detached holding the coroutine. */
+            Detached get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+            /** @brief Suspends the new coroutine until a loop resumes it. */
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            /** @brief Lets the frame be destroyed once the coroutine finishes. */
+            std::suspend_never final_suspend() const noexcept { return {}; }
+
+            /** @brief Marks the end of the coroutine. */
+            void return_void() const noexcept {}
+
+            /** @brief Unreachable, since run() catches everything. */
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+
+        std::coroutine_handle<promise_type> handle; /**< The suspended coroutine. */
+    };
+
+    std::vector<std::unique_ptr<Loop>> loops; /**< The loops; never resized after construction. */
+    std::atomic<std::size_t> nextLoop{0}; /**< Loop receiving the next spawned coroutine. */
+    std::atomic<std::size_t> active{0}; /**< Number of spawned coroutines not finished yet. */
+    std::mutex activeMutex; /**< Guards the waits on finished. */
+    std::condition_variable finished; /**< Wakes the destructor when the last spawned coroutine finishes. */
+
+    /**
+     * @brief Counts a spawned coroutine as finished.
+     */
+    void release();
+
+    /**
+     * @brief Awaits a Task and fulfils a promise with its result.
+     *
+     * @param task The Task.
+     * @param promise Receives the result or the exception.
+     * @return The coroutine, suspended before its first statement.
+     */
+    template <typename T>
+    Detached run(Task<T> task, std::promise<T> promise) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                promise.set_value();
+            } else {
+                promise.set_value(co_await task);
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+        release();
+    }
+
+public:
+    /**
+     * @brief Constructs an executor and starts its loops.
+     *
+     * @param loopsCount The number of loop threads (at least 1).
+     */
+    explicit Executor(std::size_t loopsCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Waits for every spawned coroutine and joins the loop threads.
+     *
+     * Must not be called from a loop of this executor.
+     */
+    ~Executor();
+
+    /**
+     * @brief Starts a Task on the next loop.
+     *
+     * @param task The Task.
+     * @return Future of the result of the Task.
+     */
+    template <typename T>
+    std::future<T> spawn(Task<T> task) {
+        std::promise<T> promise;
+        std::future<T> result = promise.get_future();
+        active++;
+
+        const Detached detached = run(std::move(task), std::move(promise));
+        loops[nextLoop++ % loops.size()]->post(detached.handle);
+
+        return result;
+    }
+
+    /**
+     * @brief Gets the number of loop threads.
+     *
+     * @return The number of loops.
+     */
+    [[nodiscard]] std::size_t getLoopsCount() const;
+
+    /**
+     * @brief Gets a function resuming a coroutine on the loop running the calling thread.
+     *
+     * Called by an awaiter before it hands a completion callback to another thread, so that the
+     * coroutine continues on its own loop; outside any loop the function resumes the coroutine on
+     * whichever thread calls it.
+     *
+     * @return Function queueing a coroutine on the current loop.
+     */
+    static std::function<void(std::coroutine_handle<>)> resumer();
+};
+
+
+/**
+ * @brief Awaitable suspending a coroutine until a callback delivers a value.
+ *
+ * Adapts the callback-based asynchronous interfaces, such as FileIO and Flusher, to coroutines:
+ * the start function receives the callback and begins the operation, and the coroutine is resumed
+ * on its own loop with the value passed to the callback. The callback must be called exactly once.
+ *
+ * GCC 12 destroys twice a lambda that captures a std::string or another non-trivial object by
+ * value when the lambda is created inside the co_await expression, so such a Completion is
+ * declared as a variable and then awaited.
+ *
+ * @tparam T Type of the value.
+ */
+template <typename T>
+class Completion {
+private:
+    std::function<void(std::function<void(T)>)> start; /**< Begins the operation and arranges the callback. */
+    std::optional<T> value; /**< The value passed to the callback. */
+
+public:
+    /**
+     * @brief Constructs a Completion.
+     *
+     * @param start Function beginning the operation; receives the callback.
+     */
+    explicit Completion(std::function<void(std::function<void(T)>)> start) : start(std::move(start)) {}
+
+    /**
+     * @brief Never ready, since the operation has not started.
+     *
+     * @return False.
+     */
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    /**
+     * @brief Begins the operation, to resume the coroutine from the callback.
+     *
+     * @param coroutine The suspended coroutine.
+     */
+    void await_suspend(const std::coroutine_handle<> coroutine) {
+        // Nothing may touch the Completion after start(): the callback may already have resumed
+        // the coroutine, which owns it.
+        start([this, coroutine, resume = Executor::resumer()](T delivered) {
+            value.emplace(std::move(delivered));
+            resume(coroutine);
+        });
+    }
+
+    /**
+     * @brief Gets the value passed to the callback.
+     *
+     * @return The value.
+     */
+    T await_resume() {
+        return std::move(*value);
+    }
+};
+
+
+
+#endif //EXECUTOR_H
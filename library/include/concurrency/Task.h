@@ -0,0 +1,159 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @brief Lazily started coroutine producing a value of type T.
+ *
+ * A Task does nothing until it is awaited; the awaiting coroutine is suspended, the Task runs
+ * on the same thread, and when it finishes its awaiter is resumed at once, by symmetric transfer,
+ * so a chain of awaited Tasks neither grows the stack nor passes through a queue. An exception
+ * escaping the Task is rethrown to its awaiter. Executor::spawn() starts a Task that nobody awaits.
+ *
+ * @tparam T Type of the value, or void.
+ */
+template <typename T>
+class Task {
+private:
+    /**
+     * @brief State shared by the promises of every Task.
+     */
+    struct PromiseBase {
+        std::coroutine_handle<> continuation; /**< The coroutine awaiting the Task, or null. */
+        std::exception_ptr error; /**< The exception that escaped the Task, if any. */
+
+        /**
+         * @brief Resumes the awaiter when the Task finishes.
+         */
+        struct FinalAwaiter {
+            /** @brief Always suspends, so the awaiter can read the result before the frame is destroyed. */
+            bool await_ready() const noexcept { return false; }
+
+            /** @brief Transfers to the awaiter, or returns to whoever resumed the Task. */
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+                const std::coroutine_handle<> continuation = finished.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            /** @brief Never resumed. */
+            void await_resume() const noexcept {}
+        };
+
+        /** @brief Suspends the new Task until it is awaited. */
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        /** @brief Hands control back to the awaiter. */
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        /** @brief Keeps the exception for the awaiter. */
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    /**
+     * @brief Promise of a Task returning a value.
+     */
+    struct ValuePromise : PromiseBase {
+        std::optional<T> value; /**< The returned value. */
+
+        /** @brief Creates the Task owning the coroutine. */
+        Task get_return_object() { return Task(std::coroutine_handle<ValuePromise>::from_promise(*this)); }
+
+        /** @brief Stores the returned value. */
+        template <typename Value>
+        void return_value(Value &&returned) { value.emplace(std::forward<Value>(returned)); }
+
+        /** @brief Gets the value, or rethrows the exception. */
+        T result() {
+            if (this->error) std::rethrow_exception(this->error);
+            return std::move(*value);
+        }
+    };
+
+    /**
+     * @brief Promise of a Task returning nothing.
+     */
+    struct VoidPromise : PromiseBase {
+        /** @brief Creates the Task owning the coroutine. */
+        Task get_return_object() { return Task(std::coroutine_handle<VoidPromise>::from_promise(*this)); }
+
+        /** @brief Marks the end of the coroutine. */
+        void return_void() const noexcept {}
+
+        /** @brief Rethrows the exception, if any. */
+        void result() const {
+            if (this->error) std::rethrow_exception(this->error);
+        }
+    };
+
+public:
+    using promise_type = std::conditional_t<std::is_void_v<T>, VoidPromise, ValuePromise>; /**< Promise type looked up by the compiler. */
+
+private:
+    std::coroutine_handle<promise_type> handle; /**< The coroutine, owned by the Task; null once moved from. */
+
+    /**
+     * @brief Constructs the Task owning a coroutine.
+     *
+     * @param handle The coroutine.
+     */
+    explicit Task(const std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+public:
+    /**
+     * @brief Takes over the coroutine of another Task.
+     *
+     * @param other The Task moved from.
+     */
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /**
+     * @brief Destroys the coroutine.
+     */
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    /**
+     * @brief Never ready, since the Task has not started.
+     *
+     * @return False.
+     */
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    /**
+     * @brief Starts the Task, to resume the awaiter when it finishes.
+     *
+     * @param awaiter The awaiting coroutine.
+     * @return The Task, to run in place of the awaiter.
+     */
+    std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiter) noexcept {
+        handle.promise().continuation = awaiter;
+        return handle;
+    }
+
+    /**
+     * @brief Gets the result of the finished Task.
+     *
+     * @return The value returned by the Task.
+     * @throws Whatever escaped the Task.
+     */
+    T await_resume() {
+        return handle.promise().result();
+    }
+};
+
+
+
+#endif //TASK_H
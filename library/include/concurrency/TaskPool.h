@@ -0,0 +1,216 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+/**
+ * @brief Work-stealing pool of threads running background tasks.
+ *
+ * Every worker thread has its own queue. A task submitted by a worker goes to the back of that
+ * worker's queue and is taken back from there first, so related tasks stay on one thread; other
+ * submissions are spread over the queues in turn. A worker whose queue is empty steals from the
+ * front of the other queues before it goes to sleep, so no thread idles while work is waiting.
+ *
+ * The pool counts submitted, completed, stolen and failed tasks, and measures how long tasks
+ * wait in the queues and how long they run; getStatistics() returns the figures for tuning the
+ * number of threads. Tasks still queued when the pool is destroyed are run before its threads
+ * are joined.
+ */
+class TaskPool {
+public:
+    /**
+     * @brief Counters and timings of the pool since it was created.
+     */
+    struct Statistics {
+        std::size_t threadsCount; /**< Number of worker threads. */
+        std::uint64_t submitted; /**< Number of tasks submitted. */
+        std::uint64_t completed; /**< Number of tasks that have finished running. */
+        std::uint64_t stolen; /**< Number of tasks taken from the queue of another worker. */
+        std::uint64_t failed; /**< Number of posted tasks that threw an exception. */
+        std::size_t queueDepth; /**< Number of tasks waiting in the queues now. */
+        std::size_t maxQueueDepth; /**< Largest number of tasks ever waiting at once. */
+        double averageWaitMicroseconds; /**< Average time from submission to the start of a task. */
+        double maxWaitMicroseconds; /**< Longest time a task waited to start. */
+        double averageRunMicroseconds; /**< Average running time of a task. */
+    };
+
+private:
+    using Clock = std::chrono::steady_clock; /**< Clock measuring waiting and running times. */
+
+    /**
+     * @brief A queued task.
+     */
+    struct Task {
+        std::function<void()> function; /**< The work to do. */
+        Clock::time_point submitted; /**< When the task was submitted. */
+    };
+
+    /**
+     * @brief A worker thread and its queue.
+     */
+    struct Worker {
+        std::deque<Task> tasks; /**< Tasks queued on the worker; its owner takes from the back, thieves from the front. */
+        std::mutex mutex; /**< Guards tasks. */
+        std::thread thread; /**< The worker thread. */
+    };
+
+    std::vector<Worker> workers; /**< The workers; never resized, since a Worker cannot be moved. */
+    std::atomic<std::size_t> nextWorker{0}; /**< Worker whose queue receives the next task submitted from outside the pool. */
+    std::atomic<std::size_t> queued{0}; /**< Number of tasks waiting in the queues. */
+    std::atomic<std::size_t> running{0}; /**< Number of tasks being run. */
+    std::atomic<std::size_t> sleeping{0}; /**< Number of workers waiting for tasks. */
+    bool stopping = false; /**< Set by the destructor; guarded by sleepMutex. */
+    std::mutex sleepMutex; /**< Guards stopping and the waits on wakeUp and idle. */
+    std::condition_variable wakeUp; /**< Wakes sleeping workers when a task is queued or the pool stops. */
+    std::condition_variable idle; /**< Wakes waitIdle() when the last task finishes. */
+
+    std::atomic<std::uint64_t> submitted{0}; /**< Number of tasks submitted. */
+    std::atomic<std::uint64_t> completed{0}; /**< Number of tasks finished. */
+    std::atomic<std::uint64_t> stolen{0}; /**< Number of tasks stolen. */
+    std::atomic<std::uint64_t> failed{0}; /**< Number of posted tasks that threw. */
+    std::atomic<std::size_t> maxQueueDepth{0}; /**< Largest value queued has reached. */
+    std::atomic<std::uint64_t> totalWaitNanoseconds{0}; /**< Sum of the waiting times of started tasks. */
+    std::atomic<std::uint64_t> maxWaitNanoseconds{0}; /**< Longest waiting time of a started task. */
+    std::atomic<std::uint64_t> totalRunNanoseconds{0}; /**< Sum of the running times of finished tasks. */
+
+    /**
+     * @brief Takes the next task for a worker, from its own queue or stolen from another.
+     *
+     * @param index Index of the worker.
+     * @param task Receives the task.
+     * @return True if a task was taken, false if every queue is empty.
+     */
+    bool take(std::size_t index, Task &task);
+
+    /**
+     * @brief Runs a taken task and records its statistics.
+     *
+     * @param task The task.
+     */
+    void run(Task &task);
+
+    /**
+     * @brief Body of a worker thread.
+     *
+     * @param index Index of the worker.
+     */
+    void work(std::size_t index);
+
+public:
+    /**
+     * @brief Constructs a pool and starts its threads.
+     *
+     * @param threadsCount The number of worker threads (at least 1).
+     */
+    explicit TaskPool(std::size_t threadsCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Runs the tasks still queued and joins the worker threads.
+     */
+    ~TaskPool();
+
+    /**
+     * @brief Gets the pool shared by the whole library.
+     *
+     * The pool is created on first use with one thread per hardware thread.
+     *
+     * @return The shared pool.
+     */
+    static TaskPool& shared();
+
+    /**
+     * @brief Queues a task whose result nobody waits for.
+     *
+     * An exception thrown by the task is counted as failed and otherwise ignored.
+     *
+     * @param function The work to do.
+     */
+    void post(std::function<void()> function);
+
+    /**
+     * @brief Queues a task and returns a future of its result.
+     *
+     * An exception thrown by the task is stored in the future.
+     *
+     * @param function Callable taking no arguments.
+     * @return Future of the value returned by the callable.
+     */
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function function) {
+        using Result = std::invoke_result_t<Function>;
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+        std::future<Result> result = task->get_future();
+        post([task] { (*task)(); });
+
+        return result;
+    }
+
+    /**
+     * @brief Queues a task on a pool, or runs it at once when there is no pool.
+     *
+     * Lets a component hand work to an optional pool and treat the result the same either way.
+     *
+     * @param pool Shared pointer to the pool, or nullptr to run the callable on the calling thread.
+     * @param function Callable taking no arguments.
+     * @return Future of the value returned by the callable.
+     */
+    template <typename Function>
+    static std::future<std::invoke_result_t<Function>> submitTo(const std::shared_ptr<TaskPool> &pool, Function function) {
+        if (pool != nullptr) return pool->submit(std::move(function));
+
+        std::packaged_task<std::invoke_result_t<Function>()> task(std::move(function));
+        task();
+        return task.get_future();
+    }
+
+    /**
+     * @brief Calls a function for every index of a range, using the pool and the calling thread.
+     *
+     * The calling thread takes indices too and never waits for a queued task to start, so the
+     * loop finishes even when every worker is busy, including when it is called from a task of
+     * this pool. The first exception thrown for any index is rethrown once every index is done.
+     *
+     * @param count The number of indices.
+     * @param function Function taking an index; it must be safe to call concurrently.
+     */
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)> &function);
+
+    /**
+     * @brief Waits until no task is queued or running.
+     *
+     * Must not be called from a task of this pool, which would wait for itself.
+     */
+    void waitIdle();
+
+    /**
+     * @brief Gets the number of worker threads.
+     *
+     * @return The number of threads.
+     */
+    [[nodiscard]] std::size_t getThreadsCount() const;
+
+    /**
+     * @brief Gets the counters and timings of the pool.
+     *
+     * @return The statistics; the figures are read one by one, so they may be slightly out of step with each other.
+     */
+    [[nodiscard]] Statistics getStatistics() const;
+};
+
+
+
+#endif //TASKPOOL_H
@@ -78,8 +78,8 @@ public:
     /**
      * @brief Saves all classrooms to a file.
      *
-     * Delegates to the ClassRoomManager to save classrooms to a file and outputs a success
-     * or failure message to the console.
+     * Delegates to the ClassRoomManager to save classrooms to a file in the background and returns
+     * at once; outputs a success or failure message to the console if the save has already finished.
      */
     void save() const;
 
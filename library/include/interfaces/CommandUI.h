@@ -0,0 +1,137 @@
+#ifndef COMMANDUI_H
+#define COMMANDUI_H
+
+#include "typedefs.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Runs line-oriented command scripts against the managers without any prompts.
+ *
+ * The CommandUI class is the headless counterpart of PersonUI, ClassRoomUI and LessonUI. Every
+ * line of a script is one command whose arguments are separated by whitespace; blank lines and
+ * lines starting with '#' are ignored. Commands are executed directly against the managers and
+ * every command produces exactly one tab-separated result line:
+ *
+ *     ok      <line>  <command>  <result>  <microseconds>
+ *     error   <line>  <command>  <reason>  <microseconds>
+ *
+ * followed at the end by a summary line:
+ *
+ *     summary <commands>  <failed>  <seconds>  <commands per second>
+ *
+ * Supported commands:
+ * - add-person <firstName> <lastName> <id>
+ * - add-room <number> <seats> <rentCost> <type> <equipment> (type is a registered tag such as IT, MATH or ENG)
+ * - plan-lesson group <teacherId> <classRoomNumber> <begin> <end> <baseCost> <subject> [studentId...]
+ * - plan-lesson individual <teacherId> <classRoomNumber> <begin> <end> <baseCost> <subject> <studentId>
+ * - start <lessonId>
+ * - finish <lessonId>
+ * - report persons|rooms|lessons
+ * - save
+ * - ping (answers "pong"; used to measure the round trip of the socket API)
+ *
+ * Times are written as "YYYY-MM-DDTHH:MM[:SS]". Numbers and times are read by TextParser, so they
+ * are accepted exactly as in ImportManager files. The lesson ID "@" stands for the lesson planned
+ * most recently by the script, so scripts do not depend on the IDs generated at run time.
+ */
+class CommandUI {
+public:
+    /**
+     * @brief Outcome of a script run.
+     */
+    struct Summary {
+        long commands; /**< Number of commands executed. */
+        long failed; /**< Number of commands that failed. */
+        double seconds; /**< Wall-clock duration of the run. */
+    };
+
+private:
+    PersonManagerPtr personManager; /**< Shared pointer to the PersonManager for handling person operations. */
+    ClassRoomManagerPtr classRoomManager; /**< Shared pointer to the ClassRoomManager for handling classroom operations. */
+    LessonManagerPtr lessonManager; /**< Shared pointer to the LessonManager for handling lesson operations. */
+    int lastLessonId; /**< ID of the lesson planned most recently, or -1 if none was planned. */
+
+    /**
+     * @brief Executes a single command.
+     *
+     * @param arguments The command name followed by its arguments.
+     * @param result Receives the result on success or the reason on failure.
+     * @return True if the command succeeded, false otherwise.
+     */
+    bool execute(const std::vector<std::string> &arguments, std::string &result);
+
+    bool addPerson(const std::vector<std::string> &arguments, std::string &result) const;
+    bool addClassRoom(const std::vector<std::string> &arguments, std::string &result) const;
+    bool planLesson(const std::vector<std::string> &arguments, std::string &result);
+    bool startLesson(const std::vector<std::string> &arguments, std::string &result) const;
+    bool finishLesson(const std::vector<std::string> &arguments, std::string &result) const;
+    bool report(const std::vector<std::string> &arguments, std::string &result) const;
+    bool save(const std::vector<std::string> &arguments, std::string &result) const;
+
+    /**
+     * @brief Resolves a lesson ID argument, including "@".
+     *
+     * @param argument The argument to resolve.
+     * @param id Receives the lesson ID.
+     * @return True if the argument is a valid lesson ID, false otherwise.
+     */
+    bool parseLessonId(const std::string &argument, int &id) const;
+
+public:
+    /**
+     * @brief Constructs a CommandUI object.
+     *
+     * @param personManager Shared pointer to the PersonManager to use.
+     * @param classRoomManager Shared pointer to the ClassRoomManager to use.
+     * @param lessonManager Shared pointer to the LessonManager to use.
+     */
+    CommandUI(PersonManagerPtr personManager, ClassRoomManagerPtr classRoomManager, LessonManagerPtr lessonManager);
+
+    /**
+     * @brief Default destructor.
+     */
+    ~CommandUI() = default;
+
+    /**
+     * @brief Runs a command script.
+     *
+     * Commands are executed in order; a failed command is reported and the run continues.
+     *
+     * @param input The script.
+     * @param output Receives one result line per command and the summary line.
+     * @return The summary of the run.
+     */
+    Summary run(std::istream &input, std::ostream &output);
+
+    /**
+     * @brief Executes a single command line.
+     *
+     * Used by SocketServer, which receives the commands one at a time. The line is not required
+     * to end with a newline; a blank line or a comment is reported as a failure. The lesson ID "@"
+     * is rejected, since requests sent over the socket are not executed in order.
+     *
+     * @param line The command and its arguments.
+     * @param result Receives the result on success or the reason on failure.
+     * @return True if the command succeeded, false otherwise.
+     */
+    bool executeLine(const std::string &line, std::string &result);
+
+    /**
+     * @brief Checks whether a command line only reads data.
+     *
+     * Read-only commands (report and ping) may run at the same time as each other, but not at the
+     * same time as a command that changes data.
+     *
+     * @param line The command and its arguments.
+     * @return True if the command does not change any data, false otherwise.
+     */
+    [[nodiscard]] static bool isReadOnly(const std::string &line);
+};
+
+
+
+#endif //COMMANDUI_H
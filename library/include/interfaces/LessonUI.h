@@ -71,8 +71,8 @@ public:
     /**
      * @brief Saves all lessons to files.
      *
-     * Delegates to the LessonManager to save lessons to files and outputs a success or
-     * failure message to the console.
+     * Delegates to the LessonManager to save lessons to files in the background and returns at
+     * once; outputs a success or failure message to the console if the save has already finished.
      */
     void save() const;
 
@@ -77,8 +77,8 @@ public:
     /**
      * @brief Saves all persons to a file.
      *
-     * Delegates to the PersonManager to save persons to a file and outputs a success or
-     * failure message to the console.
+     * Delegates to the PersonManager to save persons to a file in the background and returns at
+     * once; outputs a success or failure message to the console if the save has already finished.
      */
     void save() const;
 
@@ -0,0 +1,220 @@
+#ifndef SOCKETSERVER_H
+#define SOCKETSERVER_H
+
+#include "typedefs.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Serves the command API of CommandUI on a Unix domain socket.
+ *
+ * The SocketServer class lets many clients use one set of managers at the same time. A single
+ * event-loop thread accepts connections and moves bytes with non-blocking I/O driven by epoll;
+ * complete requests are handed to a pool of worker threads, which execute them and pass the
+ * responses back to the event loop through an eventfd.
+ *
+ * Requests and responses are frames: a 4-byte payload length and a 4-byte request ID, both
+ * big-endian, followed by the payload. A request payload is one CommandUI command line; the
+ * response carries the same request ID and the payload "ok\t<result>" or "error\t<reason>".
+ * A client may send several requests without waiting, and responses can arrive in any order.
+ * Frames longer than maxPayload close the connection.
+ *
+ * A client that sends faster than it is served is held back: once maxPendingRequests of its
+ * requests are queued or running, or maxUnsentOutput bytes of responses wait for it to read them,
+ * the server stops reading the connection until it drains, so the kernel buffers fill and the
+ * client's writes block.
+ *
+ * Read-only commands (see CommandUI::isReadOnly()) run on several workers at once. Commands that
+ * change data run alone: the repositories lock themselves, but a manager operation spans several
+ * repository calls and updates the model objects, which are not synchronized.
+ */
+class SocketServer {
+public:
+    static constexpr std::size_t headerSize = 8; /**< Size of the frame header in bytes. */
+    static constexpr std::uint32_t maxPayload = 1 << 20; /**< Largest accepted payload in bytes. */
+    static constexpr std::size_t maxPendingRequests = 64; /**< Requests of one connection queued or running before it stops being read. */
+    static constexpr std::size_t maxUnsentOutput = 4 << 20; /**< Unsent response bytes of one connection before it stops being read. */
+
+private:
+    /**
+     * @brief State of one client connection, owned by the event-loop thread.
+     */
+    struct Connection {
+        std::uint64_t id; /**< Unique ID of the connection, never reused, unlike the descriptor. */
+        std::string input; /**< Bytes received but not yet parsed into frames. */
+        std::string output; /**< Bytes waiting to be sent. */
+        std::size_t sent; /**< Number of leading output bytes already sent. */
+        std::size_t pending; /**< Number of requests handed to the workers whose responses have not been delivered yet. */
+        bool reading; /**< True if the connection is registered for EPOLLIN. */
+        bool writing; /**< True if the connection is registered for EPOLLOUT. */
+    };
+
+    /**
+     * @brief A request waiting for a worker, or a response waiting for the event loop.
+     */
+    struct Job {
+        int fd; /**< Descriptor of the connection. */
+        std::uint64_t connectionId; /**< ID of the connection, to detect a closed and reused descriptor. */
+        std::uint32_t requestId; /**< Request ID echoed in the response. */
+        std::string payload; /**< Request command line, or response frame. */
+    };
+
+    CommandUIPtr commandUI; /**< Shared pointer to the CommandUI executing the commands. */
+    std::string socketPath; /**< Path of the listening socket. */
+    unsigned workersCount; /**< Number of worker threads. */
+
+    int listenFd = -1; /**< Listening socket. */
+    int epollFd = -1; /**< epoll instance of the event loop. */
+    int wakeFd = -1; /**< eventfd signalled when responses are ready or the server stops. */
+    std::atomic<bool> running{false}; /**< True while the server accepts and serves requests. */
+    std::thread loopThread; /**< Event-loop thread. */
+    std::vector<std::thread> workers; /**< Worker threads. */
+
+    std::unordered_map<int, Connection> connections; /**< Open connections by descriptor (event loop only). */
+    std::uint64_t nextConnectionId = 0; /**< ID given to the next accepted connection (event loop only). */
+
+    std::mutex jobsMutex; /**< Guards jobs and stopping. */
+    std::condition_variable jobsReady; /**< Signalled when a job is queued or the workers must stop. */
+    std::deque<Job> jobs; /**< Requests waiting for a worker. */
+    bool stopping = false; /**< True when the workers must exit. */
+
+    std::mutex responsesMutex; /**< Guards responses. */
+    std::vector<Job> responses; /**< Responses waiting for the event loop. */
+
+    std::shared_mutex commandMutex; /**< Shared by read-only commands, exclusive for the others. */
+
+    /**
+     * @brief Runs the event loop until stop() is called.
+     */
+    void loop();
+
+    /**
+     * @brief Runs a worker: executes queued requests and hands the responses to the event loop.
+     */
+    void work();
+
+    /**
+     * @brief Accepts every pending connection.
+     */
+    void accept();
+
+    /**
+     * @brief Reads what is available on a connection while it may be read, and queues its complete frames.
+     *
+     * @param fd Descriptor of the connection.
+     */
+    void receive(int fd);
+
+    /**
+     * @brief Queues the complete frames received on a connection, as far as its limits allow, and updates its epoll events.
+     *
+     * Reading is paused while the connection has maxPendingRequests requests in flight or
+     * maxUnsentOutput bytes unsent, and resumed once it drains.
+     *
+     * @param fd Descriptor of the connection.
+     * @param connection The connection.
+     * @return True if the connection is still open, false if it was closed for an oversized frame.
+     */
+    bool dispatch(int fd, Connection &connection);
+
+    /**
+     * @brief Writes as much pending output as the socket takes, then dispatches what the drained connection may take on.
+     *
+     * @param fd Descriptor of the connection.
+     * @param connection The connection.
+     */
+    void send(int fd, Connection &connection);
+
+    /**
+     * @brief Moves the responses produced by the workers to their connections.
+     */
+    void deliver();
+
+    /**
+     * @brief Closes a connection and forgets its state.
+     *
+     * @param fd Descriptor of the connection.
+     */
+    void close(int fd);
+
+    /**
+     * @brief Wakes the event loop.
+     */
+    void wake() const;
+
+public:
+    /**
+     * @brief Constructs a SocketServer object.
+     *
+     * @param commandUI Shared pointer to the CommandUI executing the commands.
+     * @param socketPath Path of the listening socket; an existing file at the path is replaced.
+     * @param workers Number of worker threads (0 means one per hardware thread).
+     */
+    SocketServer(CommandUIPtr commandUI, std::string socketPath, unsigned workers = 0);
+
+    /**
+     * @brief Stops the server and removes the socket file.
+     */
+    ~SocketServer();
+
+    SocketServer(const SocketServer &) = delete;
+    SocketServer& operator=(const SocketServer &) = delete;
+
+    /**
+     * @brief Starts listening and serving in background threads.
+     *
+     * @return 0 on success, 1 if the server is already running, 2 if the socket cannot be created or bound.
+     */
+    int start();
+
+    /**
+     * @brief Stops serving, closes every connection and joins the threads.
+     *
+     * Requests already handed to the workers are finished, but their responses are dropped.
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether the server is running.
+     *
+     * @return True between a successful start() and stop(), false otherwise.
+     */
+    [[nodiscard]] bool isRunning() const;
+
+    /**
+     * @brief Builds a frame.
+     *
+     * @param requestId The request ID.
+     * @param payload The payload.
+     * @return The header followed by the payload.
+     */
+    static std::string encodeFrame(std::uint32_t requestId, std::string_view payload);
+
+    /**
+     * @brief Decodes the complete frame starting at an offset of a buffer.
+     *
+     * The caller erases the consumed prefix once after decoding every complete frame, so a buffer
+     * holding many small frames is not shifted once per frame.
+     *
+     * @param buffer Received bytes.
+     * @param offset Start of the frame; moved past the frame when one is decoded.
+     * @param requestId Receives the request ID.
+     * @param payload Receives the payload.
+     * @return 1 if a frame was decoded, 0 if the buffer does not hold a whole frame yet, -1 if the frame is longer than maxPayload.
+     */
+    static int decodeFrame(const std::string &buffer, std::size_t &offset, std::uint32_t &requestId, std::string &payload);
+};
+
+
+
+#endif //SOCKETSERVER_H
@@ -2,6 +2,7 @@
 #define CLASSROOMMANAGER_H
 
 #include "repositories/ClassRoomRepository.h"
+#include <future>
 
 
 /**
@@ -16,6 +17,8 @@ class ClassRoomManager {
 private:
     ClassRoomRepositoryPtr classRoomRepo; /**< Shared pointer to the ClassRoomRepository for managing classroom data. */
     ClassRoomFilesStoragePtr classRoomFilesStorage; /**< Shared pointer to the ClassRoomFileStorage for file-based operations. */
+    FlusherPtr flusher; /**< Flusher writing the database file in the background, or nullptr to write it on the calling thread. */
+    TaskPoolPtr taskPool; /**< Pool running background reports, or nullptr to run them on the calling thread. */
 
 public:
     /**
@@ -67,6 +70,41 @@ public:
      */
     [[nodiscard]] bool saveClassRooms() const;
 
+    /**
+     * @brief Saves all classrooms to a file in the background.
+     *
+     * Serializes the classrooms on the calling thread, so the file shows them as they are at the call,
+     * and hands the contents to the flusher, returning at once. Without a flusher the file is
+     * written before the call returns.
+     *
+     * @return Future of the result of the write: true if the file was written, false otherwise.
+     */
+    [[nodiscard]] std::shared_future<bool> saveClassRoomsAsync() const;
+
+    /**
+     * @brief Generates the report of all classrooms in the background.
+     *
+     * Runs report() on the task pool, or at once without one. The manager must stay alive until
+     * the future is ready.
+     *
+     * @return Future of the report.
+     */
+    [[nodiscard]] std::future<std::string> reportAsync() const;
+
+    /**
+     * @brief Sets the pool running background work of the manager.
+     *
+     * @param taskPool Shared pointer to the pool, or nullptr to do all work on the calling thread.
+     */
+    void setTaskPool(TaskPoolPtr taskPool);
+
+    /**
+     * @brief Sets the flusher writing the database file in the background.
+     *
+     * @param flusher Shared pointer to the flusher, or nullptr to write the file on the calling thread.
+     */
+    void setFlusher(FlusherPtr flusher);
+
     /**
      * @brief Loads classrooms from a file into the repository.
      *
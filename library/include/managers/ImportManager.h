@@ -0,0 +1,119 @@
+#ifndef IMPORTMANAGER_H
+#define IMPORTMANAGER_H
+
+#include "typedefs.h"
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Imports persons, classrooms and lessons in bulk from CSV data.
+ *
+ * The ImportManager class reads CSV rows from a stream one line at a time, so the input never has
+ * to fit in memory. Every row is parsed and validated against the repositories and the rows already
+ * accepted in the current batch. Valid rows are collected into batches and inserted through the
+ * repositories' bulk APIs, which reserve capacity once per batch. Invalid rows are skipped and
+ * reported with their line number and reason.
+ *
+ * Input formats, one record per line, fields separated by commas:
+ * - persons: firstName,lastName,id
+ * - classrooms: number,seats,rentCost,type,equipment (type is a registered tag such as IT, MATH or ENG)
+ * - lessons: type,teacherId,classRoomNumber,beginTime,endTime,baseCost,subject,studentIds
+ *   (type is GROUP or INDIVIDUAL, times are "YYYY-MM-DD HH:MM[:SS]", studentIds are separated by ';')
+ *
+ * Blank lines and lines starting with '#' are ignored, and so is a first line equal to the header
+ * of the format (the field names above). Referenced teachers, students and classrooms must already
+ * be stored. A lesson is rejected if its classroom or teacher is taken at that time, by a stored
+ * lesson or by an earlier row of the same import.
+ */
+class ImportManager {
+public:
+    /**
+     * @brief A row that was not imported.
+     */
+    struct Rejection {
+        long line; /**< Line number in the input, from 1. */
+        std::string reason; /**< Why the row was rejected. */
+    };
+
+    /**
+     * @brief Outcome of a single import.
+     */
+    struct Report {
+        long rows; /**< Number of data rows read (blank lines, comments and the header are not counted). */
+        long imported; /**< Number of rows inserted into the repositories. */
+        std::vector<Rejection> rejected; /**< Rejected rows in input order. */
+        double seconds; /**< Wall-clock duration of the import. */
+
+        /**
+         * @brief Gets the import throughput.
+         *
+         * @return The number of rows read per second, or 0 if the duration is zero.
+         */
+        [[nodiscard]] double rowsPerSecond() const;
+    };
+
+private:
+    PersonRepositoryPtr personRepo; /**< Shared pointer to the PersonRepository receiving persons and resolving references. */
+    ClassRoomRepositoryPtr classRoomRepo; /**< Shared pointer to the ClassRoomRepository receiving classrooms and resolving references. */
+    LessonManagerPtr lessonManager; /**< Shared pointer to the LessonManager receiving lessons. */
+    std::size_t batchSize; /**< Number of accepted rows inserted together. */
+
+public:
+    /**
+     * @brief Constructs an ImportManager object.
+     *
+     * @param personRepo Shared pointer to the PersonRepository receiving persons and resolving references.
+     * @param classRoomRepo Shared pointer to the ClassRoomRepository receiving classrooms and resolving references.
+     * @param lessonManager Shared pointer to the LessonManager receiving lessons.
+     * @param batchSize Number of accepted rows inserted together (values below 1 are treated as 1).
+     */
+    ImportManager(PersonRepositoryPtr personRepo, ClassRoomRepositoryPtr classRoomRepo, LessonManagerPtr lessonManager,
+                  std::size_t batchSize = 4096);
+
+    /**
+     * @brief Default destructor.
+     */
+    ~ImportManager() = default;
+
+    /**
+     * @brief Imports persons.
+     *
+     * A row is rejected if a name is empty, the ID is not a number, or a person with the ID is
+     * already stored or appears earlier in the input.
+     *
+     * @param input The CSV input.
+     * @return The report of the import.
+     */
+    Report importPersons(std::istream &input) const;
+
+    /**
+     * @brief Imports classrooms.
+     *
+     * A row is rejected if a number is invalid, the seats are not positive, the rent cost is
+     * negative, the type tag is unknown, or a classroom with the number is already stored or
+     * appears earlier in the input. Imported classrooms are available.
+     *
+     * @param input The CSV input.
+     * @return The report of the import.
+     */
+    Report importClassRooms(std::istream &input) const;
+
+    /**
+     * @brief Imports lessons as planned lessons.
+     *
+     * A row is rejected if a field is invalid, a referenced person or classroom is not stored, an
+     * individual lesson does not have exactly one student, or the classroom or teacher is taken.
+     * Students beyond the classroom's capacity are put on the group lesson's waitlist.
+     *
+     * @param input The CSV input.
+     * @return The report of the import.
+     */
+    Report importLessons(std::istream &input) const;
+};
+
+
+
+#endif //IMPORTMANAGER_H
@@ -3,7 +3,13 @@
 
 #include "typedefs.h"
 #include "model/GroupLesson.h"
+#include "model/LessonSeries.h"
+#include "repositories/Transaction.h"
 #include <boost/date_time.hpp>
+#include <future>
+#include <mutex>
+#include <span>
+#include <unordered_set>
 
 /**
  * @brief Namespace alias for boost::posix_time.
@@ -19,6 +25,13 @@ namespace pt = boost::posix_time;
  * LessonRepository, PersonRepository, ClassRoomRepository, and LessonFilesStorage to
  * perform operations such as creating group or individual lessons, managing student
  * participation in group lessons, and handling file-based storage and archiving.
+ *
+ * Starting and finishing a lesson change the lesson, its teacher and students, its classroom and
+ * the repositories together, so they run as a Transaction: several threads may start and finish
+ * lessons at once, and those sharing no lesson, person or classroom do not wait for each other.
+ * A transaction that loses a conflict is retried with fresh state. Enrolling and removing students
+ * change the lesson's students, so they are transactions too and conflict with starts and finishes
+ * of the lesson. Other operations are not transactional and must not run at the same time as these.
  */
 class LessonManager {
 private:
@@ -26,6 +39,140 @@ private:
     LessonFilesStoragePtr lessonFilesStorage; /**< Shared pointer to the LessonFilesStorage for file-based operations. */
     PersonRepositoryPtr personRepo; /**< Shared pointer to the PersonRepository for managing person data. */
     ClassRoomRepositoryPtr classRoomRepo; /**< Shared pointer to the ClassRoomRepository for managing classroom data. */
+    VersionTablePtr versions; /**< Versions of the persons, classrooms and lessons changed by transactions. */
+    FlusherPtr flusher; /**< Flusher writing the database file in the background, or nullptr to write it on the calling thread. */
+    TaskPoolPtr taskPool; /**< Pool running background reports and archive writes, or nullptr to run them on the calling thread. */
+    std::shared_ptr<std::mutex> archiveMutex; /**< Serializes writes to the archive file by concurrent finishes without a flusher. */
+    std::shared_ptr<std::mutex> finishingMutex; /**< Guards finishing. */
+    std::shared_ptr<std::unordered_set<int>> finishing; /**< IDs of lessons finished by a committed transaction but not yet archived and removed. */
+
+    static constexpr int transactionAttempts = 16; /**< Number of times a conflicting transaction is tried before giving up. */
+
+    /**
+     * @brief Reads the participants and the classroom of a lesson into a transaction.
+     *
+     * @param transaction The transaction.
+     * The students are copied while no commit can change the lesson, so they match the version read.
+     *
+     * @param transaction The transaction.
+     * @param lesson Shared pointer to the lesson, whose version must have been read before it was looked up.
+     * @return The teacher and students of the lesson, followed by the same persons as stored in the person repository
+     *         when those are separate objects.
+     */
+    std::vector<PersonPtr> readParticipants(Transaction &transaction, const LessonPtr &lesson) const;
+
+    /**
+     * @brief Checks whether a lesson has been finished and is only waiting to be archived and removed.
+     *
+     * @param id The ID of the lesson.
+     * @return True if the lesson must no longer be changed, false otherwise.
+     */
+    [[nodiscard]] bool isFinishing(int id) const;
+
+    /**
+     * @brief Links a student who has just been seated in a group lesson to that lesson.
+     *
+     * A student seated in a lesson that has already started takes part in it at once, as in
+     * startLesson(); otherwise the lesson is added to the student's future lessons.
+     *
+     * @param groupLesson Shared pointer to the group lesson.
+     * @param student Shared pointer to the seated student.
+     */
+    void joinGroupLesson(const GroupLessonPtr &groupLesson, const PersonPtr &student) const;
+
+    /**
+     * @brief Books or releases a time interval in a person's weekly occupancy grid.
+     *
+     * The person stored in the person repository under the same ID is updated when there is one,
+     * so grids stay shared with lessons loaded from files.
+     *
+     * @param person Shared pointer to the person (ignored if null).
+     * @param beginTime The start of the interval.
+     * @param endTime The end of the interval (exclusive).
+     * @param occupy True to book the interval, false to release it.
+     */
+    void updateOccupancy(const PersonPtr &person, const pt::ptime &beginTime, const pt::ptime &endTime, bool occupy) const;
+
+    /**
+     * @brief Books or releases a lesson in the weekly occupancy grids of its classroom, teacher and students.
+     *
+     * A lesson expanded from a stored series leaves out whatever the series already books (see
+     * findCoveringSeries()), so the weekly slot is counted once.
+     *
+     * @param lesson Shared pointer to the lesson.
+     * @param beginTime The start of the lesson, as it was booked.
+     * @param endTime The end of the lesson, as it was booked.
+     * @param occupy True to book the lesson, false to release it.
+     */
+    void updateOccupancy(const LessonPtr &lesson, const pt::ptime &beginTime, const pt::ptime &endTime, bool occupy) const;
+
+    /**
+     * @brief Books or releases the part of a lesson not already booked by a series.
+     *
+     * @param lesson Shared pointer to the lesson.
+     * @param heldBy The series booking the classroom, the teacher and its own students, or nullptr to book everything.
+     * @param beginTime The start of the lesson, as it was booked.
+     * @param endTime The end of the lesson, as it was booked.
+     * @param occupy True to book the lesson, false to release it.
+     */
+    void updateOccupancy(const LessonPtr &lesson, const LessonSeriesPtr &heldBy, const pt::ptime &beginTime, const pt::ptime &endTime,
+                         bool occupy) const;
+
+    /**
+     * @brief Books or releases a single participant of a lesson, unless a series already books them.
+     *
+     * @param lesson Shared pointer to the lesson.
+     * @param person Shared pointer to the participant.
+     * @param occupy True to book the participant, false to release them.
+     */
+    void updateOccupancy(const LessonPtr &lesson, const PersonPtr &person, bool occupy) const;
+
+    /**
+     * @brief Finds the stored series a lesson was expanded from.
+     *
+     * Follows the series ID recorded on the lesson by expandDueSeries(); lessons planned on their
+     * own are never covered, whatever slot they take.
+     *
+     * @param lesson Shared pointer to the lesson.
+     * @return Shared pointer to the series, or nullptr if there is none.
+     */
+    [[nodiscard]] LessonSeriesPtr findCoveringSeries(const LessonPtr &lesson) const;
+
+    /**
+     * @brief Removes a series, handing its weekly booking over to the lessons expanded from it.
+     *
+     * @param lessonSeries Shared pointer to the stored series.
+     * @return 0 if the series was removed, non-zero otherwise.
+     */
+    int dropSeries(const LessonSeriesPtr &lessonSeries) const;
+
+    /**
+     * @brief Books or releases the weekly slots of a series in the grids of its classroom, teacher and students.
+     *
+     * A series is booked once for as long as it is stored, since every occurrence falls into the
+     * same weekly slots.
+     *
+     * @param lessonSeries Shared pointer to the series.
+     * @param occupy True to book the series, false to release it.
+     */
+    void updateOccupancy(const LessonSeriesPtr &lessonSeries, bool occupy) const;
+
+    /**
+     * @brief Validates and stores a new lesson series.
+     *
+     * @return Shared pointer to the stored series, or nullptr if any argument is invalid.
+     */
+    LessonSeriesPtr addLessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, int baseCost,
+                                    const std::string &subject, const ClassRoomPtr &classRoom, const std::vector<PersonPtr> &students,
+                                    bool individual, int intervalWeeks, int count) const;
+
+    /**
+     * @brief Archives a lesson and removes it from the repository.
+     *
+     * @param lesson Shared pointer to the stored lesson.
+     * @return 0 on success, non-zero if the repository could not remove the lesson.
+     */
+    int archiveAndRemove(const LessonPtr &lesson) const;
 
 public:
     /**
@@ -102,28 +249,164 @@ public:
      */
     [[nodiscard]] LessonPtr addIndividualLesson(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, int baseCost, const std::string &subject, const ClassRoomPtr &classRoom, const PersonPtr &individualPerson, bool now) const;
 
+    /**
+     * @brief Adds a batch of already created lessons.
+     *
+     * Inserts the lessons through the repository's bulk API and books them in the weekly occupancy
+     * grids. Planned lessons are added to the future lessons of their students, as with
+     * addGroupLesson() and addIndividualLesson(). The lessons are not checked for conflicts.
+     *
+     * @param lessons The lessons to add (null entries are skipped).
+     * @param now Indicates whether the lessons start immediately (true) or are scheduled for the future (false).
+     * @return The number of lessons added.
+     */
+    int addLessons(const std::vector<LessonPtr> &lessons, bool now) const;
+
+    /**
+     * @brief Adds a recurring group lesson.
+     *
+     * Stores the series once instead of one lesson per occurrence. Occurrences become group lessons
+     * with the given students only when they are due (see expandDueSeries()).
+     *
+     * @param teacher Shared pointer to the teacher conducting the lessons.
+     * @param beginTime The start time of the first lesson.
+     * @param endTime The end time of the first lesson (must be after beginTime).
+     * @param baseCost The base cost per hour for every lesson.
+     * @param subject The subject of the lessons.
+     * @param classRoom Shared pointer to the classroom where the lessons take place.
+     * @param students The students of every lesson (null entries are ignored).
+     * @param intervalWeeks The number of weeks between two lessons (must be positive).
+     * @param count The number of lessons (must be positive).
+     * @return Shared pointer to the new series, or nullptr if any argument is invalid.
+     */
+    [[nodiscard]] LessonSeriesPtr addGroupLessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, int baseCost,
+                                                       const std::string &subject, const ClassRoomPtr &classRoom,
+                                                       const std::vector<PersonPtr> &students, int intervalWeeks, int count) const;
+
+    /**
+     * @brief Adds a recurring individual lesson.
+     *
+     * Stores the series once instead of one lesson per occurrence. Occurrences become individual
+     * lessons only when they are due (see expandDueSeries()).
+     *
+     * @param teacher Shared pointer to the teacher conducting the lessons.
+     * @param beginTime The start time of the first lesson.
+     * @param endTime The end time of the first lesson (must be after beginTime).
+     * @param baseCost The base cost per hour for every lesson.
+     * @param subject The subject of the lessons.
+     * @param classRoom Shared pointer to the classroom where the lessons take place.
+     * @param individualPerson Shared pointer to the student attending the lessons.
+     * @param intervalWeeks The number of weeks between two lessons (must be positive).
+     * @param count The number of lessons (must be positive).
+     * @return Shared pointer to the new series, or nullptr if any argument is invalid.
+     */
+    [[nodiscard]] LessonSeriesPtr addIndividualLessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime,
+                                                            int baseCost, const std::string &subject, const ClassRoomPtr &classRoom,
+                                                            const PersonPtr &individualPerson, int intervalWeeks, int count) const;
+
+    /**
+     * @brief Removes a lesson series by its ID.
+     *
+     * Pending occurrences are dropped; lessons already created from the series stay.
+     *
+     * @param id The unique ID of the series.
+     * @return 0 on success, 1 if the series is not found.
+     */
+    [[nodiscard]] int removeLessonSeries(const int &id) const;
+
+    /**
+     * @brief Cancels a single pending occurrence of a series.
+     *
+     * @param id The unique ID of the series.
+     * @param index The index of the occurrence, from 0.
+     * @return 0 on success, 1 if the series is not found, 2 if the index is out of range, 3 if the occurrence
+     * is already cancelled or has become a lesson.
+     */
+    [[nodiscard]] int skipSeriesOccurrence(const int &id, int index) const;
+
+    /**
+     * @brief Turns the due occurrences of all series into lessons.
+     *
+     * Every pending occurrence starting no later than the given time becomes a planned lesson, as if
+     * added with addGroupLesson() or addIndividualLesson(). A series whose occurrences have all been
+     * handed out is removed. Meant to be run by the scheduler before findLessonsToStart().
+     *
+     * @param until The latest start time to expand.
+     * @return The created lessons.
+     */
+    std::vector<LessonPtr> expandDueSeries(const pt::ptime &until);
+
+    /**
+     * @brief Finds the pending series occurrences overlapping a time window.
+     *
+     * Nothing is expanded; the occurrences are computed from the series rules.
+     *
+     * @param beginTime The start of the window.
+     * @param endTime The end of the window (exclusive).
+     * @return The occurrences of all series, series by series and in order of time within a series.
+     */
+    [[nodiscard]] std::vector<LessonSeries::Occurrence> findSeriesOccurrences(const pt::ptime &beginTime, const pt::ptime &endTime) const;
+
     /**
      * @brief Adds a student to a group lesson.
      *
-     * Adds the specified person to the group lesson identified by the given ID.
+     * Adds the specified person to the group lesson identified by the given ID. If the lesson's
+     * classroom is full, the person is put on the lesson's waitlist instead. A person seated in a
+     * lesson that has already started takes part in it at once.
      *
      * @param id The unique ID of the group lesson.
      * @param person Shared pointer to the person to add as a student.
-     * @return 0 on success, 3 if the lesson is not found, 4 if the person is null, non-zero if adding the student fails.
+     * @return 0 on success, 3 if the lesson is not found, 4 if the person is null, 6 if the person was put on the waitlist,
+     * 7 if concurrent changes kept conflicting, non-zero if adding the student fails.
      */
     [[nodiscard]] int addStudentToGroupLesson(const int &id, const PersonPtr& person) const;
 
+    /**
+     * @brief Enrolls a batch of students in a group lesson.
+     *
+     * Resolves the lesson once, validates every person in a single pass and hands the valid ones to
+     * GroupLesson::addStudents() in one batch. Enrolled students get the lesson added to their future
+     * lessons, or join it at once if it has already started. Persons are processed in order, so when the classroom fills up the later ones are put
+     * on the lesson's waitlist.
+     *
+     * @param id The unique ID of the group lesson.
+     * @param personIds The IDs of the persons to enroll.
+     * @return One result per requested ID, in the same order: 0 on success, 2 if the person is already
+     * enrolled or waitlisted (or listed twice) or teaches the lesson, 3 if the group lesson is not found, 4 if
+     * the person is not found, 6 if no seat is left and the person was put on the waitlist, 7 for every person if
+     * concurrent changes kept conflicting.
+     */
+    [[nodiscard]] std::vector<int> enrollStudents(const int &id, std::span<const int> personIds) const;
+
     /**
      * @brief Removes a student from a group lesson.
      *
-     * Removes the specified person from the group lesson identified by the given ID.
+     * Removes the specified person from the group lesson identified by the given ID (or from its
+     * waitlist) and drops the lesson from the person's future lessons. A freed seat goes to the first
+     * waitlisted student, who joins the lesson as if enrolled directly (see joinGroupLesson()).
      *
      * @param id The unique ID of the group lesson.
      * @param person Shared pointer to the person to remove.
-     * @return 0 on success, 3 if the lesson is not found, 4 if the person is null, 5 if the person is not in the lesson, non-zero if removing the student fails.
+     * @return 0 on success, 3 if the group lesson is not found, 4 if the person is null, 5 if the person is neither enrolled in the lesson nor waitlisted, 7 if concurrent changes kept conflicting, non-zero if removing the student fails.
      */
     [[nodiscard]] int removeStudentFromGroupLesson(const int &id, const PersonPtr &person) const;
 
+    /**
+     * @brief Removes a batch of students from a group lesson.
+     *
+     * Resolves the lesson once and hands the enrolled or waitlisted persons to
+     * GroupLesson::removeStudents() in one batch. They lose the lesson from their future lessons;
+     * the waitlisted students given the freed seats join it (see joinGroupLesson()) and are booked in
+     * the occupancy grids.
+     *
+     * @param id The unique ID of the group lesson.
+     * @param personIds The IDs of the persons to remove.
+     * @return One result per requested ID, in the same order: 0 on success, 3 if the group lesson is not found,
+     * 4 if the person is not found, 5 if the person is neither enrolled nor waitlisted (or listed twice), 7 for every person
+     * if concurrent changes kept conflicting.
+     */
+    [[nodiscard]] std::vector<int> removeStudentsFromGroupLesson(const int &id, std::span<const int> personIds) const;
+
     /**
      * @brief Retrieves a lesson by its ID.
      *
@@ -141,20 +424,42 @@ public:
      */
     [[nodiscard]] std::string report() const;
 
+    /**
+     * @brief Starts a lesson and marks its classroom, teacher and students as busy.
+     *
+     * Runs as a transaction, retried if a concurrent start or finish changes the same entities.
+     *
+     * @param id The unique ID of the lesson to start.
+     * @return True if the lesson was started, false if it is not found or keeps conflicting.
+     */
     [[nodiscard]] bool startLesson(const int &id) const;
 
     /**
      * @brief Finishes a lesson and updates related entities.
      *
-     * Marks the lesson as finished, updates the classroom availability, clears lesson IDs for
-     * associated persons, and removes the lesson from the repository. Logs errors if the lesson
-     * or classroom is not found.
+     * Marks the lesson as finished, updates the classroom availability, clears lesson IDs of its
+     * teacher and students, and removes the lesson from the repository. Logs errors if the lesson
+     * or classroom is not found. Runs as a transaction, like startLesson().
      *
      * @param id The unique ID of the lesson to finish.
-     * @return True if the lesson is successfully finished and removed, false if the lesson is not found.
+     * @return True if the lesson is successfully finished and removed, false if the lesson is not found or keeps conflicting.
      */
     [[nodiscard]] bool finishLesson(const int &id) const;
 
+    /**
+     * @brief Begins a transaction over the persons, classrooms and lessons managed here.
+     *
+     * @return A new open transaction.
+     */
+    [[nodiscard]] Transaction beginTransaction() const;
+
+    /**
+     * @brief Gets the number of transactions rejected because of a conflict.
+     *
+     * @return The number of conflicts since the manager was created.
+     */
+    [[nodiscard]] long getTransactionConflicts() const;
+
     /**
      * @brief Finds lessons that satisfy a given predicate.
      *
@@ -172,12 +477,74 @@ public:
      */
     [[nodiscard]] std::vector<LessonPtr> findAllLessons() const;
 
+    /**
+     * @brief Finds lessons whose start time has passed but which have not started yet.
+     *
+     * Uses the repository's compact schedule rather than the Lesson objects. Occurrences of lesson
+     * series are only found once expandDueSeries() has turned them into lessons.
+     *
+     * @param now The current time.
+     * @return A vector with the IDs of the lessons to start.
+     */
+    [[nodiscard]] std::vector<int> findLessonsToStart(const pt::ptime &now) const;
+
+    /**
+     * @brief Finds started lessons whose end time has passed.
+     *
+     * Uses the repository's compact schedule rather than the Lesson objects.
+     *
+     * @param now The current time.
+     * @return A vector with the IDs of the lessons to finish.
+     */
+    [[nodiscard]] std::vector<int> findLessonsToFinish(const pt::ptime &now) const;
+
+    /**
+     * @brief Finds classrooms that are free for a whole time window.
+     *
+     * Answered from the lesson repository's classroom occupancy index, so no lessons are scanned.
+     *
+     * @param beginTime The start of the window.
+     * @param endTime The end of the window (exclusive, must be after beginTime).
+     * @param minSeats The minimal number of seats.
+     * @param type The classroom type tag (e.g. "IT"), or an empty string for any type.
+     * @return A vector of shared pointers to the matching classrooms, empty if the window is invalid.
+     */
+    [[nodiscard]] std::vector<ClassRoomPtr> findFreeClassRooms(const pt::ptime &beginTime, const pt::ptime &endTime, int minSeats, const std::string &type) const;
+
+    /**
+     * @brief Finds persons who teach no lesson in a time window.
+     *
+     * Answered from the lesson repository's teacher occupancy index, so no lessons are scanned.
+     *
+     * @param beginTime The start of the window.
+     * @param endTime The end of the window (exclusive, must be after beginTime).
+     * @return A vector of shared pointers to the free persons, empty if the window is invalid.
+     */
+    [[nodiscard]] std::vector<PersonPtr> findFreeTeachers(const pt::ptime &beginTime, const pt::ptime &endTime) const;
+
+    /**
+     * @brief Finds the first weekly time at which a classroom, a teacher and a group of students are all free.
+     *
+     * Combines the weekly occupancy grids of all participants word by word and searches the result
+     * for a long enough run of free slots, starting at the first slot boundary not before the given
+     * time and wrapping around the end of the week. Unknown classroom, teacher or student IDs are ignored.
+     *
+     * @param classRoomNumber The number of the classroom.
+     * @param teacherId The ID of the teacher.
+     * @param studentIds The IDs of the students.
+     * @param duration The length of the lesson (must be positive and at most a week).
+     * @param from The time from which to search.
+     * @return The earliest slot-aligned start time not before from, or not_a_date_time if there is no common free slot.
+     */
+    [[nodiscard]] pt::ptime findCommonFreeSlot(int classRoomNumber, int teacherId, const std::vector<int> &studentIds,
+                                               const pt::time_duration &duration, const pt::ptime &from) const;
+
     /**
      * @brief Retrieves all started lessons in the repository.
      *
      * Queries the LessonRepository to obtain a list of all lessons that have been marked as started.
      *
-     * @return A vector of shared pointers to Lesson objects that are currently started.
+     * @return The shared pointers to Lesson objects that are currently started.
      */
     [[nodiscard]] std::vector<LessonPtr> findStartedLessons() const;
 
@@ -186,7 +553,7 @@ public:
      *
      * Queries the LessonRepository to obtain a list of all lessons that are scheduled but not yet started.
      *
-     * @return A vector of shared pointers to Lesson objects that are planned.
+     * @return The shared pointers to Lesson objects that are planned.
      */
     [[nodiscard]] std::vector<LessonPtr> findPlannedLessons() const;
 
@@ -199,6 +566,43 @@ public:
      */
     [[nodiscard]] bool save() const;
 
+    /**
+     * @brief Saves all lessons to a file in the background.
+     *
+     * Serializes the lessons on the calling thread, so the file shows them as they are at the call,
+     * and hands the contents to the flusher, returning at once. Without a flusher the file is
+     * written before the call returns.
+     *
+     * @return Future of the result of the write: true if the file was written, false otherwise.
+     */
+    [[nodiscard]] std::shared_future<bool> saveAsync() const;
+
+    /**
+     * @brief Generates the report of all lessons in the background.
+     *
+     * Runs report() on the task pool, or at once without one. The manager must stay alive until
+     * the future is ready.
+     *
+     * @return Future of the report.
+     */
+    [[nodiscard]] std::future<std::string> reportAsync() const;
+
+    /**
+     * @brief Sets the pool running background work of the manager.
+     *
+     * Archive writes of finished and removed lessons are then queued on the pool too.
+     *
+     * @param taskPool Shared pointer to the pool, or nullptr to do all work on the calling thread.
+     */
+    void setTaskPool(TaskPoolPtr taskPool);
+
+    /**
+     * @brief Sets the flusher writing the database file in the background.
+     *
+     * @param flusher Shared pointer to the flusher, or nullptr to write the file on the calling thread.
+     */
+    void setFlusher(FlusherPtr flusher);
+
     /**
      * @brief Loads lessons from a file into the repository.
      *
@@ -211,8 +615,10 @@ public:
     /**
      * @brief Archives a lesson by its ID.
      *
-     * Delegates to the LessonFilesStorage to save the specified lesson to the archive file.
-     * Logs an error message to the console if the operation fails.
+     * Delegates to the LessonFilesStorage to save the specified lesson to the archive file, one
+     * caller at a time; does nothing without a storage. With a flusher the lesson is looked up at
+     * once and appended in the background. Logs an error message to the console if the
+     * operation fails.
      *
      * @param personalId The unique ID of the lesson to archive.
      */
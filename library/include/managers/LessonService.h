@@ -0,0 +1,111 @@
+#ifndef LESSONSERVICE_H
+#define LESSONSERVICE_H
+
+#include "typedefs.h"
+#include "concurrency/Task.h"
+#include <boost/date_time.hpp>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pt = boost::posix_time;
+
+
+/**
+ * @brief Coroutine front of the lesson operations, for serving many requests at once.
+ *
+ * Every operation is a Task that runs the LessonManager operation and then suspends until its
+ * effect is on disk: the snapshot of the lessons is handed to the Flusher and the coroutine waits
+ * for that write, and a finished lesson also waits for its archive entry. No thread blocks while
+ * a write is in flight, and the requests waiting at once share the writes coalesced by the
+ * Flusher. Without a Flusher the lessons are saved synchronously.
+ *
+ * The model objects are not safe to change from several threads at once, so the synchronous part
+ * of every operation runs under one mutex of the service. The mutex is never held while a
+ * coroutine is suspended, so it only orders the short in-memory steps of concurrent requests.
+ *
+ * The service must outlive the Tasks it returns, and the arguments are taken by value, since a
+ * Task runs after the call that created it has returned.
+ */
+class LessonService {
+private:
+    LessonManagerPtr lessonManager; /**< Shared pointer to the LessonManager running the operations. */
+    FlusherPtr flusher; /**< Shared pointer to the Flusher writing the lessons and the archive, or nullptr. */
+    FileIOPtr fileIO; /**< Shared pointer to the FileIO reading the archive, or nullptr. */
+    mutable std::mutex mutex; /**< Serializes the model operations and the serialization of the lessons; never held across a suspension. */
+
+    /**
+     * @brief Saves the lessons and waits until they are written.
+     *
+     * @return Task returning true if the lessons were saved.
+     */
+    [[nodiscard]] Task<bool> persist() const;
+
+public:
+    /**
+     * @brief Constructs a LessonService.
+     *
+     * @param lessonManager Shared pointer to the LessonManager; must not be null.
+     * @param flusher Shared pointer to the Flusher of the LessonManager, or nullptr to save synchronously.
+     * @param fileIO Shared pointer to the FileIO reading the archive, or nullptr to read it synchronously.
+     */
+    LessonService(LessonManagerPtr lessonManager, FlusherPtr flusher, FileIOPtr fileIO);
+
+    /**
+     * @brief Plans a group lesson, as LessonManager::addGroupLesson() does, and saves the lessons.
+     *
+     * @param teacher Shared pointer to the teacher.
+     * @param beginTime Start time of the lesson.
+     * @param endTime End time of the lesson.
+     * @param baseCost Base cost of the lesson.
+     * @param subject Subject of the lesson.
+     * @param classRoom Shared pointer to the classroom.
+     * @return Task returning the planned lesson, or nullptr if it could not be planned.
+     */
+    [[nodiscard]] Task<LessonPtr> plan(PersonPtr teacher, pt::ptime beginTime, pt::ptime endTime, int baseCost, std::string subject,
+                                       ClassRoomPtr classRoom) const;
+
+    /**
+     * @brief Enrolls students in a group lesson, as LessonManager::enrollStudents() does, and saves the lessons.
+     *
+     * @param id The unique ID of the group lesson.
+     * @param personIds The IDs of the persons to enroll.
+     * @return Task returning one result per requested ID, as LessonManager::enrollStudents() does.
+     */
+    [[nodiscard]] Task<std::vector<int>> enroll(int id, std::vector<int> personIds) const;
+
+    /**
+     * @brief Starts a lesson, as LessonManager::startLesson() does, and saves the lessons.
+     *
+     * @param id The unique ID of the lesson.
+     * @return Task returning true if the lesson was started and saved.
+     */
+    [[nodiscard]] Task<bool> start(int id) const;
+
+    /**
+     * @brief Finishes a lesson, as LessonManager::finishLesson() does, and waits for its archive entry and the saved lessons.
+     *
+     * @param id The unique ID of the lesson.
+     * @return Task returning true if the lesson was finished, archived and saved.
+     */
+    [[nodiscard]] Task<bool> finish(int id) const;
+
+    /**
+     * @brief Builds the report of the lessons, as LessonManager::report() does.
+     *
+     * @return Task returning the report.
+     */
+    [[nodiscard]] Task<std::string> report() const;
+
+    /**
+     * @brief Reads the lesson archive.
+     *
+     * @return Task returning the contents of the archive file.
+     * @throws std::runtime_error if the archive file cannot be read.
+     */
+    [[nodiscard]] Task<std::string> archive() const;
+};
+
+
+
+#endif //LESSONSERVICE_H
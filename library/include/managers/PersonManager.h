@@ -2,6 +2,7 @@
 #define PERSONMANAGER_H
 
 #include "repositories/PersonRepository.h"
+#include <future>
 
 
 /**
@@ -16,6 +17,8 @@ class PersonManager {
 private:
     PersonRepositoryPtr personRepo; /**< Shared pointer to the PersonRepository for managing person data. */
     PersonFilesStoragePtr personFilesStorage; /**< Shared pointer to the PersonFilesStorage for file-based operations. */
+    FlusherPtr flusher; /**< Flusher writing the database file in the background, or nullptr to write it on the calling thread. */
+    TaskPoolPtr taskPool; /**< Pool running background reports, or nullptr to run them on the calling thread. */
 
 public:
     /**
@@ -86,6 +89,41 @@ public:
      */
     [[nodiscard]] bool savePersons() const;
 
+    /**
+     * @brief Saves all persons to a file in the background.
+     *
+     * Serializes the persons on the calling thread, so the file shows them as they are at the call,
+     * and hands the contents to the flusher, returning at once. Without a flusher the file is
+     * written before the call returns.
+     *
+     * @return Future of the result of the write: true if the file was written, false otherwise.
+     */
+    [[nodiscard]] std::shared_future<bool> savePersonsAsync() const;
+
+    /**
+     * @brief Generates the report of all persons in the background.
+     *
+     * Runs report() on the task pool, or at once without one. The manager must stay alive until
+     * the future is ready.
+     *
+     * @return Future of the report.
+     */
+    [[nodiscard]] std::future<std::string> reportAsync() const;
+
+    /**
+     * @brief Sets the pool running background work of the manager.
+     *
+     * @param taskPool Shared pointer to the pool, or nullptr to do all work on the calling thread.
+     */
+    void setTaskPool(TaskPoolPtr taskPool);
+
+    /**
+     * @brief Sets the flusher writing the database file in the background.
+     *
+     * @param flusher Shared pointer to the flusher, or nullptr to write the file on the calling thread.
+     */
+    void setFlusher(FlusherPtr flusher);
+
     /**
      * @brief Loads persons from a file into the repository.
      *
@@ -0,0 +1,74 @@
+#ifndef ROOMASSIGNMENTMANAGER_H
+#define ROOMASSIGNMENTMANAGER_H
+
+#include "typedefs.h"
+#include <string>
+#include <vector>
+#include <boost/date_time.hpp>
+
+namespace pt = boost::posix_time;
+
+
+/**
+ * @brief Assigns classrooms to batches of not yet scheduled lessons.
+ *
+ * The RoomAssignmentManager class picks a classroom for every requested lesson so that no classroom
+ * hosts two overlapping lessons, no stored lesson is disturbed and the total cost is as low as
+ * possible. The cost of placing a lesson in a classroom is the classroom's actual rent cost, plus a
+ * weight for every empty seat, plus a penalty if the classroom is not of the preferred type.
+ *
+ * Requests are swept in order of start time, like a greedy interval-graph coloring in which the
+ * classrooms are the colors. Classrooms are released again as lessons end. All requests starting at
+ * the same time are then matched to the free classrooms at once with the Hungarian algorithm, which
+ * gives the cheapest assignment for that batch instead of a first-fit one.
+ */
+class RoomAssignmentManager {
+public:
+    /**
+     * @brief A lesson that needs a classroom.
+     */
+    struct Request {
+        pt::ptime beginTime; /**< Start time of the lesson. */
+        pt::ptime endTime; /**< End time of the lesson (exclusive). */
+        int headcount; /**< Number of seats needed. */
+        std::string type; /**< Preferred classroom type tag (e.g. "IT"), or an empty string for any type. */
+    };
+
+private:
+    ClassRoomRepositoryPtr classRoomRepo; /**< Shared pointer to the ClassRoomRepository providing the classrooms. */
+    LessonRepositoryPtr lessonRepo; /**< Shared pointer to the LessonRepository with the lessons already booked. */
+    double wastedSeatCost; /**< Cost of every seat left empty by an assignment. */
+    double typeMismatchCost; /**< Cost of assigning a classroom of a type other than the preferred one. */
+
+public:
+    /**
+     * @brief Constructs a RoomAssignmentManager object.
+     *
+     * @param classRoomRepo Shared pointer to the ClassRoomRepository providing the classrooms.
+     * @param lessonRepo Shared pointer to the LessonRepository with the lessons already booked.
+     * @param wastedSeatCost Cost of every seat left empty by an assignment (must be non-negative).
+     * @param typeMismatchCost Cost of assigning a classroom of a type other than the preferred one (must be non-negative).
+     */
+    RoomAssignmentManager(ClassRoomRepositoryPtr classRoomRepo, LessonRepositoryPtr lessonRepo, double wastedSeatCost = 1.0,
+                          double typeMismatchCost = 1000.0);
+
+    /**
+     * @brief Default destructor.
+     */
+    ~RoomAssignmentManager() = default;
+
+    /**
+     * @brief Assigns classrooms to a batch of lessons.
+     *
+     * A lesson gets no classroom if its time window is invalid, or if no free classroom with enough
+     * seats is left for it. The stored lessons and classrooms are not modified.
+     *
+     * @param requests The lessons to place.
+     * @return One classroom per request, in the same order, or nullptr where no classroom could be assigned.
+     */
+    [[nodiscard]] std::vector<ClassRoomPtr> assignRooms(const std::vector<Request> &requests) const;
+};
+
+
+
+#endif //ROOMASSIGNMENTMANAGER_H
@@ -0,0 +1,135 @@
+#ifndef TIMETABLEMANAGER_H
+#define TIMETABLEMANAGER_H
+
+#include "typedefs.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <boost/date_time.hpp>
+
+namespace pt = boost::posix_time;
+
+
+/**
+ * @brief Generates a weekly timetable for a set of courses.
+ *
+ * The TimetableManager class places every lesson of the given courses at a time of the week and in
+ * a classroom so that no teacher, student or classroom is booked twice at once. Bookings already
+ * stored in the weekly occupancy grids of persons and classrooms count as taken. Among conflict-free
+ * timetables it prefers ones with fewer empty seats, classrooms of the preferred type and at most one
+ * lesson of a course per day.
+ *
+ * The week is cut into cells of a fixed length within the working hours. The search is simulated
+ * annealing over the cell and the classroom of every lesson. Moving a lesson only re-counts the cells
+ * of that lesson for its teacher, students and classroom, so a move costs as much as the lesson is
+ * long, not as much as the timetable is large. Several annealing chains with different seeds run on
+ * separate threads and the best timetable found by any of them wins.
+ */
+class TimetableManager {
+public:
+    /**
+     * @brief A course whose lessons have to be placed in the week.
+     */
+    struct Course {
+        std::string subject; /**< Subject of the lessons. */
+        int teacherId; /**< ID of the teacher giving the lessons. */
+        std::vector<int> studentIds; /**< IDs of the students attending; exactly one gives individual lessons. */
+        int lessonsPerWeek; /**< Number of lessons of the course in the week. */
+        int durationMinutes; /**< Length of a single lesson in minutes. */
+        int baseCost; /**< Base cost of a single lesson. */
+        std::string type; /**< Preferred classroom type tag (e.g. "IT"), or an empty string for any type. */
+    };
+
+    /**
+     * @brief State of the search reported to the progress callback.
+     */
+    struct Progress {
+        int thread; /**< Index of the reporting chain. */
+        long iteration; /**< Iterations done by the reporting chain. */
+        double cost; /**< Cost of the chain's current timetable. */
+        double bestCost; /**< Cost of the best timetable found by any chain so far. */
+        int bestConflicts; /**< Number of doubly booked cells in the best timetable. */
+        double seconds; /**< Time since the search started. */
+    };
+
+    /**
+     * @brief Parameters of a single generate() call.
+     */
+    struct Options {
+        pt::ptime weekStart; /**< Any time in the week to fill; lessons are placed from its Monday on. */
+        int days = 5; /**< Number of days used, from Monday on (1 to 7). */
+        int dayStartHour = 8; /**< Hour the working day starts at. */
+        int dayEndHour = 18; /**< Hour the working day ends at. */
+        int stepMinutes = 30; /**< Length of a cell; lessons start at cell boundaries (a positive multiple of 5). */
+        int threads = 0; /**< Number of annealing chains, or 0 for one per hardware thread. */
+        long iterations = 200000; /**< Number of moves tried by every chain. */
+        unsigned seed = 1; /**< Seed of the first chain; chain i uses seed + i. */
+        long progressInterval = 10000; /**< Number of iterations between progress reports of a chain. */
+        std::function<void(const Progress&)> onProgress; /**< Called with the state of the search; may be empty. */
+    };
+
+    /**
+     * @brief Best score of the search at a point in time.
+     */
+    struct Sample {
+        double seconds; /**< Time since the search started. */
+        double cost; /**< Cost of the best timetable at that time. */
+    };
+
+    /**
+     * @brief Outcome of a generate() call.
+     */
+    struct Result {
+        std::vector<LessonPtr> lessons; /**< The placed lessons, course by course. */
+        double cost; /**< Total cost of the timetable. */
+        int conflicts; /**< Number of doubly booked cells left; 0 for a conflict-free timetable. */
+        int skipped; /**< Number of lessons that could not be placed at all (unknown teacher, too long, no classroom). */
+        std::vector<Sample> bestOverTime; /**< Best cost after every improvement, in order of time. */
+    };
+
+private:
+    PersonRepositoryPtr personRepo; /**< Shared pointer to the PersonRepository providing teachers and students. */
+    ClassRoomRepositoryPtr classRoomRepo; /**< Shared pointer to the ClassRoomRepository providing the classrooms. */
+    double wastedSeatCost; /**< Cost of every seat left empty by a lesson. */
+    double typeMismatchCost; /**< Cost of a lesson in a classroom of a type other than the preferred one. */
+    double sameDayCost; /**< Cost of every extra lesson of a course on the same day. */
+    double conflictCost; /**< Cost of every cell in which a teacher, student or classroom is booked twice. */
+
+public:
+    /**
+     * @brief Constructs a TimetableManager object.
+     *
+     * @param personRepo Shared pointer to the PersonRepository providing teachers and students.
+     * @param classRoomRepo Shared pointer to the ClassRoomRepository providing the classrooms.
+     * @param wastedSeatCost Cost of every seat left empty by a lesson (must be non-negative).
+     * @param typeMismatchCost Cost of a lesson in a classroom of a type other than the preferred one (must be non-negative).
+     * @param sameDayCost Cost of every extra lesson of a course on the same day (must be non-negative).
+     * @param conflictCost Cost of every cell in which a teacher, student or classroom is booked twice (must be positive).
+     */
+    TimetableManager(PersonRepositoryPtr personRepo, ClassRoomRepositoryPtr classRoomRepo, double wastedSeatCost = 1.0,
+                     double typeMismatchCost = 50.0, double sameDayCost = 20.0, double conflictCost = 1000.0);
+
+    /**
+     * @brief Default destructor.
+     */
+    ~TimetableManager() = default;
+
+    /**
+     * @brief Generates a timetable for a set of courses.
+     *
+     * The returned lessons are not added to any repository and the occupancy grids are not modified.
+     * A course with one student gives individual lessons, any other course gives group lessons.
+     * If no classroom has enough seats for a course, it is placed in any classroom and the extra
+     * students of its group lessons end up on the waitlist.
+     *
+     * @param courses The courses to place.
+     * @param options Parameters of the search.
+     * @return The placed lessons with the cost and history of the search, or an empty result if the options are invalid.
+     */
+    [[nodiscard]] Result generate(const std::vector<Course> &courses, const Options &options) const;
+};
+
+
+
+#endif //TIMETABLEMANAGER_H
@@ -2,6 +2,7 @@
 #define CLASSROOM_H
 
 #include "typedefs.h"
+#include "model/WeeklyOccupancy.h"
 #include <string>
 
 
@@ -19,6 +20,7 @@ private:
     int seatsNumber;       /**< Number of seats available in the classroom. */
     double rentCost;       /**< Base rent cost for the classroom. */
     ClassRoomTypePtr classRoomType; /**< Pointer to the classroom type, defining additional attributes or behavior. */
+    WeeklyOccupancy occupancy; /**< Weekly timetable of the lessons held in the classroom. */
 
 public:
     /**
@@ -77,6 +79,22 @@ public:
      */
     [[nodiscard]] ClassRoomTypePtr getClassRoomType() const;
 
+    /**
+     * @brief Gets the weekly occupancy grid of the classroom.
+     *
+     * The grid is maintained by LessonManager as lessons are added, removed and finished.
+     *
+     * @return A const reference to the occupancy grid.
+     */
+    [[nodiscard]] const WeeklyOccupancy& getOccupancy() const;
+
+    /**
+     * @brief Gets the weekly occupancy grid of the classroom for modification.
+     *
+     * @return A reference to the occupancy grid.
+     */
+    [[nodiscard]] WeeklyOccupancy& getOccupancy();
+
     /**
      * @brief Sets the classroom's unique identifier.
      *
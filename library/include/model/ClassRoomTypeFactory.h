@@ -0,0 +1,88 @@
+#ifndef CLASSROOMTYPEFACTORY_H
+#define CLASSROOMTYPEFACTORY_H
+
+#include "typedefs.h"
+#include <map>
+#include <mutex>
+#include <string_view>
+
+
+/**
+ * @brief Flyweight factory for ClassRoomType instances.
+ *
+ * ClassRoomType objects are immutable and only a handful of distinct (type, equipment)
+ * combinations exist, so the factory canonicalizes them: every request for the same
+ * combination returns the same shared instance instead of allocating a new one. Storages
+ * and interfaces obtain classroom types through this class rather than constructing them.
+ *
+ * Type tags ("IT", "MATH", "ENG") are dispatched through a registration table fixed at
+ * compile time and indexed by a perfect hash of the tag, so parsers resolve a tag with a
+ * single table lookup instead of a chain of string comparisons. A new classroom type only
+ * needs its own registration entry.
+ *
+ * The canonical instances are created on first request under a mutex, so storages, importers
+ * and request workers can resolve types from several threads at once.
+ */
+class ClassRoomTypeFactory {
+public:
+    /**
+     * @brief Gets the shared IT classroom type with the given number of computers.
+     *
+     * @param computerCount The number of computers in the classroom.
+     * @return Shared pointer to the canonical ITClassRoom instance.
+     */
+    static ClassRoomTypePtr getITClassRoom(int computerCount);
+
+    /**
+     * @brief Gets the shared math classroom type.
+     *
+     * @param formulasTables Specifies whether the classroom has formulas tables.
+     * @return Shared pointer to the canonical MathClassRoom instance.
+     */
+    static ClassRoomTypePtr getMathClassRoom(bool formulasTables);
+
+    /**
+     * @brief Gets the shared English classroom type.
+     *
+     * @param headphones Specifies whether the classroom has headphones.
+     * @return Shared pointer to the canonical EngClassRoom instance.
+     */
+    static ClassRoomTypePtr getEngClassRoom(bool headphones);
+
+    /**
+     * @brief Gets the shared classroom type for a serialized type tag and equipment value.
+     *
+     * The equipment value is interpreted by the registered type: the number of computers for
+     * "IT", and a 0/1 flag for "MATH" and "ENG".
+     *
+     * @param type The type tag, as returned by ClassRoomType::getType().
+     * @param equipment The type-specific equipment value.
+     * @return Shared pointer to the canonical instance, or nullptr if the tag is not registered.
+     */
+    static ClassRoomTypePtr create(std::string_view type, int equipment);
+
+    /**
+     * @brief Checks whether a type tag is registered.
+     *
+     * @param type The type tag to check.
+     * @return True if create() accepts the tag, false otherwise.
+     */
+    [[nodiscard]] static bool isRegistered(std::string_view type);
+
+    /**
+     * @brief Gets the number of distinct classroom type instances created so far.
+     *
+     * @return The number of canonical instances held by the factory.
+     */
+    [[nodiscard]] static int size();
+
+private:
+    static std::map<int, ClassRoomTypePtr> itClassRooms; /**< Canonical IT classroom types keyed by computer count. */
+    static ClassRoomTypePtr mathClassRooms[2]; /**< Canonical math classroom types indexed by the formulas tables flag. */
+    static ClassRoomTypePtr engClassRooms[2]; /**< Canonical English classroom types indexed by the headphones flag. */
+    static std::mutex mutex; /**< Guards itClassRooms, mathClassRooms and engClassRooms. */
+};
+
+
+
+#endif //CLASSROOMTYPEFACTORY_H
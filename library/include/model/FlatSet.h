@@ -0,0 +1,176 @@
+#ifndef FLATSET_H
+#define FLATSET_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+
+/**
+ * @brief Sorted vector of shared pointers with unique integer keys.
+ *
+ * The FlatSet class keeps its elements in a contiguous vector ordered by the key returned by
+ * the Key member function, which gives O(log n) lookups, cache-friendly iteration and cheap
+ * batch merges. Keys of stored elements must not change while they are in the set.
+ *
+ * @tparam T The element type.
+ * @tparam Key Const member function of T returning the unique key of an element.
+ */
+template <typename T, int (T::*Key)() const>
+class FlatSet {
+private:
+    std::vector<std::shared_ptr<T>> elements; /**< Elements sorted by ascending key. */
+
+    static bool keyLess(const std::shared_ptr<T> &element, const int key) {
+        return ((*element).*Key)() < key;
+    }
+
+    static bool elementLess(const std::shared_ptr<T> &first, const std::shared_ptr<T> &second) {
+        return ((*first).*Key)() < ((*second).*Key)();
+    }
+
+    static bool elementEqual(const std::shared_ptr<T> &first, const std::shared_ptr<T> &second) {
+        return ((*first).*Key)() == ((*second).*Key)();
+    }
+
+    [[nodiscard]] typename std::vector<std::shared_ptr<T>>::const_iterator lowerBound(const int key) const {
+        return std::lower_bound(elements.begin(), elements.end(), key, keyLess);
+    }
+
+public:
+    /**
+     * @brief Gets the elements ordered by key.
+     *
+     * @return A const reference to the sorted vector of elements.
+     */
+    [[nodiscard]] const std::vector<std::shared_ptr<T>>& values() const {
+        return elements;
+    }
+
+    /**
+     * @brief Finds the element with the given key.
+     *
+     * @param key The key to look for.
+     * @return Shared pointer to the element, or nullptr if no element has the key.
+     */
+    [[nodiscard]] std::shared_ptr<T> find(const int key) const {
+        const auto it = lowerBound(key);
+        if (it != elements.end() && ((**it).*Key)() == key) return *it;
+        return nullptr;
+    }
+
+    /**
+     * @brief Checks whether an element with the given key is stored.
+     *
+     * @param key The key to look for.
+     * @return True if the set contains an element with the key, false otherwise.
+     */
+    [[nodiscard]] bool contains(const int key) const {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief Inserts an element unless one with the same key is already stored.
+     *
+     * @param element Shared pointer to the element to insert (must not be null).
+     * @return True if the element was inserted, false if its key was already present.
+     */
+    bool insert(const std::shared_ptr<T> &element) {
+        const int key = ((*element).*Key)();
+        const auto it = lowerBound(key);
+        if (it != elements.end() && ((**it).*Key)() == key) return false;
+        elements.insert(it, element);
+        return true;
+    }
+
+    /**
+     * @brief Inserts a batch of elements in a single merge pass.
+     *
+     * Null pointers and elements whose key is already present (in the set or earlier in the
+     * batch) are skipped.
+     *
+     * @param batch The elements to insert.
+     * @return The number of inserted elements.
+     */
+    int insert(const std::vector<std::shared_ptr<T>> &batch) {
+        const std::size_t oldSize = elements.size();
+        elements.reserve(oldSize + batch.size());
+
+        for (const auto &element : batch) {
+            if (element != nullptr) elements.push_back(element);
+        }
+
+        const auto middle = elements.begin() + static_cast<std::ptrdiff_t>(oldSize);
+        std::stable_sort(middle, elements.end(), elementLess);
+        std::inplace_merge(elements.begin(), middle, elements.end(), elementLess);
+        elements.erase(std::unique(elements.begin(), elements.end(), elementEqual), elements.end());
+
+        return static_cast<int>(elements.size() - oldSize);
+    }
+
+    /**
+     * @brief Removes the element with the given key.
+     *
+     * @param key The key of the element to remove.
+     * @return True if an element was removed, false if the key was not present.
+     */
+    bool erase(const int key) {
+        const auto it = lowerBound(key);
+        if (it == elements.end() || ((**it).*Key)() != key) return false;
+        elements.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief Removes a batch of elements in a single pass.
+     *
+     * @param batch The elements to remove; null pointers and elements not in the set are ignored.
+     * @return The number of removed elements.
+     */
+    int erase(const std::vector<std::shared_ptr<T>> &batch) {
+        std::vector<int> keys;
+        keys.reserve(batch.size());
+        for (const auto &element : batch) {
+            if (element != nullptr) keys.push_back(((*element).*Key)());
+        }
+        std::sort(keys.begin(), keys.end());
+
+        const std::size_t oldSize = elements.size();
+        elements.erase(std::remove_if(elements.begin(), elements.end(), [&keys](const std::shared_ptr<T> &element) {
+            return std::binary_search(keys.begin(), keys.end(), ((*element).*Key)());
+        }), elements.end());
+
+        return static_cast<int>(oldSize - elements.size());
+    }
+
+    /**
+     * @brief Reserves storage for the given number of elements.
+     *
+     * @param capacity The number of elements to reserve space for.
+     */
+    void reserve(const std::size_t capacity) {
+        elements.reserve(capacity);
+    }
+
+    /**
+     * @brief Gets the number of stored elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] int size() const {
+        return static_cast<int>(elements.size());
+    }
+
+    /**
+     * @brief Checks whether the set is empty.
+     *
+     * @return True if no elements are stored, false otherwise.
+     */
+    [[nodiscard]] bool empty() const {
+        return elements.empty();
+    }
+};
+
+
+
+#endif //FLATSET_H
@@ -1,8 +1,13 @@
 #ifndef GROUPLESSON_H
 #define GROUPLESSON_H
 
+#include <deque>
+#include <span>
+#include <unordered_set>
 #include <vector>
 #include "Lesson.h"
+#include "Person.h"
+#include "FlatSet.h"
 #include "typedefs.h"
 
 
@@ -12,10 +17,30 @@
  * The GroupLesson class is a derived class of Lesson, extending its functionality to manage
  * a group of students attending the lesson. It includes methods to add and remove students,
  * calculate costs, and provide detailed information about the lesson and its participants.
+ *
+ * Enrollment is limited by the number of seats in the lesson's classroom. Students who sign up
+ * when the lesson is full are queued on a first-in, first-out waitlist and are promoted in order
+ * whenever a seat is freed.
  */
 class GroupLesson final : public Lesson {
 private:
-    std::vector<PersonPtr> students; /**< List of students attending the group lesson. */
+    FlatSet<Person, &Person::getId> students; /**< Students attending the group lesson, sorted by person ID. */
+    std::deque<PersonPtr> waitlist;           /**< Students waiting for a free seat, in sign-up order. */
+    std::unordered_set<int> waitlistedIds;    /**< IDs of the waitlisted students, for constant-time membership checks. */
+
+    /**
+     * @brief Appends a student to the end of the waitlist.
+     *
+     * @param student Shared pointer to the student to queue.
+     */
+    void enqueue(const PersonPtr &student);
+
+    /**
+     * @brief Moves students from the front of the waitlist into free seats.
+     *
+     * @return The promoted students, in waitlist order.
+     */
+    std::vector<PersonPtr> promoteWaitlisted();
 
 public:
     /**
@@ -43,103 +68,95 @@ public:
     /**
      * @brief Gets the list of students attending the lesson.
      *
-     * @return A vector of shared pointers to the students.
-     */
-    [[nodiscard]] std::vector<PersonPtr> getStudents() const;
-
-    /**
-     * @brief Gets the teacher conducting the lesson.
-     *
-     * @return Shared pointer to the teacher, inherited from the Lesson base class.
-     */
-    [[nodiscard]] PersonPtr getTeacher() const override;
-
-    /**
-     * @brief Gets the start time of the lesson.
-     *
-     * @return The start time as a boost::posix_time::ptime, inherited from the Lesson base class.
-     */
-    [[nodiscard]] pt::ptime getBeginTime() const override;
-
-    /**
-     * @brief Gets the end time of the lesson.
+     * The list is exposed read-only; it is modified only through addStudent(), addStudents(),
+     * removeStudent() and removeStudents().
      *
-     * @return The end time as a boost::posix_time::ptime, inherited from the Lesson base class.
+     * @return A read-only view of the shared pointers to the students, sorted by person ID.
      */
-    [[nodiscard]] pt::ptime getEndTime() const override;
+    [[nodiscard]] std::span<const PersonPtr> getStudents() const;
 
     /**
-     * @brief Gets the base cost per hour of the lesson.
+     * @brief Checks whether a person is enrolled in the group lesson.
      *
-     * @return The base cost, inherited from the Lesson base class.
+     * @param personId The ID of the person.
+     * @return True if the person is one of the lesson's students, false otherwise.
      */
-    [[nodiscard]] int getBaseCost() const override;
+    [[nodiscard]] bool hasStudent(int personId) const;
 
     /**
-     * @brief Gets the subject of the lesson.
+     * @brief Gets the students waiting for a free seat.
      *
-     * @return The subject as a string, inherited from the Lesson base class.
+     * @return A const reference to the waitlist, in the order the students will be promoted.
      */
-    [[nodiscard]] std::string getSubject() const override;
+    [[nodiscard]] const std::deque<PersonPtr>& getWaitlist() const;
 
     /**
-     * @brief Gets the classroom where the lesson takes place.
+     * @brief Checks whether a person is on the waitlist of the group lesson.
      *
-     * @return Shared pointer to the classroom, inherited from the Lesson base class.
+     * @param personId The ID of the person.
+     * @return True if the person is waiting for a seat, false otherwise.
      */
-    [[nodiscard]] ClassRoomPtr getClassRoom() const override;
+    [[nodiscard]] bool isWaitlisted(int personId) const;
 
     /**
-     * @brief Gets the unique identifier of the lesson.
+     * @brief Gets the number of seats left in the lesson.
      *
-     * @return The lesson ID, inherited from the Lesson base class.
-     */
-    [[nodiscard]] int getID() const override;
-
-    /**
-     * @brief Gets the total cost of the lesson.
+     * Computed in constant time from the classroom's seats number and the number of enrolled students,
+     * so it follows changes made to the classroom.
      *
-     * @return The total cost, inherited from the Lesson base class.
+     * @return The number of free seats, never negative.
      */
-    [[nodiscard]] long getTotalCost() const override;
+    [[nodiscard]] int getFreeSeats() const;
 
     /**
-     * @brief Checks if the lesson has started.
+     * @brief Adds a student to the group lesson.
      *
-     * Delegates to the base class to determine if the lesson is marked as started.
+     * The student is inserted in O(log n) lookup time; a student with the same ID is added only once.
+     * If no seat is left, the student is appended to the waitlist instead.
      *
-     * @return True if the lesson has started, false otherwise.
+     * @param student Shared pointer to the student to add.
+     * @return 0 on success, 1 if the student pointer is null, 2 if the student is already enrolled or waitlisted,
+     * 3 if the lesson is full and the student was put on the waitlist.
      */
-    [[nodiscard]] bool isStarted() const override;
+    int addStudent(const PersonPtr &student);
 
     /**
-     * @brief Marks the lesson as started or not started.
+     * @brief Adds a batch of students to the group lesson.
      *
-     * Delegates to the base class to set the lesson's started status.
+     * Students fill the free seats in the order given and are merged into the lesson in a single pass;
+     * the remaining ones are appended to the waitlist. Null pointers, duplicates and already enrolled
+     * or waitlisted students are skipped.
      *
-     * @param start Boolean indicating whether the lesson is started (true) or not (false).
+     * @param newStudents The students to add.
+     * @return The number of students actually enrolled.
      */
-    void startLesson(bool start) override;
+    int addStudents(const std::vector<PersonPtr> &newStudents);
 
     /**
-     * @brief Adds a student to the group lesson.
+     * @brief Removes a student from the group lesson.
      *
-     * Marks the student as attending the lesson and assigns the lesson ID to the student.
+     * Removes the student from the lesson and, if the student is attending this lesson right now,
+     * updates their status to not attending and clears their lesson ID. The freed seat goes to the
+     * first student on the waitlist. A waitlisted student is simply taken off the waitlist.
      *
-     * @param student Shared pointer to the student to add.
-     * @return 0 on success, 1 if the student pointer is null.
+     * @param student Shared pointer to the student to remove.
+     * @param promoted If not null, receives the waitlisted students given the freed seat, so the caller can update their bookkeeping.
+     * @return 0 on success, 1 if the student pointer is null, 2 if the student is neither enrolled nor waitlisted.
      */
-    int addStudent(const PersonPtr &student);
+    int removeStudent(const PersonPtr &student, std::vector<PersonPtr> *promoted = nullptr);
 
     /**
-     * @brief Removes a student from the group lesson.
+     * @brief Removes a batch of students from the group lesson.
      *
-     * Removes the student from the lesson and updates their status to not attending.
+     * All students are removed in a single pass, from the enrolled students and from the waitlist,
+     * and the freed seats are then given to the waitlist in order. Null pointers and unknown students
+     * are ignored.
      *
-     * @param student Shared pointer to the student to remove.
-     * @return 0 on success, 1 if the student pointer is null, 2 if the student is not attending the lesson.
+     * @param oldStudents The students to remove.
+     * @param promoted If not null, receives the waitlisted students given the freed seats, so the caller can update their bookkeeping.
+     * @return The number of students actually removed.
      */
-    int removeStudent(const PersonPtr &student);
+    int removeStudents(const std::vector<PersonPtr> &oldStudents, std::vector<PersonPtr> *promoted = nullptr);
 
     /**
      * @brief Finishes the group lesson and updates its state.
@@ -149,16 +166,6 @@ public:
      */
     void finishLesson() override;
 
-    /**
-     * @brief Calculates the total cost of the group lesson.
-     *
-     * Delegates to the base class calculateTotalCost() to compute the cost based on lesson duration
-     * and classroom rent.
-     *
-     * @return The calculated total cost, inherited from the Lesson base class.
-     */
-    [[nodiscard]] long calculateTotalCost() const override;
-
     /**
      * @brief Retrieves a formatted string with detailed information about the group lesson.
      *
@@ -172,7 +179,8 @@ public:
      * @brief Retrieves a comma-separated string of the group lesson's attributes.
      *
      * The string includes the lesson type ("GROUP"), base lesson attributes (from Lesson::getAttributes),
-     * and attributes of all students.
+     * the number of students and their attributes, then the number of waitlisted students and
+     * their attributes. The counts delimit the lists, so no name can be mistaken for a separator.
      *
      * @return A comma-separated string of the group lesson's attributes.
      */
@@ -48,80 +48,6 @@ public:
      */
     [[nodiscard]] PersonPtr getStudent() const;
 
-    /**
-     * @brief Gets the teacher conducting the lesson.
-     *
-     * @return Shared pointer to the teacher, inherited from the Lesson base class.
-     */
-    [[nodiscard]] PersonPtr getTeacher() const override;
-
-    /**
-     * @brief Gets the start time of the lesson.
-     *
-     * @return The start time as a boost::posix_time::ptime, inherited from the Lesson base class.
-     */
-    [[nodiscard]] pt::ptime getBeginTime() const override;
-
-    /**
-     * @brief Gets the end time of the lesson.
-     *
-     * @return The end time as a boost::posix_time::ptime, inherited from the Lesson base class.
-     */
-    [[nodiscard]] pt::ptime getEndTime() const override;
-
-    /**
-     * @brief Gets the base cost per hour of the lesson.
-     *
-     * @return The base cost, inherited from the Lesson base class.
-     */
-    [[nodiscard]] int getBaseCost() const override;
-
-    /**
-     * @brief Gets the subject of the lesson.
-     *
-     * @return The subject as a string, inherited from the Lesson base class.
-     */
-    [[nodiscard]] std::string getSubject() const override;
-
-    /**
-     * @brief Gets the classroom where the lesson takes place.
-     *
-     * @return Shared pointer to the classroom, inherited from the Lesson base class.
-     */
-    [[nodiscard]] ClassRoomPtr getClassRoom() const override;
-
-    /**
-     * @brief Gets the unique identifier of the lesson.
-     *
-     * @return The lesson ID, inherited from the Lesson base class.
-     */
-    [[nodiscard]] int getID() const override;
-
-    /**
-     * @brief Gets the total cost of the lesson.
-     *
-     * @return The total cost, inherited from the Lesson base class.
-     */
-    [[nodiscard]] long getTotalCost() const override;
-
-    /**
-     * @brief Checks if the lesson has started.
-     *
-     * Delegates to the base class to determine if the lesson is marked as started.
-     *
-     * @return True if the lesson has started, false otherwise.
-     */
-    [[nodiscard]] bool isStarted() const override;
-
-    /**
-     * @brief Marks the lesson as started or not started.
-     *
-     * Delegates to the base class to set the lesson's started status.
-     *
-     * @param start Boolean indicating whether the lesson is started (true) or not (false).
-     */
-    void startLesson(bool start) override;
-
     /**
      * @brief Finishes the individual lesson and updates its state.
      *
@@ -130,16 +56,6 @@ public:
      */
     void finishLesson() override;
 
-    /**
-     * @brief Calculates the total cost of the individual lesson.
-     *
-     * Delegates to the base class calculateTotalCost() to compute the cost based on lesson duration
-     * and classroom rent.
-     *
-     * @return The calculated total cost, inherited from the Lesson base class.
-     */
-    [[nodiscard]] long calculateTotalCost() const override;
-
     /**
      * @brief Retrieves a formatted string with detailed information about the individual lesson.
      *
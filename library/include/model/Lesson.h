@@ -2,7 +2,9 @@
 #define LESSON_H
 
 #include "typedefs.h"
+#include "model/StringPool.h"
 #include <boost/date_time.hpp>
+#include <atomic>
 
 /**
  * @brief Namespace alias for boost::posix_time.
@@ -20,21 +22,25 @@ namespace bdt = boost::date_time;
  * The Lesson class encapsulates the properties and behaviors of a lesson, including the teacher,
  * start and end times, base cost, subject, and associated classroom. It provides methods to access
  * and manipulate lesson data, calculate total costs based on duration and classroom rent, and
- * manage lesson lifecycle (e.g., marking a classroom as unavailable during a lesson). Derived
- * classes may extend this functionality.
+ * manage lesson lifecycle (e.g., marking a classroom as unavailable during a lesson).
+ *
+ * Accessors for the fields shared by every lesson are non-virtual, so scans over lessons do
+ * not pay for dynamic dispatch. Only the behavior that differs between lesson kinds, finishing
+ * the lesson and producing its description and serialized form, is virtual.
  */
 class Lesson {
 private:
-    static int counter; /**< Static counter for generating unique lesson IDs. */
+    static std::atomic<int> counter; /**< Static counter for generating unique lesson IDs; atomic, since lessons are created on several threads. */
     PersonPtr teacher; /**< Shared pointer to the teacher conducting the lesson. */
     pt::ptime startTime; /**< Start time of the lesson. */
     pt::ptime endTime; /**< End time of the lesson. */
     int baseCost; /**< Base cost per hour for the lesson. */
     long totalCost; /**< Total calculated cost of the lesson (set after completion). */
     int id; /**< Unique identifier for the lesson. */
-    std::string subject; /**< Subject of the lesson. */
+    StringPool::Id subject; /**< Interned subject of the lesson. */
     ClassRoomPtr classRoom; /**< Shared pointer to the classroom where the lesson takes place. */
     bool started; /**< Indicates whether the lesson has started. */
+    int seriesId; /**< ID of the series the lesson was expanded from, or -1 for a standalone lesson. */
 
 public:
     /**
@@ -51,7 +57,7 @@ public:
      * @param subject The subject of the lesson.
      * @param classRoom Shared pointer to the classroom where the lesson takes place.
      */
-    Lesson(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, int baseCost, std::string subject, const ClassRoomPtr &classRoom);
+    Lesson(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, int baseCost, const std::string &subject, const ClassRoomPtr &classRoom);
 
     /**
      * @brief Pure virtual destructor.
@@ -65,63 +71,111 @@ public:
      *
      * @return Shared pointer to the teacher.
      */
-    [[nodiscard]] virtual PersonPtr getTeacher() const;
+    [[nodiscard]] PersonPtr getTeacher() const {
+        return teacher;
+    }
 
     /**
      * @brief Gets the start time of the lesson.
      *
      * @return The start time as a boost::posix_time::ptime.
      */
-    [[nodiscard]] virtual pt::ptime getBeginTime() const;
+    [[nodiscard]] pt::ptime getBeginTime() const {
+        return startTime;
+    }
 
     /**
      * @brief Gets the end time of the lesson.
      *
      * @return The end time as a boost::posix_time::ptime, or not_a_date_time if the lesson is not finished.
      */
-    [[nodiscard]] virtual pt::ptime getEndTime() const;
+    [[nodiscard]] pt::ptime getEndTime() const {
+        return endTime;
+    }
 
     /**
      * @brief Gets the base cost per hour of the lesson.
      *
      * @return The base cost.
      */
-    [[nodiscard]] virtual int getBaseCost() const;
+    [[nodiscard]] int getBaseCost() const {
+        return baseCost;
+    }
 
     /**
      * @brief Gets the subject of the lesson.
      *
-     * @return The subject as a string.
+     * @return The subject as a const reference to the interned string.
+     */
+    [[nodiscard]] const std::string& getSubject() const {
+        return StringPool::get(subject);
+    }
+
+    /**
+     * @brief Gets the interned identifier of the subject.
+     *
+     * Lessons with equal subjects share the same identifier.
+     *
+     * @return The StringPool identifier of the subject.
      */
-    [[nodiscard]] virtual std::string getSubject() const;
+    [[nodiscard]] StringPool::Id getSubjectId() const {
+        return subject;
+    }
 
     /**
      * @brief Gets the classroom where the lesson takes place.
      *
      * @return Shared pointer to the classroom.
      */
-    [[nodiscard]] virtual ClassRoomPtr getClassRoom() const;
+    [[nodiscard]] ClassRoomPtr getClassRoom() const {
+        return classRoom;
+    }
 
     /**
      * @brief Gets the unique identifier of the lesson.
      *
      * @return The lesson ID.
      */
-    [[nodiscard]] virtual int getID() const;
+    [[nodiscard]] int getID() const {
+        return id;
+    }
 
     /**
      * @brief Gets the total cost of the lesson.
      *
      * @return The total cost, or -1 if the lesson is not finished or invalid.
      */
-    [[nodiscard]] virtual long getTotalCost() const;
+    [[nodiscard]] long getTotalCost() const {
+        return totalCost;
+    }
 
     /**
      * @brief Checks if the lesson has started.
      *
      * @return True if the lesson has started, false otherwise.
      */
-    [[nodiscard]] virtual bool isStarted() const;
+    [[nodiscard]] bool isStarted() const {
+        return started;
+    }
+
+    /**
+     * @brief Gets the ID of the series the lesson was expanded from.
+     *
+     * @return The series ID, or -1 if the lesson was planned on its own.
+     */
+    [[nodiscard]] int getSeriesId() const {
+        return seriesId;
+    }
+
+    /**
+     * @brief Records the series the lesson was expanded from.
+     *
+     * Meant to be called before the lesson is stored, since the link decides which part of the
+     * lesson its series already books.
+     *
+     * @param id The series ID, or -1 for a standalone lesson.
+     */
+    void setSeriesId(int id);
 
     /**
      * @brief Marks the lesson as started or not started.
@@ -130,7 +184,7 @@ public:
      *
      * @param start Boolean indicating whether the lesson is started (true) or not (false).
      */
-    virtual void startLesson(bool start);
+    void startLesson(bool start);
 
     /**
      * @brief Finishes the lesson and updates its state.
@@ -150,7 +204,7 @@ public:
      *
      * @return The calculated total cost.
      */
-    [[nodiscard]] virtual long calculateTotalCost() const;
+    [[nodiscard]] long calculateTotalCost() const;
 
     /**
      * @brief Retrieves a formatted string with detailed information about the lesson.
@@ -165,7 +219,7 @@ public:
      * @brief Retrieves a comma-separated string of the lesson's attributes.
      *
      * The string includes the lesson ID, base cost, subject, start time, classroom attributes,
-     * and teacher attributes.
+     * teacher attributes and the ID of the series the lesson was expanded from (-1 if none).
      *
      * @return A comma-separated string of the lesson's attributes.
      */
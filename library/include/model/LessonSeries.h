@@ -0,0 +1,247 @@
+#ifndef LESSONSERIES_H
+#define LESSONSERIES_H
+
+#include "typedefs.h"
+#include "model/StringPool.h"
+#include <span>
+#include <string>
+#include <vector>
+#include <boost/date_time.hpp>
+#include <atomic>
+
+/**
+ * @brief Namespace alias for boost::posix_time.
+ */
+namespace pt = boost::posix_time;
+
+
+/**
+ * @brief A lesson repeated at a fixed weekly interval.
+ *
+ * The LessonSeries class stores a recurring lesson once: the lesson template (teacher, classroom,
+ * subject, cost and students), the first occurrence, the interval in weeks and the number of
+ * occurrences, plus the occurrences cancelled as exceptions. Occurrence k starts at the first start
+ * time plus k intervals. Occurrences are computed on demand and are turned into concrete lessons
+ * only when they become due, so a series costs the same memory and file space whatever its length.
+ *
+ * Occurrences are expanded in order; a cursor remembers how many have already been handed out,
+ * so every occurrence becomes a lesson at most once.
+ */
+class LessonSeries {
+public:
+    /**
+     * @brief A single occurrence of a series.
+     */
+    struct Occurrence {
+        int seriesId; /**< ID of the series. */
+        int index; /**< Index of the occurrence in the series, from 0. */
+        pt::ptime beginTime; /**< Start time of the occurrence. */
+        pt::ptime endTime; /**< End time of the occurrence. */
+    };
+
+private:
+    static std::atomic<int> counter; /**< Static counter for generating unique series IDs; atomic, since series are created on several threads. */
+    int id; /**< Unique identifier of the series. */
+    PersonPtr teacher; /**< Shared pointer to the teacher conducting the lessons. */
+    ClassRoomPtr classRoom; /**< Shared pointer to the classroom of the lessons. */
+    StringPool::Id subject; /**< Interned subject of the lessons. */
+    int baseCost; /**< Base cost per hour of every lesson. */
+    std::vector<PersonPtr> students; /**< Students of the lessons. */
+    bool individual; /**< True if the occurrences are individual lessons of the single student. */
+    pt::ptime firstBegin; /**< Start time of the first occurrence. */
+    pt::ptime firstEnd; /**< End time of the first occurrence. */
+    int intervalWeeks; /**< Number of weeks between two occurrences. */
+    int count; /**< Total number of occurrences, including the cancelled ones. */
+    std::vector<int> exceptions; /**< Sorted indexes of the cancelled occurrences. */
+    int expanded; /**< Number of leading occurrences already handed out by expandUntil(). */
+
+public:
+    /**
+     * @brief Constructs a LessonSeries object.
+     *
+     * The series ID is generated automatically. The arguments are stored as given; they are
+     * validated by LessonManager before a series is created.
+     *
+     * @param teacher Shared pointer to the teacher conducting the lessons.
+     * @param beginTime The start time of the first occurrence.
+     * @param endTime The end time of the first occurrence.
+     * @param baseCost The base cost per hour of every lesson.
+     * @param subject The subject of the lessons.
+     * @param classRoom Shared pointer to the classroom of the lessons.
+     * @param students The students of the lessons.
+     * @param individual True if the occurrences are individual lessons of the single student.
+     * @param intervalWeeks The number of weeks between two occurrences (must be positive).
+     * @param count The number of occurrences (must be positive).
+     */
+    LessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, int baseCost,
+                 const std::string &subject, const ClassRoomPtr &classRoom, const std::vector<PersonPtr> &students,
+                 bool individual, int intervalWeeks, int count);
+
+    /**
+     * @brief Default destructor.
+     */
+    ~LessonSeries() = default;
+
+    /**
+     * @brief Gets the unique ID of the series.
+     *
+     * @return The series ID.
+     */
+    [[nodiscard]] int getID() const;
+
+    /**
+     * @brief Gets the teacher conducting the lessons.
+     *
+     * @return Shared pointer to the teacher.
+     */
+    [[nodiscard]] const PersonPtr& getTeacher() const;
+
+    /**
+     * @brief Gets the classroom of the lessons.
+     *
+     * @return Shared pointer to the classroom.
+     */
+    [[nodiscard]] const ClassRoomPtr& getClassRoom() const;
+
+    /**
+     * @brief Gets the subject of the lessons.
+     *
+     * @return A const reference to the subject.
+     */
+    [[nodiscard]] const std::string& getSubject() const;
+
+    /**
+     * @brief Gets the base cost per hour of every lesson.
+     *
+     * @return The base cost.
+     */
+    [[nodiscard]] int getBaseCost() const;
+
+    /**
+     * @brief Gets the students of the lessons.
+     *
+     * @return A read-only view of the students.
+     */
+    [[nodiscard]] std::span<const PersonPtr> getStudents() const;
+
+    /**
+     * @brief Checks whether the occurrences are individual lessons.
+     *
+     * @return True for individual lessons of the single student, false for group lessons.
+     */
+    [[nodiscard]] bool isIndividual() const;
+
+    /**
+     * @brief Gets the number of weeks between two occurrences.
+     *
+     * @return The interval in weeks.
+     */
+    [[nodiscard]] int getIntervalWeeks() const;
+
+    /**
+     * @brief Gets the total number of occurrences, including the cancelled ones.
+     *
+     * @return The number of occurrences.
+     */
+    [[nodiscard]] int getCount() const;
+
+    /**
+     * @brief Gets the indexes of the cancelled occurrences.
+     *
+     * @return A const reference to the sorted indexes.
+     */
+    [[nodiscard]] const std::vector<int>& getExceptions() const;
+
+    /**
+     * @brief Gets the number of leading occurrences already turned into lessons.
+     *
+     * @return The position of the expansion cursor.
+     */
+    [[nodiscard]] int getExpandedCount() const;
+
+    /**
+     * @brief Gets the start time of an occurrence.
+     *
+     * @param index The index of the occurrence.
+     * @return The start time, or not_a_date_time if the index is out of range.
+     */
+    [[nodiscard]] pt::ptime getOccurrenceBegin(int index) const;
+
+    /**
+     * @brief Gets the end time of an occurrence.
+     *
+     * @param index The index of the occurrence.
+     * @return The end time, or not_a_date_time if the index is out of range.
+     */
+    [[nodiscard]] pt::ptime getOccurrenceEnd(int index) const;
+
+    /**
+     * @brief Checks whether every occurrence has been turned into a lesson or cancelled.
+     *
+     * @return True if no occurrence is pending, false otherwise.
+     */
+    [[nodiscard]] bool isExhausted() const;
+
+    /**
+     * @brief Finds the pending occurrences overlapping a time window.
+     *
+     * Only occurrences not yet turned into lessons and not cancelled are returned. The first
+     * candidate is computed directly from the window, so the cost depends on the number of
+     * occurrences in the window, not on the length of the series.
+     *
+     * @param beginTime The start of the window.
+     * @param endTime The end of the window (exclusive).
+     * @return The overlapping occurrences in order of time.
+     */
+    [[nodiscard]] std::vector<Occurrence> findOccurrences(const pt::ptime &beginTime, const pt::ptime &endTime) const;
+
+    /**
+     * @brief Cancels a pending occurrence.
+     *
+     * @param index The index of the occurrence.
+     * @return 0 on success, 1 if the index is out of range, 2 if the occurrence is already cancelled or turned into a lesson.
+     */
+    int skipOccurrence(int index);
+
+    /**
+     * @brief Hands out the pending occurrences starting no later than a given time.
+     *
+     * Moves the expansion cursor past them, so they are never handed out again. Cancelled
+     * occurrences are passed over.
+     *
+     * @param until The latest start time to hand out.
+     * @return The occurrences to turn into lessons, in order of time.
+     */
+    std::vector<Occurrence> expandUntil(const pt::ptime &until);
+
+    /**
+     * @brief Moves the expansion cursor without handing out occurrences.
+     *
+     * Used when loading a series whose first occurrences were saved as lessons of their own.
+     *
+     * @param expandedCount The number of leading occurrences already turned into lessons (clamped to [0, count]).
+     */
+    void setExpandedCount(int expandedCount);
+
+    /**
+     * @brief Retrieves detailed information about the series.
+     *
+     * @return A string describing the series, its template and its occurrences.
+     */
+    [[nodiscard]] std::string getInfo() const;
+
+    /**
+     * @brief Retrieves the series attributes as a string.
+     *
+     * The format follows the lesson lines (ID, base cost, subject, first start and end, classroom,
+     * teacher) followed by the interval, the number of occurrences, the expansion cursor, the
+     * individual flag, the number of cancelled occurrences and their indexes, and the students.
+     *
+     * @return A string containing the series attributes, prefixed with "SERIES".
+     */
+    [[nodiscard]] std::string getAttributes() const;
+};
+
+
+
+#endif //LESSONSERIES_H
@@ -1,9 +1,14 @@
 #ifndef PERSON_H
 #define PERSON_H
 
+#include <span>
 #include <string>
 #include <vector>
 #include "typedefs.h"
+#include "model/StringPool.h"
+#include "model/FlatSet.h"
+#include "model/Lesson.h"
+#include "model/WeeklyOccupancy.h"
 
 
 /**
@@ -15,12 +20,13 @@
  */
 class Person {
 private:
-    std::string firstName; /**< First name of the person. */
-    std::string lastName; /**< Last name of the person. */
+    StringPool::Id firstName; /**< Interned first name of the person. */
+    StringPool::Id lastName; /**< Interned last name of the person. */
     int id; /**< Unique identifier for the person. */
     bool duringLesson; /**< Indicates whether the person is currently participating in a lesson. */
     int lessonId; /**< ID of the lesson the person is participating in, or -1 if not in a lesson. */
-    std::vector<LessonPtr> futureLessons; /**< List of scheduled lessons the person is assigned to attend. */
+    FlatSet<Lesson, &Lesson::getID> futureLessons; /**< Scheduled lessons the person is assigned to attend, sorted by lesson ID. */
+    WeeklyOccupancy occupancy; /**< Weekly timetable of the lessons the person teaches or attends. */
 
 public:
     /**
@@ -34,7 +40,7 @@ public:
      * @param duringLesson Indicates whether the person is currently in a lesson (default is false).
      * @param lessonId The ID of the lesson the person is participating in (default is -1).
      */
-    Person(std::string firstName, std::string lastName, int id, bool duringLesson = false, int lessonId = -1);
+    Person(const std::string &firstName, const std::string &lastName, int id, bool duringLesson = false, int lessonId = -1);
 
     /**
      * @brief Default destructor.
@@ -46,16 +52,38 @@ public:
     /**
      * @brief Gets the first name of the person.
      *
-     * @return The first name as a string.
+     * The returned reference points into the StringPool and stays valid for the lifetime of the program.
+     *
+     * @return The first name as a const reference to the interned string.
      */
-    [[nodiscard]] std::string getFirstName() const;
+    [[nodiscard]] const std::string& getFirstName() const;
 
     /**
      * @brief Gets the last name of the person.
      *
-     * @return The last name as a string.
+     * The returned reference points into the StringPool and stays valid for the lifetime of the program.
+     *
+     * @return The last name as a const reference to the interned string.
+     */
+    [[nodiscard]] const std::string& getLastName() const;
+
+    /**
+     * @brief Gets the interned identifier of the first name.
+     *
+     * Persons with equal first names share the same identifier.
+     *
+     * @return The StringPool identifier of the first name.
+     */
+    [[nodiscard]] StringPool::Id getFirstNameId() const;
+
+    /**
+     * @brief Gets the interned identifier of the last name.
+     *
+     * Persons with equal last names share the same identifier.
+     *
+     * @return The StringPool identifier of the last name.
      */
-    [[nodiscard]] std::string getLastName() const;
+    [[nodiscard]] StringPool::Id getLastNameId() const;
 
     /**
      * @brief Gets the unique identifier of the person.
@@ -88,12 +116,30 @@ public:
     /**
      * @brief Sets the ID of the lesson the person is participating in.
      *
-     * The lesson ID is updated only if the provided value is non-negative.
+     * The lesson ID is updated only if the provided value is non-negative, or -1 to clear it.
      *
      * @param newLessonId The new lesson ID.
      */
     void setLessonId(int newLessonId);
 
+    /**
+     * @brief Sets the first name of the person.
+     *
+     * The first name is updated only if the provided value is not empty.
+     *
+     * @param newFirstName The new first name.
+     */
+    void setFirstName(const std::string &newFirstName);
+
+    /**
+     * @brief Sets the last name of the person.
+     *
+     * The last name is updated only if the provided value is not empty.
+     *
+     * @param newLastName The new last name.
+     */
+    void setLastName(const std::string &newLastName);
+
     /**
      * @brief Sets the unique identifier of the person.
      *
@@ -106,7 +152,8 @@ public:
     /**
      * @brief Adds a lesson to the person's list of future lessons.
      *
-     * Appends the specified lesson to the person's future lessons if the lesson pointer is not null.
+     * Inserts the specified lesson into the person's future lessons if the lesson pointer is not null
+     * and the lesson is not already there. Runs in O(log n) lookup time.
      *
      * @param newFutureLesson Shared pointer to the lesson to add to the person's future lessons.
      */
@@ -116,18 +163,46 @@ public:
      * @brief Removes a lesson from the person's list of future lessons.
      *
      * Removes the specified lesson from the person's future lessons if the lesson pointer is not null.
+     * The lesson is looked up by ID in O(log n) time.
      *
      * @param futureLesson Shared pointer to the lesson to remove from the person's future lessons.
      * @return 0 on success, 1 if the lesson pointer is null.
      */
     int removeFutureLesson(const LessonPtr& futureLesson);
 
+    /**
+     * @brief Checks whether a lesson is among the person's future lessons.
+     *
+     * @param lessonId The ID of the lesson.
+     * @return True if the lesson is scheduled for the person, false otherwise.
+     */
+    [[nodiscard]] bool hasFutureLesson(int lessonId) const;
+
     /**
      * @brief Retrieves the list of future lessons the person is assigned to.
      *
-     * @return A vector of shared pointers to Lesson objects representing the person's future lessons.
+     * The list is exposed read-only; it is modified only through addFutureLesson() and
+     * removeFutureLesson(), which invalidate the returned view.
+     *
+     * @return A read-only view of the shared pointers to the person's future lessons, sorted by lesson ID.
+     */
+    [[nodiscard]] std::span<const LessonPtr> getFutureLessons() const;
+
+    /**
+     * @brief Gets the weekly occupancy grid of the person.
+     *
+     * The grid is maintained by LessonManager as lessons are added, removed and finished.
+     *
+     * @return A const reference to the occupancy grid.
+     */
+    [[nodiscard]] const WeeklyOccupancy& getOccupancy() const;
+
+    /**
+     * @brief Gets the weekly occupancy grid of the person for modification.
+     *
+     * @return A reference to the occupancy grid.
      */
-    [[nodiscard]] std::vector<LessonPtr> getFutureLessons() const;
+    [[nodiscard]] WeeklyOccupancy& getOccupancy();
 
     /**
      * @brief Retrieves a formatted string with detailed information about the person.
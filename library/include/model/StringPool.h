@@ -0,0 +1,63 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+/**
+ * @brief Global table of interned strings.
+ *
+ * The StringPool class stores every distinct string exactly once and hands out compact
+ * integer identifiers for them. Names and lesson subjects repeat many times across persons,
+ * lessons and the archive, so entities keep only the identifier and equality checks between
+ * them become integer comparisons. Interned strings are never released, which keeps every
+ * reference returned by get() valid for the lifetime of the program.
+ *
+ * The pool is shared by every thread: lookups take a shared lock and insertions an exclusive one.
+ */
+class StringPool {
+public:
+    /**
+     * @brief Identifier of an interned string.
+     */
+    typedef unsigned int Id;
+
+    /**
+     * @brief Interns a string.
+     *
+     * Returns the identifier of an already interned equal string, or stores a new copy of the
+     * value and returns its freshly assigned identifier.
+     *
+     * @param value The string to intern.
+     * @return The identifier of the interned string.
+     */
+    static Id intern(std::string_view value);
+
+    /**
+     * @brief Retrieves the string behind an identifier.
+     *
+     * @param id The identifier returned by intern().
+     * @return A reference to the interned string, or to an empty string if the identifier is unknown.
+     */
+    [[nodiscard]] static const std::string& get(Id id);
+
+    /**
+     * @brief Gets the number of distinct strings stored in the pool.
+     *
+     * @return The number of interned strings.
+     */
+    [[nodiscard]] static int size();
+
+private:
+    static std::deque<std::string> strings; /**< Interned strings, indexed by their identifier; a deque keeps references stable on growth. */
+    static std::unordered_map<std::string_view, Id> index; /**< Lookup from string contents to identifier, viewing into strings. */
+    static std::shared_mutex mutex; /**< Guards strings and index. */
+};
+
+
+
+#endif //STRINGPOOL_H
@@ -0,0 +1,137 @@
+#ifndef WEEKLYOCCUPANCY_H
+#define WEEKLYOCCUPANCY_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/date_time.hpp>
+
+/**
+ * @brief Namespace alias for boost::posix_time.
+ */
+namespace pt = boost::posix_time;
+
+
+/**
+ * @brief Occupancy bitmap of a resource over a weekly timetable.
+ *
+ * The WeeklyOccupancy class divides a week (Monday 00:00 to Sunday 24:00) into 5-minute slots
+ * and keeps one bit per slot, set when any lesson of the resource falls into that slot in any
+ * week. Lessons are projected onto the week, so a lesson on two different Mondays at 10:00 books
+ * the same slots. A per-slot counter lets overlapping bookings be released independently. Both are
+ * allocated on the first booking, so resources without lessons stay pointer-sized. Finding a time
+ * when several resources are all free is a word-wise OR of their bitmaps rather than a comparison
+ * of their lessons.
+ */
+class WeeklyOccupancy {
+public:
+    static constexpr int slotMinutes = 5; /**< Length of a single slot in minutes. */
+    static constexpr int slotsPerWeek = 7 * 24 * 60 / slotMinutes; /**< Number of slots in a week. */
+    static constexpr int wordsCount = (slotsPerWeek + 63) / 64; /**< Number of 64-bit words in the bitmap. */
+
+    /**
+     * @brief Bitmap of busy slots, slot i stored in bit i % 64 of word i / 64.
+     */
+    typedef std::array<std::uint64_t, wordsCount> Bits;
+
+private:
+    /**
+     * @brief Bitmap and booking counters of the week.
+     */
+    struct Slots {
+        Bits bits{}; /**< Busy slots of the week. */
+        std::array<std::uint16_t, slotsPerWeek> counts{}; /**< Number of bookings per slot. */
+    };
+
+    std::unique_ptr<Slots> slots; /**< Slots of the week; null until the first booking. */
+
+    /**
+     * @brief Adds a delta to the booking counters of every slot covered by a time interval.
+     *
+     * @param beginTime The start of the interval.
+     * @param endTime The end of the interval (exclusive).
+     * @param delta +1 to book the slots, -1 to release them.
+     */
+    void change(const pt::ptime &beginTime, const pt::ptime &endTime, int delta);
+
+public:
+    /**
+     * @brief Constructs an empty occupancy grid.
+     */
+    WeeklyOccupancy() = default;
+
+    /**
+     * @brief Copies the bookings of another grid.
+     *
+     * @param other The grid to copy.
+     */
+    WeeklyOccupancy(const WeeklyOccupancy &other);
+
+    /**
+     * @brief Replaces the bookings with a copy of another grid's.
+     *
+     * @param other The grid to copy.
+     * @return A reference to this grid.
+     */
+    WeeklyOccupancy& operator=(const WeeklyOccupancy &other);
+
+    /**
+     * @brief Books the slots covered by a time interval.
+     *
+     * Special or empty intervals are ignored; intervals of a week or longer book every slot.
+     *
+     * @param beginTime The start of the interval.
+     * @param endTime The end of the interval (exclusive).
+     */
+    void occupy(const pt::ptime &beginTime, const pt::ptime &endTime);
+
+    /**
+     * @brief Releases a booking made by occupy() with the same interval.
+     *
+     * @param beginTime The start of the interval.
+     * @param endTime The end of the interval (exclusive).
+     */
+    void release(const pt::ptime &beginTime, const pt::ptime &endTime);
+
+    /**
+     * @brief Checks whether no booked slot falls into a time interval.
+     *
+     * @param beginTime The start of the interval.
+     * @param endTime The end of the interval (exclusive).
+     * @return True if every slot covered by the interval is free, false otherwise.
+     */
+    [[nodiscard]] bool isFree(const pt::ptime &beginTime, const pt::ptime &endTime) const;
+
+    /**
+     * @brief Gets the bitmap of busy slots.
+     *
+     * @return A const reference to the bitmap, all zeros if nothing has been booked.
+     */
+    [[nodiscard]] const Bits& getBits() const;
+
+    /**
+     * @brief Gets the weekly slot a time point falls into.
+     *
+     * @param time The time point (must not be special).
+     * @return The slot index, from 0 (Monday 00:00) to slotsPerWeek - 1.
+     */
+    [[nodiscard]] static int slotOf(const pt::ptime &time);
+
+    /**
+     * @brief Finds the first run of slots free in every given bitmap.
+     *
+     * The busy bitmaps are merged word by word and the merged bitmap is then searched for a run of
+     * free slots, starting at fromSlot and wrapping around the end of the week.
+     *
+     * @param grids The bitmaps to combine; null pointers and grids without bookings are ignored.
+     * @param slotsNeeded The length of the run in slots (must be positive).
+     * @param fromSlot The slot to start searching from.
+     * @return The first slot of the run, or -1 if no such run exists.
+     */
+    [[nodiscard]] static int findCommonFreeSlot(const std::vector<const WeeklyOccupancy*> &grids, int slotsNeeded, int fromSlot);
+};
+
+
+
+#endif //WEEKLYOCCUPANCY_H
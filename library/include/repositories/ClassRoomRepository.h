@@ -2,9 +2,16 @@
 #define CLASSROOMREPOSITORY_H
 
 #include "model/ClassRoom.h"
+#include "repositories/PersistentVector.h"
+#include "repositories/SnapshotCell.h"
 #include "typedefs.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
+#include <shared_mutex>
+#include <unordered_map>
 
 
 /**
@@ -13,10 +20,24 @@
  * The ClassRoomRepository class provides functionality to store, retrieve, and manipulate
  * a collection of classrooms. It supports operations such as adding and removing classrooms,
  * finding classrooms by number or custom criteria, and querying the size of the collection.
+ *
+ * Like PersonRepository, it may be shared between threads: lookups by number take a shared lock,
+ * changes an exclusive one, and findBy() and findAll() walk a lock-free snapshot.
  */
 class ClassRoomRepository {
 private:
-    std::vector<ClassRoomPtr> rooms; /**< Collection of shared pointers to ClassRoom objects. */
+    PersistentVector<ClassRoomPtr> rooms; /**< Collection of shared pointers to ClassRoom objects, in insertion order. */
+    std::unordered_map<int, ClassRoomPtr> roomsByNumber; /**< Index of the stored classrooms by number; the first classroom added with a number wins. */
+    mutable std::shared_mutex mutex; /**< Shared for lookups, exclusive for changes. */
+    std::atomic<std::uint64_t> version{0}; /**< Number of changes made so far. */
+    mutable SnapshotCell<PersistentVector<ClassRoomPtr>> snapshots; /**< Latest published snapshot of rooms. */
+
+    /**
+     * @brief Stores a classroom; the caller holds the exclusive lock.
+     *
+     * @param classRoom Shared pointer to the ClassRoom to add.
+     */
+    void insert(const ClassRoomPtr& classRoom);
 
 public:
     /**
@@ -36,7 +57,8 @@ public:
     /**
      * @brief Finds a classroom by its unique number.
      *
-     * Searches the repository for a classroom with the specified number.
+     * Looks the classroom up in the number index in constant average time. The number of a stored
+     * classroom must not be changed with ClassRoom::setNumber().
      *
      * @param number The unique number of the classroom to find.
      * @return A shared pointer to the found ClassRoom, or nullptr if no matching classroom is found.
@@ -52,6 +74,16 @@ public:
      */
     void add(const ClassRoomPtr& classRoom);
 
+    /**
+     * @brief Adds a batch of classrooms to the repository.
+     *
+     * Reserves room for the whole batch at once and then adds every classroom as add() does; null
+     * pointers are skipped.
+     *
+     * @param classRooms The classrooms to add.
+     */
+    void addAll(const std::vector<ClassRoomPtr>& classRooms);
+
     /**
      * @brief Removes a classroom from the repository.
      *
@@ -84,6 +116,15 @@ public:
      * @return A vector of shared pointers to ClassRoom objects that satisfy the predicate.
      */
     [[nodiscard]] std::vector<ClassRoomPtr> findBy(const ClassRoomPredicate& predicate) const;
+
+    /**
+     * @brief Gets an immutable snapshot of the stored classrooms.
+     *
+     * See PersonRepository::snapshot().
+     *
+     * @return Shared pointer to the snapshot.
+     */
+    [[nodiscard]] std::shared_ptr<const PersistentVector<ClassRoomPtr>> snapshot() const;
 };
 
 
@@ -2,7 +2,17 @@
 #define LESSONREPOSITORY_H
 
 #include <vector>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
 #include "model/Lesson.h"
+#include "model/LessonSeries.h"
+#include "repositories/OccupancyIndex.h"
+#include "repositories/PersistentVector.h"
+#include "repositories/ShardedView.h"
+#include "repositories/Sharding.h"
+#include "repositories/SnapshotCell.h"
 
 
 /**
@@ -11,19 +21,167 @@
  * The LessonRepository class provides functionality to store, retrieve, and manipulate
  * a collection of lessons. It supports operations such as adding and removing lessons,
  * finding lessons by index, ID, or custom criteria, and querying the size of the collection.
+ *
+ * Next to the Lesson objects the repository keeps a compact, contiguous schedule of the few
+ * fields the start/finish scheduler needs, with times stored as 8-byte epoch seconds. Time
+ * based scans walk only this array and never dereference the lessons themselves.
+ *
+ * The repository also maintains occupancy indexes of classrooms (by number) and teachers (by
+ * person ID), which answer whether a resource is free for a time window without scanning the
+ * lessons. The classroom, teacher and times of a lesson must not change while it is stored.
+ *
+ * Recurring lessons are stored as LessonSeries objects next to the lessons. Their occurrences that
+ * have not been turned into lessons yet are not indexed; the free-resource checks compute the
+ * occurrences of the series using the resource within the queried window instead.
+ *
+ * The repository may be shared between threads. Like PersonRepository, it partitions the lessons
+ * and their schedule entries by a hash of the lesson ID into shards, each with its own lock, so
+ * changes to lessons in different shards run in parallel. The occupancy indexes are partitioned
+ * the same way by classroom number and by teacher ID, so a free-resource check locks only the part
+ * holding its resource. A lesson is entered into its shard first and into the occupancy indexes
+ * right after, each under its own lock. Walks over the lessons (findBy(), findAll(), the collection
+ * getters and reports) read an immutable snapshot made of per-shard snapshots, without holding any
+ * lock, and see the lessons in insertion order. The collection getters return copies rather than
+ * references to the live collections.
  */
 class LessonRepository {
+public:
+    /**
+     * @brief Scheduling fields of a single lesson, kept contiguously for time-based scans.
+     */
+    struct ScheduleEntry {
+        std::int64_t beginTime; /**< Start time in seconds since the Unix epoch. */
+        std::int64_t endTime; /**< End time in seconds since the Unix epoch, or INT64_MAX if unknown. */
+        int id; /**< ID of the lesson. */
+        bool started; /**< Indicates whether the lesson has started. */
+    };
+
+    /**
+     * @brief Converts a time point to seconds since the Unix epoch.
+     *
+     * @param time The time to convert.
+     * @return The number of seconds since 1970-01-01 00:00:00, or INT64_MAX if the time is not a valid date.
+     */
+    [[nodiscard]] static std::int64_t toEpochSeconds(const pt::ptime &time);
+
+    /**
+     * @brief The stored lessons, as published in snapshots.
+     */
+    struct Lessons {
+        ShardedView<LessonPtr> started; /**< Shared pointers to Lesson objects that have started. */
+        ShardedView<LessonPtr> planned; /**< Shared pointers to Lesson objects that are scheduled but not yet started. */
+    };
+
 private:
-    std::vector<LessonPtr> startedLessons; /**< Collection of shared pointers to Lesson objects that have started. */
-    std::vector<LessonPtr> plannedLessons; /**< Collection of shared pointers to Lesson objects that are scheduled but not yet started. */
+    using Part = ShardedView<LessonPtr>::Part; /**< Lessons of a single shard. */
+
+    /**
+     * @brief The lessons of one shard, as published in the snapshots of the shard.
+     */
+    struct ShardLessons {
+        Part started; /**< Lessons that have started, in insertion order. */
+        Part planned; /**< Lessons that are scheduled but not yet started, in insertion order. */
+    };
+
+    /**
+     * @brief The lessons whose IDs hash to one shard.
+     */
+    struct Shard {
+        ShardLessons lessons; /**< The stored lessons. */
+        std::vector<ScheduleEntry> schedule; /**< Hot scheduling fields of the lessons of the shard, in no particular order. */
+        mutable std::shared_mutex mutex; /**< Shared for lookups, exclusive for changes. */
+        std::atomic<std::uint64_t> version{0}; /**< Number of changes made to lessons of the shard so far. */
+        mutable SnapshotCell<ShardLessons> snapshots; /**< Latest published snapshot of lessons. */
+    };
+
+    /**
+     * @brief The booked intervals of the resources whose keys hash to one shard.
+     */
+    struct OccupancyShard {
+        OccupancyIndex index; /**< Booked intervals keyed by resource. */
+        mutable std::shared_mutex mutex; /**< Shared for checks, exclusive for bookings. */
+    };
+
+    std::vector<Shard> shards; /**< Lesson shards by lesson ID; never resized, since a Shard cannot be moved. */
+    std::vector<OccupancyShard> classRoomOccupancy; /**< Booked intervals of classrooms, sharded by classroom number. */
+    std::vector<OccupancyShard> teacherOccupancy; /**< Booked intervals of teachers, sharded by person ID. */
+    std::atomic<std::uint64_t> sequence{0}; /**< Sequence number given to the next added lesson. */
+    std::vector<LessonSeriesPtr> series; /**< Collection of shared pointers to the stored lesson series. */
+    mutable std::shared_mutex seriesMutex; /**< Guards series; shared for lookups, exclusive for changes. */
+
+    /**
+     * @brief Gets the shard of a lesson ID.
+     *
+     * @param id The lesson ID.
+     * @return The shard.
+     */
+    Shard& shardOf(int id);
+
+    /**
+     * @brief Gets the shard of a lesson ID.
+     *
+     * @param id The lesson ID.
+     * @return The shard.
+     */
+    [[nodiscard]] const Shard& shardOf(int id) const;
+
+    /**
+     * @brief Gets the snapshot of the lessons of one shard.
+     *
+     * @param shard The shard.
+     * @return Shared pointer to the snapshot.
+     */
+    [[nodiscard]] static std::shared_ptr<const ShardLessons> snapshotOf(const Shard &shard);
+
+    /**
+     * @brief Stores a lesson in its shard; the caller holds the exclusive lock of the shard.
+     *
+     * @param shard The shard of the lesson.
+     * @param lesson Shared pointer to the Lesson to add (not null).
+     * @param now True to store the lesson as started, false to store it as planned.
+     * @param number The sequence number of the lesson.
+     */
+    static void insert(Shard &shard, const LessonPtr &lesson, bool now, std::uint64_t number);
+
+    /**
+     * @brief Removes a lesson from the schedule of its shard; the caller holds the exclusive lock of the shard.
+     *
+     * @param shard The shard of the lesson.
+     * @param id The ID of the lesson.
+     */
+    static void unschedule(Shard &shard, int id);
+
+    /**
+     * @brief Books the classroom and teacher of a lesson in the occupancy indexes.
+     *
+     * @param lesson Shared pointer to the stored lesson.
+     */
+    void book(const LessonPtr &lesson);
+
+    /**
+     * @brief Releases the bookings made by book().
+     *
+     * @param lesson Shared pointer to the stored lesson.
+     */
+    void release(const LessonPtr &lesson);
+
+    /**
+     * @brief Checks whether no pending occurrence of the matching series overlaps a time window.
+     *
+     * @param matches Returns true for the series using the resource in question.
+     * @param beginTime The start of the window, as returned by toEpochSeconds().
+     * @param endTime The end of the window (exclusive), as returned by toEpochSeconds().
+     * @return True if no matching series has a pending occurrence within the window, false otherwise.
+     */
+    [[nodiscard]] bool isFreeOfSeries(const std::function<bool(const LessonSeries&)> &matches, std::int64_t beginTime, std::int64_t endTime) const;
 
 public:
     /**
-     * @brief Default constructor.
+     * @brief Constructs an empty LessonRepository.
      *
-     * Initializes an empty LessonRepository.
+     * @param shardsCount The number of shards of the lessons and of each occupancy index (at least 1).
      */
-    LessonRepository() = default;
+    explicit LessonRepository(std::size_t shardsCount = Sharding::defaultShardsCount);
 
     /**
      * @brief Default destructor.
@@ -35,6 +193,8 @@ public:
     /**
      * @brief Retrieves a lesson by its index in the repository.
      *
+     * Walks the started lessons in insertion order up to the index.
+     *
      * @param index The index of the lesson in the repository (must be non-negative and less than the size of the repository).
      * @return A shared pointer to the Lesson at the specified index, or nullptr if the index is invalid.
      */
@@ -53,14 +213,14 @@ public:
     /**
      * @brief Retrieves all started lessons in the repository.
      *
-     * @return A vector of shared pointers to Lesson objects that have started.
+     * @return A copy of the vector of shared pointers to Lesson objects that have started.
      */
     [[nodiscard]] std::vector<LessonPtr> getStartedLessons() const;
 
     /**
      * @brief Retrieves all planned lessons in the repository.
      *
-     * @return A vector of shared pointers to Lesson objects that are scheduled but not yet started.
+     * @return A copy of the vector of shared pointers to Lesson objects that are scheduled but not yet started.
      */
     [[nodiscard]] std::vector<LessonPtr> getPlannedLessons() const;
 
@@ -74,17 +234,29 @@ public:
     /**
      * @brief Finds lessons that satisfy a given predicate.
      *
-     * Searches the repository for lessons that match the specified predicate function.
+     * Searches the repository for lessons that match the specified predicate function. The shards
+     * of a large repository are searched in parallel, so the predicate may be called from several
+     * threads at once.
      *
      * @param predicate A function that takes a LessonPtr and returns true if the lesson matches the criteria.
-     * @return A vector of shared pointers to Lesson objects that satisfy the predicate.
+     * @return A vector of shared pointers to Lesson objects that satisfy the predicate: the started ones, then the planned
+     *         ones, each in insertion order.
      */
     [[nodiscard]] std::vector<LessonPtr> findBy(const LessonPredicate& predicate) const;
 
+    /**
+     * @brief Gets an immutable snapshot of the stored lessons.
+     *
+     * See PersonRepository::snapshot(). Series and the schedule are not part of the snapshot.
+     *
+     * @return Shared pointer to the snapshot.
+     */
+    [[nodiscard]] std::shared_ptr<const Lessons> snapshot() const;
+
     /**
      * @brief Finds a lesson by its unique ID.
      *
-     * Searches the repository for a lesson with the specified ID.
+     * Searches only the shard of the ID.
      *
      * @param index The unique ID of the lesson to find.
      * @return A shared pointer to the found Lesson, or nullptr if no matching lesson is found.
@@ -124,6 +296,132 @@ public:
      */
     int add(const LessonPtr &lesson, bool now);
 
+    /**
+     * @brief Adds a batch of lessons to the repository.
+     *
+     * Reserves room in the lesson collection and the schedule for the whole batch at once and then
+     * adds every lesson as add() does; null pointers are skipped.
+     *
+     * @param newLessons The lessons to add.
+     * @param now Indicates whether the lessons start immediately (true) or are scheduled for the future (false).
+     * @return The number of lessons added.
+     */
+    int addAll(const std::vector<LessonPtr> &newLessons, bool now);
+
+    /**
+     * @brief Marks a lesson as started or not started in the schedule.
+     *
+     * Must be called whenever Lesson::startLesson() changes the state of a stored lesson, so the
+     * schedule used by findToStart() and findToFinish() stays in sync.
+     *
+     * @param id The ID of the lesson.
+     * @param started The new started status.
+     * @return 0 on success, 1 if no lesson with the given ID is stored.
+     */
+    int setStarted(int id, bool started);
+
+    /**
+     * @brief Finds lessons that should be started at the given time.
+     *
+     * Scans only the schedule for lessons that have not started and whose start time has passed.
+     *
+     * @param now The current time.
+     * @return A vector with the IDs of the lessons to start, in ascending order.
+     */
+    [[nodiscard]] std::vector<int> findToStart(const pt::ptime &now) const;
+
+    /**
+     * @brief Finds lessons that should be finished at the given time.
+     *
+     * Scans only the schedule for started lessons whose end time has passed.
+     *
+     * @param now The current time.
+     * @return A vector with the IDs of the lessons to finish, in ascending order.
+     */
+    [[nodiscard]] std::vector<int> findToFinish(const pt::ptime &now) const;
+
+    /**
+     * @brief Retrieves the scheduling fields of all lessons.
+     *
+     * @return A copy of the contiguous schedule.
+     */
+    [[nodiscard]] std::vector<ScheduleEntry> getSchedule() const;
+
+    /**
+     * @brief Checks whether a classroom has no lesson in a time window.
+     *
+     * @param number The number of the classroom.
+     * @param beginTime The start of the window.
+     * @param endTime The end of the window (exclusive).
+     * @return True if no stored lesson or pending series occurrence uses the classroom within [beginTime, endTime), false otherwise.
+     */
+    [[nodiscard]] bool isClassRoomFree(int number, const pt::ptime &beginTime, const pt::ptime &endTime) const;
+
+    /**
+     * @brief Checks whether a classroom has no lesson in a time window given in epoch seconds.
+     *
+     * Lets callers testing many classrooms against one window convert the times only once.
+     *
+     * @param number The number of the classroom.
+     * @param beginTime The start of the window, as returned by toEpochSeconds().
+     * @param endTime The end of the window (exclusive), as returned by toEpochSeconds().
+     * @return True if no stored lesson or pending series occurrence uses the classroom within [beginTime, endTime), false otherwise.
+     */
+    [[nodiscard]] bool isClassRoomFree(int number, std::int64_t beginTime, std::int64_t endTime) const;
+
+    /**
+     * @brief Checks whether a person teaches no lesson in a time window.
+     *
+     * @param personId The ID of the person.
+     * @param beginTime The start of the window.
+     * @param endTime The end of the window (exclusive).
+     * @return True if the person teaches no stored lesson or pending series occurrence within [beginTime, endTime), false otherwise.
+     */
+    [[nodiscard]] bool isTeacherFree(int personId, const pt::ptime &beginTime, const pt::ptime &endTime) const;
+
+    /**
+     * @brief Checks whether a person teaches no lesson in a time window given in epoch seconds.
+     *
+     * @param personId The ID of the person.
+     * @param beginTime The start of the window, as returned by toEpochSeconds().
+     * @param endTime The end of the window (exclusive), as returned by toEpochSeconds().
+     * @return True if the person teaches no stored lesson or pending series occurrence within [beginTime, endTime), false otherwise.
+     */
+    [[nodiscard]] bool isTeacherFree(int personId, std::int64_t beginTime, std::int64_t endTime) const;
+
+    /**
+     * @brief Adds a lesson series to the repository.
+     *
+     * @param lessonSeries Shared pointer to the series to add.
+     * @return 0 on success, 1 if the series pointer is null.
+     */
+    int addSeries(const LessonSeriesPtr &lessonSeries);
+
+    /**
+     * @brief Removes a lesson series from the repository.
+     *
+     * Lessons already created from the series stay in the repository.
+     *
+     * @param lessonSeries Shared pointer to the series to remove.
+     * @return 0 on success, 1 if the series pointer is null, 2 if the series is not found.
+     */
+    int removeSeries(const LessonSeriesPtr &lessonSeries);
+
+    /**
+     * @brief Finds a lesson series by its unique ID.
+     *
+     * @param id The unique ID of the series.
+     * @return A shared pointer to the found series, or nullptr if no matching series is found.
+     */
+    [[nodiscard]] LessonSeriesPtr findSeriesById(int id) const;
+
+    /**
+     * @brief Retrieves all lesson series in the repository.
+     *
+     * @return A copy of the vector of shared pointers to the series.
+     */
+    [[nodiscard]] std::vector<LessonSeriesPtr> getSeries() const;
+
     /**
      * @brief Gets the number of lessons in the repository.
      *
@@ -0,0 +1,84 @@
+#ifndef OCCUPANCYINDEX_H
+#define OCCUPANCYINDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Per-resource index of occupied time intervals.
+ *
+ * The OccupancyIndex class keeps, for every resource (a classroom number or a person ID), the
+ * half-open intervals [beginTime, endTime) during which the resource is booked, sorted by start
+ * time. Each timeline also remembers the length of its longest interval, so an overlap query only
+ * has to look at intervals starting within that distance before the queried window, which takes
+ * O(log n) time for a typical timeline. Intervals without a known end are kept apart and block the
+ * resource from their start onwards.
+ */
+class OccupancyIndex {
+public:
+    /**
+     * @brief A booked time interval of a resource.
+     */
+    struct Interval {
+        std::int64_t beginTime; /**< Start time in seconds since the Unix epoch. */
+        std::int64_t endTime; /**< End time in seconds since the Unix epoch, or INT64_MAX if unknown. */
+        int lessonId; /**< ID of the lesson occupying the resource. */
+    };
+
+private:
+    /**
+     * @brief Booked intervals of a single resource.
+     */
+    struct Timeline {
+        std::vector<Interval> intervals; /**< Intervals with a known end, sorted by start time. */
+        std::vector<Interval> openEnded; /**< Intervals without a known end, in no particular order. */
+        std::int64_t longest = 0; /**< Length of the longest interval ever added; never shrinks, which keeps queries correct. */
+    };
+
+    std::unordered_map<int, Timeline> timelines; /**< Timelines indexed by resource key. */
+
+public:
+    /**
+     * @brief Books a resource for a time interval.
+     *
+     * @param resource The key of the resource.
+     * @param beginTime Start time in seconds since the Unix epoch.
+     * @param endTime End time in seconds since the Unix epoch, or INT64_MAX if unknown.
+     * @param lessonId The ID of the lesson occupying the resource.
+     */
+    void add(int resource, std::int64_t beginTime, std::int64_t endTime, int lessonId);
+
+    /**
+     * @brief Releases a booking made by add().
+     *
+     * @param resource The key of the resource.
+     * @param beginTime Start time the interval was added with.
+     * @param lessonId The ID of the lesson occupying the resource.
+     * @return 0 on success, 1 if no such booking exists.
+     */
+    int remove(int resource, std::int64_t beginTime, int lessonId);
+
+    /**
+     * @brief Checks whether a resource is free for a whole time window.
+     *
+     * @param resource The key of the resource.
+     * @param beginTime Start of the window in seconds since the Unix epoch.
+     * @param endTime End of the window (exclusive) in seconds since the Unix epoch.
+     * @return True if no booked interval of the resource overlaps [beginTime, endTime), false otherwise.
+     */
+    [[nodiscard]] bool isFree(int resource, std::int64_t beginTime, std::int64_t endTime) const;
+
+    /**
+     * @brief Gets the number of bookings of a resource.
+     *
+     * @param resource The key of the resource.
+     * @return The number of intervals stored for the resource.
+     */
+    [[nodiscard]] int size(int resource) const;
+};
+
+
+
+#endif //OCCUPANCYINDEX_H
@@ -0,0 +1,232 @@
+#ifndef PERSISTENTVECTOR_H
+#define PERSISTENTVECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+/**
+ * @brief Sequence stored in fixed-size chunks that copies share.
+ *
+ * The PersistentVector class keeps its elements, in insertion order, in chunks of at most
+ * chunkCapacity elements held by shared pointers. Copying a PersistentVector copies only the
+ * chunk pointers, so a copy taken as a snapshot costs O(n / chunkCapacity) and shares every
+ * element with the original. A chunk is changed in place only while no copy shares it; otherwise
+ * the change is made on a private copy of that one chunk (copy-on-write), so a snapshot never sees
+ * later changes.
+ *
+ * A single PersistentVector object is not safe for concurrent use, but separate copies may be used
+ * by separate threads, which is how repositories publish snapshots to lock-free readers.
+ *
+ * @tparam T The element type.
+ */
+template <typename T>
+class PersistentVector {
+public:
+    static constexpr std::size_t chunkCapacity = 256; /**< Largest number of elements in a chunk. */
+
+private:
+    using Chunk = std::vector<T>;
+
+    std::vector<std::shared_ptr<Chunk>> chunks; /**< Non-empty chunks in order; a chunk shared with a copy is never modified. */
+    std::size_t count = 0; /**< Total number of elements. */
+
+    /**
+     * @brief Makes a chunk safe to modify, copying it if another PersistentVector shares it.
+     *
+     * @param chunk The chunk to detach.
+     * @return A reference to the private chunk.
+     */
+    Chunk& detach(std::shared_ptr<Chunk> &chunk) {
+        if (chunk.use_count() != 1) {
+            auto copy = std::make_shared<Chunk>();
+            copy->reserve(chunkCapacity);
+            copy->assign(chunk->begin(), chunk->end());
+            chunk = std::move(copy);
+        }
+        // Pairs with the release decrement of the last other owner, so its reads finish before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return *chunk;
+    }
+
+    /**
+     * @brief Removes the element at a position of a chunk, dropping the chunk if it becomes empty.
+     *
+     * @param chunkIndex The index of the chunk.
+     * @param offset The position in the chunk.
+     */
+    void eraseFromChunk(const std::size_t chunkIndex, const std::size_t offset) {
+        if (chunks[chunkIndex]->size() == 1) {
+            chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(chunkIndex));
+        } else {
+            Chunk &chunk = detach(chunks[chunkIndex]);
+            chunk.erase(chunk.begin() + static_cast<std::ptrdiff_t>(offset));
+        }
+        count--;
+    }
+
+public:
+    /**
+     * @brief Gets the number of elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief Checks whether there are no elements.
+     *
+     * @return True if the sequence is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const {
+        return count == 0;
+    }
+
+    /**
+     * @brief Gets the element at a position.
+     *
+     * Chunks may be partly filled after removals, so the position is found by walking the chunk
+     * sizes, which costs O(n / chunkCapacity).
+     *
+     * @param index The position, which must be less than size().
+     * @return A const reference to the element.
+     */
+    [[nodiscard]] const T& at(std::size_t index) const {
+        for (const auto &chunk : chunks) {
+            if (index < chunk->size()) return (*chunk)[index];
+            index -= chunk->size();
+        }
+        return chunks.back()->back();
+    }
+
+    /**
+     * @brief Gets the number of chunks.
+     *
+     * @return The number of chunks, none of which is empty.
+     */
+    [[nodiscard]] std::size_t chunksCount() const {
+        return chunks.size();
+    }
+
+    /**
+     * @brief Gets the elements of a chunk, for walks that advance through several sequences at once.
+     *
+     * @param index The index of the chunk, which must be less than chunksCount().
+     * @return A const reference to the elements of the chunk, in order.
+     */
+    [[nodiscard]] const std::vector<T>& chunk(const std::size_t index) const {
+        return *chunks[index];
+    }
+
+    /**
+     * @brief Reserves room for chunk pointers, so that appending n elements does not reallocate them.
+     *
+     * @param elements The number of elements the sequence is expected to hold.
+     */
+    void reserve(const std::size_t elements) {
+        chunks.reserve(elements / chunkCapacity + 1);
+    }
+
+    /**
+     * @brief Appends an element.
+     *
+     * @param value The element to append.
+     */
+    void pushBack(const T &value) {
+        if (chunks.empty() || chunks.back()->size() >= chunkCapacity) {
+            auto chunk = std::make_shared<Chunk>();
+            chunk->reserve(chunkCapacity);
+            chunks.push_back(std::move(chunk));
+        }
+        detach(chunks.back()).push_back(value);
+        count++;
+    }
+
+    /**
+     * @brief Removes every element equal to a value.
+     *
+     * @param value The value to remove.
+     * @return The number of removed elements.
+     */
+    std::size_t erase(const T &value) {
+        return eraseIf([&value](const T &element) { return element == value; });
+    }
+
+    /**
+     * @brief Removes every element that satisfies a predicate.
+     *
+     * Only the chunks holding removed elements are copied or changed.
+     *
+     * @param predicate Function taking a const reference to an element and returning true if it must be removed.
+     * @return The number of removed elements.
+     */
+    template <typename Predicate>
+    std::size_t eraseIf(Predicate predicate) {
+        std::size_t removed = 0;
+
+        for (std::size_t chunkIndex = 0; chunkIndex < chunks.size();) {
+            std::size_t offset = 0;
+            while (offset < chunks[chunkIndex]->size() && !predicate((*chunks[chunkIndex])[offset])) offset++;
+
+            if (offset == chunks[chunkIndex]->size()) {
+                chunkIndex++;
+                continue;
+            }
+
+            // The same index now holds the rest of the chunk, or the next chunk if this one was dropped.
+            eraseFromChunk(chunkIndex, offset);
+            removed++;
+        }
+
+        return removed;
+    }
+
+    /**
+     * @brief Removes the element at a position.
+     *
+     * @param index The position, which must be less than size().
+     */
+    void eraseAt(std::size_t index) {
+        for (std::size_t chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++) {
+            if (index < chunks[chunkIndex]->size()) {
+                eraseFromChunk(chunkIndex, index);
+                return;
+            }
+            index -= chunks[chunkIndex]->size();
+        }
+    }
+
+    /**
+     * @brief Calls a function for every element in order.
+     *
+     * @param function Function taking a const reference to an element.
+     */
+    template <typename Function>
+    void forEach(Function function) const {
+        for (const auto &chunk : chunks) {
+            for (const T &value : *chunk) {
+                function(value);
+            }
+        }
+    }
+
+    /**
+     * @brief Copies the elements into a vector.
+     *
+     * @return The elements in order.
+     */
+    [[nodiscard]] std::vector<T> toVector() const {
+        std::vector<T> result;
+        result.reserve(count);
+        forEach([&result](const T &value) { result.push_back(value); });
+        return result;
+    }
+};
+
+
+
+#endif //PERSISTENTVECTOR_H
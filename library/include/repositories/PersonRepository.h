@@ -2,9 +2,18 @@
 #define PERSONREPOSITORY_H
 
 #include "model/Person.h"
+#include "repositories/PersistentVector.h"
+#include "repositories/ShardedView.h"
+#include "repositories/Sharding.h"
+#include "repositories/SnapshotCell.h"
 #include "typedefs.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
+#include <shared_mutex>
+#include <unordered_map>
 
 
 /**
@@ -14,18 +23,67 @@
  * a collection of persons (e.g., teachers or students). It supports operations such as
  * adding and removing persons, finding persons by ID or custom criteria, and querying
  * the size of the collection.
+ *
+ * The repository is safe to use from several threads. The persons are partitioned by a hash of
+ * their ID into shards, each with its own lock, ID index and snapshot, so changes to persons in
+ * different shards run in parallel, and a lookup by ID only locks the shard of the ID. Walks over
+ * the whole collection (findBy(), findAll() and reports) read an immutable ShardedView made of
+ * snapshots of every shard instead: the persons of a shard are kept in a PersistentVector, and a
+ * snapshot shares its chunks with the live shard. A walk therefore holds no lock and never delays a
+ * writer, however long it takes, and still sees the persons in insertion order. The stored Person
+ * objects themselves are not synchronized.
  */
 class PersonRepository {
+public:
+    using Snapshot = ShardedView<PersonPtr>; /**< Immutable view of the stored persons. */
+
 private:
-    std::vector<PersonPtr> persons; /**< Collection of shared pointers to Person objects. */
+    /**
+     * @brief The persons whose IDs hash to one shard.
+     */
+    struct Shard {
+        Snapshot::Part persons; /**< Shared pointers to Person objects, in insertion order. */
+        std::unordered_map<int, PersonPtr> personsById; /**< Index of the persons by ID; the first person added with an ID wins. */
+        mutable std::shared_mutex mutex; /**< Shared for lookups, exclusive for changes. */
+        std::atomic<std::uint64_t> version{0}; /**< Number of changes made to the shard so far. */
+        mutable SnapshotCell<Snapshot::Part> snapshots; /**< Latest published snapshot of persons. */
+    };
+
+    std::vector<Shard> shards; /**< The shards; never resized, since a Shard cannot be moved. */
+    std::atomic<std::uint64_t> sequence{0}; /**< Sequence number given to the next added person. */
+
+    /**
+     * @brief Gets the shard of a person ID.
+     *
+     * @param id The ID.
+     * @return The shard.
+     */
+    Shard& shardOf(int id);
+
+    /**
+     * @brief Gets the shard of a person ID.
+     *
+     * @param id The ID.
+     * @return The shard.
+     */
+    [[nodiscard]] const Shard& shardOf(int id) const;
+
+    /**
+     * @brief Stores a person; the caller holds the exclusive lock of its shard.
+     *
+     * @param shard The shard of the person.
+     * @param person Shared pointer to the Person to add.
+     * @param number The sequence number of the person.
+     */
+    static void insert(Shard &shard, const PersonPtr& person, std::uint64_t number);
 
 public:
     /**
-     * @brief Default constructor.
+     * @brief Constructs an empty PersonRepository.
      *
-     * Initializes an empty PersonRepository.
+     * @param shardsCount The number of shards (at least 1).
      */
-    PersonRepository() = default;
+    explicit PersonRepository(std::size_t shardsCount = Sharding::defaultShardsCount);
 
     /**
      * @brief Default destructor.
@@ -52,6 +110,16 @@ public:
      */
     void add(const PersonPtr& person);
 
+    /**
+     * @brief Adds a batch of persons to the repository.
+     *
+     * Splits the batch by shard, reserves room in every shard at once and then adds every person as
+     * add() does, locking each shard only once; null pointers are skipped.
+     *
+     * @param newPersons The persons to add.
+     */
+    void addAll(const std::vector<PersonPtr>& newPersons);
+
     /**
      * @brief Gets the number of persons in the repository.
      *
@@ -62,7 +130,8 @@ public:
     /**
      * @brief Finds a person by their unique ID.
      *
-     * Searches the repository for a person with the specified ID.
+     * Looks the person up in the ID index in constant average time. The ID of a stored person
+     * must not be changed with Person::setId().
      *
      * @param id The unique ID of the person to find.
      * @return A shared pointer to the found Person, or nullptr if no matching person is found.
@@ -72,10 +141,12 @@ public:
     /**
      * @brief Finds persons that satisfy a given predicate.
      *
-     * Searches the repository for persons that match the specified predicate function.
+     * Searches the repository for persons that match the specified predicate function. The shards
+     * of a large repository are searched in parallel, so the predicate may be called from several
+     * threads at once.
      *
      * @param predicate A function that takes a PersonPtr and returns true if the person matches the criteria.
-     * @return A vector of shared pointers to Person objects that satisfy the predicate.
+     * @return A vector of shared pointers to Person objects that satisfy the predicate, in insertion order.
      */
     [[nodiscard]] std::vector<PersonPtr> findBy(const PersonPredicate& predicate) const;
 
@@ -85,6 +156,19 @@ public:
      * @return A vector of shared pointers to all Person objects.
      */
     [[nodiscard]] std::vector<PersonPtr> findAll() const;
+
+    /**
+     * @brief Gets an immutable snapshot of the stored persons.
+     *
+     * Takes the snapshot of every shard: lock-free for a shard whose snapshot of its current
+     * version is already published; otherwise under the shared lock of the shard, which costs
+     * O(n / PersistentVector::chunkCapacity). Later changes to the repository are not visible in
+     * the snapshot. Shards are captured one after another, so a change made meanwhile may be seen
+     * in one shard and not yet in another.
+     *
+     * @return Shared pointer to the snapshot.
+     */
+    [[nodiscard]] std::shared_ptr<const Snapshot> snapshot() const;
 };
 
 
@@ -0,0 +1,219 @@
+#ifndef SHARDEDVIEW_H
+#define SHARDEDVIEW_H
+
+#include "repositories/PersistentVector.h"
+#include "repositories/Sharding.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Immutable view of a sequence split over the shards of a repository.
+ *
+ * A sharded repository stores every element together with a sequence number taken from one
+ * counter when the element is added. Each shard keeps its elements in insertion order, so a walk
+ * that repeatedly takes the element with the lowest sequence number among the heads of all shards
+ * (a k-way merge) visits the elements in the order in which they were added to the repository,
+ * exactly as an unsharded repository would.
+ *
+ * The view holds snapshots of the shards and never changes; it may be used from any thread.
+ *
+ * @tparam T The element type.
+ */
+template <typename T>
+class ShardedView {
+public:
+    /**
+     * @brief An element and its position in the insertion order of the repository.
+     */
+    struct Entry {
+        std::uint64_t sequence; /**< Position of the element in the insertion order. */
+        T value; /**< The element. */
+    };
+
+    using Part = PersistentVector<Entry>; /**< Contents of a single shard. */
+
+private:
+    std::vector<std::shared_ptr<const Part>> parts; /**< Snapshots of the shards. */
+    std::size_t count = 0; /**< Total number of elements. */
+
+    /**
+     * @brief Walks the entries of several parts in sequence order.
+     *
+     * @param sources The parts to walk.
+     * @param function Function taking a const reference to an entry and returning false to stop the walk.
+     */
+    template <typename Function>
+    static void walk(const std::vector<const Part*> &sources, Function function) {
+        struct Cursor {
+            const Part *part; /**< The part. */
+            std::size_t chunk; /**< Index of the current chunk. */
+            std::size_t offset; /**< Position of the current entry in the chunk. */
+        };
+
+        std::vector<Cursor> cursors;
+        cursors.reserve(sources.size());
+        for (const Part *source : sources) {
+            if (!source->empty()) cursors.push_back({source, 0, 0});
+        }
+
+        while (!cursors.empty()) {
+            std::size_t lowest = 0;
+            for (std::size_t i = 1; i < cursors.size(); i++) {
+                if (cursors[i].part->chunk(cursors[i].chunk)[cursors[i].offset].sequence <
+                    cursors[lowest].part->chunk(cursors[lowest].chunk)[cursors[lowest].offset].sequence) {
+                    lowest = i;
+                }
+            }
+
+            Cursor &cursor = cursors[lowest];
+            if (!function(cursor.part->chunk(cursor.chunk)[cursor.offset])) return;
+
+            if (++cursor.offset == cursor.part->chunk(cursor.chunk).size()) {
+                cursor.offset = 0;
+                if (++cursor.chunk == cursor.part->chunksCount()) {
+                    cursor = cursors.back();
+                    cursors.pop_back();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Gets raw pointers to the parts, as walk() takes them.
+     *
+     * @return Pointers to the parts.
+     */
+    [[nodiscard]] std::vector<const Part*> sources() const {
+        std::vector<const Part*> result;
+        result.reserve(parts.size());
+        for (const auto &part : parts) {
+            result.push_back(part.get());
+        }
+        return result;
+    }
+
+public:
+    /**
+     * @brief Constructs an empty view.
+     */
+    ShardedView() = default;
+
+    /**
+     * @brief Constructs a view of shard snapshots.
+     *
+     * @param parts Snapshots of the shards; none may be null.
+     */
+    explicit ShardedView(std::vector<std::shared_ptr<const Part>> parts) : parts(std::move(parts)) {
+        for (const auto &part : this->parts) {
+            count += part->size();
+        }
+    }
+
+    /**
+     * @brief Gets the number of elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief Checks whether there are no elements.
+     *
+     * @return True if the view is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const {
+        return count == 0;
+    }
+
+    /**
+     * @brief Calls a function for every element in insertion order.
+     *
+     * @param function Function taking a const reference to an element.
+     */
+    template <typename Function>
+    void forEach(Function function) const {
+        if (parts.size() == 1) {
+            parts.front()->forEach([&function](const Entry &entry) { function(entry.value); });
+            return;
+        }
+
+        walk(sources(), [&function](const Entry &entry) {
+            function(entry.value);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Gets the element at a position of the insertion order.
+     *
+     * Walks the elements up to the position, which costs O(index * number of shards).
+     *
+     * @param index The position, which must be less than size().
+     * @return Copy of the element.
+     */
+    [[nodiscard]] T at(std::size_t index) const {
+        T result{};
+        walk(sources(), [&index, &result](const Entry &entry) {
+            if (index-- > 0) return true;
+            result = entry.value;
+            return false;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Copies the elements into a vector.
+     *
+     * @return The elements in insertion order.
+     */
+    [[nodiscard]] std::vector<T> toVector() const {
+        std::vector<T> result;
+        result.reserve(count);
+        forEach([&result](const T &value) { result.push_back(value); });
+        return result;
+    }
+
+    /**
+     * @brief Finds the elements that satisfy a predicate.
+     *
+     * Every shard is searched separately, in parallel if the view holds at least
+     * Sharding::parallelThreshold elements, and the matches are merged back into insertion order.
+     *
+     * @param predicate Function taking a const reference to an element; it may be called from several threads at once.
+     * @return The matching elements in insertion order.
+     */
+    template <typename Predicate>
+    [[nodiscard]] std::vector<T> select(const Predicate &predicate) const {
+        std::vector<Part> matches(parts.size());
+        Sharding::fanOut(parts.size(), count >= Sharding::parallelThreshold, [this, &predicate, &matches](const std::size_t shard) {
+            parts[shard]->forEach([&predicate, &matches, shard](const Entry &entry) {
+                if (predicate(entry.value)) matches[shard].pushBack(entry);
+            });
+        });
+
+        std::vector<const Part*> found;
+        std::size_t matched = 0;
+        for (const Part &part : matches) {
+            found.push_back(&part);
+            matched += part.size();
+        }
+
+        std::vector<T> result;
+        result.reserve(matched);
+        walk(found, [&result](const Entry &entry) {
+            result.push_back(entry.value);
+            return true;
+        });
+        return result;
+    }
+};
+
+
+
+#endif //SHARDEDVIEW_H
@@ -0,0 +1,60 @@
+#ifndef SHARDING_H
+#define SHARDING_H
+
+#include "concurrency/TaskPool.h"
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * @brief Helpers shared by the repositories that partition their contents into shards.
+ *
+ * A sharded repository keeps every element in the shard chosen by hashing its key, and each shard
+ * has its own lock, so writes to different shards do not wait for each other. Queries that need
+ * every shard run once per shard with fanOut() and merge the partial results.
+ */
+class Sharding {
+public:
+    static constexpr std::size_t defaultShardsCount = 16; /**< Number of shards of a repository unless its constructor is told otherwise. */
+    static constexpr std::size_t parallelThreshold = 1 << 14; /**< Smallest number of elements for which a query runs its shards in parallel. */
+
+    /**
+     * @brief Chooses the shard of a key.
+     *
+     * Uses Fibonacci hashing, so consecutive IDs are spread over all shards.
+     *
+     * @param key The key, such as a person or lesson ID.
+     * @param shardsCount The number of shards.
+     * @return The index of the shard.
+     */
+    [[nodiscard]] static std::size_t shardOf(const int key, const std::size_t shardsCount) {
+        return static_cast<std::size_t>(static_cast<std::uint32_t>(key) * 0x9E3779B97F4A7C15ull >> 32) % shardsCount;
+    }
+
+    /**
+     * @brief Calls a function once for every shard.
+     *
+     * In parallel mode the shards are spread over the threads of TaskPool::shared() and the calling
+     * thread; the function returns once all of them have finished. An exception thrown for any
+     * shard is rethrown.
+     *
+     * @param shardsCount The number of shards.
+     * @param parallel True to run the shards in parallel, false to run them one after another.
+     * @param function Function taking the index of a shard; it must be safe to call concurrently in parallel mode.
+     */
+    template <typename Function>
+    static void fanOut(const std::size_t shardsCount, const bool parallel, const Function &function) {
+        if (!parallel || shardsCount < 2) {
+            for (std::size_t shard = 0; shard < shardsCount; shard++) {
+                function(shard);
+            }
+            return;
+        }
+
+        TaskPool::shared().parallelFor(shardsCount, function);
+    }
+};
+
+
+
+#endif //SHARDING_H
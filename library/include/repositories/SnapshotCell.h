@@ -0,0 +1,64 @@
+#ifndef SNAPSHOTCELL_H
+#define SNAPSHOTCELL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+
+/**
+ * @brief Holds the latest published snapshot of a repository, tagged with its version.
+ *
+ * A repository counts its changes in a version number. Readers ask for the snapshot of the current
+ * version with get(), which only loads a shared pointer atomically and never takes the repository
+ * lock. If nothing is published for that version yet, the reader copies the contents under the
+ * shared lock (cheap for a PersistentVector) and publishes them, so writers pay nothing for
+ * snapshots that nobody reads.
+ *
+ * @tparam T The snapshot type.
+ */
+template <typename T>
+class SnapshotCell {
+private:
+    /**
+     * @brief A published snapshot and the version it belongs to.
+     */
+    struct Version {
+        std::uint64_t number; /**< Version number of the repository when the snapshot was taken. */
+        T value; /**< The snapshot. */
+    };
+
+    std::atomic<std::shared_ptr<const Version>> published; /**< Latest snapshot. */
+
+public:
+    /**
+     * @brief Gets the published snapshot if it belongs to a given version.
+     *
+     * @param number The current version number.
+     * @return Shared pointer to the snapshot, or nullptr if the published snapshot is missing or older.
+     */
+    [[nodiscard]] std::shared_ptr<const T> get(const std::uint64_t number) const {
+        const std::shared_ptr<const Version> current = published.load();
+        if (current == nullptr || current->number != number) return nullptr;
+
+        return std::shared_ptr<const T>(current, &current->value);
+    }
+
+    /**
+     * @brief Publishes a copy of the contents as the snapshot of a version.
+     *
+     * @param number The version number of the contents.
+     * @param value The contents to copy.
+     * @return Shared pointer to the published snapshot.
+     */
+    std::shared_ptr<const T> publish(const std::uint64_t number, const T &value) {
+        const auto fresh = std::make_shared<const Version>(Version{number, value});
+        published.store(fresh);
+
+        return std::shared_ptr<const T>(fresh, &fresh->value);
+    }
+};
+
+
+
+#endif //SNAPSHOTCELL_H
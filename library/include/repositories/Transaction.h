@@ -0,0 +1,107 @@
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include "repositories/VersionTable.h"
+#include "typedefs.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief A group of changes to persons, classrooms and lessons that is applied all at once or not at all.
+ *
+ * A Transaction is used in three steps:
+ * 1. read() every entity whose state the changes depend on or modify, before looking at that state;
+ * 2. stage() the changes, which are only recorded;
+ * 3. commit() them, or abort().
+ *
+ * Concurrency control is optimistic: nothing is locked until commit(), which applies the staged
+ * changes only if none of the read entities was changed by another transaction in the meantime
+ * (see VersionTable). On a conflict nothing is applied and the caller starts a new transaction,
+ * reading the current state again. Changes made outside transactions are not detected.
+ *
+ * A Transaction is used by one thread; separate transactions may run on separate threads.
+ */
+class Transaction {
+public:
+    /**
+     * @brief The state of a transaction.
+     */
+    enum class State {
+        Open, /**< Accepting reads and changes. */
+        Committed, /**< The changes were applied. */
+        Aborted /**< The changes were dropped, by abort() or because of a conflict. */
+    };
+
+private:
+    VersionTablePtr versions; /**< Shared pointer to the table of entity versions. */
+    std::vector<std::pair<VersionTable::Key, std::uint64_t>> readSet; /**< Entities read so far and the versions they had. */
+    std::vector<std::function<void()>> changes; /**< Staged changes in order. */
+    State state = State::Open; /**< The state of the transaction. */
+
+public:
+    /**
+     * @brief Begins a transaction.
+     *
+     * @param versions Shared pointer to the table of entity versions.
+     */
+    explicit Transaction(VersionTablePtr versions);
+
+    /**
+     * @brief Default destructor; a transaction that was not committed is dropped.
+     */
+    ~Transaction() = default;
+
+    Transaction(Transaction &&) = default;
+    Transaction& operator=(Transaction &&) = default;
+
+    /**
+     * @brief Records the current version of an entity.
+     *
+     * Reading an entity again keeps the version recorded first. State that committed transactions
+     * change, such as the students of a lesson, is safely copied by an inspect function: it runs
+     * while no commit can change the entity, and a later change makes this transaction conflict.
+     *
+     * @param kind The kind of the entity.
+     * @param id The ID of a person or lesson, or the number of a classroom.
+     * @param inspect If set, copies state of the entity; it runs even if the entity was read before.
+     */
+    void read(VersionTable::Kind kind, int id, const std::function<void()> &inspect = nullptr);
+
+    /**
+     * @brief Records a change to apply on commit.
+     *
+     * @param change Applies the change; it must only modify entities passed to read().
+     * @return 0 on success, 1 if the transaction is not open.
+     */
+    int stage(std::function<void()> change);
+
+    /**
+     * @brief Applies the staged changes in order.
+     *
+     * @return 0 if the changes were applied, 1 if another transaction changed a read entity and nothing was applied,
+     *         2 if the transaction is not open.
+     */
+    int commit();
+
+    /**
+     * @brief Drops the staged changes.
+     *
+     * @return 0 on success, 1 if the transaction is not open.
+     */
+    int abort();
+
+    /**
+     * @brief Gets the state of the transaction.
+     *
+     * @return The state.
+     */
+    [[nodiscard]] State getState() const;
+};
+
+
+
+#endif //TRANSACTION_H
@@ -0,0 +1,121 @@
+#ifndef VERSIONTABLE_H
+#define VERSIONTABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Version numbers of the persons, classrooms and lessons changed by transactions.
+ *
+ * The VersionTable class backs the optimistic concurrency control of Transaction. Every entity is
+ * identified by a Key (its kind and its ID or number) and has a version number, 0 until the first
+ * transaction changing it commits. A transaction remembers the versions of the entities it reads;
+ * commit() locks the stripes holding those entities, checks that none of the versions has moved
+ * and only then applies the changes and advances the versions. Transactions on disjoint entities
+ * lock disjoint stripes (unless two keys happen to share one) and commit in parallel.
+ *
+ * Versions of entities removed from the repositories are kept, so a transaction that read a
+ * removed lesson still detects the removal.
+ */
+class VersionTable {
+public:
+    static constexpr std::size_t stripesCount = 64; /**< Number of independently locked stripes. */
+
+    /**
+     * @brief The kind of an entity.
+     */
+    enum class Kind : std::uint8_t {
+        Person, /**< A person, identified by its ID. */
+        ClassRoom, /**< A classroom, identified by its number. */
+        Lesson /**< A lesson, identified by its ID. */
+    };
+
+    /**
+     * @brief Identifies an entity.
+     */
+    struct Key {
+        Kind kind; /**< The kind of the entity. */
+        int id; /**< The ID of a person or lesson, or the number of a classroom. */
+
+        bool operator==(const Key &other) const { return kind == other.kind && id == other.id; }
+    };
+
+private:
+    /**
+     * @brief A part of the table guarded by its own mutex.
+     */
+    struct Stripe {
+        std::mutex mutex; /**< Guards versions. */
+        std::unordered_map<std::uint64_t, std::uint64_t> versions; /**< Versions by packed key; missing keys are at version 0. */
+    };
+
+    std::array<Stripe, stripesCount> stripes; /**< The stripes. */
+    std::atomic<long> conflicts{0}; /**< Number of commits rejected so far. */
+
+    /**
+     * @brief Packs a key into one integer.
+     *
+     * @param key The key.
+     * @return The packed key.
+     */
+    static std::uint64_t pack(const Key &key);
+
+    /**
+     * @brief Gets the index of the stripe holding a key.
+     *
+     * @param key The key.
+     * @return The stripe index.
+     */
+    static std::size_t stripeOf(const Key &key);
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Initializes a table with every entity at version 0.
+     */
+    VersionTable() = default;
+
+    VersionTable(const VersionTable &) = delete;
+    VersionTable& operator=(const VersionTable &) = delete;
+
+    /**
+     * @brief Gets the current version of an entity.
+     *
+     * @param key The entity.
+     * @param inspect If set, runs with the entity's stripe locked, so it sees the entity as of the
+     *        returned version and never in the middle of a commit changing it.
+     * @return The version number.
+     */
+    [[nodiscard]] std::uint64_t read(const Key &key, const std::function<void()> &inspect = nullptr);
+
+    /**
+     * @brief Applies changes if no entity read by a transaction has changed since it was read.
+     *
+     * Locks the stripes of every entity in ascending order, so concurrent commits cannot deadlock,
+     * validates the versions, runs apply and advances the version of every entity by one.
+     *
+     * @param readSet The entities read by the transaction and the versions they had, without duplicates.
+     * @param apply Applies the changes; runs with the stripes locked and must not commit another transaction.
+     * @return True if the changes were applied, false if some version had moved and nothing was applied.
+     */
+    bool commit(const std::vector<std::pair<Key, std::uint64_t>> &readSet, const std::function<void()> &apply);
+
+    /**
+     * @brief Gets the number of commits rejected because of a conflict.
+     *
+     * @return The number of conflicts since the table was created.
+     */
+    [[nodiscard]] long getConflicts() const;
+};
+
+
+
+#endif //VERSIONTABLE_H
@@ -28,12 +28,23 @@ public:
      */
     ~ClassRoomFilesStorage() = default;
 
+    static constexpr const char *databaseFile = "./../../database/classrooms/Classroom.txt"; /**< File holding the stored classrooms. */
+
+    /**
+     * @brief Serializes all classrooms of a repository into the contents of the database file.
+     *
+     * @param classRoomRepo Shared pointer to the ClassRoomRepository containing the classrooms.
+     * @return The contents, one line of attributes per element.
+     */
+    [[nodiscard]] static std::string serialize(const ClassRoomRepositoryPtr& classRoomRepo);
+
     /**
      * @brief Saves all classrooms from a repository to a file.
      *
      * Writes the attributes of all classrooms in the repository to a text file located at
      * "./../../database/classrooms/Classroom.txt". Each classroom's attributes are written
-     * on a new line.
+     * on a new line. The file is replaced as a whole with Flusher::writeFile(), so it is never left
+     * half written.
      *
      * @param classRoomRepo Shared pointer to the ClassRoomRepository containing the classrooms to save.
      * @return True if the save operation is successful, throws a std::runtime_error if the file cannot be opened.
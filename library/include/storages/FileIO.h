@@ -0,0 +1,111 @@
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include "typedefs.h"
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+
+/**
+ * @brief Asynchronous whole-file reads and writes.
+ *
+ * Every operation returns at once and reports its result to a callback, which runs on a thread
+ * of the implementation once the data has been transferred; a callback should be short and may
+ * start further operations. The future-returning helpers wrap the callbacks for callers that
+ * would rather wait.
+ *
+ * create() picks the fastest implementation available: UringFileIO, which hands the transfers to
+ * the kernel through io_uring, or ThreadPoolFileIO, which runs blocking pread()/pwrite() calls on
+ * a TaskPool.
+ */
+class FileIO {
+public:
+    using WriteCallback = std::function<void(bool)>; /**< Receives true if the write succeeded. */
+    using ReadCallback = std::function<void(bool, std::string)>; /**< Receives true and the contents if the read succeeded. */
+
+    /**
+     * @brief Default destructor.
+     *
+     * Ensures proper cleanup of derived classes.
+     */
+    virtual ~FileIO() = default;
+
+    /**
+     * @brief Replaces the contents of a file.
+     *
+     * Writes the contents to the file name followed by ".tmp" and renames that file over the
+     * target, so the file is never left half written.
+     *
+     * @param fileName The name of the file.
+     * @param contents The new contents.
+     * @param done Called with the result.
+     */
+    virtual void submitReplace(const std::string &fileName, std::string contents, WriteCallback done) = 0;
+
+    /**
+     * @brief Appends to a file, creating it if needed.
+     *
+     * Appends to the same file are not ordered against each other; a caller that needs an order
+     * starts the next one from the callback of the previous one.
+     *
+     * @param fileName The name of the file.
+     * @param contents The data to append.
+     * @param done Called with the result.
+     */
+    virtual void submitAppend(const std::string &fileName, std::string contents, WriteCallback done) = 0;
+
+    /**
+     * @brief Reads a whole file.
+     *
+     * @param fileName The name of the file.
+     * @param done Called with the result and the contents.
+     */
+    virtual void submitRead(const std::string &fileName, ReadCallback done) = 0;
+
+    /**
+     * @brief Gets the name of the implementation.
+     *
+     * @return "io_uring" or "thread pool".
+     */
+    [[nodiscard]] virtual std::string getName() const = 0;
+
+    /**
+     * @brief Replaces the contents of a file, as submitReplace() does.
+     *
+     * @param fileName The name of the file.
+     * @param contents The new contents.
+     * @return Future of the result.
+     */
+    std::future<bool> replace(const std::string &fileName, std::string contents);
+
+    /**
+     * @brief Appends to a file, as submitAppend() does.
+     *
+     * @param fileName The name of the file.
+     * @param contents The data to append.
+     * @return Future of the result.
+     */
+    std::future<bool> append(const std::string &fileName, std::string contents);
+
+    /**
+     * @brief Reads a whole file, as submitRead() does.
+     *
+     * @param fileName The name of the file.
+     * @return Future of the contents; holds a std::runtime_error if the file could not be read.
+     */
+    std::future<std::string> read(const std::string &fileName);
+
+    /**
+     * @brief Creates the fastest implementation available.
+     *
+     * @param taskPool Shared pointer to the pool used by ThreadPoolFileIO if io_uring is not available.
+     * @return Shared pointer to a UringFileIO if the kernel supports io_uring, to a ThreadPoolFileIO otherwise.
+     */
+    static FileIOPtr create(const TaskPoolPtr &taskPool);
+};
+
+
+
+#endif //FILEIO_H
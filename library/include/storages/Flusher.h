@@ -0,0 +1,181 @@
+#ifndef FLUSHER_H
+#define FLUSHER_H
+
+#include "typedefs.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Writes files in the background.
+ *
+ * A caller hands over the complete contents of a file, serialized while its data was consistent,
+ * or a piece of data to append to a file, and gets a future at once. The writes are done by a
+ * FileIO. Each file has one write in flight at a time, so writes to the same file happen in the
+ * order they were queued and never interleave, while different files are written in parallel.
+ * When contents for a file arrive while an older replacement of it is still waiting, only the
+ * newer contents are written and both callers share its future; appends are never merged. A file
+ * is written to a temporary file next to it and then renamed over it, so a crash leaves either
+ * the old or the new file, never a partial one.
+ *
+ * The destructor waits for every outstanding write.
+ */
+class Flusher {
+private:
+    /**
+     * @brief Contents waiting to be written to a file.
+     */
+    struct Pending {
+        bool append = false; /**< Indicates whether contents are appended to the file instead of replacing it. */
+        std::string contents; /**< The complete new contents of the file, or the data to append. */
+        std::promise<bool> promise; /**< Fulfilled with the result of the write. */
+        std::shared_future<bool> result; /**< Future of promise, handed to every caller of the write. */
+        std::vector<std::function<void(bool)>> callbacks; /**< Called with the result once the write finishes. */
+    };
+
+    /**
+     * @brief State of the writes to one file.
+     */
+    struct File {
+        std::shared_ptr<Pending> writing; /**< The write in flight, or nullptr. */
+        std::deque<std::shared_ptr<Pending>> pending; /**< Writes waiting for the one in flight, oldest first. */
+    };
+
+    FileIOPtr fileIO; /**< Performs the writes. */
+    mutable std::mutex mutex; /**< Guards files and the counters. */
+    std::condition_variable drained; /**< Wakes waitAll() when the last outstanding write finishes. */
+    std::unordered_map<std::string, File> files; /**< Write state of every file ever flushed, by name. */
+    std::size_t outstanding = 0; /**< Number of writes queued or running. */
+    std::uint64_t written = 0; /**< Number of successful writes. */
+    std::uint64_t coalesced = 0; /**< Number of flushes replaced by newer contents before being written. */
+    std::uint64_t failed = 0; /**< Number of failed writes. */
+
+    /**
+     * @brief Queues a write of a file, starting it if no write of the file is in flight.
+     *
+     * @param fileName The name of the file.
+     * @param contents The contents.
+     * @param append True to append the contents, false to replace the file with them.
+     * @return Future of the result of the write.
+     */
+    std::shared_future<bool> enqueue(const std::string &fileName, std::string contents, bool append);
+
+    /**
+     * @brief Hands a write to the FileIO.
+     *
+     * @param fileName The name of the file.
+     * @param pending The write.
+     */
+    void start(const std::string &fileName, const std::shared_ptr<Pending> &pending);
+
+    /**
+     * @brief Records the result of a write and starts the next write of the file.
+     *
+     * @param fileName The name of the file.
+     * @param pending The finished write.
+     * @param saved True if the write succeeded.
+     */
+    void finish(const std::string &fileName, const std::shared_ptr<Pending> &pending, bool saved);
+
+public:
+    /**
+     * @brief Constructs a Flusher.
+     *
+     * @param fileIO Shared pointer to the FileIO performing the writes; must not be null.
+     */
+    explicit Flusher(FileIOPtr fileIO);
+
+    /**
+     * @brief Waits for every outstanding write.
+     */
+    ~Flusher();
+
+    /**
+     * @brief Queues new contents of a file.
+     *
+     * @param fileName The name of the file.
+     * @param contents The complete new contents of the file.
+     * @return Future of the result of the write: true if the file was written, false otherwise.
+     */
+    std::shared_future<bool> flush(const std::string &fileName, std::string contents);
+
+    /**
+     * @brief Queues data to append to a file.
+     *
+     * @param fileName The name of the file.
+     * @param contents The data to append.
+     * @return Future of the result of the write: true if the data was appended, false otherwise.
+     */
+    std::shared_future<bool> append(const std::string &fileName, std::string contents);
+
+    /**
+     * @brief Calls a function once every write of a file queued so far has finished.
+     *
+     * Lets a caller wait for a write without blocking a thread. The function runs on the thread
+     * finishing the write, or at once on the calling thread when no write of the file is queued.
+     *
+     * @param fileName The name of the file.
+     * @param done Called with the result of the last of those writes, or true if there were none.
+     */
+    void whenWritten(const std::string &fileName, std::function<void(bool)> done);
+
+    /**
+     * @brief Waits until every write queued so far has finished.
+     *
+     * Must not be called from a callback of the FileIO of the Flusher.
+     */
+    void waitAll();
+
+    /**
+     * @brief Gets the number of writes queued or running.
+     *
+     * @return The number of outstanding writes.
+     */
+    [[nodiscard]] std::size_t getOutstanding() const;
+
+    /**
+     * @brief Gets the number of successful writes.
+     *
+     * @return The number of writes.
+     */
+    [[nodiscard]] std::uint64_t getWritten() const;
+
+    /**
+     * @brief Gets the number of flushes whose contents were replaced by newer ones before being written.
+     *
+     * @return The number of coalesced flushes.
+     */
+    [[nodiscard]] std::uint64_t getCoalesced() const;
+
+    /**
+     * @brief Gets the number of failed writes.
+     *
+     * @return The number of failures.
+     */
+    [[nodiscard]] std::uint64_t getFailed() const;
+
+    /**
+     * @brief Replaces the contents of a file.
+     *
+     * Writes the contents to the file name followed by ".tmp" and renames that file over the
+     * target.
+     *
+     * @param fileName The name of the file.
+     * @param contents The new contents.
+     * @return True if the file was replaced, false if it could not be written.
+     */
+    static bool writeFile(const std::string &fileName, const std::string &contents);
+};
+
+
+
+#endif //FLUSHER_H
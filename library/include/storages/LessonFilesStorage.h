@@ -2,6 +2,7 @@
 #define LESSONFILESTORAGE_H
 
 #include "typedefs.h"
+#include <string>
 
 
 /**
@@ -28,11 +29,24 @@ public:
      */
     ~LessonFilesStorage();
 
+    static constexpr const char *databaseFile = "./../../database/lessons/Lesson.txt"; /**< File holding the stored lessons and series. */
+    static constexpr const char *archiveFile = "./../../archive/lessons/Lesson.txt"; /**< File to which finished and removed lessons are appended. */
+
+    /**
+     * @brief Serializes all lessons and series of a repository into the contents of the database file.
+     *
+     * @param repository Shared pointer to the LessonRepository containing the lessons.
+     * @return The contents: one line of attributes per lesson, followed by one line per series.
+     */
+    [[nodiscard]] static std::string serialize(const LessonRepositoryPtr &repository);
+
     /**
      * @brief Saves all lessons from a repository to individual files.
      *
      * Writes the attributes of each lesson in the repository to a separate text file named
-     * "lesson-<ID>.txt", where <ID> is the lesson's unique ID.
+     * "lesson-<ID>.txt", where <ID> is the lesson's unique ID. Lesson series follow the lessons,
+     * one line per series regardless of the number of occurrences. The file is replaced as a whole
+     * with Flusher::writeFile(), so it is never left half written.
      *
      * @param repository Shared pointer to the LessonRepository containing the lessons to save.
      * @return True if the save operation is successful, throws a std::runtime_error if a file cannot be opened.
@@ -43,8 +57,9 @@ public:
      * @brief Loads lessons from a file into a repository.
      *
      * Reads lesson data from "./../../database/lessons/Lesson.txt", parses each line to create
-     * Lesson objects (either IndividualLesson or GroupLesson with appropriate ClassRoomType subclasses),
-     * and adds them to the provided repository. Skips empty lines and logs errors for parsing failures.
+     * Lesson objects (either IndividualLesson or GroupLesson with appropriate ClassRoomType subclasses)
+     * and LessonSeries objects, and adds them to the provided repository. Skips empty lines and logs errors for parsing failures.
+     * Lessons expanded from a series are linked to the series as loaded, which gets a new ID.
      *
      * @param repository Shared pointer to the LessonRepository to populate with loaded lessons.
      * @return True if the load operation is successful or the file is empty, throws a std::runtime_error if the file cannot be opened.
@@ -64,6 +79,17 @@ public:
      */
     static void saveArchive(const LessonRepositoryPtr& lessonRepo, int id) ;
 
+    /**
+     * @brief Saves a single lesson to the archive file.
+     *
+     * Appends the attributes of the lesson to the archive file, as the overload taking an ID does;
+     * the lesson need not be stored in any repository any more.
+     *
+     * @param lesson Shared pointer to the lesson to archive.
+     * @throws std::runtime_error if the archive file cannot be opened.
+     */
+    static void saveArchive(const LessonPtr& lesson);
+
     /**
      * @brief Displays the contents of the lesson archive file.
      *
@@ -28,11 +28,22 @@ public:
      */
     ~PersonFilesStorage() = default;
 
+    static constexpr const char *databaseFile = "./../../database/students/Person.txt"; /**< File holding the stored persons. */
+
+    /**
+     * @brief Serializes all persons of a repository into the contents of the database file.
+     *
+     * @param personRepo Shared pointer to the PersonRepository containing the persons.
+     * @return The contents, one line of attributes per element.
+     */
+    [[nodiscard]] static std::string serialize(const PersonRepositoryPtr& personRepo);
+
     /**
      * @brief Saves all persons from a repository to a file.
      *
      * Writes the attributes of all persons in the repository to a text file located at
      * "./../../database/students/Person.txt". Each person's attributes are written on a new line.
+     * The file is replaced as a whole with Flusher::writeFile(), so it is never left half written.
      *
      * @param personRepo Shared pointer to the PersonRepository containing the persons to save.
      * @return True if the save operation is successful, throws a std::runtime_error if the file cannot be opened.
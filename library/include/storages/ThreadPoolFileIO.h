@@ -0,0 +1,56 @@
+#ifndef THREADPOOLFILEIO_H
+#define THREADPOOLFILEIO_H
+
+#include "storages/FileIO.h"
+
+
+/**
+ * @brief FileIO running blocking pread() and pwrite() calls on a TaskPool.
+ *
+ * Used where io_uring is not available. Every operation is one task of the pool, which does the
+ * whole transfer and then calls the callback, so an operation occupies a worker thread while the
+ * disk is busy.
+ */
+class ThreadPoolFileIO : public FileIO {
+private:
+    TaskPoolPtr taskPool; /**< Pool running the operations. */
+
+public:
+    /**
+     * @brief Constructs a ThreadPoolFileIO.
+     *
+     * @param taskPool Shared pointer to the pool running the operations; must not be null.
+     */
+    explicit ThreadPoolFileIO(TaskPoolPtr taskPool);
+
+    void submitReplace(const std::string &fileName, std::string contents, WriteCallback done) override;
+
+    void submitAppend(const std::string &fileName, std::string contents, WriteCallback done) override;
+
+    void submitRead(const std::string &fileName, ReadCallback done) override;
+
+    [[nodiscard]] std::string getName() const override;
+
+    /**
+     * @brief Writes a whole buffer to a file descriptor, retrying short and interrupted writes.
+     *
+     * @param fd The file descriptor.
+     * @param contents The data.
+     * @param append True to write at the end of the file, false to write from the start.
+     * @return True if every byte was written.
+     */
+    static bool writeAll(int fd, const std::string &contents, bool append);
+
+    /**
+     * @brief Reads a whole file from a file descriptor.
+     *
+     * @param fd The file descriptor.
+     * @param contents Receives the contents.
+     * @return True if the file was read to its end.
+     */
+    static bool readAll(int fd, std::string &contents);
+};
+
+
+
+#endif //THREADPOOLFILEIO_H
@@ -0,0 +1,137 @@
+#ifndef URINGFILEIO_H
+#define URINGFILEIO_H
+
+#include "storages/FileIO.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief FileIO handing the transfers to the kernel through io_uring.
+ *
+ * The reads and writes of every operation are queued on one submission ring and no thread waits
+ * for them: a single reaper thread collects the completions, queues the rest of a short transfer
+ * and calls the callback when an operation is done, so any number of files are in flight at once
+ * without a thread each. Opening, closing and renaming the files stay ordinary system calls,
+ * made by the submitting thread and the reaper; they touch only metadata and return quickly.
+ *
+ * The rings are set up with the raw system calls, so no library beyond the kernel headers is
+ * needed. create() returns nullptr where the kernel or the build lacks io_uring.
+ */
+class UringFileIO : public FileIO {
+private:
+    struct Operation;
+
+    static constexpr int maxSubmitRetries = 100; /**< Attempts to queue a transfer the kernel keeps refusing for want of room. */
+
+    int ringFd = -1; /**< File descriptor of the ring. */
+    int stopFd = -1; /**< eventfd the destructor writes to stop the reaper. */
+    void *submissionRing = nullptr; /**< Mapping of the submission ring. */
+    std::size_t submissionRingSize = 0; /**< Size of the mapping of the submission ring. */
+    void *completionRing = nullptr; /**< Mapping of the completion ring; the same as submissionRing when the kernel maps both at once. */
+    std::size_t completionRingSize = 0; /**< Size of the mapping of the completion ring. */
+    void *entries = nullptr; /**< Mapping of the submission queue entries. */
+    std::size_t entriesSize = 0; /**< Size of the mapping of the entries. */
+
+    unsigned *submissionTail = nullptr; /**< Tail of the submission ring, advanced by this process. */
+    unsigned *submissionMask = nullptr; /**< Mask turning a position into a submission ring index. */
+    unsigned *submissionArray = nullptr; /**< Indices of the queued entries. */
+    unsigned *completionHead = nullptr; /**< Head of the completion ring, advanced by the reaper. */
+    unsigned *completionTail = nullptr; /**< Tail of the completion ring, advanced by the kernel. */
+    unsigned *completionMask = nullptr; /**< Mask turning a position into a completion ring index. */
+    void *completions = nullptr; /**< The completion queue entries. */
+
+    std::mutex submitMutex; /**< Serializes the use of the submission ring. */
+    std::thread reaper; /**< Thread collecting the completions. */
+    std::mutex inFlightMutex; /**< Guards the waits on finished and drained. */
+    std::condition_variable finished; /**< Wakes the destructor when the last operation finishes. */
+    std::condition_variable drained; /**< Wakes submitters waiting for the reaper to collect completions. */
+    std::atomic<std::size_t> inFlight{0}; /**< Number of operations started and not finished. */
+    std::atomic<unsigned long> drains{0}; /**< Number of times the reaper has collected completions. */
+    std::vector<Operation*> retrying; /**< Transfers the kernel refused while the reaper queued them; used by the reaper only. */
+
+    /**
+     * @brief Constructs an empty UringFileIO; create() sets up the ring.
+     */
+    UringFileIO() = default;
+
+    /**
+     * @brief Sets up the ring and starts the reaper.
+     *
+     * @param queueDepth The number of submission queue entries.
+     * @return True if the kernel supports everything needed.
+     */
+    bool setUp(unsigned queueDepth);
+
+    /**
+     * @brief Opens the file of an operation and queues its first transfer.
+     *
+     * @param operation The operation; owned by the ring from now on.
+     */
+    void start(std::unique_ptr<Operation> operation);
+
+    /**
+     * @brief Queues the next transfer of an operation.
+     *
+     * A transfer refused with EAGAIN or EBUSY, which the kernel reports while its completion
+     * queue is full, is retried once the reaper has collected completions, up to maxSubmitRetries
+     * times. On the reaper thread it is put on retrying instead, since waiting there for the
+     * reaper would never end.
+     *
+     * @param operation The operation.
+     * @return True if the transfer was queued or put on retrying.
+     */
+    bool queue(Operation *operation);
+
+    /**
+     * @brief Handles the completion of a transfer, queueing the next one or finishing the operation.
+     *
+     * @param operation The operation.
+     * @param result The result of the transfer: a number of bytes or a negated error number.
+     */
+    void complete(Operation *operation, int result);
+
+    /**
+     * @brief Closes the file of an operation, renames a replaced file and calls the callback.
+     *
+     * @param operation The operation; deleted.
+     * @param succeeded True if every transfer succeeded.
+     */
+    void finish(Operation *operation, bool succeeded);
+
+    /**
+     * @brief Body of the reaper thread.
+     */
+    void reap();
+
+public:
+    /**
+     * @brief Waits for the operations in flight, stops the reaper and releases the ring.
+     */
+    ~UringFileIO() override;
+
+    /**
+     * @brief Creates a UringFileIO.
+     *
+     * @param queueDepth The number of submission queue entries.
+     * @return Shared pointer to the UringFileIO, or nullptr if io_uring is not available.
+     */
+    static std::shared_ptr<UringFileIO> create(unsigned queueDepth = 64);
+
+    void submitReplace(const std::string &fileName, std::string contents, WriteCallback done) override;
+
+    void submitAppend(const std::string &fileName, std::string contents, WriteCallback done) override;
+
+    void submitRead(const std::string &fileName, ReadCallback done) override;
+
+    [[nodiscard]] std::string getName() const override;
+};
+
+
+
+#endif //URINGFILEIO_H
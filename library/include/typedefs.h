@@ -13,6 +13,7 @@
 class Lesson;
 class IndividualLesson;
 class GroupLesson;
+class LessonSeries;
 class Person;
 class ClassRoom;
 class ClassRoomType;
@@ -25,9 +26,15 @@ class LessonFilesStorage;
 class PersonManager;
 class ClassRoomManager;
 class LessonManager;
+class LessonService;
 class LessonUI;
 class PersonUI;
 class ClassRoomUI;
+class CommandUI;
+class VersionTable;
+class TaskPool;
+class Flusher;
+class FileIO;
 
 /**
  * @brief Shared pointer alias for Lesson.
@@ -50,6 +57,13 @@ typedef std::shared_ptr<IndividualLesson> IndividualLessonPtr;
  */
 typedef std::shared_ptr<GroupLesson> GroupLessonPtr;
 
+/**
+ * @brief Shared pointer alias for LessonSeries.
+ *
+ * Represents a shared pointer to a LessonSeries object, a lesson repeated every few weeks.
+ */
+typedef std::shared_ptr<LessonSeries> LessonSeriesPtr;
+
 /**
  * @brief Shared pointer alias for Person.
  *
@@ -145,6 +159,13 @@ typedef std::shared_ptr<ClassRoomManager> ClassRoomManagerPtr;
  */
 typedef std::shared_ptr<LessonManager> LessonManagerPtr;
 
+/**
+ * @brief Shared pointer alias for LessonService.
+ *
+ * Represents a shared pointer to a LessonService object, used for handling lesson requests as coroutines.
+ */
+typedef std::shared_ptr<LessonService> LessonServicePtr;
+
 /**
  * @brief Shared pointer alias for LessonUI.
  *
@@ -169,29 +190,69 @@ typedef std::shared_ptr<PersonUI> PersonUIPtr;
  */
 typedef std::shared_ptr<ClassRoomUI> ClassRoomUIPtr;
 
+/**
+ * @brief Shared pointer alias for CommandUI.
+ *
+ * Represents a shared pointer to a CommandUI object, used for running command scripts
+ * against the managers.
+ */
+typedef std::shared_ptr<CommandUI> CommandUIPtr;
+
+/**
+ * @brief Shared pointer alias for VersionTable.
+ *
+ * Represents a shared pointer to a VersionTable object, shared by the transactions that change
+ * the same persons, classrooms and lessons.
+ */
+typedef std::shared_ptr<VersionTable> VersionTablePtr;
+
+/**
+ * @brief Shared pointer alias for TaskPool.
+ *
+ * Represents a shared pointer to a TaskPool object, used for running saves, archive writes and
+ * reports in the background.
+ */
+typedef std::shared_ptr<TaskPool> TaskPoolPtr;
+
+/**
+ * @brief Shared pointer alias for Flusher.
+ *
+ * Represents a shared pointer to a Flusher object, used for writing the database files in the
+ * background.
+ */
+typedef std::shared_ptr<Flusher> FlusherPtr;
+
+/**
+ * @brief Shared pointer alias for FileIO.
+ *
+ * Represents a shared pointer to a FileIO object, used for reading and writing files without
+ * blocking the calling thread.
+ */
+typedef std::shared_ptr<FileIO> FileIOPtr;
+
 /**
  * @brief Predicate function type for ClassRoom objects.
  *
- * Represents a function that takes a ClassRoomPtr and returns a boolean, used for filtering
+ * Represents a function that takes a ClassRoomPtr by const reference and returns a boolean, used for filtering
  * or searching classrooms based on specific criteria.
  */
-typedef std::function<bool(ClassRoomPtr)> ClassRoomPredicate;
+typedef std::function<bool(const ClassRoomPtr&)> ClassRoomPredicate;
 
 /**
  * @brief Predicate function type for Lesson objects.
  *
- * Represents a function that takes a LessonPtr and returns a boolean, used for filtering
+ * Represents a function that takes a LessonPtr by const reference and returns a boolean, used for filtering
  * or searching lessons based on specific criteria.
  */
-typedef std::function<bool(LessonPtr)> LessonPredicate;
+typedef std::function<bool(const LessonPtr&)> LessonPredicate;
 
 /**
  * @brief Predicate function type for Person objects.
  *
- * Represents a function that takes a PersonPtr and returns a boolean, used for filtering
+ * Represents a function that takes a PersonPtr by const reference and returns a boolean, used for filtering
  * or searching persons based on specific criteria.
  */
-typedef std::function<bool(PersonPtr)> PersonPredicate;
+typedef std::function<bool(const PersonPtr&)> PersonPredicate;
 
 
 
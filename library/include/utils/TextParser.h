@@ -0,0 +1,56 @@
+#ifndef TEXTPARSER_H
+#define TEXTPARSER_H
+
+#include <boost/date_time.hpp>
+#include <charconv>
+#include <string_view>
+
+/**
+ * @brief Namespace alias for boost::posix_time.
+ */
+namespace pt = boost::posix_time;
+
+
+/**
+ * @brief Strict parsers for the numbers and times typed in commands and import files.
+ *
+ * CommandUI and ImportManager both read values through this class, so a value is accepted by
+ * one entry point exactly when it is accepted by the other. A field must consist of the value
+ * alone: signs other than '-', surrounding spaces and trailing characters are rejected. The
+ * parsers use std::from_chars, which neither allocates, throws nor depends on the locale.
+ */
+class TextParser {
+public:
+    /**
+     * @brief Parses the whole of a text as a number.
+     *
+     * @tparam Number An integer or floating-point type.
+     * @param text The text.
+     * @param value Receives the number; unchanged if the text is rejected.
+     * @return True if the whole text is a number in the range of the type, false otherwise.
+     */
+    template <typename Number>
+    static bool parseNumber(const std::string_view text, Number &value) {
+        if (text.empty()) return false;
+
+        Number parsed;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        if (error != std::errc() || end != text.data() + text.size()) return false;
+
+        value = parsed;
+        return true;
+    }
+
+    /**
+     * @brief Parses "YYYY-MM-DD HH:MM" or "YYYY-MM-DD HH:MM:SS"; a 'T' may separate the date and the time.
+     *
+     * @param text The text.
+     * @param time Receives the time; unchanged if the text is rejected.
+     * @return True if the text is a valid time in one of the formats, false otherwise.
+     */
+    static bool parseTime(std::string_view text, pt::ptime &time);
+};
+
+
+
+#endif //TEXTPARSER_H
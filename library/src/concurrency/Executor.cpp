@@ -0,0 +1,75 @@
+#include "concurrency/Executor.h"
+#include <algorithm>
+
+
+namespace {
+    /** The loop running on the current thread, or nullptr outside any executor. */
+    thread_local void *currentLoop = nullptr;
+}
+
+
+void Executor::Loop::post(const std::coroutine_handle<> coroutine) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(coroutine);
+    }
+    wakeUp.notify_one();
+}
+
+void Executor::Loop::run() {
+    currentLoop = this;
+
+    while (true) {
+        std::coroutine_handle<> coroutine;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this] { return !ready.empty() || stopping; });
+            if (ready.empty()) return;
+
+            coroutine = ready.front();
+            ready.pop_front();
+        }
+        coroutine.resume();
+    }
+}
+
+
+Executor::Executor(const std::size_t loopsCount) {
+    for (std::size_t i = 0; i < std::max<std::size_t>(1, loopsCount); i++) {
+        loops.push_back(std::make_unique<Loop>());
+    }
+    for (const std::unique_ptr<Loop> &loop : loops) {
+        loop->thread = std::thread([loop = loop.get()] { loop->run(); });
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::unique_lock<std::mutex> lock(activeMutex);
+        finished.wait(lock, [this] { return active.load() == 0; });
+    }
+
+    for (const std::unique_ptr<Loop> &loop : loops) {
+        {
+            std::lock_guard<std::mutex> lock(loop->mutex);
+            loop->stopping = true;
+        }
+        loop->wakeUp.notify_one();
+        loop->thread.join();
+    }
+}
+
+void Executor::release() {
+    std::lock_guard<std::mutex> lock(activeMutex);
+    if (--active == 0) finished.notify_all();
+}
+
+std::size_t Executor::getLoopsCount() const {
+    return loops.size();
+}
+
+std::function<void(std::coroutine_handle<>)> Executor::resumer() {
+    if (currentLoop == nullptr) return [](const std::coroutine_handle<> coroutine) { coroutine.resume(); };
+
+    return [loop = static_cast<Loop*>(currentLoop)](const std::coroutine_handle<> coroutine) { loop->post(coroutine); };
+}
@@ -0,0 +1,202 @@
+#include "concurrency/TaskPool.h"
+#include <algorithm>
+#include <exception>
+
+
+namespace {
+    /** The pool whose worker runs on the current thread, or nullptr outside any pool. */
+    thread_local const TaskPool *currentPool = nullptr;
+    /** Index of the worker running on the current thread within currentPool. */
+    thread_local std::size_t currentWorker = 0;
+
+    /** Raises an atomic maximum to a value. */
+    template <typename T>
+    void raiseTo(std::atomic<T> &maximum, const T value) {
+        T current = maximum.load();
+        while (current < value && !maximum.compare_exchange_weak(current, value)) {
+        }
+    }
+}
+
+
+TaskPool::TaskPool(const std::size_t threadsCount) : workers(std::max<std::size_t>(1, threadsCount)) {
+    for (std::size_t index = 0; index < workers.size(); index++) {
+        workers[index].thread = std::thread([this, index] { work(index); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (Worker &worker : workers) {
+        worker.thread.join();
+    }
+}
+
+TaskPool& TaskPool::shared() {
+    static TaskPool pool;
+    return pool;
+}
+
+void TaskPool::post(std::function<void()> function) {
+    // Counted before it is queued, so that a worker taking it at once never sees queued drop below zero.
+    submitted++;
+    raiseTo(maxQueueDepth, ++queued);
+
+    Worker &worker = workers[currentPool == this ? currentWorker : nextWorker++ % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back({std::move(function), Clock::now()});
+    }
+
+    // A worker counts itself as sleeping before it checks queued, so either it sees the new task
+    // or this thread sees it sleeping; locking the mutex makes sure it is already waiting.
+    if (sleeping.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wakeUp.notify_one();
+    }
+}
+
+bool TaskPool::take(const std::size_t index, Task &task) {
+    {
+        Worker &own = workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            running++;
+            queued--;
+            return true;
+        }
+    }
+
+    for (std::size_t offset = 1; offset < workers.size(); offset++) {
+        Worker &victim = workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            running++;
+            queued--;
+            stolen++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskPool::run(Task &task) {
+    const Clock::time_point started = Clock::now();
+    const auto waited = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(started - task.submitted).count());
+    totalWaitNanoseconds += waited;
+    raiseTo(maxWaitNanoseconds, waited);
+
+    try {
+        task.function();
+    } catch (...) {
+        failed++;
+    }
+    task.function = nullptr;
+
+    totalRunNanoseconds += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count());
+    completed++;
+
+    if (--running == 0 && queued.load() == 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        idle.notify_all();
+    }
+}
+
+void TaskPool::work(const std::size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        Task task;
+        if (take(index, task)) {
+            run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping++;
+        wakeUp.wait(lock, [this] { return queued.load() > 0 || stopping; });
+        sleeping--;
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+void TaskPool::parallelFor(const std::size_t count, const std::function<void(std::size_t)> &function) {
+    if (count == 0) return;
+
+    struct Loop {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    const auto loop = std::make_shared<Loop>();
+
+    // A helper that starts after every index has been taken returns at once, without touching
+    // function, which is only guaranteed to live until this call returns.
+    const auto body = [loop, &function, count] {
+        for (std::size_t index = loop->next++; index < count; index = loop->next++) {
+            try {
+                function(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(loop->mutex);
+                if (!loop->error) loop->error = std::current_exception();
+            }
+
+            if (++loop->done == count) {
+                std::lock_guard<std::mutex> lock(loop->mutex);
+                loop->finished.notify_all();
+            }
+        }
+    };
+
+    const std::size_t helpers = std::min(count - 1, workers.size());
+    for (std::size_t i = 0; i < helpers; i++) {
+        post(body);
+    }
+    body();
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finished.wait(lock, [&loop, count] { return loop->done.load() == count; });
+    if (loop->error) std::rethrow_exception(loop->error);
+}
+
+void TaskPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idle.wait(lock, [this] { return queued.load() == 0 && running.load() == 0; });
+}
+
+std::size_t TaskPool::getThreadsCount() const {
+    return workers.size();
+}
+
+TaskPool::Statistics TaskPool::getStatistics() const {
+    Statistics statistics{};
+    statistics.threadsCount = workers.size();
+    statistics.submitted = submitted.load();
+    statistics.completed = completed.load();
+    statistics.stolen = stolen.load();
+    statistics.failed = failed.load();
+    statistics.queueDepth = queued.load();
+    statistics.maxQueueDepth = maxQueueDepth.load();
+
+    const std::uint64_t started = statistics.completed + running.load();
+    if (started > 0) statistics.averageWaitMicroseconds = static_cast<double>(totalWaitNanoseconds.load()) / 1000.0 / static_cast<double>(started);
+    if (statistics.completed > 0) {
+        statistics.averageRunMicroseconds = static_cast<double>(totalRunNanoseconds.load()) / 1000.0 / static_cast<double>(statistics.completed);
+    }
+    statistics.maxWaitMicroseconds = static_cast<double>(maxWaitNanoseconds.load()) / 1000.0;
+
+    return statistics;
+}
@@ -1,9 +1,9 @@
 #include "interfaces/ClassRoomUI.h"
-#include "model/EngClassRoom.h"
-#include "model/ITClassRoom.h"
-#include "model/MathClassRoom.h"
+#include "model/ClassRoomTypeFactory.h"
 #include "managers/ClassRoomManager.h"
 #include <iostream>
+#include <chrono>
+#include <future>
 #include <string>
 #include <utility>
 
@@ -102,7 +102,11 @@ void ClassRoomUI::restore() const {
 }
 
 void ClassRoomUI::save() const {
-    if (classRoomManager->saveClassRooms()) {
+    const std::shared_future<bool> saved = classRoomManager->saveClassRoomsAsync();
+
+    if (saved.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        std::cout << "Zapisywanie sal w tle" << std::endl;
+    } else if (saved.get()) {
         std::cout << "Zapis sal przebiegl pomyslnie" << std::endl;
     } else {
         std::cerr << "Nie udalo sie zapisac sal" << std::endl;
@@ -135,16 +139,16 @@ void ClassRoomUI::addClassRoom() const {
                 if (std::cin.fail() || computers < 0) {
                     error1();
                 } else {
-                    classRoomType = std::make_shared<ITClassRoom>(computers);
+                    classRoomType = ClassRoomTypeFactory::getITClassRoom(computers);
                     break;
                 }
             }
         } else if (type == "MATH") {
             bool formulasTables = getYesNo("Czy sa tablice matematyczne (t/n)? ");
-            classRoomType = std::make_shared<MathClassRoom>(formulasTables);
+            classRoomType = ClassRoomTypeFactory::getMathClassRoom(formulasTables);
         } else if (type == "ENG") {
             bool headphones = getYesNo("Czy sa sluchawki (t/n)? ");
-            classRoomType = std::make_shared<EngClassRoom>(headphones);
+            classRoomType = ClassRoomTypeFactory::getEngClassRoom(headphones);
         } else {
             std::cout << "Nieznany typ sali." << std::endl;
             continue;
@@ -233,10 +237,12 @@ void ClassRoomUI::removeClassRoom() const {
 }
 
 void ClassRoomUI::showClassRooms() const {
-    if (classRoomManager->report().empty()) {
+    const std::string report = classRoomManager->report();
+
+    if (report.empty()) {
         std::cout << std::endl << "Brak sal w systemie" << std::endl;
         return;
     }
 
-    std::cout << std::endl << classRoomManager->report();
+    std::cout << std::endl << report;
 }
@@ -0,0 +1,364 @@
+#include "interfaces/CommandUI.h"
+#include "managers/PersonManager.h"
+#include "managers/ClassRoomManager.h"
+#include "managers/LessonManager.h"
+#include "utils/TextParser.h"
+#include "repositories/LessonRepository.h"
+#include "model/ClassRoom.h"
+#include "model/ClassRoomTypeFactory.h"
+#include "model/Lesson.h"
+#include "model/Person.h"
+#include <boost/date_time.hpp>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <sstream>
+#include <utility>
+
+namespace pt = boost::posix_time;
+
+
+CommandUI::CommandUI(PersonManagerPtr personManager, ClassRoomManagerPtr classRoomManager, LessonManagerPtr lessonManager)
+    : personManager(std::move(personManager)), classRoomManager(std::move(classRoomManager)), lessonManager(std::move(lessonManager)),
+      lastLessonId(-1) {
+}
+
+CommandUI::Summary CommandUI::run(std::istream &input, std::ostream &output) {
+    Summary summary{0, 0, 0.0};
+    const auto started = std::chrono::steady_clock::now();
+
+    std::string line;
+    std::vector<std::string> arguments;
+    std::string result;
+    long lineNumber = 0;
+
+    while (std::getline(input, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        arguments.clear();
+        std::istringstream tokens(line);
+        for (std::string token; tokens >> token;) {
+            arguments.push_back(std::move(token));
+        }
+        if (arguments.empty() || arguments.front().front() == '#') continue;
+
+        result.clear();
+        const auto commandStarted = std::chrono::steady_clock::now();
+        bool succeeded;
+        try {
+            succeeded = execute(arguments, result);
+        } catch (const std::exception &e) {
+            succeeded = false;
+            result = std::string("Blad: ") + e.what();
+        }
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - commandStarted).count();
+
+        summary.commands++;
+        if (!succeeded) summary.failed++;
+
+        // Multi-line results (reports) continue on comment lines, so every record stays on one line.
+        const std::size_t firstBreak = result.find('\n');
+        output << (succeeded ? "ok" : "error") << '\t' << lineNumber << '\t' << arguments.front() << '\t'
+               << result.substr(0, firstBreak) << '\t' << micros << '\n';
+        if (firstBreak != std::string::npos) {
+            std::istringstream rest(result.substr(firstBreak + 1));
+            for (std::string restLine; std::getline(rest, restLine);) {
+                output << "# " << restLine << '\n';
+            }
+        }
+    }
+
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    output << "summary\t" << summary.commands << '\t' << summary.failed << '\t' << summary.seconds << '\t'
+           << (summary.seconds > 0 ? summary.commands / summary.seconds : 0.0) << std::endl;
+
+    return summary;
+}
+
+bool CommandUI::executeLine(const std::string &line, std::string &result) {
+    std::vector<std::string> arguments;
+    std::istringstream tokens(line);
+    for (std::string token; tokens >> token;) {
+        arguments.push_back(std::move(token));
+    }
+
+    result.clear();
+    if (arguments.empty() || arguments.front().front() == '#') {
+        result = "Puste polecenie";
+        return false;
+    }
+    // Requests of one connection run out of order and share this CommandUI with other connections,
+    // so "the lesson planned most recently" has no meaning here.
+    if (std::find(arguments.begin(), arguments.end(), "@") != arguments.end()) {
+        result = "Odwolanie @ jest dostepne tylko w skryptach";
+        return false;
+    }
+
+    try {
+        return execute(arguments, result);
+    } catch (const std::exception &e) {
+        result = std::string("Blad: ") + e.what();
+        return false;
+    }
+}
+
+bool CommandUI::isReadOnly(const std::string &line) {
+    std::istringstream tokens(line);
+    std::string command;
+    tokens >> command;
+
+    return command == "report" || command == "ping";
+}
+
+bool CommandUI::execute(const std::vector<std::string> &arguments, std::string &result) {
+    const std::string &command = arguments.front();
+
+    if (command == "add-person") return addPerson(arguments, result);
+    if (command == "add-room") return addClassRoom(arguments, result);
+    if (command == "plan-lesson") return planLesson(arguments, result);
+    if (command == "start") return startLesson(arguments, result);
+    if (command == "finish") return finishLesson(arguments, result);
+    if (command == "report") return report(arguments, result);
+    if (command == "save") return save(arguments, result);
+    if (command == "ping" && arguments.size() == 1) {
+        result = "pong";
+        return true;
+    }
+
+    result = "Nieznane polecenie";
+    return false;
+}
+
+bool CommandUI::addPerson(const std::vector<std::string> &arguments, std::string &result) const {
+    int id;
+    if (arguments.size() != 4) {
+        result = "Uzycie: add-person <imie> <nazwisko> <id>";
+        return false;
+    }
+    if (!TextParser::parseNumber(arguments[3], id)) {
+        result = "Niepoprawne ID";
+        return false;
+    }
+    if (personManager->getPerson(id) != nullptr) {
+        result = "Osoba o tym ID juz istnieje";
+        return false;
+    }
+
+    result = std::to_string(personManager->addPerson(arguments[1], arguments[2], id)->getId());
+    return true;
+}
+
+bool CommandUI::addClassRoom(const std::vector<std::string> &arguments, std::string &result) const {
+    int number, seats, equipment;
+    double rentCost;
+    if (arguments.size() != 6) {
+        result = "Uzycie: add-room <numer> <miejsca> <koszt> <typ> <wyposazenie>";
+        return false;
+    }
+    if (!TextParser::parseNumber(arguments[1], number) || !TextParser::parseNumber(arguments[2], seats) || seats <= 0 ||
+        !TextParser::parseNumber(arguments[3], rentCost) || rentCost < 0 || !TextParser::parseNumber(arguments[5], equipment)) {
+        result = "Niepoprawne dane sali";
+        return false;
+    }
+
+    const ClassRoomTypePtr type = ClassRoomTypeFactory::create(arguments[4], equipment);
+    if (type == nullptr) {
+        result = "Nieznany typ sali";
+        return false;
+    }
+    if (classRoomManager->getClassRoom(number) != nullptr) {
+        result = "Sala o tym numerze juz istnieje";
+        return false;
+    }
+
+    result = std::to_string(classRoomManager->addClassRoom(number, true, seats, rentCost, type)->getNumber());
+    return true;
+}
+
+bool CommandUI::planLesson(const std::vector<std::string> &arguments, std::string &result) {
+    int teacherId, classRoomNumber, baseCost;
+    pt::ptime beginTime, endTime;
+    if (arguments.size() < 8) {
+        result = "Uzycie: plan-lesson group|individual <nauczyciel> <sala> <poczatek> <koniec> <koszt> <przedmiot> [uczniowie...]";
+        return false;
+    }
+
+    const bool individual = arguments[1] == "individual";
+    if (!individual && arguments[1] != "group") {
+        result = "Nieznany typ lekcji";
+        return false;
+    }
+    if (individual && arguments.size() != 9) {
+        result = "Lekcja indywidualna wymaga jednego ucznia";
+        return false;
+    }
+    if (!TextParser::parseNumber(arguments[2], teacherId) || !TextParser::parseNumber(arguments[3], classRoomNumber) || !TextParser::parseNumber(arguments[6], baseCost) || baseCost < 0) {
+        result = "Niepoprawne dane lekcji";
+        return false;
+    }
+    if (!TextParser::parseTime(arguments[4], beginTime) || !TextParser::parseTime(arguments[5], endTime) || endTime <= beginTime) {
+        result = "Niepoprawny czas";
+        return false;
+    }
+
+    const PersonPtr teacher = personManager->getPerson(teacherId);
+    if (teacher == nullptr) {
+        result = "Nie znaleziono nauczyciela";
+        return false;
+    }
+    const ClassRoomPtr classRoom = classRoomManager->getClassRoom(classRoomNumber);
+    if (classRoom == nullptr) {
+        result = "Nie znaleziono sali";
+        return false;
+    }
+
+    std::vector<int> studentIds;
+    for (std::size_t i = 8; i < arguments.size(); i++) {
+        int studentId;
+        if (!TextParser::parseNumber(arguments[i], studentId)) {
+            result = "Niepoprawne ID ucznia";
+            return false;
+        }
+        if (personManager->getPerson(studentId) == nullptr) {
+            result = "Nie znaleziono ucznia";
+            return false;
+        }
+        studentIds.push_back(studentId);
+    }
+
+    const LessonRepositoryPtr lessonRepo = lessonManager->getLessonRepo();
+    if (!lessonRepo->isClassRoomFree(classRoomNumber, beginTime, endTime)) {
+        result = "Sala jest zajeta w tym czasie";
+        return false;
+    }
+    if (!lessonRepo->isTeacherFree(teacherId, beginTime, endTime)) {
+        result = "Nauczyciel jest zajety w tym czasie";
+        return false;
+    }
+
+    LessonPtr lesson;
+    if (individual) {
+        lesson = lessonManager->addIndividualLesson(teacher, beginTime, endTime, baseCost, arguments[7], classRoom,
+                                                    personManager->getPerson(studentIds.front()), false);
+    } else {
+        lesson = lessonManager->addGroupLesson(teacher, beginTime, endTime, baseCost, arguments[7], classRoom, false);
+        const std::vector<int> codes = lessonManager->enrollStudents(lesson->getID(), studentIds);
+        const long waitlisted = std::count(codes.begin(), codes.end(), 6);
+        if (waitlisted > 0) {
+            result = std::to_string(lesson->getID()) + " " + std::to_string(waitlisted) + " na liscie oczekujacych";
+            lastLessonId = lesson->getID();
+            return true;
+        }
+    }
+
+    lastLessonId = lesson->getID();
+    result = std::to_string(lastLessonId);
+    return true;
+}
+
+bool CommandUI::startLesson(const std::vector<std::string> &arguments, std::string &result) const {
+    int id;
+    if (arguments.size() != 2 || !parseLessonId(arguments[1], id)) {
+        result = "Uzycie: start <id lekcji|@>";
+        return false;
+    }
+
+    const LessonPtr lesson = lessonManager->getLesson(id);
+    if (lesson == nullptr) {
+        result = "Nie znaleziono lekcji";
+        return false;
+    }
+    if (lesson->isStarted()) {
+        result = "Lekcja juz trwa";
+        return false;
+    }
+    if (!lessonManager->startLesson(id)) {
+        result = "Nie udalo sie rozpoczac lekcji";
+        return false;
+    }
+
+    result = std::to_string(id);
+    return true;
+}
+
+bool CommandUI::finishLesson(const std::vector<std::string> &arguments, std::string &result) const {
+    int id;
+    if (arguments.size() != 2 || !parseLessonId(arguments[1], id)) {
+        result = "Uzycie: finish <id lekcji|@>";
+        return false;
+    }
+
+    const LessonPtr lesson = lessonManager->getLesson(id);
+    if (lesson == nullptr) {
+        result = "Nie znaleziono lekcji";
+        return false;
+    }
+    if (!lesson->isStarted()) {
+        result = "Lekcja nie zostala rozpoczeta";
+        return false;
+    }
+    if (!lessonManager->finishLesson(id)) {
+        result = "Nie udalo sie zakonczyc lekcji";
+        return false;
+    }
+
+    std::ostringstream ss;
+    ss << id << " " << lesson->getTotalCost();
+    result = ss.str();
+    return true;
+}
+
+bool CommandUI::report(const std::vector<std::string> &arguments, std::string &result) const {
+    if (arguments.size() != 2) {
+        result = "Uzycie: report persons|rooms|lessons";
+        return false;
+    }
+
+    std::string text;
+    std::size_t count;
+    if (arguments[1] == "persons") {
+        count = personManager->findAllPersons().size();
+        text = personManager->report();
+    } else if (arguments[1] == "rooms") {
+        count = classRoomManager->findAllClassRooms().size();
+        text = classRoomManager->report();
+    } else if (arguments[1] == "lessons") {
+        count = static_cast<std::size_t>(lessonManager->getLessonRepo()->totalSize());
+        text = lessonManager->report();
+    } else {
+        result = "Nieznany raport";
+        return false;
+    }
+
+    result = std::to_string(count) + "\n" + text;
+    return true;
+}
+
+bool CommandUI::save(const std::vector<std::string> &arguments, std::string &result) const {
+    if (arguments.size() != 1) {
+        result = "Uzycie: save";
+        return false;
+    }
+    // The three files are independent, so they are written at the same time when the managers have a task pool.
+    std::shared_future<bool> personsSaved = personManager->savePersonsAsync();
+    std::shared_future<bool> classRoomsSaved = classRoomManager->saveClassRoomsAsync();
+    std::shared_future<bool> lessonsSaved = lessonManager->saveAsync();
+    const bool personsOk = personsSaved.get();
+    const bool classRoomsOk = classRoomsSaved.get();
+    if (const bool lessonsOk = lessonsSaved.get(); !personsOk || !classRoomsOk || !lessonsOk) {
+        result = "Blad zapisu";
+        return false;
+    }
+
+    result = "zapisano";
+    return true;
+}
+
+bool CommandUI::parseLessonId(const std::string &argument, int &id) const {
+    if (argument == "@") {
+        id = lastLessonId;
+        return id >= 0;
+    }
+    return TextParser::parseNumber(argument, id);
+}
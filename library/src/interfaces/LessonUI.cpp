@@ -3,9 +3,12 @@
 #include "managers/ClassRoomManager.h"
 #include "managers/LessonManager.h"
 #include "typedefs.h"
+#include <chrono>
+#include <future>
 #include <string>
 #include <boost/date_time.hpp>
 #include <utility>
+#include <algorithm>
 
 namespace pt = boost::posix_time;
 
@@ -26,7 +29,6 @@ void LessonUI::startLesson(const PersonManagerPtr& personManager, const ClassRoo
     pt::ptime startTime;
     pt::ptime endTime;
     const std::vector<PersonPtr> people = personManager->findAllPersons();
-    const std::vector<ClassRoomPtr> classRooms = classRoomManager->findAllClassRooms();
     auto availablePersons = personManager->findPersons([](const PersonPtr& person) {
         return !person->isDuringLesson();
     });
@@ -193,8 +195,14 @@ void LessonUI::startLesson(const PersonManagerPtr& personManager, const ClassRoo
         std::getline(std::cin, lessonSubject);
 
         // -------- Choosing Lesson Class Room --------
+        const std::vector<ClassRoomPtr> freeClassRooms = manager->findFreeClassRooms(startTime, endTime, choice == 2 ? 2 : 1, "");
+        if (freeClassRooms.empty()) {
+            std::cout << "Brak wolnych sal w tym czasie" << std::endl;
+            return;
+        }
+
         std::cout << std::endl << "Wybierz sale:" << std::endl;
-        for (const ClassRoomPtr& classRoomI : classRooms) {
+        for (const ClassRoomPtr& classRoomI : freeClassRooms) {
             std::cout << classRoomI->getNumber() << ". " << classRoomI->getInfo() << std::endl;
         }
         std::cout << ">> ";
@@ -216,6 +224,11 @@ void LessonUI::startLesson(const PersonManagerPtr& personManager, const ClassRoo
                 std::cout << ">> ";
             }
 
+            else if (std::find(freeClassRooms.begin(), freeClassRooms.end(), classRoom) == freeClassRooms.end()) {
+                std::cout << "Ta sala jest zajeta w tym czasie!" << std::endl;
+                std::cout << ">> ";
+            }
+
             else break;
         }
 
@@ -236,6 +249,7 @@ void LessonUI::startLesson(const PersonManagerPtr& personManager, const ClassRoo
         }
 
         // -------- Choosing Lesson Teacher --------
+        const std::vector<PersonPtr> freeTeachers = manager->findFreeTeachers(startTime, endTime);
         std::cout << std::endl << "Wybierz nauczyciela:" << std::endl;
         for (const PersonPtr& person : availablePersons) {
             std::cout << person->getId() << ". " << person->getInfo() << std::endl;
@@ -265,6 +279,11 @@ void LessonUI::startLesson(const PersonManagerPtr& personManager, const ClassRoo
                 std::cout << ">> ";
             }
 
+            else if (std::find(freeTeachers.begin(), freeTeachers.end(), teacher) == freeTeachers.end()) {
+                std::cout << "Ta osoba prowadzi juz lekcje w tym czasie!" << std::endl;
+                std::cout << ">> ";
+            }
+
             else break;
         }
 
@@ -386,21 +405,21 @@ void LessonUI::startLesson(const PersonManagerPtr& personManager, const ClassRoo
 
                     else {
                         chosenIds.push_back(studentID);
-                        student->addFutureLesson(newLesson);
                         break;
                     }
                 }
 
-                if (manager->addStudentToGroupLesson(newLessonID, personManager->getPerson(studentID)) != 0)
-                    std::cerr << "Blad podczas dodawania ucznia do lekcji!" << std::endl;
-
                 if (now) {
-                    availablePersons = personManager->findPersons([](const PersonPtr& person) {
-                        return !person->isDuringLesson();
+                    availablePersons = personManager->findPersons([&chosenIds](const PersonPtr& person) {
+                        return !person->isDuringLesson() &&
+                               std::find(chosenIds.begin(), chosenIds.end(), person->getId()) == chosenIds.end();
                     });
                 }
                 else {
-                    availablePersons = personManager->findPersons([&startTime, &endTime](const PersonPtr& person) {
+                    availablePersons = personManager->findPersons([&startTime, &endTime, &chosenIds](const PersonPtr& person) {
+                        if (std::find(chosenIds.begin(), chosenIds.end(), person->getId()) != chosenIds.end()) {
+                            return false;
+                        }
                         for (const auto& lesson : person->getFutureLessons()) {
                             if (lesson->getBeginTime() < endTime && lesson->getEndTime() > startTime) {
                                 return false;
@@ -435,7 +454,14 @@ void LessonUI::startLesson(const PersonManagerPtr& personManager, const ClassRoo
                 }
             }
 
-            chosenIds.clear();
+            const std::vector<int> results = manager->enrollStudents(newLessonID, chosenIds);
+            for (std::size_t i = 0; i < results.size(); i++) {
+                if (results[i] == 6)
+                    std::cout << "Brak wolnych miejsc, uczen " << chosenIds[i] << " trafil na liste oczekujacych" << std::endl;
+                else if (results[i] != 0)
+                    std::cerr << "Blad podczas dodawania ucznia " << chosenIds[i] << " do lekcji!" << std::endl;
+            }
+
             std::cout << "Lekcja zapisana!" << std::endl;
             break;
         }
@@ -488,7 +514,7 @@ void LessonUI::endLesson() const {
 }
 
 void LessonUI::showStartedLessons() const {
-    const std::vector<LessonPtr> lessons = manager->findStartedLessons();
+    const std::vector<LessonPtr> &lessons = manager->findStartedLessons();
 
     if (lessons.empty()) {
         std::cout << std::endl << "Nie ma zadnych rozpoczetych lekcji!" << std::endl;
@@ -502,7 +528,7 @@ void LessonUI::showStartedLessons() const {
 }
 
 void LessonUI::showPlannedLessons() const {
-    const std::vector<LessonPtr> lessons = manager->findPlannedLessons();
+    const std::vector<LessonPtr> &lessons = manager->findPlannedLessons();
 
     if (lessons.empty()) {
         std::cout << std::endl << "Nie ma zadnych zaplanowanych lekcji!" << std::endl;
@@ -516,11 +542,14 @@ void LessonUI::showPlannedLessons() const {
 }
 
 void LessonUI::save() const {
-    if (manager->save()) {
+    const std::shared_future<bool> saved = manager->saveAsync();
+
+    if (saved.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        std::cout << "Zapisywanie lekcji w tle" << std::endl;
+    } else if (saved.get()) {
         std::cout << "Zapis lekcji przebiegl pomyslnie" << std::endl;
-    }
-    else {
-        std::cerr << "Nie udalo sie zapisac osob" << std::endl;
+    } else {
+        std::cerr << "Nie udalo sie zapisac lekcji" << std::endl;
     }
 }
 
@@ -538,28 +567,19 @@ void LessonUI::showArchive() const {
 }
 
 void LessonUI::shouldStart() const {
-    const std::vector<LessonPtr> lessons = manager->findLessons([](const LessonPtr& lesson) {
-        return !lesson->isStarted();
-    });
-    for (const LessonPtr& lessonI : lessons) {
-        if (lessonI->getBeginTime() < pt::second_clock::local_time()) {
-            if (!manager->startLesson(lessonI->getID())) {
-                std::cout << "Nie udalo sie zakonczyc lekcji: " << lessonI->getID() << std::endl;
-            }
+    const pt::ptime now = pt::second_clock::local_time();
+    manager->expandDueSeries(now);
+    for (const int lessonId : manager->findLessonsToStart(now)) {
+        if (!manager->startLesson(lessonId)) {
+            std::cout << "Nie udalo sie zakonczyc lekcji: " << lessonId << std::endl;
         }
     }
 }
 
 void LessonUI::shouldEnd() const {
-    const std::vector<LessonPtr> lessons = manager->findLessons([](const LessonPtr& lesson) {
-        return lesson->isStarted();
-    });
-
-    for (const LessonPtr& lessonI : lessons) {
-        if (lessonI->getEndTime() < pt::second_clock::local_time()) {
-            if (!manager->finishLesson(lessonI->getID())) {
-                std::cout << "Nie udalo sie zakonczyc lekcji: " << lessonI->getID() << std::endl;
-            }
+    for (const int lessonId : manager->findLessonsToFinish(pt::second_clock::local_time())) {
+        if (!manager->finishLesson(lessonId)) {
+            std::cout << "Nie udalo sie zakonczyc lekcji: " << lessonId << std::endl;
         }
     }
 }
\ No newline at end of file
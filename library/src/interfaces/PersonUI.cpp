@@ -2,6 +2,8 @@
 #include "model/Person.h"
 #include "managers/PersonManager.h"
 #include <iostream>
+#include <chrono>
+#include <future>
 #include <string>
 
 
@@ -97,12 +99,14 @@ void PersonUI::removePerson() const {
 }
 
 void PersonUI::showPersons() const {
-    if (personManager->report().empty()) {
+    const std::string report = personManager->report();
+
+    if (report.empty()) {
         std::cout << std::endl << "Brak osob w systemie" << std::endl;
         return;
     }
 
-    std::cout << std::endl << personManager->report();
+    std::cout << std::endl << report;
 }
 
 void PersonUI::showAvailablePersons() const {
@@ -132,7 +136,11 @@ void PersonUI::showArchive() const {
 }
 
 void PersonUI::save() const {
-    if (personManager->savePersons()) {
+    const std::shared_future<bool> saved = personManager->savePersonsAsync();
+
+    if (saved.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        std::cout << "Zapisywanie osob w tle" << std::endl;
+    } else if (saved.get()) {
         std::cout << "Zapis osob przebiegl pomyslnie" << std::endl;
     } else {
         std::cerr << "Nie udalo sie zapisac osob" << std::endl;
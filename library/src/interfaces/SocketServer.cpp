@@ -0,0 +1,342 @@
+#include "interfaces/SocketServer.h"
+#include "interfaces/CommandUI.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace {
+    constexpr int maxEvents = 256;
+    constexpr std::size_t readChunk = 64 * 1024;
+
+    void putUint32(char *out, const std::uint32_t value) {
+        out[0] = static_cast<char>(value >> 24);
+        out[1] = static_cast<char>(value >> 16);
+        out[2] = static_cast<char>(value >> 8);
+        out[3] = static_cast<char>(value);
+    }
+
+    std::uint32_t getUint32(const char *in) {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(in);
+        return static_cast<std::uint32_t>(bytes[0]) << 24 | static_cast<std::uint32_t>(bytes[1]) << 16 |
+               static_cast<std::uint32_t>(bytes[2]) << 8 | static_cast<std::uint32_t>(bytes[3]);
+    }
+}
+
+SocketServer::SocketServer(CommandUIPtr commandUI, std::string socketPath, const unsigned workers)
+    : commandUI(std::move(commandUI)), socketPath(std::move(socketPath)),
+      workersCount(workers > 0 ? workers : std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+SocketServer::~SocketServer() {
+    stop();
+}
+
+int SocketServer::start() {
+    if (running) return 1;
+
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) return 2;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ::unlink(socketPath.c_str());
+
+    epoll_event listenEvent{}, wakeEvent{};
+    listenEvent.events = EPOLLIN;
+    listenEvent.data.fd = listenFd;
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.fd = wakeFd;
+
+    if (listenFd < 0 || epollFd < 0 || wakeFd < 0 ||
+        ::bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(listenFd, SOMAXCONN) != 0 ||
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent) != 0 || ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &wakeEvent) != 0) {
+        for (int *fd : {&listenFd, &epollFd, &wakeFd}) {
+            if (*fd >= 0) ::close(*fd);
+            *fd = -1;
+        }
+        return 2;
+    }
+
+    stopping = false;
+    running = true;
+    for (unsigned i = 0; i < workersCount; i++) {
+        workers.emplace_back(&SocketServer::work, this);
+    }
+    loopThread = std::thread(&SocketServer::loop, this);
+
+    return 0;
+}
+
+void SocketServer::stop() {
+    if (!running.exchange(false)) return;
+
+    wake();
+    loopThread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobsReady.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    responses.clear();
+
+    while (!connections.empty()) {
+        close(connections.begin()->first);
+    }
+    for (int *fd : {&listenFd, &epollFd, &wakeFd}) {
+        ::close(*fd);
+        *fd = -1;
+    }
+    ::unlink(socketPath.c_str());
+}
+
+bool SocketServer::isRunning() const {
+    return running;
+}
+
+std::string SocketServer::encodeFrame(const std::uint32_t requestId, const std::string_view payload) {
+    std::string frame(headerSize + payload.size(), '\0');
+    putUint32(frame.data(), static_cast<std::uint32_t>(payload.size()));
+    putUint32(frame.data() + 4, requestId);
+    std::memcpy(frame.data() + headerSize, payload.data(), payload.size());
+
+    return frame;
+}
+
+int SocketServer::decodeFrame(const std::string &buffer, std::size_t &offset, std::uint32_t &requestId, std::string &payload) {
+    if (buffer.size() - offset < headerSize) return 0;
+
+    const std::uint32_t length = getUint32(buffer.data() + offset);
+    if (length > maxPayload) return -1;
+    if (buffer.size() - offset - headerSize < length) return 0;
+
+    requestId = getUint32(buffer.data() + offset + 4);
+    payload.assign(buffer, offset + headerSize, length);
+    offset += headerSize + length;
+
+    return 1;
+}
+
+void SocketServer::loop() {
+    epoll_event events[maxEvents];
+
+    while (running) {
+        const int ready = ::epoll_wait(epollFd, events, maxEvents, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int i = 0; i < ready && running; i++) {
+            const int fd = events[i].data.fd;
+
+            if (fd == listenFd) {
+                accept();
+            } else if (fd == wakeFd) {
+                std::uint64_t count;
+                while (::read(wakeFd, &count, sizeof(count)) > 0) {}
+                deliver();
+            } else if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                close(fd);
+            } else {
+                if (events[i].events & EPOLLIN) receive(fd);
+                if (const auto it = connections.find(fd); it != connections.end() && (events[i].events & EPOLLOUT)) {
+                    send(fd, it->second);
+                }
+            }
+        }
+    }
+}
+
+void SocketServer::work() {
+    std::string result;
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            jobsReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        bool succeeded;
+        if (CommandUI::isReadOnly(job.payload)) {
+            std::shared_lock<std::shared_mutex> lock(commandMutex);
+            succeeded = commandUI->executeLine(job.payload, result);
+        } else {
+            std::unique_lock<std::shared_mutex> lock(commandMutex);
+            succeeded = commandUI->executeLine(job.payload, result);
+        }
+        job.payload = encodeFrame(job.requestId, (succeeded ? "ok\t" : "error\t") + result);
+
+        {
+            std::lock_guard<std::mutex> lock(responsesMutex);
+            responses.push_back(std::move(job));
+        }
+        wake();
+    }
+}
+
+void SocketServer::accept() {
+    while (true) {
+        const int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+
+        connections[fd] = Connection{nextConnectionId++, {}, {}, 0, 0, true, false};
+    }
+}
+
+void SocketServer::receive(const int fd) {
+    const auto it = connections.find(fd);
+    if (it == connections.end()) return;
+    Connection &connection = it->second;
+
+    char buffer[readChunk];
+    while (connection.reading) {
+        const ssize_t received = ::read(fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<std::size_t>(received));
+            if (!dispatch(fd, connection)) return;
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+        close(fd);
+        return;
+    }
+}
+
+bool SocketServer::dispatch(const int fd, Connection &connection) {
+    const auto full = [&connection](const std::size_t queued) {
+        return connection.pending + queued >= maxPendingRequests || connection.output.size() - connection.sent >= maxUnsentOutput;
+    };
+
+    std::vector<Job> decoded;
+    std::uint32_t requestId;
+    std::string payload;
+    std::size_t offset = 0;
+    int status = 0;
+    while (!full(decoded.size()) && (status = decodeFrame(connection.input, offset, requestId, payload)) == 1) {
+        decoded.push_back({fd, connection.id, requestId, std::move(payload)});
+    }
+    if (status < 0) {
+        close(fd);
+        return false;
+    }
+    connection.input.erase(0, offset);
+    connection.pending += decoded.size();
+
+    if (!decoded.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            std::move(decoded.begin(), decoded.end(), std::back_inserter(jobs));
+        }
+        if (decoded.size() == 1) {
+            jobsReady.notify_one();
+        } else {
+            jobsReady.notify_all();
+        }
+    }
+
+    // epoll is level-triggered, so bytes left in the socket are reported again once reading resumes.
+    const bool reading = !full(0);
+    const bool writing = connection.sent < connection.output.size();
+    if (reading != connection.reading || writing != connection.writing) {
+        epoll_event event{};
+        event.events = (reading ? static_cast<std::uint32_t>(EPOLLIN) : 0u) | (writing ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+        event.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+        connection.reading = reading;
+        connection.writing = writing;
+    }
+
+    return true;
+}
+
+void SocketServer::send(const int fd, Connection &connection) {
+    while (connection.sent < connection.output.size()) {
+        const ssize_t written = ::send(fd, connection.output.data() + connection.sent, connection.output.size() - connection.sent,
+                                       MSG_NOSIGNAL);
+        if (written > 0) {
+            connection.sent += static_cast<std::size_t>(written);
+            continue;
+        }
+        if (written < 0 && errno == EINTR) continue;
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+        close(fd);
+        return;
+    }
+
+    if (connection.sent == connection.output.size()) {
+        connection.output.clear();
+        connection.sent = 0;
+    }
+
+    dispatch(fd, connection);
+}
+
+void SocketServer::deliver() {
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(responsesMutex);
+        ready.swap(responses);
+    }
+
+    // Append every response first, so a connection with several of them is written once.
+    std::vector<int> touched;
+    for (Job &job : ready) {
+        const auto it = connections.find(job.fd);
+        if (it == connections.end() || it->second.id != job.connectionId) continue;
+
+        if (it->second.output.empty()) touched.push_back(job.fd);
+        it->second.output += job.payload;
+        it->second.pending--;
+    }
+
+    for (const int fd : touched) {
+        if (const auto it = connections.find(fd); it != connections.end()) {
+            send(fd, it->second);
+        }
+    }
+}
+
+void SocketServer::close(const int fd) {
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+void SocketServer::wake() const {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(wakeFd, &one, sizeof(one));
+}
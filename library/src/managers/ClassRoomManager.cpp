@@ -1,5 +1,7 @@
 #include "managers/ClassRoomManager.h"
 #include "storages/ClassRoomFilesStorage.h"
+#include "concurrency/TaskPool.h"
+#include "storages/Flusher.h"
 #include <iostream>
 #include <sstream>
 #include <utility>
@@ -18,6 +20,28 @@ bool ClassRoomManager::saveClassRooms() const {
     }
 }
 
+std::shared_future<bool> ClassRoomManager::saveClassRoomsAsync() const {
+    if (flusher == nullptr) {
+        std::promise<bool> saved;
+        saved.set_value(saveClassRooms());
+        return saved.get_future().share();
+    }
+
+    return flusher->flush(ClassRoomFilesStorage::databaseFile, ClassRoomFilesStorage::serialize(classRoomRepo));
+}
+
+std::future<std::string> ClassRoomManager::reportAsync() const {
+    return TaskPool::submitTo(taskPool, [this] { return report(); });
+}
+
+void ClassRoomManager::setTaskPool(TaskPoolPtr taskPool) {
+    this->taskPool = std::move(taskPool);
+}
+
+void ClassRoomManager::setFlusher(FlusherPtr flusher) {
+    this->flusher = std::move(flusher);
+}
+
 bool ClassRoomManager::loadClassRooms() {
     try {
         return classRoomFilesStorage->load(classRoomRepo);
@@ -78,19 +102,17 @@ void ClassRoomManager::removeClassRoom(const int number) const {
 std::string ClassRoomManager::report() const {
     std::stringstream ss;
 
-    for (auto& room : classRoomRepo->findAll()) {
+    classRoomRepo->snapshot()->forEach([&ss](const ClassRoomPtr &room) {
         if (room != nullptr) {
             ss << room->getNumber() << ". " << room->getInfo() << std::endl;
         }
-    }
+    });
 
     return ss.str();
 }
 
 std::vector<ClassRoomPtr> ClassRoomManager::findClassRooms(const ClassRoomPredicate& predicate) const {
-    return classRoomRepo->findBy([predicate](const ClassRoomPtr& classRoom) {
-        return predicate(classRoom);
-    });
+    return classRoomRepo->findBy(predicate);
 }
 
 std::vector<ClassRoomPtr> ClassRoomManager::findAllClassRooms() const {
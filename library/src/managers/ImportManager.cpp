@@ -0,0 +1,227 @@
+#include "managers/ImportManager.h"
+#include "managers/LessonManager.h"
+#include "utils/TextParser.h"
+#include "repositories/PersonRepository.h"
+#include "repositories/ClassRoomRepository.h"
+#include "repositories/LessonRepository.h"
+#include "repositories/OccupancyIndex.h"
+#include "model/ClassRoom.h"
+#include "model/ClassRoomTypeFactory.h"
+#include "model/GroupLesson.h"
+#include "model/IndividualLesson.h"
+#include "model/Person.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+
+namespace {
+    constexpr std::string_view personsHeader = "firstName,lastName,id";
+    constexpr std::string_view classRoomsHeader = "number,seats,rentCost,type,equipment";
+    constexpr std::string_view lessonsHeader = "type,teacherId,classRoomNumber,beginTime,endTime,baseCost,subject,studentIds";
+
+    /** Splits text at every separator; the views point into text. */
+    void split(const std::string_view text, const char separator, std::vector<std::string_view> &fields) {
+        fields.clear();
+        std::size_t from = 0;
+
+        while (true) {
+            const std::size_t to = text.find(separator, from);
+            fields.push_back(text.substr(from, to == std::string_view::npos ? std::string_view::npos : to - from));
+            if (to == std::string_view::npos) return;
+            from = to + 1;
+        }
+    }
+
+    /**
+     * Reads the input line by line, passes every data row to validate (which returns nullptr to
+     * accept the row or the reason to reject it) and calls flush (which inserts the accepted rows
+     * and returns their number) after every batchSize accepted rows and at the end.
+     */
+    template <typename Validate, typename Flush>
+    ImportManager::Report importRows(std::istream &input, const std::string_view header, const std::size_t batchSize,
+                                     Validate validate, Flush flush) {
+        ImportManager::Report report{0, 0, {}, 0.0};
+        const auto started = std::chrono::steady_clock::now();
+
+        std::string line;
+        std::vector<std::string_view> fields;
+        long lineNumber = 0;
+        bool first = true;
+        std::size_t batched = 0;
+
+        while (std::getline(input, line)) {
+            lineNumber++;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line.front() == '#') continue;
+            if (std::exchange(first, false) && line == header) continue;
+
+            report.rows++;
+            split(line, ',', fields);
+
+            if (const char *reason = validate(fields); reason != nullptr) {
+                report.rejected.push_back({lineNumber, reason});
+                continue;
+            }
+
+            if (++batched == batchSize) {
+                report.imported += flush();
+                batched = 0;
+            }
+        }
+
+        if (batched > 0) report.imported += flush();
+
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return report;
+    }
+}
+
+double ImportManager::Report::rowsPerSecond() const {
+    return seconds > 0 ? rows / seconds : 0.0;
+}
+
+ImportManager::ImportManager(PersonRepositoryPtr personRepo, ClassRoomRepositoryPtr classRoomRepo, LessonManagerPtr lessonManager,
+                             const std::size_t batchSize)
+    : personRepo(std::move(personRepo)), classRoomRepo(std::move(classRoomRepo)), lessonManager(std::move(lessonManager)),
+      batchSize(std::max<std::size_t>(batchSize, 1)) {
+}
+
+ImportManager::Report ImportManager::importPersons(std::istream &input) const {
+    std::vector<PersonPtr> batch;
+    std::unordered_set<int> batchIds;
+    batch.reserve(batchSize);
+
+    auto validate = [this, &batch, &batchIds](const std::vector<std::string_view> &fields) -> const char* {
+        int id;
+        if (fields.size() != 3) return "Zla liczba pol";
+        if (fields[0].empty() || fields[1].empty()) return "Puste imie lub nazwisko";
+        if (!TextParser::parseNumber(fields[2], id)) return "Niepoprawne ID";
+        if (personRepo->findPersonById(id) != nullptr || !batchIds.insert(id).second) return "Osoba o tym ID juz istnieje";
+
+        batch.push_back(std::make_shared<Person>(std::string(fields[0]), std::string(fields[1]), id));
+        return nullptr;
+    };
+
+    auto flush = [this, &batch, &batchIds]() {
+        personRepo->addAll(batch);
+        const long added = static_cast<long>(batch.size());
+        batch.clear();
+        batchIds.clear();
+        return added;
+    };
+
+    return importRows(input, personsHeader, batchSize, validate, flush);
+}
+
+ImportManager::Report ImportManager::importClassRooms(std::istream &input) const {
+    std::vector<ClassRoomPtr> batch;
+    std::unordered_set<int> batchNumbers;
+    batch.reserve(batchSize);
+
+    auto validate = [this, &batch, &batchNumbers](const std::vector<std::string_view> &fields) -> const char* {
+        int number, seats, equipment;
+        double rentCost;
+        if (fields.size() != 5) return "Zla liczba pol";
+        if (!TextParser::parseNumber(fields[0], number)) return "Niepoprawny numer sali";
+        if (!TextParser::parseNumber(fields[1], seats) || seats <= 0) return "Niepoprawna liczba miejsc";
+        if (!TextParser::parseNumber(fields[2], rentCost) || rentCost < 0) return "Niepoprawny koszt wynajmu";
+        if (!TextParser::parseNumber(fields[4], equipment)) return "Niepoprawne wyposazenie";
+
+        const ClassRoomTypePtr type = ClassRoomTypeFactory::create(fields[3], equipment);
+        if (type == nullptr) return "Nieznany typ sali";
+        if (classRoomRepo->findClassRoomByNumber(number) != nullptr || !batchNumbers.insert(number).second) return "Sala o tym numerze juz istnieje";
+
+        batch.push_back(std::make_shared<ClassRoom>(number, true, seats, rentCost, type));
+        return nullptr;
+    };
+
+    auto flush = [this, &batch, &batchNumbers]() {
+        classRoomRepo->addAll(batch);
+        const long added = static_cast<long>(batch.size());
+        batch.clear();
+        batchNumbers.clear();
+        return added;
+    };
+
+    return importRows(input, classRoomsHeader, batchSize, validate, flush);
+}
+
+ImportManager::Report ImportManager::importLessons(std::istream &input) const {
+    const LessonRepositoryPtr lessonRepo = lessonManager->getLessonRepo();
+    std::vector<LessonPtr> batch;
+    OccupancyIndex batchClassRooms, batchTeachers;
+    std::vector<std::string_view> studentFields;
+    std::vector<PersonPtr> students;
+    batch.reserve(batchSize);
+
+    auto validate = [&](const std::vector<std::string_view> &fields) -> const char* {
+        int teacherId, classRoomNumber, baseCost;
+        pt::ptime beginTime, endTime;
+        if (fields.size() != 8) return "Zla liczba pol";
+
+        const bool individual = fields[0] == "INDIVIDUAL";
+        if (!individual && fields[0] != "GROUP") return "Nieznany typ lekcji";
+        if (!TextParser::parseNumber(fields[1], teacherId)) return "Niepoprawne ID nauczyciela";
+        if (!TextParser::parseNumber(fields[2], classRoomNumber)) return "Niepoprawny numer sali";
+        if (!TextParser::parseTime(fields[3], beginTime) || !TextParser::parseTime(fields[4], endTime)) return "Niepoprawny czas";
+        if (endTime <= beginTime) return "Koniec lekcji przed jej poczatkiem";
+        if (!TextParser::parseNumber(fields[5], baseCost) || baseCost < 0) return "Niepoprawny koszt";
+        if (fields[6].empty()) return "Pusty przedmiot";
+
+        const PersonPtr teacher = personRepo->findPersonById(teacherId);
+        if (teacher == nullptr) return "Nie znaleziono nauczyciela";
+        const ClassRoomPtr classRoom = classRoomRepo->findClassRoomByNumber(classRoomNumber);
+        if (classRoom == nullptr) return "Nie znaleziono sali";
+
+        students.clear();
+        if (!fields[7].empty()) {
+            split(fields[7], ';', studentFields);
+            for (const std::string_view studentField : studentFields) {
+                int studentId;
+                if (!TextParser::parseNumber(studentField, studentId)) return "Niepoprawne ID ucznia";
+
+                const PersonPtr student = personRepo->findPersonById(studentId);
+                if (student == nullptr) return "Nie znaleziono ucznia";
+                students.push_back(student);
+            }
+        }
+        if (individual && students.size() != 1) return "Lekcja indywidualna wymaga jednego ucznia";
+
+        const std::int64_t begin = LessonRepository::toEpochSeconds(beginTime);
+        const std::int64_t end = LessonRepository::toEpochSeconds(endTime);
+        if (!lessonRepo->isClassRoomFree(classRoomNumber, begin, end) || !batchClassRooms.isFree(classRoomNumber, begin, end)) {
+            return "Sala jest zajeta w tym czasie";
+        }
+        if (!lessonRepo->isTeacherFree(teacherId, begin, end) || !batchTeachers.isFree(teacherId, begin, end)) {
+            return "Nauczyciel jest zajety w tym czasie";
+        }
+
+        LessonPtr lesson;
+        if (individual) {
+            lesson = std::make_shared<IndividualLesson>(teacher, beginTime, endTime, baseCost, std::string(fields[6]), classRoom, students.front());
+        } else {
+            const auto groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, std::string(fields[6]), classRoom);
+            groupLesson->addStudents(students);
+            lesson = groupLesson;
+        }
+
+        batchClassRooms.add(classRoomNumber, begin, end, lesson->getID());
+        batchTeachers.add(teacherId, begin, end, lesson->getID());
+        batch.push_back(std::move(lesson));
+        return nullptr;
+    };
+
+    auto flush = [&]() {
+        const long added = lessonManager->addLessons(batch, false);
+        batch.clear();
+        batchClassRooms = OccupancyIndex();
+        batchTeachers = OccupancyIndex();
+        return added;
+    };
+
+    return importRows(input, lessonsHeader, batchSize, validate, flush);
+}
@@ -1,20 +1,30 @@
 #include "managers/LessonManager.h"
 #include "storages/LessonFilesStorage.h"
+#include "concurrency/TaskPool.h"
+#include "storages/Flusher.h"
 #include "repositories/LessonRepository.h"
 #include "repositories/PersonRepository.h"
 #include "repositories/ClassRoomRepository.h"
 #include "model/ClassRoom.h"
+#include "model/ClassRoomType.h"
 #include "model/IndividualLesson.h"
 #include "model/Lesson.h"
 #include "model/Person.h"
+#include "model/WeeklyOccupancy.h"
 #include "typedefs.h"
+#include <algorithm>
+#include <deque>
+#include <iterator>
 #include <sstream>
 #include <utility>
+#include <unordered_set>
 
 
 LessonManager::LessonManager(LessonRepositoryPtr  lessonRepo, LessonFilesStoragePtr  lessonFilesStorage, PersonRepositoryPtr  personRepo,
                   ClassRoomRepositoryPtr  classRoomRepo)
-    : lessonRepo(std::move(lessonRepo)), lessonFilesStorage(std::move(lessonFilesStorage)), personRepo(std::move(personRepo)), classRoomRepo(std::move(classRoomRepo))
+    : lessonRepo(std::move(lessonRepo)), lessonFilesStorage(std::move(lessonFilesStorage)), personRepo(std::move(personRepo)), classRoomRepo(std::move(classRoomRepo)),
+      versions(std::make_shared<VersionTable>()), archiveMutex(std::make_shared<std::mutex>()),
+      finishingMutex(std::make_shared<std::mutex>()), finishing(std::make_shared<std::unordered_set<int>>())
 {
 }
 
@@ -26,6 +36,28 @@ bool LessonManager::save() const {
     }
 }
 
+std::shared_future<bool> LessonManager::saveAsync() const {
+    if (flusher == nullptr) {
+        std::promise<bool> saved;
+        saved.set_value(save());
+        return saved.get_future().share();
+    }
+
+    return flusher->flush(LessonFilesStorage::databaseFile, LessonFilesStorage::serialize(lessonRepo));
+}
+
+std::future<std::string> LessonManager::reportAsync() const {
+    return TaskPool::submitTo(taskPool, [this] { return report(); });
+}
+
+void LessonManager::setTaskPool(TaskPoolPtr taskPool) {
+    this->taskPool = std::move(taskPool);
+}
+
+void LessonManager::setFlusher(FlusherPtr flusher) {
+    this->flusher = std::move(flusher);
+}
+
 bool LessonManager::load() {
     bool flag=true;
     try {
@@ -34,6 +66,13 @@ bool LessonManager::load() {
         flag = false;
     }
 
+    for (const LessonPtr &lesson : lessonRepo->findAll()) {
+        updateOccupancy(lesson, lesson->getBeginTime(), lesson->getEndTime(), true);
+    }
+    for (const LessonSeriesPtr &lessonSeries : lessonRepo->getSeries()) {
+        updateOccupancy(lessonSeries, true);
+    }
+
     return flag;
 }
 
@@ -43,21 +82,218 @@ LessonRepositoryPtr LessonManager::getLessonRepo() const {
 
 int LessonManager::removeLesson(const int &id) const {
     if (const LessonPtr lesson = lessonRepo->findByIndex(id); lesson != nullptr) {
-        try {
-            saveArchive(id);
-        } catch (const std::exception& e) {
-            std::cerr << "Blad archiwum: " << e.what() << std::endl;
-        }
-        return lessonRepo->remove(lesson);
+        updateOccupancy(lesson, lesson->getBeginTime(), lesson->getEndTime(), false);
+        return archiveAndRemove(lesson);
     }
 
     return 1;
 }
 
+int LessonManager::archiveAndRemove(const LessonPtr &lesson) const {
+    try {
+        saveArchive(lesson->getID());
+    } catch (const std::exception& e) {
+        std::cerr << "Blad archiwum: " << e.what() << std::endl;
+    }
+
+    return lessonRepo->remove(lesson);
+}
+
+void LessonManager::updateOccupancy(const PersonPtr &person, const pt::ptime &beginTime, const pt::ptime &endTime, const bool occupy) const {
+    if (person == nullptr) return;
+
+    const PersonPtr stored = personRepo->findPersonById(person->getId());
+    WeeklyOccupancy &occupancy = (stored != nullptr ? stored : person)->getOccupancy();
+
+    if (occupy) occupancy.occupy(beginTime, endTime);
+    else occupancy.release(beginTime, endTime);
+}
+
+void LessonManager::updateOccupancy(const LessonPtr &lesson, const pt::ptime &beginTime, const pt::ptime &endTime, const bool occupy) const {
+    updateOccupancy(lesson, findCoveringSeries(lesson), beginTime, endTime, occupy);
+}
+
+void LessonManager::updateOccupancy(const LessonPtr &lesson, const LessonSeriesPtr &heldBy, const pt::ptime &beginTime,
+                                    const pt::ptime &endTime, const bool occupy) const {
+    const auto held = [&heldBy](const PersonPtr &person) {
+        if (heldBy == nullptr || person == nullptr) return false;
+        if (heldBy->getTeacher()->getId() == person->getId()) return true;
+        return std::any_of(heldBy->getStudents().begin(), heldBy->getStudents().end(),
+                           [&person](const PersonPtr &student) { return student->getId() == person->getId(); });
+    };
+
+    if (const ClassRoomPtr &classRoom = lesson->getClassRoom(); classRoom != nullptr && heldBy == nullptr) {
+        const ClassRoomPtr stored = classRoomRepo->findClassRoomByNumber(classRoom->getNumber());
+        WeeklyOccupancy &occupancy = (stored != nullptr ? stored : classRoom)->getOccupancy();
+
+        if (occupy) occupancy.occupy(beginTime, endTime);
+        else occupancy.release(beginTime, endTime);
+    }
+
+    if (!held(lesson->getTeacher())) updateOccupancy(lesson->getTeacher(), beginTime, endTime, occupy);
+
+    if (const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lesson); groupLesson != nullptr) {
+        for (const PersonPtr &student : groupLesson->getStudents()) {
+            if (!held(student)) updateOccupancy(student, beginTime, endTime, occupy);
+        }
+    } else if (const auto individualLesson = std::dynamic_pointer_cast<IndividualLesson>(lesson); individualLesson != nullptr) {
+        if (!held(individualLesson->getStudent())) updateOccupancy(individualLesson->getStudent(), beginTime, endTime, occupy);
+    }
+}
+
+void LessonManager::updateOccupancy(const LessonPtr &lesson, const PersonPtr &person, const bool occupy) const {
+    if (const LessonSeriesPtr heldBy = findCoveringSeries(lesson); heldBy != nullptr) {
+        const std::span<const PersonPtr> students = heldBy->getStudents();
+        if (std::any_of(students.begin(), students.end(), [&person](const PersonPtr &student) { return student->getId() == person->getId(); })) {
+            return;
+        }
+    }
+
+    updateOccupancy(person, lesson->getBeginTime(), lesson->getEndTime(), occupy);
+}
+
+LessonSeriesPtr LessonManager::findCoveringSeries(const LessonPtr &lesson) const {
+    if (lesson->getSeriesId() < 0) return nullptr;
+
+    return lessonRepo->findSeriesById(lesson->getSeriesId());
+}
+
+int LessonManager::dropSeries(const LessonSeriesPtr &lessonSeries) const {
+    std::vector<LessonPtr> covered;
+    for (const LessonPtr &lesson : lessonRepo->findAll()) {
+        if (lesson->getSeriesId() == lessonSeries->getID()) covered.push_back(lesson);
+    }
+
+    // The lessons already booked whatever the series did not; they now book the rest themselves.
+    for (const LessonPtr &lesson : covered) {
+        updateOccupancy(lesson, lessonSeries, lesson->getBeginTime(), lesson->getEndTime(), false);
+    }
+    updateOccupancy(lessonSeries, false);
+    const int result = lessonRepo->removeSeries(lessonSeries);
+    for (const LessonPtr &lesson : covered) {
+        updateOccupancy(lesson, nullptr, lesson->getBeginTime(), lesson->getEndTime(), true);
+    }
+
+    return result;
+}
+
+void LessonManager::updateOccupancy(const LessonSeriesPtr &lessonSeries, const bool occupy) const {
+    const pt::ptime beginTime = lessonSeries->getOccurrenceBegin(0);
+    const pt::ptime endTime = lessonSeries->getOccurrenceEnd(0);
+
+    const ClassRoomPtr stored = classRoomRepo->findClassRoomByNumber(lessonSeries->getClassRoom()->getNumber());
+    WeeklyOccupancy &occupancy = (stored != nullptr ? stored : lessonSeries->getClassRoom())->getOccupancy();
+    if (occupy) occupancy.occupy(beginTime, endTime);
+    else occupancy.release(beginTime, endTime);
+
+    updateOccupancy(lessonSeries->getTeacher(), beginTime, endTime, occupy);
+    for (const PersonPtr &student : lessonSeries->getStudents()) {
+        updateOccupancy(student, beginTime, endTime, occupy);
+    }
+}
+
+LessonSeriesPtr LessonManager::addLessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, const int baseCost,
+                                               const std::string &subject, const ClassRoomPtr &classRoom, const std::vector<PersonPtr> &students,
+                                               const bool individual, const int intervalWeeks, const int count) const {
+    if (teacher == nullptr || classRoom == nullptr || beginTime.is_special() || endTime.is_special() || endTime <= beginTime ||
+        intervalWeeks <= 0 || count <= 0) {
+        return nullptr;
+    }
+
+    auto lessonSeries = std::make_shared<LessonSeries>(teacher, beginTime, endTime, baseCost, subject, classRoom, students, individual,
+                                                       intervalWeeks, count);
+    lessonRepo->addSeries(lessonSeries);
+    updateOccupancy(lessonSeries, true);
+
+    return lessonSeries;
+}
+
+LessonSeriesPtr LessonManager::addGroupLessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, const int baseCost,
+                                                    const std::string &subject, const ClassRoomPtr &classRoom,
+                                                    const std::vector<PersonPtr> &students, const int intervalWeeks, const int count) const {
+    std::vector<PersonPtr> attending;
+    attending.reserve(students.size());
+    std::copy_if(students.begin(), students.end(), std::back_inserter(attending), [](const PersonPtr &student) { return student != nullptr; });
+
+    return addLessonSeries(teacher, beginTime, endTime, baseCost, subject, classRoom, attending, false, intervalWeeks, count);
+}
+
+LessonSeriesPtr LessonManager::addIndividualLessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime,
+                                                         const int baseCost, const std::string &subject, const ClassRoomPtr &classRoom,
+                                                         const PersonPtr &individualPerson, const int intervalWeeks, const int count) const {
+    if (individualPerson == nullptr) return nullptr;
+
+    return addLessonSeries(teacher, beginTime, endTime, baseCost, subject, classRoom, {individualPerson}, true, intervalWeeks, count);
+}
+
+int LessonManager::removeLessonSeries(const int &id) const {
+    const LessonSeriesPtr lessonSeries = lessonRepo->findSeriesById(id);
+    if (lessonSeries == nullptr) return 1;
+
+    return dropSeries(lessonSeries) == 0 ? 0 : 1;
+}
+
+int LessonManager::skipSeriesOccurrence(const int &id, const int index) const {
+    const LessonSeriesPtr lessonSeries = lessonRepo->findSeriesById(id);
+    if (lessonSeries == nullptr) return 1;
+
+    const int result = lessonSeries->skipOccurrence(index);
+    return result == 0 ? 0 : result + 1;
+}
+
+std::vector<LessonPtr> LessonManager::expandDueSeries(const pt::ptime &until) {
+    std::vector<LessonPtr> created;
+
+    // Copied, since exhausted series are removed from the repository while iterating.
+    const std::vector<LessonSeriesPtr> allSeries = lessonRepo->getSeries();
+    for (const LessonSeriesPtr &lessonSeries : allSeries) {
+        std::vector<LessonPtr> lessons;
+        for (const LessonSeries::Occurrence &occurrence : lessonSeries->expandUntil(until)) {
+            LessonPtr lesson;
+            if (lessonSeries->isIndividual()) {
+                lesson = std::make_shared<IndividualLesson>(lessonSeries->getTeacher(), occurrence.beginTime, occurrence.endTime,
+                                                            lessonSeries->getBaseCost(), lessonSeries->getSubject(), lessonSeries->getClassRoom(),
+                                                            lessonSeries->getStudents().front());
+            } else {
+                const auto groupLesson = std::make_shared<GroupLesson>(lessonSeries->getTeacher(), occurrence.beginTime, occurrence.endTime,
+                                                                       lessonSeries->getBaseCost(), lessonSeries->getSubject(),
+                                                                       lessonSeries->getClassRoom());
+                const std::span<const PersonPtr> students = lessonSeries->getStudents();
+                groupLesson->addStudents(std::vector<PersonPtr>(students.begin(), students.end()));
+                lesson = groupLesson;
+            }
+
+            // Linked before booking, so the lesson leaves out what the series already books.
+            lesson->setSeriesId(lessonSeries->getID());
+            lessons.push_back(lesson);
+        }
+        addLessons(lessons, false);
+        created.insert(created.end(), lessons.begin(), lessons.end());
+
+        if (lessonSeries->isExhausted()) {
+            dropSeries(lessonSeries);
+        }
+    }
+
+    return created;
+}
+
+std::vector<LessonSeries::Occurrence> LessonManager::findSeriesOccurrences(const pt::ptime &beginTime, const pt::ptime &endTime) const {
+    std::vector<LessonSeries::Occurrence> result;
+
+    for (const LessonSeriesPtr &lessonSeries : lessonRepo->getSeries()) {
+        const std::vector<LessonSeries::Occurrence> occurrences = lessonSeries->findOccurrences(beginTime, endTime);
+        result.insert(result.end(), occurrences.begin(), occurrences.end());
+    }
+
+    return result;
+}
+
 LessonPtr LessonManager::addGroupLesson(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, int baseCost, const std::string &subject, const ClassRoomPtr &classRoom, const bool now) const {
     auto newLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
 
     lessonRepo->add(newLesson, now);
+    updateOccupancy(newLesson, beginTime, endTime, true);
 
     if (!now) {
         for (const auto& person : newLesson->getStudents()) {
@@ -72,34 +308,221 @@ LessonPtr LessonManager::addIndividualLesson(const PersonPtr &teacher, const pt:
     auto newLesson = std::make_shared<IndividualLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom, individualPerson);
 
     lessonRepo->add(newLesson, now);
+    updateOccupancy(newLesson, beginTime, endTime, true);
     if (!now)
         newLesson->getStudent()->addFutureLesson(newLesson);
 
     return newLesson;
 }
 
+int LessonManager::addLessons(const std::vector<LessonPtr> &lessons, const bool now) const {
+    const int added = lessonRepo->addAll(lessons, now);
+
+    for (const LessonPtr &lesson : lessons) {
+        if (lesson == nullptr) continue;
+
+        updateOccupancy(lesson, lesson->getBeginTime(), lesson->getEndTime(), true);
+        if (now) continue;
+
+        if (const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lesson); groupLesson != nullptr) {
+            for (const PersonPtr &student : groupLesson->getStudents()) {
+                student->addFutureLesson(lesson);
+            }
+        } else if (const auto individualLesson = std::dynamic_pointer_cast<IndividualLesson>(lesson); individualLesson != nullptr) {
+            individualLesson->getStudent()->addFutureLesson(lesson);
+        }
+    }
+
+    return added;
+}
+
 int LessonManager::addStudentToGroupLesson(const int &id, const PersonPtr& person) const {
-    const auto lesson = lessonRepo->findByIndex(id);
-    if (lesson == nullptr) return 3;
-    if (person == nullptr) return 4;
+    for (int attempt = 0; attempt < transactionAttempts; attempt++) {
+        Transaction transaction = beginTransaction();
+        transaction.read(VersionTable::Kind::Lesson, id);
+
+        const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lessonRepo->findByIndex(id));
+        if (groupLesson == nullptr || isFinishing(id)) return 3;
+        if (person == nullptr) return 4;
+        transaction.read(VersionTable::Kind::Person, person->getId());
+
+        int result = 0;
+        transaction.stage([this, &result, &groupLesson, &person] {
+            result = groupLesson->addStudent(person);
+            if (result == 0) {
+                joinGroupLesson(groupLesson, person);
+                updateOccupancy(groupLesson, person, true);
+            }
+        });
+
+        if (transaction.commit() == 0) return result == 3 ? 6 : result;
+    }
 
-    const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lesson);
+    std::cerr << "Konflikt przy zapisie na lekcje o ID " << id << std::endl;
+    return 7;
+}
 
-    person->addFutureLesson(groupLesson);
+std::vector<int> LessonManager::enrollStudents(const int &id, const std::span<const int> personIds) const {
+    for (int attempt = 0; attempt < transactionAttempts; attempt++) {
+        std::vector<int> results(personIds.size(), 3);
+        Transaction transaction = beginTransaction();
+        transaction.read(VersionTable::Kind::Lesson, id);
+
+        const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lessonRepo->findByIndex(id));
+        if (groupLesson == nullptr || isFinishing(id)) return results;
+
+        std::vector<PersonPtr> persons(personIds.size());
+        for (std::size_t i = 0; i < personIds.size(); i++) {
+            persons[i] = personRepo->findPersonById(personIds[i]);
+            if (persons[i] != nullptr) transaction.read(VersionTable::Kind::Person, personIds[i]);
+        }
+
+        // Membership is checked in the stage, where no other transaction can change the lesson.
+        transaction.stage([this, &results, &groupLesson, &persons, &personIds] {
+            const int teacherId = groupLesson->getTeacher()->getId();
+            std::vector<PersonPtr> candidates;
+            std::vector<std::size_t> candidateIndexes;
+            std::unordered_set<int> requested;
+            candidates.reserve(personIds.size());
+            candidateIndexes.reserve(personIds.size());
+            requested.reserve(personIds.size());
+
+            for (std::size_t i = 0; i < personIds.size(); i++) {
+                if (persons[i] == nullptr) {
+                    results[i] = 4;
+                } else if (personIds[i] == teacherId || !requested.insert(personIds[i]).second ||
+                           groupLesson->hasStudent(personIds[i]) || groupLesson->isWaitlisted(personIds[i])) {
+                    results[i] = 2;
+                } else {
+                    candidates.push_back(persons[i]);
+                    candidateIndexes.push_back(i);
+                }
+            }
+
+            groupLesson->addStudents(candidates);
+            for (std::size_t i = 0; i < candidates.size(); i++) {
+                if (groupLesson->hasStudent(candidates[i]->getId())) {
+                    joinGroupLesson(groupLesson, candidates[i]);
+                    updateOccupancy(groupLesson, candidates[i], true);
+                    results[candidateIndexes[i]] = 0;
+                } else {
+                    results[candidateIndexes[i]] = 6;
+                }
+            }
+        });
+
+        if (transaction.commit() == 0) return results;
+    }
 
-    return groupLesson->addStudent(person);
+    std::cerr << "Konflikt przy zapisie na lekcje o ID " << id << std::endl;
+    return std::vector<int>(personIds.size(), 7);
 }
 
 int LessonManager::removeStudentFromGroupLesson(const int &id, const PersonPtr &person) const {
-    const LessonPtr lesson = lessonRepo->getByIndex(id);
+    for (int attempt = 0; attempt < transactionAttempts; attempt++) {
+        Transaction transaction = beginTransaction();
+        const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lessonRepo->findByIndex(id));
+        if (groupLesson == nullptr || isFinishing(id)) return 3;
+        if (person == nullptr) return 4;
+
+        // Waitlisted students may be promoted into the freed seat, so they are read as well.
+        std::deque<PersonPtr> waitlist;
+        transaction.read(VersionTable::Kind::Lesson, id, [&waitlist, &groupLesson] { waitlist = groupLesson->getWaitlist(); });
+        transaction.read(VersionTable::Kind::Person, person->getId());
+        for (const PersonPtr &waiting : waitlist) {
+            transaction.read(VersionTable::Kind::Person, waiting->getId());
+        }
+
+        int result = 0;
+        transaction.stage([this, &result, &groupLesson, &person] {
+            if (!groupLesson->hasStudent(person->getId()) && !groupLesson->isWaitlisted(person->getId())) {
+                result = 5;
+                return;
+            }
+
+            person->removeFutureLesson(groupLesson);
+            if (groupLesson->hasStudent(person->getId())) {
+                updateOccupancy(groupLesson, person, false);
+            }
+
+            std::vector<PersonPtr> promoted;
+            result = groupLesson->removeStudent(person, &promoted);
+            for (const PersonPtr &next : promoted) {
+                joinGroupLesson(groupLesson, next);
+                updateOccupancy(groupLesson, next, true);
+            }
+        });
+
+        if (transaction.commit() == 0) return result;
+    }
 
-    if (lesson == nullptr) return 3;
-    if (person == nullptr) return 4;
-    if (person->getLessonId() != id) return 5;
+    std::cerr << "Konflikt przy wypisie z lekcji o ID " << id << std::endl;
+    return 7;
+}
 
-    const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lesson);
+std::vector<int> LessonManager::removeStudentsFromGroupLesson(const int &id, const std::span<const int> personIds) const {
+    for (int attempt = 0; attempt < transactionAttempts; attempt++) {
+        std::vector<int> results(personIds.size(), 3);
+        Transaction transaction = beginTransaction();
+        const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lessonRepo->findByIndex(id));
+        if (groupLesson == nullptr || isFinishing(id)) return results;
+
+        std::deque<PersonPtr> waitlist;
+        transaction.read(VersionTable::Kind::Lesson, id, [&waitlist, &groupLesson] { waitlist = groupLesson->getWaitlist(); });
+        for (const PersonPtr &waiting : waitlist) {
+            transaction.read(VersionTable::Kind::Person, waiting->getId());
+        }
 
-    return groupLesson->removeStudent(person);
+        std::vector<PersonPtr> persons(personIds.size());
+        for (std::size_t i = 0; i < personIds.size(); i++) {
+            persons[i] = personRepo->findPersonById(personIds[i]);
+            if (persons[i] != nullptr) transaction.read(VersionTable::Kind::Person, personIds[i]);
+        }
+
+        transaction.stage([this, &results, &groupLesson, &persons, &personIds] {
+            std::vector<PersonPtr> leaving;
+            std::unordered_set<int> requested;
+            leaving.reserve(personIds.size());
+            requested.reserve(personIds.size());
+
+            for (std::size_t i = 0; i < personIds.size(); i++) {
+                if (persons[i] == nullptr) {
+                    results[i] = 4;
+                } else if (!requested.insert(personIds[i]).second ||
+                           (!groupLesson->hasStudent(personIds[i]) && !groupLesson->isWaitlisted(personIds[i]))) {
+                    results[i] = 5;
+                } else {
+                    persons[i]->removeFutureLesson(groupLesson);
+                    if (groupLesson->hasStudent(personIds[i])) {
+                        updateOccupancy(groupLesson, persons[i], false);
+                    }
+                    leaving.push_back(persons[i]);
+                    results[i] = 0;
+                }
+            }
+
+            std::vector<PersonPtr> promoted;
+            groupLesson->removeStudents(leaving, &promoted);
+            for (const PersonPtr &next : promoted) {
+                joinGroupLesson(groupLesson, next);
+                updateOccupancy(groupLesson, next, true);
+            }
+        });
+
+        if (transaction.commit() == 0) return results;
+    }
+
+    std::cerr << "Konflikt przy wypisie z lekcji o ID " << id << std::endl;
+    return std::vector<int>(personIds.size(), 7);
+}
+
+void LessonManager::joinGroupLesson(const GroupLessonPtr &groupLesson, const PersonPtr &student) const {
+    if (groupLesson->isStarted()) {
+        student->setDuringLesson(true);
+        student->setLessonId(groupLesson->getID());
+    } else {
+        student->addFutureLesson(groupLesson);
+    }
 }
 
 LessonPtr LessonManager::getLesson(const int &id) const {
@@ -110,91 +533,230 @@ std::string LessonManager::report() const {
     std::stringstream ss;
     int counter = 1;
 
-    for (const LessonPtr &lessonI : lessonRepo->findAll()) {
+    const auto lessons = lessonRepo->snapshot();
+    auto print = [&ss, &counter](const LessonPtr &lessonI) {
+        if (lessonI == nullptr) return;
         ss << counter << ". " << lessonI->getInfo() << std::endl;
         counter++;
-    }
+    };
+    lessons->started.forEach(print);
+    lessons->planned.forEach(print);
 
     return ss.str();
 }
 
 bool LessonManager::startLesson(const int &id) const {
-    const LessonPtr lesson = lessonRepo->findByIndex(id);
-    if (!lesson) {
-        std::cerr << "Nie znaleziono lekcji o ID " << id << std::endl;
-        return false;
-    }
-    lesson->getClassRoom()->setAvailable(false);
-
-    if (std::dynamic_pointer_cast<IndividualLesson>(lesson)) {
-        const auto  individual = std::dynamic_pointer_cast<IndividualLesson>(lesson);
-        individual->startLesson(true);
-        individual->getStudent()->removeFutureLesson(lesson);
-        individual->getStudent()->setDuringLesson(true);
-        individual->getStudent()->setLessonId(lesson->getID());
-        individual->getTeacher()->setDuringLesson(true);
-        individual->getTeacher()->setLessonId(lesson->getID());
-        return true;
-    }
-
-    if (std::dynamic_pointer_cast<GroupLesson>(lesson)) {
-        const auto  groupLesson = std::dynamic_pointer_cast<GroupLesson>(lesson);
-        groupLesson->startLesson(true);
-        std::vector students = groupLesson->getStudents();
-        lesson->getTeacher()->removeFutureLesson(lesson);
-        lesson->getTeacher()->setDuringLesson(true);
-        lesson->getTeacher()->setLessonId(lesson->getID());
-        for (auto& student : students) {
-            student->removeFutureLesson(lesson);
-            student->setDuringLesson(true);
-            student->setLessonId(lesson->getID());
-        }
-        return true;
+    for (int attempt = 0; attempt < transactionAttempts; attempt++) {
+        Transaction transaction = beginTransaction();
+        transaction.read(VersionTable::Kind::Lesson, id);
+
+        const LessonPtr lesson = lessonRepo->findByIndex(id);
+        if (!lesson || isFinishing(id)) {
+            std::cerr << "Nie znaleziono lekcji o ID " << id << std::endl;
+            return false;
+        }
+
+        const auto individual = std::dynamic_pointer_cast<IndividualLesson>(lesson);
+        const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lesson);
+        if (!individual && !groupLesson) return false;
+        readParticipants(transaction, lesson);
+
+        transaction.stage([this, &id, lesson, individual, groupLesson] {
+            lesson->getClassRoom()->setAvailable(false);
+            lesson->startLesson(true);
+            lessonRepo->setStarted(id, true);
+
+            if (individual) {
+                individual->getStudent()->removeFutureLesson(lesson);
+                individual->getStudent()->setDuringLesson(true);
+                individual->getStudent()->setLessonId(lesson->getID());
+                individual->getTeacher()->setDuringLesson(true);
+                individual->getTeacher()->setLessonId(lesson->getID());
+                return;
+            }
+
+            lesson->getTeacher()->removeFutureLesson(lesson);
+            lesson->getTeacher()->setDuringLesson(true);
+            lesson->getTeacher()->setLessonId(lesson->getID());
+            for (const auto& student : groupLesson->getStudents()) {
+                student->removeFutureLesson(lesson);
+                student->setDuringLesson(true);
+                student->setLessonId(lesson->getID());
+            }
+        });
+
+        if (transaction.commit() == 0) return true;
     }
+
+    std::cerr << "Konflikt przy rozpoczynaniu lekcji o ID " << id << std::endl;
     return false;
 }
 
 bool LessonManager::finishLesson(const int &id) const {
-    const auto lesson = lessonRepo->findByIndex(id);
-    if (!lesson) {
-        std::cerr << "Nie znaleziono lekcji o ID " << id << std::endl;
-        return false;
-    }
+    for (int attempt = 0; attempt < transactionAttempts; attempt++) {
+        Transaction transaction = beginTransaction();
+        transaction.read(VersionTable::Kind::Lesson, id);
+
+        const auto lesson = lessonRepo->findByIndex(id);
+        if (!lesson) {
+            std::cerr << "Nie znaleziono lekcji o ID " << id << std::endl;
+            return false;
+        }
 
-    for (const auto& person : personRepo->findAll()) {
-        if (person->getLessonId() == id) {
-            person->setDuringLesson(false);
-            person->setLessonId(-1);
+        if (isFinishing(id)) {
+            std::cerr << "Nie znaleziono lekcji o ID " << id << std::endl;
+            return false;
         }
-    }
 
-    const int classRoomId = lesson->getClassRoom()->getNumber();
+        const std::vector<PersonPtr> participants = readParticipants(transaction, lesson);
 
-    if (const auto classRoom = classRoomRepo->findClassRoomByNumber(classRoomId); classRoom) {
-        classRoom->setAvailable(true);
-    } else {
-        std::cerr << "Nie znaleziono sali o ID " << classRoomId << std::endl;
-    }
+        transaction.stage([this, &id, lesson, &participants] {
+            for (const auto& person : participants) {
+                if (person->getLessonId() == id) {
+                    person->setDuringLesson(false);
+                    person->setLessonId(-1);
+                }
+            }
+
+            const int classRoomId = lesson->getClassRoom()->getNumber();
+
+            if (const auto classRoom = classRoomRepo->findClassRoomByNumber(classRoomId); classRoom) {
+                classRoom->setAvailable(true);
+            } else {
+                std::cerr << "Nie znaleziono sali o ID " << classRoomId << std::endl;
+            }
 
-    lesson->finishLesson();
+            updateOccupancy(lesson, lesson->getBeginTime(), lesson->getEndTime(), false);
+            lesson->finishLesson();
 
-    if (removeLesson(id) == 0) {
-        return true;
+            std::lock_guard<std::mutex> lock(*finishingMutex);
+            finishing->insert(id);
+        });
+
+        if (transaction.commit() != 0) continue;
+
+        // The archive write and the repository's write lock are taken once the stripes are
+        // released; until then the lesson is marked, so a concurrent finish does not repeat it.
+        const bool removed = archiveAndRemove(lesson) == 0;
+        std::lock_guard<std::mutex> lock(*finishingMutex);
+        finishing->erase(id);
+        return removed;
     }
+
+    std::cerr << "Konflikt przy konczeniu lekcji o ID " << id << std::endl;
     return false;
 }
 
+std::vector<PersonPtr> LessonManager::readParticipants(Transaction &transaction, const LessonPtr &lesson) const {
+    std::vector<PersonPtr> participants{lesson->getTeacher()};
+    transaction.read(VersionTable::Kind::Lesson, lesson->getID(), [&participants, &lesson] {
+        if (const auto groupLesson = std::dynamic_pointer_cast<GroupLesson>(lesson); groupLesson != nullptr) {
+            participants.insert(participants.end(), groupLesson->getStudents().begin(), groupLesson->getStudents().end());
+        } else if (const auto individualLesson = std::dynamic_pointer_cast<IndividualLesson>(lesson); individualLesson != nullptr) {
+            participants.push_back(individualLesson->getStudent());
+        }
+    });
+    participants.erase(std::remove(participants.begin(), participants.end(), nullptr), participants.end());
+
+    const std::size_t own = participants.size();
+    for (std::size_t i = 0; i < own; i++) {
+        transaction.read(VersionTable::Kind::Person, participants[i]->getId());
+        if (const PersonPtr stored = personRepo->findPersonById(participants[i]->getId()); stored != nullptr && stored != participants[i]) {
+            participants.push_back(stored);
+        }
+    }
+    if (lesson->getClassRoom() != nullptr) transaction.read(VersionTable::Kind::ClassRoom, lesson->getClassRoom()->getNumber());
+
+    return participants;
+}
+
+bool LessonManager::isFinishing(const int id) const {
+    std::lock_guard<std::mutex> lock(*finishingMutex);
+    return finishing->contains(id);
+}
+
+Transaction LessonManager::beginTransaction() const {
+    return Transaction(versions);
+}
+
+long LessonManager::getTransactionConflicts() const {
+    return versions->getConflicts();
+}
+
 
 std::vector<LessonPtr> LessonManager::findLessons(const LessonPredicate& predicate) const {
-    return lessonRepo->findBy([predicate](const LessonPtr &lesson) {
-        return predicate(lesson);
-    });
+    return lessonRepo->findBy(predicate);
 }
 
 std::vector<LessonPtr> LessonManager::findAllLessons() const {
     return findLessons([](const LessonPtr &) { return true; });
 }
 
+std::vector<int> LessonManager::findLessonsToStart(const pt::ptime &now) const {
+    return lessonRepo->findToStart(now);
+}
+
+std::vector<int> LessonManager::findLessonsToFinish(const pt::ptime &now) const {
+    return lessonRepo->findToFinish(now);
+}
+
+std::vector<ClassRoomPtr> LessonManager::findFreeClassRooms(const pt::ptime &beginTime, const pt::ptime &endTime, const int minSeats, const std::string &type) const {
+    if (beginTime.is_special() || endTime.is_special() || endTime <= beginTime) return {};
+
+    const std::int64_t begin = LessonRepository::toEpochSeconds(beginTime);
+    const std::int64_t end = LessonRepository::toEpochSeconds(endTime);
+
+    return classRoomRepo->findBy([this, begin, end, minSeats, &type](const ClassRoomPtr &classRoom) {
+        return classRoom->getSeatsNumber() >= minSeats &&
+               lessonRepo->isClassRoomFree(classRoom->getNumber(), begin, end) &&
+               (type.empty() || classRoom->getClassRoomType()->getType() == type);
+    });
+}
+
+std::vector<PersonPtr> LessonManager::findFreeTeachers(const pt::ptime &beginTime, const pt::ptime &endTime) const {
+    if (beginTime.is_special() || endTime.is_special() || endTime <= beginTime) return {};
+
+    const std::int64_t begin = LessonRepository::toEpochSeconds(beginTime);
+    const std::int64_t end = LessonRepository::toEpochSeconds(endTime);
+
+    return personRepo->findBy([this, begin, end](const PersonPtr &person) {
+        return lessonRepo->isTeacherFree(person->getId(), begin, end);
+    });
+}
+
+pt::ptime LessonManager::findCommonFreeSlot(const int classRoomNumber, const int teacherId, const std::vector<int> &studentIds,
+                                            const pt::time_duration &duration, const pt::ptime &from) const {
+    if (from.is_special() || duration.is_special() || duration.total_seconds() <= 0) return pt::not_a_date_time;
+
+    std::vector<const WeeklyOccupancy*> grids;
+    grids.reserve(studentIds.size() + 2);
+
+    if (const ClassRoomPtr classRoom = classRoomRepo->findClassRoomByNumber(classRoomNumber); classRoom != nullptr) {
+        grids.push_back(&classRoom->getOccupancy());
+    }
+    if (const PersonPtr teacher = personRepo->findPersonById(teacherId); teacher != nullptr) {
+        grids.push_back(&teacher->getOccupancy());
+    }
+    for (const int studentId : studentIds) {
+        if (const PersonPtr student = personRepo->findPersonById(studentId); student != nullptr) {
+            grids.push_back(&student->getOccupancy());
+        }
+    }
+
+    constexpr int slotSeconds = WeeklyOccupancy::slotMinutes * 60;
+    const int slotsNeeded = static_cast<int>((duration.total_seconds() + slotSeconds - 1) / slotSeconds);
+    const long offset = from.time_of_day().total_seconds() % slotSeconds;
+    const pt::ptime start = offset == 0 ? from : from + pt::seconds(slotSeconds - offset);
+    const int startSlot = WeeklyOccupancy::slotOf(start);
+
+    const int slot = WeeklyOccupancy::findCommonFreeSlot(grids, slotsNeeded, startSlot);
+    if (slot < 0) return pt::not_a_date_time;
+
+    const int slotsAhead = (slot - startSlot + WeeklyOccupancy::slotsPerWeek) % WeeklyOccupancy::slotsPerWeek;
+
+    return start + pt::seconds(static_cast<long>(slotsAhead) * slotSeconds);
+}
+
 std::vector<LessonPtr> LessonManager::findStartedLessons() const {
     return lessonRepo->getStartedLessons();
 }
@@ -204,7 +766,17 @@ std::vector<LessonPtr> LessonManager::findPlannedLessons() const {
 }
 
 void LessonManager::saveArchive(const int personalId) const {
+    if (lessonFilesStorage == nullptr) return;
+
+    // The lesson is about to be removed from the repository, so the line is built at once and
+    // appended in the background, after every archive write queued before it.
+    if (const LessonPtr lesson = lessonRepo->findByIndex(personalId); flusher != nullptr && lesson != nullptr) {
+        (void) flusher->append(LessonFilesStorage::archiveFile, lesson->getAttributes() + "\n");
+        return;
+    }
+
     try {
+        std::lock_guard<std::mutex> lock(*archiveMutex);
         lessonFilesStorage->saveArchive(lessonRepo, personalId);
     } catch (const std::exception &e) {
         std::cerr << "Blad archiwum: " << e.what() << std::endl;
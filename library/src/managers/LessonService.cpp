@@ -0,0 +1,123 @@
+#include "managers/LessonService.h"
+#include "managers/LessonManager.h"
+#include "concurrency/Executor.h"
+#include "storages/FileIO.h"
+#include "storages/Flusher.h"
+#include "storages/LessonFilesStorage.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+
+LessonService::LessonService(LessonManagerPtr lessonManager, FlusherPtr flusher, FileIOPtr fileIO)
+    : lessonManager(std::move(lessonManager)), flusher(std::move(flusher)), fileIO(std::move(fileIO)) {
+}
+
+Task<bool> LessonService::persist() const {
+    if (flusher == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        co_return lessonManager->save();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        (void) lessonManager->saveAsync();
+    }
+    co_return co_await Completion<bool>([this](std::function<void(bool)> done) {
+        flusher->whenWritten(LessonFilesStorage::databaseFile, std::move(done));
+    });
+}
+
+Task<LessonPtr> LessonService::plan(PersonPtr teacher, pt::ptime beginTime, pt::ptime endTime, int baseCost, std::string subject,
+                                    ClassRoomPtr classRoom) const {
+    LessonPtr lesson;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        lesson = lessonManager->addGroupLesson(teacher, beginTime, endTime, baseCost, subject, classRoom, false);
+    }
+    if (lesson == nullptr) co_return nullptr;
+
+    co_await persist();
+    co_return lesson;
+}
+
+Task<std::vector<int>> LessonService::enroll(int id, std::vector<int> personIds) const {
+    std::vector<int> results;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        results = lessonManager->enrollStudents(id, personIds);
+    }
+
+    co_await persist();
+    co_return results;
+}
+
+Task<bool> LessonService::start(int id) const {
+    bool started;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        started = lessonManager->startLesson(id);
+    }
+    if (!started) co_return false;
+
+    co_return co_await persist();
+}
+
+Task<bool> LessonService::finish(int id) const {
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = lessonManager->finishLesson(id);
+    }
+    if (!finished) co_return false;
+
+    bool archived = true;
+    if (flusher != nullptr) {
+        archived = co_await Completion<bool>([this](std::function<void(bool)> done) {
+            flusher->whenWritten(LessonFilesStorage::archiveFile, std::move(done));
+        });
+    }
+    const bool saved = co_await persist();
+
+    co_return archived && saved;
+}
+
+Task<std::string> LessonService::report() const {
+    std::string report;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        report = lessonManager->report();
+    }
+    co_return report;
+}
+
+Task<std::string> LessonService::archive() const {
+    const std::string fileName = LessonFilesStorage::archiveFile;
+
+    if (fileIO == nullptr) {
+        std::ifstream inputFile(fileName);
+        if (!inputFile) throw std::runtime_error("Blad otwierania pliku " + fileName);
+
+        std::stringstream contents;
+        contents << inputFile.rdbuf();
+        co_return contents.str();
+    }
+
+    // A pending archive entry is written first, so the archive read back includes every finished lesson.
+    if (flusher != nullptr) {
+        co_await Completion<bool>([this](std::function<void(bool)> done) {
+            flusher->whenWritten(LessonFilesStorage::archiveFile, std::move(done));
+        });
+    }
+
+    Completion<std::pair<bool, std::string>> reading([this, fileName](std::function<void(std::pair<bool, std::string>)> done) {
+        fileIO->submitRead(fileName, [done = std::move(done)](const bool read, std::string contents) {
+            done({read, std::move(contents)});
+        });
+    });
+    std::pair<bool, std::string> read = co_await reading;
+    if (!read.first) throw std::runtime_error("Blad otwierania pliku " + fileName);
+
+    co_return std::move(read.second);
+}
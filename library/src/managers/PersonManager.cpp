@@ -3,6 +3,8 @@
 #include <iostream>
 
 #include "storages/PersonFilesStorage.h"
+#include "concurrency/TaskPool.h"
+#include "storages/Flusher.h"
 #include <sstream>
 #include <utility>
 
@@ -20,6 +22,28 @@ bool PersonManager::savePersons() const {
     }
 }
 
+std::shared_future<bool> PersonManager::savePersonsAsync() const {
+    if (flusher == nullptr) {
+        std::promise<bool> saved;
+        saved.set_value(savePersons());
+        return saved.get_future().share();
+    }
+
+    return flusher->flush(PersonFilesStorage::databaseFile, PersonFilesStorage::serialize(personRepo));
+}
+
+std::future<std::string> PersonManager::reportAsync() const {
+    return TaskPool::submitTo(taskPool, [this] { return report(); });
+}
+
+void PersonManager::setTaskPool(TaskPoolPtr taskPool) {
+    this->taskPool = std::move(taskPool);
+}
+
+void PersonManager::setFlusher(FlusherPtr flusher) {
+    this->flusher = std::move(flusher);
+}
+
 bool PersonManager::loadPersons() {
     try {
         return personFilesStorage->load(personRepo);
@@ -77,11 +101,12 @@ PersonPtr PersonManager::getPerson(const int id) const {
 std::string PersonManager::report() const {
     std::stringstream ss;
 
-    for (auto& person : personRepo->findAll()) {
+    // Walks a snapshot, so a long report holds no lock and does not delay changes.
+    personRepo->snapshot()->forEach([&ss](const PersonPtr &person) {
         if (person != nullptr) {
             ss << person->getInfo() << std::endl;
         }
-    }
+    });
 
     return ss.str();
 }
@@ -91,7 +116,5 @@ std::vector<PersonPtr> PersonManager::findAllPersons() const {
 }
 
 std::vector<PersonPtr> PersonManager::findPersons(const PersonPredicate& predicate) const {
-    return personRepo->findBy([predicate](const PersonPtr& person) {
-        return predicate(person);
-    });
+    return personRepo->findBy(predicate);
 }
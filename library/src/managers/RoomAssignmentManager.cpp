@@ -0,0 +1,191 @@
+#include "managers/RoomAssignmentManager.h"
+#include "repositories/ClassRoomRepository.h"
+#include "repositories/LessonRepository.h"
+#include "model/ClassRoom.h"
+#include "model/ClassRoomType.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+
+namespace {
+    /** Cost of an assignment that is not allowed; large enough to lose against any real one. */
+    constexpr double forbiddenCost = 1e12;
+
+    /**
+     * Solves the rectangular assignment problem for a rows x cols cost matrix (rows <= cols) with the
+     * Hungarian algorithm and returns the column chosen for every row.
+     */
+    std::vector<int> solveAssignment(const std::vector<double> &cost, const int rows, const int cols) {
+        const double infinity = std::numeric_limits<double>::infinity();
+        std::vector<double> u(rows + 1, 0.0), v(cols + 1, 0.0), minv(cols + 1);
+        std::vector<int> match(cols + 1, 0), way(cols + 1, 0);
+        std::vector<char> used(cols + 1);
+
+        for (int row = 1; row <= rows; row++) {
+            match[0] = row;
+            int j0 = 0;
+            std::fill(minv.begin(), minv.end(), infinity);
+            std::fill(used.begin(), used.end(), 0);
+
+            do {
+                used[j0] = 1;
+                const int i0 = match[j0];
+                const double *costRow = &cost[static_cast<std::size_t>(i0 - 1) * cols];
+                double delta = infinity;
+                int j1 = 0;
+
+                for (int j = 1; j <= cols; j++) {
+                    if (used[j]) continue;
+                    const double current = costRow[j - 1] - u[i0] - v[j];
+                    if (current < minv[j]) {
+                        minv[j] = current;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+
+                for (int j = 0; j <= cols; j++) {
+                    if (used[j]) {
+                        u[match[j]] += delta;
+                        v[j] -= delta;
+                    } else {
+                        minv[j] -= delta;
+                    }
+                }
+                j0 = j1;
+            } while (match[j0] != 0);
+
+            do {
+                const int j1 = way[j0];
+                match[j0] = match[j1];
+                j0 = j1;
+            } while (j0 != 0);
+        }
+
+        std::vector<int> assignment(rows, -1);
+        for (int j = 1; j <= cols; j++) {
+            if (match[j] != 0) assignment[match[j] - 1] = j - 1;
+        }
+
+        return assignment;
+    }
+
+    /** Fields of a classroom read on every cost evaluation, copied out once per call. */
+    struct RoomInfo {
+        ClassRoomPtr classRoom;
+        int number;
+        int seats;
+        double rentCost;
+        std::string type;
+    };
+}
+
+RoomAssignmentManager::RoomAssignmentManager(ClassRoomRepositoryPtr classRoomRepo, LessonRepositoryPtr lessonRepo,
+                                             const double wastedSeatCost, const double typeMismatchCost)
+    : classRoomRepo(std::move(classRoomRepo)), lessonRepo(std::move(lessonRepo)), wastedSeatCost(wastedSeatCost),
+      typeMismatchCost(typeMismatchCost) {
+}
+
+std::vector<ClassRoomPtr> RoomAssignmentManager::assignRooms(const std::vector<Request> &requests) const {
+    std::vector<ClassRoomPtr> result(requests.size());
+
+    std::vector<RoomInfo> rooms;
+    for (const ClassRoomPtr &classRoom : classRoomRepo->findAll()) {
+        rooms.push_back({classRoom, classRoom->getNumber(), classRoom->getSeatsNumber(), classRoom->getActualRentCost(),
+                         classRoom->getClassRoomType()->getType()});
+    }
+
+    std::vector<std::int64_t> begins(requests.size()), ends(requests.size());
+    std::vector<int> order;
+    order.reserve(requests.size());
+    for (std::size_t i = 0; i < requests.size(); i++) {
+        begins[i] = LessonRepository::toEpochSeconds(requests[i].beginTime);
+        ends[i] = LessonRepository::toEpochSeconds(requests[i].endTime);
+        if (!requests[i].beginTime.is_special() && !requests[i].endTime.is_special() && begins[i] < ends[i]) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&begins](const int first, const int second) {
+        return begins[first] < begins[second];
+    });
+
+    // Rooms taken by lessons of earlier batches, released once those lessons end.
+    std::vector<char> busy(rooms.size(), 0);
+    std::priority_queue<std::pair<std::int64_t, int>, std::vector<std::pair<std::int64_t, int>>, std::greater<>> releases;
+
+    std::vector<int> batch;
+    std::vector<int> columns;
+    std::vector<char> freeForBatch;
+    std::vector<double> cost;
+
+    for (std::size_t first = 0; first < order.size();) {
+        const std::int64_t batchBegin = begins[order[first]];
+        std::size_t last = first;
+        while (last < order.size() && begins[order[last]] == batchBegin) last++;
+        batch.assign(order.begin() + static_cast<std::ptrdiff_t>(first), order.begin() + static_cast<std::ptrdiff_t>(last));
+        first = last;
+
+        while (!releases.empty() && releases.top().first <= batchBegin) {
+            busy[releases.top().second] = 0;
+            releases.pop();
+        }
+
+        const int smallestHeadcount = std::accumulate(batch.begin(), batch.end(), std::numeric_limits<int>::max(),
+                                                      [&requests](const int least, const int request) {
+                                                          return std::min(least, requests[request].headcount);
+                                                      });
+
+        const std::int64_t latestEnd = std::accumulate(batch.begin(), batch.end(), batchBegin,
+                                                       [&ends](const std::int64_t latest, const int request) {
+                                                           return std::max(latest, ends[request]);
+                                                       });
+
+        // A room free for the whole batch needs no per-lesson check against the stored lessons.
+        columns.clear();
+        freeForBatch.clear();
+        for (std::size_t r = 0; r < rooms.size(); r++) {
+            if (busy[r] || rooms[r].seats < smallestHeadcount) continue;
+            columns.push_back(static_cast<int>(r));
+            freeForBatch.push_back(lessonRepo->isClassRoomFree(rooms[r].number, batchBegin, latestEnd));
+        }
+
+        const int rows = static_cast<int>(batch.size());
+        const int roomColumns = static_cast<int>(columns.size());
+        const int cols = std::max(rows, roomColumns);
+        cost.assign(static_cast<std::size_t>(rows) * cols, forbiddenCost);
+
+        for (int row = 0; row < rows; row++) {
+            const Request &request = requests[batch[row]];
+            double *costRow = &cost[static_cast<std::size_t>(row) * cols];
+
+            for (int c = 0; c < roomColumns; c++) {
+                const RoomInfo &room = rooms[columns[c]];
+                if (room.seats < request.headcount) continue;
+                if (!freeForBatch[c] && !lessonRepo->isClassRoomFree(room.number, batchBegin, ends[batch[row]])) continue;
+
+                costRow[c] = room.rentCost + wastedSeatCost * (room.seats - request.headcount) +
+                             (request.type.empty() || request.type == room.type ? 0.0 : typeMismatchCost);
+            }
+        }
+
+        const std::vector<int> assignment = solveAssignment(cost, rows, cols);
+
+        for (int row = 0; row < rows; row++) {
+            const int c = assignment[row];
+            if (c < 0 || c >= roomColumns || cost[static_cast<std::size_t>(row) * cols + c] >= forbiddenCost) continue;
+
+            const int room = columns[c];
+            result[batch[row]] = rooms[room].classRoom;
+            busy[room] = 1;
+            releases.emplace(ends[batch[row]], room);
+        }
+    }
+
+    return result;
+}
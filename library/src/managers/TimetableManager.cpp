@@ -0,0 +1,366 @@
+#include "managers/TimetableManager.h"
+#include "repositories/PersonRepository.h"
+#include "repositories/ClassRoomRepository.h"
+#include "model/ClassRoom.h"
+#include "model/ClassRoomType.h"
+#include "model/GroupLesson.h"
+#include "model/IndividualLesson.h"
+#include "model/Person.h"
+#include "model/WeeklyOccupancy.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+
+namespace {
+    namespace gr = boost::gregorian;
+
+    /** Temperature the annealing ends at, in units of cost. */
+    constexpr double finalTemperature = 0.05;
+
+    /**
+     * Read-only description of the search space, shared by all chains.
+     */
+    struct Problem {
+        int days;
+        int cellsPerDay;
+        int cells; /**< days * cellsPerDay; cell of day d at offset k is d * cellsPerDay + k. */
+        int roomCount;
+        std::vector<std::vector<int>> coursePersons; /**< Teacher and students of every course, as person indices. */
+        std::vector<std::vector<int>> courseRooms; /**< Classrooms a course may be placed in. */
+        std::vector<int> courseLength; /**< Length of a lesson of every course in cells. */
+        std::vector<double> roomCost; /**< Soft cost of course c in classroom r at c * roomCount + r. */
+        std::vector<int> itemCourse; /**< Course of every lesson to place. */
+        std::vector<std::uint16_t> personBusy; /**< 1 where a person is already booked, at person * cells + cell. */
+        std::vector<std::uint16_t> roomBusy; /**< 1 where a classroom is already booked, at room * cells + cell. */
+        double sameDayCost;
+        double conflictCost;
+    };
+
+    /**
+     * A single simulated annealing chain with incrementally maintained booking counts.
+     */
+    class Chain {
+        const Problem &problem;
+        std::vector<std::uint16_t> personLoad;
+        std::vector<std::uint16_t> roomLoad;
+        std::vector<std::uint16_t> courseDays;
+        std::mt19937 random;
+
+        /** Books or releases one cell and returns the change in the number of conflicts it causes. */
+        static int bump(std::uint16_t &load, const int sign) {
+            if (sign > 0) return load++ > 0 ? 1 : 0;
+            return --load > 0 ? -1 : 0;
+        }
+
+        /** Adds (sign = 1) or removes (sign = -1) a lesson at its current cell and classroom. */
+        void place(const int item, const int sign) {
+            const int course = problem.itemCourse[item];
+            const int first = start[item];
+            const int last = first + problem.courseLength[course];
+
+            for (const int person : problem.coursePersons[course]) {
+                std::uint16_t *loads = &personLoad[static_cast<std::size_t>(person) * problem.cells];
+                for (int cell = first; cell < last; cell++) conflicts += bump(loads[cell], sign);
+            }
+
+            std::uint16_t *loads = &roomLoad[static_cast<std::size_t>(room[item]) * problem.cells];
+            for (int cell = first; cell < last; cell++) conflicts += bump(loads[cell], sign);
+
+            softCost += bump(courseDays[course * problem.days + first / problem.cellsPerDay], sign) * problem.sameDayCost;
+            softCost += sign * problem.roomCost[static_cast<std::size_t>(course) * problem.roomCount + room[item]];
+        }
+
+        void move(const int item, const int newStart, const int newRoom) {
+            place(item, -1);
+            start[item] = newStart;
+            room[item] = newRoom;
+            place(item, 1);
+        }
+
+        int uniform(const int from, const int to) {
+            return std::uniform_int_distribution<int>(from, to)(random);
+        }
+
+        int randomStart(const int course) {
+            return uniform(0, problem.days - 1) * problem.cellsPerDay + uniform(0, problem.cellsPerDay - problem.courseLength[course]);
+        }
+
+        int randomRoom(const int course) {
+            const std::vector<int> &rooms = problem.courseRooms[course];
+            return rooms[uniform(0, static_cast<int>(rooms.size()) - 1)];
+        }
+
+        bool fits(const int item, const int newStart) const {
+            return newStart % problem.cellsPerDay + problem.courseLength[problem.itemCourse[item]] <= problem.cellsPerDay;
+        }
+
+    public:
+        std::vector<int> start;
+        std::vector<int> room;
+        int conflicts = 0;
+        double softCost = 0.0;
+        std::vector<int> bestStart;
+        std::vector<int> bestRoom;
+        int bestConflicts = 0;
+        double bestScore = std::numeric_limits<double>::infinity();
+
+        Chain(const Problem &problem, const unsigned seed)
+            : problem(problem), personLoad(problem.personBusy), roomLoad(problem.roomBusy),
+              courseDays(problem.courseLength.size() * problem.days, 0), random(seed),
+              start(problem.itemCourse.size()), room(problem.itemCourse.size()) {
+            for (std::size_t item = 0; item < start.size(); item++) {
+                const int course = problem.itemCourse[item];
+                start[item] = randomStart(course);
+                room[item] = randomRoom(course);
+                place(static_cast<int>(item), 1);
+            }
+            remember();
+        }
+
+        [[nodiscard]] double score() const {
+            return conflicts * problem.conflictCost + softCost;
+        }
+
+        void remember() {
+            bestStart = start;
+            bestRoom = room;
+            bestConflicts = conflicts;
+            bestScore = score();
+        }
+
+        /**
+         * Runs the annealing, cooling geometrically from the given temperature, and calls
+         * checkpoint(iteration) every interval iterations.
+         */
+        template <typename Checkpoint>
+        void anneal(const long iterations, const double temperature, const long interval, Checkpoint checkpoint) {
+            const int items = static_cast<int>(start.size());
+            if (items == 0) return;
+
+            const double cooling = iterations > 0 ? std::pow(finalTemperature / temperature, 1.0 / iterations) : 1.0;
+            std::uniform_real_distribution<double> chance(0.0, 1.0);
+            double current = temperature;
+
+            for (long iteration = 1; iteration <= iterations; iteration++, current *= cooling) {
+                const double before = score();
+                const int item = uniform(0, items - 1);
+                const int course = problem.itemCourse[item];
+                const int oldStart = start[item];
+                const int oldRoom = room[item];
+                const int kind = uniform(0, 9);
+                int other = -1;
+
+                if (kind < 5) {
+                    move(item, randomStart(course), kind == 0 ? randomRoom(course) : oldRoom);
+                } else if (kind < 8) {
+                    move(item, oldStart, randomRoom(course));
+                } else {
+                    other = uniform(0, items - 1);
+                    if (other == item || !fits(item, start[other]) || !fits(other, oldStart)) {
+                        other = -1;
+                    } else {
+                        move(item, start[other], oldRoom);
+                        move(other, oldStart, room[other]);
+                    }
+                }
+
+                const double delta = score() - before;
+                if (delta > 0 && chance(random) >= std::exp(-delta / current)) {
+                    if (other >= 0) move(other, start[item], room[other]);
+                    move(item, oldStart, oldRoom);
+                } else if (score() < bestScore) {
+                    remember();
+                }
+
+                if (interval > 0 && iteration % interval == 0) checkpoint(iteration);
+            }
+        }
+    };
+
+    /** Marks every cell of the working week in which a weekly bitmap has a busy slot. */
+    void markBusy(const WeeklyOccupancy::Bits &bits, const TimetableManager::Options &options, const int cellsPerDay,
+                  std::uint16_t *busy) {
+        const int slotsPerCell = options.stepMinutes / WeeklyOccupancy::slotMinutes;
+
+        for (int day = 0; day < options.days; day++) {
+            for (int cell = 0; cell < cellsPerDay; cell++) {
+                const int first = ((day * 24 + options.dayStartHour) * 60 + cell * options.stepMinutes) / WeeklyOccupancy::slotMinutes;
+                for (int slot = first; slot < first + slotsPerCell; slot++) {
+                    if (bits[slot / 64] >> (slot % 64) & 1) {
+                        busy[day * cellsPerDay + cell] = 1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TimetableManager::TimetableManager(PersonRepositoryPtr personRepo, ClassRoomRepositoryPtr classRoomRepo, const double wastedSeatCost,
+                                   const double typeMismatchCost, const double sameDayCost, const double conflictCost)
+    : personRepo(std::move(personRepo)), classRoomRepo(std::move(classRoomRepo)), wastedSeatCost(wastedSeatCost),
+      typeMismatchCost(typeMismatchCost), sameDayCost(sameDayCost), conflictCost(conflictCost) {
+}
+
+TimetableManager::Result TimetableManager::generate(const std::vector<Course> &courses, const Options &options) const {
+    Result result{{}, 0.0, 0, 0, {}};
+
+    const bool valid = !options.weekStart.is_special() && options.days >= 1 && options.days <= 7 &&
+                       options.dayStartHour >= 0 && options.dayStartHour < options.dayEndHour && options.dayEndHour <= 24 &&
+                       options.stepMinutes > 0 && options.stepMinutes % WeeklyOccupancy::slotMinutes == 0 &&
+                       options.iterations >= 0 && conflictCost > 0;
+
+    const int cellsPerDay = valid ? (options.dayEndHour - options.dayStartHour) * 60 / options.stepMinutes : 0;
+    const std::vector<ClassRoomPtr> classRooms = classRoomRepo->findAll();
+
+    Problem problem{options.days, cellsPerDay, options.days * cellsPerDay, static_cast<int>(classRooms.size()),
+                    {}, {}, {}, {}, {}, {}, {}, sameDayCost, conflictCost};
+
+    std::vector<PersonPtr> persons;
+    std::unordered_map<int, int> personIndex;
+    std::vector<const Course*> placedCourses;
+    std::vector<std::vector<PersonPtr>> courseStudents;
+
+    auto indexOf = [&persons, &personIndex](const PersonPtr &person) {
+        const auto [it, inserted] = personIndex.emplace(person->getId(), static_cast<int>(persons.size()));
+        if (inserted) persons.push_back(person);
+        return it->second;
+    };
+
+    for (const Course &course : courses) {
+        if (course.lessonsPerWeek <= 0) continue;
+
+        const int length = (course.durationMinutes + options.stepMinutes - 1) / std::max(options.stepMinutes, 1);
+        const PersonPtr teacher = personRepo->findPersonById(course.teacherId);
+        if (cellsPerDay == 0 || teacher == nullptr || course.durationMinutes <= 0 || length > cellsPerDay || classRooms.empty()) {
+            result.skipped += course.lessonsPerWeek;
+            continue;
+        }
+
+        std::vector<int> attendees{indexOf(teacher)};
+        std::vector<PersonPtr> students;
+        for (const int studentId : course.studentIds) {
+            const PersonPtr student = personRepo->findPersonById(studentId);
+            if (student == nullptr) continue;
+
+            const int index = indexOf(student);
+            if (std::find(attendees.begin(), attendees.end(), index) != attendees.end()) continue;
+            attendees.push_back(index);
+            students.push_back(student);
+        }
+
+        const int headcount = static_cast<int>(students.size());
+        std::vector<int> rooms;
+        for (int r = 0; r < problem.roomCount; r++) {
+            if (classRooms[r]->getSeatsNumber() >= headcount) rooms.push_back(r);
+        }
+        if (rooms.empty()) {
+            rooms.resize(problem.roomCount);
+            for (int r = 0; r < problem.roomCount; r++) rooms[r] = r;
+        }
+
+        const int courseIndex = static_cast<int>(placedCourses.size());
+        for (const ClassRoomPtr &classRoom : classRooms) {
+            problem.roomCost.push_back(wastedSeatCost * std::max(classRoom->getSeatsNumber() - headcount, 0) +
+                                       (course.type.empty() || course.type == classRoom->getClassRoomType()->getType() ? 0.0 : typeMismatchCost));
+        }
+        problem.coursePersons.push_back(std::move(attendees));
+        problem.courseRooms.push_back(std::move(rooms));
+        problem.courseLength.push_back(length);
+        problem.itemCourse.insert(problem.itemCourse.end(), course.lessonsPerWeek, courseIndex);
+        placedCourses.push_back(&course);
+        courseStudents.push_back(std::move(students));
+    }
+
+    if (problem.itemCourse.empty()) return result;
+
+    problem.personBusy.assign(persons.size() * problem.cells, 0);
+    for (std::size_t p = 0; p < persons.size(); p++) {
+        markBusy(persons[p]->getOccupancy().getBits(), options, cellsPerDay, &problem.personBusy[p * problem.cells]);
+    }
+    problem.roomBusy.assign(classRooms.size() * problem.cells, 0);
+    for (std::size_t r = 0; r < classRooms.size(); r++) {
+        markBusy(classRooms[r]->getOccupancy().getBits(), options, cellsPerDay, &problem.roomBusy[r * problem.cells]);
+    }
+
+    const int threads = options.threads > 0 ? options.threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const auto started = std::chrono::steady_clock::now();
+    auto elapsed = [started] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    };
+
+    std::mutex bestMutex;
+    double bestScore = std::numeric_limits<double>::infinity();
+    int bestConflicts = 0;
+    std::vector<int> bestStart, bestRoom;
+
+    // Called by every chain at its checkpoints; publishes the chain's best and reports progress.
+    auto publish = [&](const int thread, const long iteration, const Chain &chain) {
+        std::lock_guard<std::mutex> lock(bestMutex);
+
+        if (chain.bestScore < bestScore) {
+            bestScore = chain.bestScore;
+            bestConflicts = chain.bestConflicts;
+            bestStart = chain.bestStart;
+            bestRoom = chain.bestRoom;
+            result.bestOverTime.push_back({elapsed(), bestScore});
+        }
+
+        if (options.onProgress) {
+            options.onProgress({thread, iteration, chain.score(), bestScore, bestConflicts, elapsed()});
+        }
+    };
+
+    auto run = [&](const int thread) {
+        Chain chain(problem, options.seed + static_cast<unsigned>(thread));
+        chain.anneal(options.iterations, std::max(conflictCost / 2, finalTemperature), options.progressInterval,
+                     [&](const long iteration) { publish(thread, iteration, chain); });
+        if (options.iterations == 0 || options.progressInterval <= 0 || options.iterations % options.progressInterval != 0) {
+            publish(thread, options.iterations, chain);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int thread = 1; thread < threads; thread++) {
+        workers.emplace_back(run, thread);
+    }
+    run(0);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    const gr::date monday = options.weekStart.date() - gr::days((options.weekStart.date().day_of_week().as_number() + 6) % 7);
+
+    for (std::size_t item = 0; item < problem.itemCourse.size(); item++) {
+        const int courseIndex = problem.itemCourse[item];
+        const Course &course = *placedCourses[courseIndex];
+        const std::vector<PersonPtr> &students = courseStudents[courseIndex];
+        const PersonPtr &teacher = persons[problem.coursePersons[courseIndex].front()];
+        const ClassRoomPtr &classRoom = classRooms[bestRoom[item]];
+
+        const pt::ptime beginTime(monday + gr::days(bestStart[item] / cellsPerDay),
+                                  pt::hours(options.dayStartHour) + pt::minutes(bestStart[item] % cellsPerDay * options.stepMinutes));
+        const pt::ptime endTime = beginTime + pt::minutes(course.durationMinutes);
+
+        if (students.size() == 1) {
+            result.lessons.push_back(std::make_shared<IndividualLesson>(teacher, beginTime, endTime, course.baseCost, course.subject,
+                                                                        classRoom, students.front()));
+        } else {
+            const GroupLessonPtr lesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, course.baseCost, course.subject, classRoom);
+            lesson->addStudents(students);
+            result.lessons.push_back(lesson);
+        }
+    }
+
+    result.cost = bestScore;
+    result.conflicts = bestConflicts;
+
+    return result;
+}
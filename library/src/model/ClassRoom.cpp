@@ -54,6 +54,14 @@ void ClassRoom::setSeatsNumber(const int newSeatsNumber){
     }
 }
 
+const WeeklyOccupancy& ClassRoom::getOccupancy() const {
+    return occupancy;
+}
+
+WeeklyOccupancy& ClassRoom::getOccupancy() {
+    return occupancy;
+}
+
 std::string ClassRoom::getInfo() const{
     std::stringstream ss;
 
@@ -0,0 +1,130 @@
+#include "model/ClassRoomTypeFactory.h"
+#include "model/ITClassRoom.h"
+#include "model/MathClassRoom.h"
+#include "model/EngClassRoom.h"
+#include <array>
+
+namespace {
+    /**
+     * @brief Entry of the compile-time classroom type registry.
+     */
+    struct Registration {
+        std::string_view tag; /**< Serialized type tag. */
+        ClassRoomTypePtr (*create)(int equipment); /**< Returns the canonical instance for an equipment value. */
+    };
+
+    ClassRoomTypePtr createIT(const int equipment) {
+        return ClassRoomTypeFactory::getITClassRoom(equipment);
+    }
+
+    ClassRoomTypePtr createMath(const int equipment) {
+        return ClassRoomTypeFactory::getMathClassRoom(equipment == 1);
+    }
+
+    ClassRoomTypePtr createEng(const int equipment) {
+        return ClassRoomTypeFactory::getEngClassRoom(equipment == 1);
+    }
+
+    constexpr Registration registrations[] = {
+        {"IT", &createIT},
+        {"MATH", &createMath},
+        {"ENG", &createEng},
+    };
+
+    constexpr std::size_t registrationsCount = sizeof(registrations) / sizeof(registrations[0]);
+    constexpr std::size_t slotsCount = 8;
+
+    constexpr std::size_t tagHash(const std::string_view tag) {
+        if (tag.empty()) return 0;
+        return (tag.size() * 31 + static_cast<unsigned char>(tag.front())) % slotsCount;
+    }
+
+    constexpr std::array<int, slotsCount> buildSlots() {
+        std::array<int, slotsCount> slots{};
+        for (std::size_t i = 0; i < slotsCount; i++) slots[i] = -1;
+        for (std::size_t i = 0; i < registrationsCount; i++) slots[tagHash(registrations[i].tag)] = static_cast<int>(i);
+        return slots;
+    }
+
+    constexpr bool isPerfectHash() {
+        for (std::size_t i = 0; i < registrationsCount; i++) {
+            for (std::size_t j = i + 1; j < registrationsCount; j++) {
+                if (tagHash(registrations[i].tag) == tagHash(registrations[j].tag)) return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(isPerfectHash(), "Classroom type tags collide in the registry hash, adjust tagHash or slotsCount");
+
+    constexpr std::array<int, slotsCount> slots = buildSlots();
+
+    const Registration *findRegistration(const std::string_view type) {
+        const int slot = slots[tagHash(type)];
+        if (slot < 0 || registrations[slot].tag != type) return nullptr;
+        return &registrations[slot];
+    }
+}
+
+
+std::map<int, ClassRoomTypePtr> ClassRoomTypeFactory::itClassRooms;
+ClassRoomTypePtr ClassRoomTypeFactory::mathClassRooms[2];
+ClassRoomTypePtr ClassRoomTypeFactory::engClassRooms[2];
+std::mutex ClassRoomTypeFactory::mutex;
+
+ClassRoomTypePtr ClassRoomTypeFactory::getITClassRoom(const int computerCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ClassRoomTypePtr &classRoomType = itClassRooms[computerCount];
+
+    if (classRoomType == nullptr) {
+        classRoomType = std::make_shared<ITClassRoom>(computerCount);
+    }
+
+    return classRoomType;
+}
+
+ClassRoomTypePtr ClassRoomTypeFactory::getMathClassRoom(const bool formulasTables) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ClassRoomTypePtr &classRoomType = mathClassRooms[formulasTables];
+
+    if (classRoomType == nullptr) {
+        classRoomType = std::make_shared<MathClassRoom>(formulasTables);
+    }
+
+    return classRoomType;
+}
+
+ClassRoomTypePtr ClassRoomTypeFactory::getEngClassRoom(const bool headphones) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ClassRoomTypePtr &classRoomType = engClassRooms[headphones];
+
+    if (classRoomType == nullptr) {
+        classRoomType = std::make_shared<EngClassRoom>(headphones);
+    }
+
+    return classRoomType;
+}
+
+ClassRoomTypePtr ClassRoomTypeFactory::create(const std::string_view type, const int equipment) {
+    if (const Registration *registration = findRegistration(type); registration != nullptr) {
+        return registration->create(equipment);
+    }
+
+    return nullptr;
+}
+
+bool ClassRoomTypeFactory::isRegistered(const std::string_view type) {
+    return findRegistration(type) != nullptr;
+}
+
+int ClassRoomTypeFactory::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    int count = static_cast<int>(itClassRooms.size());
+
+    for (int i = 0; i < 2; i++) {
+        if (mathClassRooms[i] != nullptr) count++;
+        if (engClassRooms[i] != nullptr) count++;
+    }
+
+    return count;
+}
@@ -1,7 +1,9 @@
 #include "model/Person.h"
 #include "model/GroupLesson.h"
-#include <sstream>
+#include "model/ClassRoom.h"
 #include <algorithm>
+#include <sstream>
+#include <utility>
 
 
 GroupLesson::GroupLesson(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, const int baseCost, const std::string &subject, const ClassRoomPtr &classRoom)
@@ -11,89 +13,156 @@ GroupLesson::GroupLesson(const PersonPtr &teacher, const pt::ptime &beginTime, c
 
 GroupLesson::~GroupLesson() = default;
 
-std::vector<PersonPtr> GroupLesson::getStudents() const {
-    return students;
-}
-
-PersonPtr GroupLesson::getTeacher() const {
-    return Lesson::getTeacher();
+std::span<const PersonPtr> GroupLesson::getStudents() const {
+    return students.values();
 }
 
-pt::ptime GroupLesson::getBeginTime() const {
-    return Lesson::getBeginTime();
+bool GroupLesson::hasStudent(const int personId) const {
+    return students.contains(personId);
 }
 
-pt::ptime GroupLesson::getEndTime() const {
-    return Lesson::getEndTime();
+const std::deque<PersonPtr>& GroupLesson::getWaitlist() const {
+    return waitlist;
 }
 
-int GroupLesson::getBaseCost() const {
-    return Lesson::getBaseCost();
+bool GroupLesson::isWaitlisted(const int personId) const {
+    return waitlistedIds.count(personId) != 0;
 }
 
-std::string GroupLesson::getSubject() const {
-    return Lesson::getSubject();
+int GroupLesson::getFreeSeats() const {
+    return std::max(getClassRoom()->getSeatsNumber() - students.size(), 0);
 }
 
-ClassRoomPtr GroupLesson::getClassRoom() const {
-    return Lesson::getClassRoom();
+void GroupLesson::enqueue(const PersonPtr &student) {
+    waitlist.push_back(student);
+    waitlistedIds.insert(student->getId());
 }
 
-int GroupLesson::getID() const {
-    return Lesson::getID();
-}
+std::vector<PersonPtr> GroupLesson::promoteWaitlisted() {
+    std::vector<PersonPtr> promoted;
 
-long GroupLesson::getTotalCost() const {
-    return Lesson::getTotalCost();
-}
+    while (!waitlist.empty() && getFreeSeats() > 0) {
+        const PersonPtr next = waitlist.front();
+        waitlist.pop_front();
+        waitlistedIds.erase(next->getId());
 
-bool GroupLesson::isStarted() const {
-    return Lesson::isStarted();
-}
+        if (students.insert(next)) promoted.push_back(next);
+    }
 
-void GroupLesson::startLesson(const bool start) {
-    Lesson::startLesson(start);
+    return promoted;
 }
 
 int GroupLesson::addStudent(const PersonPtr &student) {
     if (student == nullptr) return 1;
+    if (students.contains(student->getId()) || isWaitlisted(student->getId())) return 2;
 
-    students.push_back(student);
+    if (getFreeSeats() == 0) {
+        enqueue(student);
+        return 3;
+    }
+
+    students.insert(student);
 
     return 0;
 }
 
-int GroupLesson::removeStudent(const PersonPtr &student) {
+int GroupLesson::addStudents(const std::vector<PersonPtr> &newStudents) {
+    int freeSeats = getFreeSeats();
+    std::vector<PersonPtr> accepted;
+    std::unordered_set<int> seen;
+    accepted.reserve(std::min<std::size_t>(newStudents.size(), freeSeats));
+    seen.reserve(newStudents.size());
+
+    for (const PersonPtr &student : newStudents) {
+        if (student == nullptr || students.contains(student->getId()) || isWaitlisted(student->getId()) ||
+            !seen.insert(student->getId()).second) {
+            continue;
+        }
+
+        if (freeSeats > 0) {
+            accepted.push_back(student);
+            freeSeats--;
+        } else {
+            enqueue(student);
+        }
+    }
+
+    return students.insert(accepted);
+}
+
+int GroupLesson::removeStudent(const PersonPtr &student, std::vector<PersonPtr> *promoted) {
     if (student == nullptr) return 1;
-    if (!student->isDuringLesson()) return 2;
 
-    students.erase(std::remove(students.begin(), students.end(), student), students.end());
-    student->setDuringLesson(false);
+    if (waitlistedIds.erase(student->getId())) {
+        waitlist.erase(std::find_if(waitlist.begin(), waitlist.end(), [&student](const PersonPtr &waiting) {
+            return waiting->getId() == student->getId();
+        }));
+        return 0;
+    }
+
+    if (!students.erase(student->getId())) return 2;
+
+    if (student->getLessonId() == getID()) {
+        student->setDuringLesson(false);
+        student->setLessonId(-1);
+    }
+
+    std::vector<PersonPtr> seated = promoteWaitlisted();
+    if (promoted != nullptr) *promoted = std::move(seated);
 
     return 0;
 }
 
+int GroupLesson::removeStudents(const std::vector<PersonPtr> &oldStudents, std::vector<PersonPtr> *promoted) {
+    int removed = 0;
+
+    for (const PersonPtr &student : oldStudents) {
+        if (student == nullptr) continue;
+
+        if (waitlistedIds.erase(student->getId())) {
+            removed++;
+        } else if (student->getLessonId() == getID() && students.contains(student->getId())) {
+            student->setDuringLesson(false);
+            student->setLessonId(-1);
+        }
+    }
+
+    if (removed > 0) {
+        waitlist.erase(std::remove_if(waitlist.begin(), waitlist.end(), [this](const PersonPtr &waiting) {
+            return !isWaitlisted(waiting->getId());
+        }), waitlist.end());
+    }
+
+    removed += students.erase(oldStudents);
+    std::vector<PersonPtr> seated = promoteWaitlisted();
+    if (promoted != nullptr) *promoted = std::move(seated);
+
+    return removed;
+}
+
 void GroupLesson::finishLesson() {
     Lesson::finishLesson();
 
-    for (const PersonPtr &student : students) {
+    for (const PersonPtr &student : students.values()) {
         student->setDuringLesson(false);
         student->setLessonId(-1);
     }
 }
 
-long GroupLesson::calculateTotalCost() const {
-    return Lesson::calculateTotalCost();
-}
-
 std::string GroupLesson::getInfo() const {
     std::stringstream ss;
 
     ss << Lesson::getInfo();
     ss << "\tStudenci:" << std::endl;
-    for (const PersonPtr &student : students) {
+    for (const PersonPtr &student : students.values()) {
         ss << "\t\t" << student->getInfo() << std::endl;
     }
+    if (!waitlist.empty()) {
+        ss << "\tLista oczekujacych:" << std::endl;
+        for (const PersonPtr &student : waitlist) {
+            ss << "\t\t" << student->getInfo() << std::endl;
+        }
+    }
 
     return ss.str();
 }
@@ -103,11 +172,14 @@ std::string GroupLesson::getAttributes() const {
 
     oss << "GROUP," << Lesson::getAttributes();
 
-    if (!students.empty()) {
-        for (const PersonPtr &student : students) {
-            oss << ",";
-            oss << student->getAttributes();
-        }
+    oss << "," << students.size();
+    for (const PersonPtr &student : students.values()) {
+        oss << "," << student->getAttributes();
+    }
+
+    oss << "," << waitlist.size();
+    for (const PersonPtr &student : waitlist) {
+        oss << "," << student->getAttributes();
     }
 
     return oss.str();
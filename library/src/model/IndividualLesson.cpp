@@ -13,46 +13,6 @@ PersonPtr IndividualLesson::getStudent() const {
     return student;
 }
 
-PersonPtr IndividualLesson::getTeacher() const {
-    return Lesson::getTeacher();
-}
-
-pt::ptime IndividualLesson::getBeginTime() const {
-    return Lesson::getBeginTime();
-}
-
-pt::ptime IndividualLesson::getEndTime() const {
-    return Lesson::getEndTime();
-}
-
-int IndividualLesson::getBaseCost() const {
-    return Lesson::getBaseCost();
-}
-
-std::string IndividualLesson::getSubject() const {
-    return Lesson::getSubject();
-}
-
-ClassRoomPtr IndividualLesson::getClassRoom() const {
-    return Lesson::getClassRoom();
-}
-
-int IndividualLesson::getID() const {
-    return Lesson::getID();
-}
-
-long IndividualLesson::getTotalCost() const {
-    return Lesson::getTotalCost();
-}
-
-bool IndividualLesson::isStarted() const {
-    return Lesson::isStarted();
-}
-
-void IndividualLesson::startLesson(const bool start) {
-    Lesson::startLesson(start);
-}
-
 void IndividualLesson::finishLesson() {
     Lesson::finishLesson();
 
@@ -60,10 +20,6 @@ void IndividualLesson::finishLesson() {
     student->setLessonId(-1);
 }
 
-long IndividualLesson::calculateTotalCost() const {
-    return Lesson::calculateTotalCost();
-}
-
 std::string IndividualLesson::getInfo() const {
     std::stringstream ss;
 
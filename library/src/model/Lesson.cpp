@@ -3,26 +3,26 @@
 #include "model/Person.h"
 #include <sstream>
 #include <cmath>
-#include <utility>
 
+std::atomic<int> Lesson::counter{0};
 
-int Lesson::counter = 0;
-
-Lesson::Lesson(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, const int baseCost, std::string subject, const ClassRoomPtr &classRoom)
+Lesson::Lesson(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, const int baseCost, const std::string &subject, const ClassRoomPtr &classRoom)
         : teacher(teacher),
-          startTime(beginTime),
+          startTime(beginTime.is_not_a_date_time() ? pt::second_clock::local_time() : beginTime),
           endTime(endTime),
           baseCost(baseCost),
-          subject(std::move(subject)),
+          totalCost(-1),
+          subject(StringPool::intern(subject)),
           classRoom(classRoom),
-          totalCost(-1) {
+          started(false),
+          seriesId(-1) {
     id = ++counter;
 }
 
 Lesson::~Lesson() = default;
 
-bool Lesson::isStarted() const {
-    return started;
+void Lesson::setSeriesId(const int id) {
+    seriesId = id;
 }
 
 void Lesson::startLesson(const bool start) {
@@ -42,38 +42,6 @@ void Lesson::finishLesson() {
     totalCost = calculateTotalCost();
 }
 
-PersonPtr Lesson::getTeacher() const {
-    return teacher;
-}
-
-pt::ptime Lesson::getBeginTime() const {
-    return startTime;
-}
-
-pt::ptime Lesson::getEndTime() const {
-    return endTime;
-}
-
-int Lesson::getBaseCost() const {
-    return baseCost;
-}
-
-std::string Lesson::getSubject() const {
-    return subject;
-}
-
-ClassRoomPtr Lesson::getClassRoom() const {
-    return classRoom;
-}
-
-int Lesson::getID() const {
-    return id;
-}
-
-long Lesson::getTotalCost() const {
-    return totalCost;
-}
-
 long Lesson::calculateTotalCost() const {
     if (endTime.is_not_a_date_time() || startTime >= endTime) return -1;
 
@@ -106,7 +74,8 @@ std::string Lesson::getAttributes() const {
         << boost::posix_time::to_simple_string(startTime) << ","
         << boost::posix_time::to_simple_string(endTime) << ","
         << classRoom->getAttributes() << ","
-        << teacher->getAttributes();
+        << teacher->getAttributes() << ","
+        << seriesId;
 
     return ss.str();
 }
@@ -0,0 +1,179 @@
+#include "model/LessonSeries.h"
+#include "model/ClassRoom.h"
+#include "model/Person.h"
+#include <algorithm>
+#include <sstream>
+
+
+std::atomic<int> LessonSeries::counter{0};
+
+LessonSeries::LessonSeries(const PersonPtr &teacher, const pt::ptime &beginTime, const pt::ptime &endTime, const int baseCost,
+                           const std::string &subject, const ClassRoomPtr &classRoom, const std::vector<PersonPtr> &students,
+                           const bool individual, const int intervalWeeks, const int count)
+        : teacher(teacher),
+          classRoom(classRoom),
+          subject(StringPool::intern(subject)),
+          baseCost(baseCost),
+          students(students),
+          individual(individual),
+          firstBegin(beginTime),
+          firstEnd(endTime),
+          intervalWeeks(intervalWeeks),
+          count(count),
+          expanded(0) {
+    id = ++counter;
+}
+
+int LessonSeries::getID() const {
+    return id;
+}
+
+const PersonPtr& LessonSeries::getTeacher() const {
+    return teacher;
+}
+
+const ClassRoomPtr& LessonSeries::getClassRoom() const {
+    return classRoom;
+}
+
+const std::string& LessonSeries::getSubject() const {
+    return StringPool::get(subject);
+}
+
+int LessonSeries::getBaseCost() const {
+    return baseCost;
+}
+
+std::span<const PersonPtr> LessonSeries::getStudents() const {
+    return students;
+}
+
+bool LessonSeries::isIndividual() const {
+    return individual;
+}
+
+int LessonSeries::getIntervalWeeks() const {
+    return intervalWeeks;
+}
+
+int LessonSeries::getCount() const {
+    return count;
+}
+
+const std::vector<int>& LessonSeries::getExceptions() const {
+    return exceptions;
+}
+
+int LessonSeries::getExpandedCount() const {
+    return expanded;
+}
+
+pt::ptime LessonSeries::getOccurrenceBegin(const int index) const {
+    if (index < 0 || index >= count) return pt::not_a_date_time;
+
+    return firstBegin + pt::hours(24 * 7 * intervalWeeks) * index;
+}
+
+pt::ptime LessonSeries::getOccurrenceEnd(const int index) const {
+    if (index < 0 || index >= count) return pt::not_a_date_time;
+
+    return firstEnd + pt::hours(24 * 7 * intervalWeeks) * index;
+}
+
+bool LessonSeries::isExhausted() const {
+    return expanded >= count;
+}
+
+std::vector<LessonSeries::Occurrence> LessonSeries::findOccurrences(const pt::ptime &beginTime, const pt::ptime &endTime) const {
+    std::vector<Occurrence> result;
+    if (beginTime.is_special() || endTime.is_special() || endTime <= beginTime) return result;
+
+    // Occurrence k ends after beginTime exactly when k > (beginTime - firstEnd) / period.
+    const long long period = 24LL * 7 * 3600 * intervalWeeks;
+    const long long behind = (beginTime - firstEnd).total_seconds();
+    long long index = behind < 0 ? 0 : behind / period + 1;
+    index = std::max<long long>(index, expanded);
+
+    for (; index < count; index++) {
+        const pt::ptime begin = getOccurrenceBegin(static_cast<int>(index));
+        if (begin >= endTime) break;
+
+        if (!std::binary_search(exceptions.begin(), exceptions.end(), static_cast<int>(index))) {
+            result.push_back({id, static_cast<int>(index), begin, getOccurrenceEnd(static_cast<int>(index))});
+        }
+    }
+
+    return result;
+}
+
+int LessonSeries::skipOccurrence(const int index) {
+    if (index < 0 || index >= count) return 1;
+    if (index < expanded) return 2;
+
+    const auto it = std::lower_bound(exceptions.begin(), exceptions.end(), index);
+    if (it != exceptions.end() && *it == index) return 2;
+
+    exceptions.insert(it, index);
+    return 0;
+}
+
+std::vector<LessonSeries::Occurrence> LessonSeries::expandUntil(const pt::ptime &until) {
+    std::vector<Occurrence> result;
+    if (until.is_special()) return result;
+
+    for (; expanded < count; expanded++) {
+        const pt::ptime begin = getOccurrenceBegin(expanded);
+        if (begin > until) break;
+
+        if (!std::binary_search(exceptions.begin(), exceptions.end(), expanded)) {
+            result.push_back({id, expanded, begin, getOccurrenceEnd(expanded)});
+        }
+    }
+
+    return result;
+}
+
+void LessonSeries::setExpandedCount(const int expandedCount) {
+    expanded = std::clamp(expandedCount, 0, count);
+}
+
+std::string LessonSeries::getInfo() const {
+    std::stringstream ss;
+
+    ss << "Seria lekcji nr: " << id << ", przedmiot: " << getSubject() << std::endl;
+    ss << ", pierwsza lekcja: " << firstBegin << " - " << firstEnd << ", co " << intervalWeeks << " tyg., liczba lekcji: " << count
+       << ", rozpisane: " << expanded << ", odwolane: " << exceptions.size() << std::endl;
+    ss << "\tSala: " << classRoom->getInfo() << std::endl;
+    ss << "\tNauczyciel: " << teacher->getInfo() << std::endl;
+    for (const PersonPtr &student : students) {
+        ss << "\tStudent: " << student->getInfo() << std::endl;
+    }
+
+    return ss.str();
+}
+
+std::string LessonSeries::getAttributes() const {
+    std::ostringstream ss;
+
+    ss << "SERIES," << id << ","
+       << baseCost << ","
+       << getSubject() << ","
+       << pt::to_simple_string(firstBegin) << ","
+       << pt::to_simple_string(firstEnd) << ","
+       << classRoom->getAttributes() << ","
+       << teacher->getAttributes() << ","
+       << intervalWeeks << ","
+       << count << ","
+       << expanded << ","
+       << individual << ","
+       << exceptions.size();
+
+    for (const int index : exceptions) {
+        ss << "," << index;
+    }
+    for (const PersonPtr &student : students) {
+        ss << "," << student->getAttributes();
+    }
+
+    return ss.str();
+}
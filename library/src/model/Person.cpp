@@ -1,18 +1,25 @@
 #include "model/Person.h"
 #include <sstream>
-#include <utility>
 
 
-Person::Person(std::string firstName, std::string  lastName, const int id, const bool duringLesson, const int lessonId)
-        : firstName(std::move(firstName)), lastName(std::move(lastName)), id(id), duringLesson(duringLesson), lessonId(lessonId)
+Person::Person(const std::string &firstName, const std::string &lastName, const int id, const bool duringLesson, const int lessonId)
+        : firstName(StringPool::intern(firstName)), lastName(StringPool::intern(lastName)), id(id), duringLesson(duringLesson), lessonId(lessonId)
 {
 }
 
-std::string Person::getFirstName() const {
+const std::string& Person::getFirstName() const {
+        return StringPool::get(firstName);
+}
+
+const std::string& Person::getLastName() const {
+        return StringPool::get(lastName);
+}
+
+StringPool::Id Person::getFirstNameId() const {
         return firstName;
 }
 
-std::string Person::getLastName() const {
+StringPool::Id Person::getLastNameId() const {
         return lastName;
 }
 
@@ -33,11 +40,23 @@ void Person::setDuringLesson(const bool newDuringLesson) {
 }
 
 void Person::setLessonId(const int newLessonId) {
-        if (newLessonId >= 0) {
+        if (newLessonId >= -1) {
                 lessonId = newLessonId;
         }
 }
 
+void Person::setFirstName(const std::string &newFirstName) {
+        if (!newFirstName.empty()) {
+                firstName = StringPool::intern(newFirstName);
+        }
+}
+
+void Person::setLastName(const std::string &newLastName) {
+        if (!newLastName.empty()) {
+                lastName = StringPool::intern(newLastName);
+        }
+}
+
 void Person::setId(const int newId) {
         if (newId >= 0) {
                 id = newId;
@@ -46,20 +65,32 @@ void Person::setId(const int newId) {
 
 void Person::addFutureLesson(const LessonPtr& newFutureLesson) {
         if (newFutureLesson != nullptr) {
-                futureLessons.push_back(newFutureLesson);
+                futureLessons.insert(newFutureLesson);
         }
 }
 
 int Person::removeFutureLesson(const LessonPtr& futureLesson) {
         if (futureLesson != nullptr) {
-                futureLessons.erase(std::remove(futureLessons.begin(), futureLessons.end(), futureLesson), futureLessons.end());
+                futureLessons.erase(futureLesson->getID());
                 return 0;
         }
         return 1;
 }
 
-std::vector<LessonPtr> Person::getFutureLessons() const {
-        return futureLessons;
+bool Person::hasFutureLesson(const int lessonId) const {
+        return futureLessons.contains(lessonId);
+}
+
+std::span<const LessonPtr> Person::getFutureLessons() const {
+        return futureLessons.values();
+}
+
+const WeeklyOccupancy& Person::getOccupancy() const {
+        return occupancy;
+}
+
+WeeklyOccupancy& Person::getOccupancy() {
+        return occupancy;
 }
 
 std::string Person::getInfo() const {
@@ -0,0 +1,45 @@
+#include "model/StringPool.h"
+#include <mutex>
+
+
+std::deque<std::string> StringPool::strings;
+std::unordered_map<std::string_view, StringPool::Id> StringPool::index;
+std::shared_mutex StringPool::mutex;
+
+StringPool::Id StringPool::intern(const std::string_view value) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (const auto it = index.find(value); it != index.end()) {
+            return it->second;
+        }
+    }
+
+    // Another thread may have interned the value between the two locks.
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (const auto it = index.find(value); it != index.end()) {
+        return it->second;
+    }
+
+    const auto id = static_cast<Id>(strings.size());
+    strings.emplace_back(value);
+    index.emplace(strings.back(), id);
+
+    return id;
+}
+
+const std::string& StringPool::get(const Id id) {
+    static const std::string empty;
+
+    // Elements of a deque never move when it grows, so the reference stays valid after unlocking.
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (id < strings.size()) {
+        return strings[id];
+    }
+
+    return empty;
+}
+
+int StringPool::size() {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return static_cast<int>(strings.size());
+}
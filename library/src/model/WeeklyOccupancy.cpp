@@ -0,0 +1,124 @@
+#include "model/WeeklyOccupancy.h"
+#include <algorithm>
+
+
+namespace {
+    constexpr std::int64_t slotSeconds = WeeklyOccupancy::slotMinutes * 60;
+
+    std::int64_t secondsIntoWeek(const pt::ptime &time) {
+        const int dayOfWeek = (time.date().day_of_week().as_number() + 6) % 7;
+        return dayOfWeek * 24 * 3600 + time.time_of_day().total_seconds();
+    }
+
+    /**
+     * Calls visit(slot) for every weekly slot covered by [beginTime, endTime), at most once per slot.
+     */
+    template <typename Visitor>
+    void forEachSlot(const pt::ptime &beginTime, const pt::ptime &endTime, Visitor visit) {
+        if (beginTime.is_special() || endTime.is_special() || endTime <= beginTime) return;
+
+        const std::int64_t offset = secondsIntoWeek(beginTime);
+        const std::int64_t first = offset / slotSeconds;
+        const std::int64_t last = (offset + (endTime - beginTime).total_seconds() + slotSeconds - 1) / slotSeconds;
+        const std::int64_t count = std::min<std::int64_t>(last - first, WeeklyOccupancy::slotsPerWeek);
+
+        for (std::int64_t k = 0; k < count; k++) {
+            visit(static_cast<int>((first + k) % WeeklyOccupancy::slotsPerWeek));
+        }
+    }
+}
+
+WeeklyOccupancy::WeeklyOccupancy(const WeeklyOccupancy &other)
+    : slots(other.slots != nullptr ? std::make_unique<Slots>(*other.slots) : nullptr) {
+}
+
+WeeklyOccupancy& WeeklyOccupancy::operator=(const WeeklyOccupancy &other) {
+    if (this != &other) {
+        slots = other.slots != nullptr ? std::make_unique<Slots>(*other.slots) : nullptr;
+    }
+
+    return *this;
+}
+
+void WeeklyOccupancy::change(const pt::ptime &beginTime, const pt::ptime &endTime, const int delta) {
+    if (slots == nullptr) {
+        if (delta < 0) return;
+        slots = std::make_unique<Slots>();
+    }
+
+    forEachSlot(beginTime, endTime, [this, delta](const int slot) {
+        std::uint16_t &count = slots->counts[slot];
+        if (delta < 0 && count == 0) return;
+
+        count = static_cast<std::uint16_t>(count + delta);
+        const std::uint64_t mask = std::uint64_t{1} << (slot % 64);
+        if (count > 0) slots->bits[slot / 64] |= mask;
+        else slots->bits[slot / 64] &= ~mask;
+    });
+}
+
+void WeeklyOccupancy::occupy(const pt::ptime &beginTime, const pt::ptime &endTime) {
+    change(beginTime, endTime, 1);
+}
+
+void WeeklyOccupancy::release(const pt::ptime &beginTime, const pt::ptime &endTime) {
+    change(beginTime, endTime, -1);
+}
+
+bool WeeklyOccupancy::isFree(const pt::ptime &beginTime, const pt::ptime &endTime) const {
+    if (slots == nullptr) return true;
+
+    bool free = true;
+
+    forEachSlot(beginTime, endTime, [this, &free](const int slot) {
+        if (slots->bits[slot / 64] >> (slot % 64) & 1) free = false;
+    });
+
+    return free;
+}
+
+const WeeklyOccupancy::Bits& WeeklyOccupancy::getBits() const {
+    static const Bits empty{};
+
+    return slots != nullptr ? slots->bits : empty;
+}
+
+int WeeklyOccupancy::slotOf(const pt::ptime &time) {
+    return static_cast<int>(secondsIntoWeek(time) / slotSeconds);
+}
+
+int WeeklyOccupancy::findCommonFreeSlot(const std::vector<const WeeklyOccupancy*> &grids, const int slotsNeeded, const int fromSlot) {
+    if (slotsNeeded <= 0 || slotsNeeded > slotsPerWeek) return -1;
+
+    Bits busy{};
+    for (const WeeklyOccupancy *grid : grids) {
+        if (grid == nullptr || grid->slots == nullptr) continue;
+        for (int w = 0; w < wordsCount; w++) {
+            busy[w] |= grid->slots->bits[w];
+        }
+    }
+
+    const int start = ((fromSlot % slotsPerWeek) + slotsPerWeek) % slotsPerWeek;
+    int run = 0;
+
+    for (int i = 0; i < slotsPerWeek + slotsNeeded - 1; i++) {
+        const int slot = (start + i) % slotsPerWeek;
+
+        if (slot % 64 == 0 && busy[slot / 64] == ~std::uint64_t{0}) {
+            run = 0;
+            i += 63;
+            continue;
+        }
+
+        if (busy[slot / 64] >> (slot % 64) & 1) {
+            run = 0;
+            continue;
+        }
+
+        if (++run == slotsNeeded) {
+            return (start + i - slotsNeeded + 1) % slotsPerWeek;
+        }
+    }
+
+    return -1;
+}
@@ -1,33 +1,63 @@
 #include "repositories/ClassRoomRepository.h"
 #include <algorithm>
+#include <mutex>
 #include <fstream>
 
 
 ClassRoomPtr ClassRoomRepository::findClassRoomByNumber(int number) const {
-    auto results = findBy([number](const ClassRoomPtr& classRoom){
-    return classRoom->getNumber() == number;
-  });
-
-    if (!results.empty()){
-        return results.front();
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (const auto it = roomsByNumber.find(number); it != roomsByNumber.end()) {
+        return it->second;
     }
 
     return nullptr;
 }
 
 void ClassRoomRepository::add(const ClassRoomPtr& classRoom) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    insert(classRoom);
+    version++;
+}
+
+void ClassRoomRepository::insert(const ClassRoomPtr& classRoom) {
     if (classRoom != nullptr) {
-        rooms.push_back(classRoom);
+        rooms.pushBack(classRoom);
+        roomsByNumber.emplace(classRoom->getNumber(), classRoom);
+    }
+}
+
+void ClassRoomRepository::addAll(const std::vector<ClassRoomPtr>& classRooms) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    // Grow geometrically, so that many small batches do not reallocate on every call.
+    const std::size_t needed = rooms.size() + classRooms.size();
+    rooms.reserve(std::max(needed, rooms.size() * 2));
+    if (needed > roomsByNumber.bucket_count() * roomsByNumber.max_load_factor()) roomsByNumber.reserve(std::max(needed, roomsByNumber.size() * 2));
+
+    for (const ClassRoomPtr &classRoom : classRooms) {
+        insert(classRoom);
     }
+    version++;
 }
 
 void ClassRoomRepository::remove(const ClassRoomPtr& classRoom) {
     if (classRoom != nullptr) {
-        rooms.erase(std::remove(rooms.begin(), rooms.end(), classRoom));
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        rooms.erase(classRoom);
+
+        if (const auto it = roomsByNumber.find(classRoom->getNumber()); it != roomsByNumber.end() && it->second == classRoom) {
+            roomsByNumber.erase(it);
+            rooms.forEach([this, &classRoom](const ClassRoomPtr &other) {
+                if (other->getNumber() == classRoom->getNumber()) roomsByNumber.emplace(other->getNumber(), other);
+            });
+        }
+        version++;
     }
 }
 
 int ClassRoomRepository::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
     return static_cast<int>(rooms.size());
 }
 
@@ -38,10 +68,17 @@ std::vector<ClassRoomPtr> ClassRoomRepository::findAll() const {
 std::vector<ClassRoomPtr> ClassRoomRepository::findBy(const ClassRoomPredicate& predicate) const {
     std::vector<ClassRoomPtr> result;
 
-    for (auto& room : rooms) {
+    snapshot()->forEach([&result, &predicate](const ClassRoomPtr &room) {
         if (room != nullptr && predicate(room)) {
             result.push_back(room);
         }
-    }
+    });
     return result;
 }
+
+std::shared_ptr<const PersistentVector<ClassRoomPtr>> ClassRoomRepository::snapshot() const {
+    if (auto current = snapshots.get(version.load()); current != nullptr) return current;
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return snapshots.publish(version.load(), rooms);
+}
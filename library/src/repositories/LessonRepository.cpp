@@ -1,12 +1,56 @@
 #include "repositories/LessonRepository.h"
 #include <algorithm>
+#include <mutex>
+#include <limits>
 
 #include "model/Person.h"
+#include "model/ClassRoom.h"
 
 
+namespace {
+    /** Converts seconds since the Unix epoch back to a time point; INT64_MAX maps to the latest representable time. */
+    pt::ptime fromEpochSeconds(const std::int64_t seconds) {
+        static const pt::ptime epoch(boost::gregorian::date(1970, 1, 1));
+
+        if (seconds == std::numeric_limits<std::int64_t>::max()) return pt::ptime(boost::date_time::max_date_time);
+
+        return epoch + pt::seconds(static_cast<long>(seconds));
+    }
+}
+
+
+LessonRepository::LessonRepository(const std::size_t shardsCount)
+    : shards(std::max<std::size_t>(1, shardsCount)), classRoomOccupancy(shards.size()), teacherOccupancy(shards.size()) {
+}
+
+std::int64_t LessonRepository::toEpochSeconds(const pt::ptime &time) {
+    static const pt::ptime epoch(boost::gregorian::date(1970, 1, 1));
+
+    if (time.is_special()) return std::numeric_limits<std::int64_t>::max();
+
+    return (time - epoch).total_seconds();
+}
+
+LessonRepository::Shard& LessonRepository::shardOf(const int id) {
+    return shards[Sharding::shardOf(id, shards.size())];
+}
+
+const LessonRepository::Shard& LessonRepository::shardOf(const int id) const {
+    return shards[Sharding::shardOf(id, shards.size())];
+}
+
+std::shared_ptr<const LessonRepository::ShardLessons> LessonRepository::snapshotOf(const Shard &shard) {
+    if (auto current = shard.snapshots.get(shard.version.load()); current != nullptr) return current;
+
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.snapshots.publish(shard.version.load(), shard.lessons);
+}
+
 LessonPtr LessonRepository::getByIndex(const int &index) {
-    if (index >= 0 && index < startedLessons.size()) {
-        return startedLessons[index];
+    if (index < 0) return nullptr;
+
+    if (const auto current = snapshot(); static_cast<std::size_t>(index) < current->started.size()) {
+        return current->started.at(index);
     }
 
     return nullptr;
@@ -14,104 +58,361 @@ LessonPtr LessonRepository::getByIndex(const int &index) {
 
 LessonPtr LessonRepository::get(const LessonPtr &lesson) const {
     if (lesson == nullptr) return nullptr;
+    const auto current = snapshotOf(shardOf(lesson->getID()));
+    bool found = false;
 
-    for (const LessonPtr &lessonI : startedLessons) {
-        if (lesson == lessonI) return lessonI;
-    }
-
-    for (const LessonPtr &lessonI : plannedLessons) {
-        if (lesson == lessonI) return lessonI;
-    }
+    auto match = [&lesson, &found](const ShardedView<LessonPtr>::Entry &entry) { found = found || lesson == entry.value; };
+    current->started.forEach(match);
+    current->planned.forEach(match);
 
-    return nullptr;
+    return found ? lesson : nullptr;
 }
 
 std::vector<LessonPtr> LessonRepository::getStartedLessons() const {
-    return startedLessons;
+    return snapshot()->started.toVector();
 }
 
 std::vector<LessonPtr> LessonRepository::getPlannedLessons() const {
-    return plannedLessons;
+    return snapshot()->planned.toVector();
 }
 
 std::vector<LessonPtr> LessonRepository::findAll() const {
-    return findBy([](const LessonPtr &) { return true; });
+    const auto current = snapshot();
+
+    std::vector<LessonPtr> result = current->started.toVector();
+    result.reserve(result.size() + current->planned.size());
+    current->planned.forEach([&result](const LessonPtr &lesson) { result.push_back(lesson); });
+
+    return result;
 }
 
 std::vector<LessonPtr> LessonRepository::findBy(const LessonPredicate& predicate) const {
-    std::vector<LessonPtr> result;
+    const auto current = snapshot();
+    auto matches = [&predicate](const LessonPtr &lesson) { return lesson != nullptr && predicate(lesson); };
 
-    for (auto &lesson : startedLessons) {
-        if (lesson != nullptr && predicate(lesson)) result.push_back(lesson);
-    }
+    std::vector<LessonPtr> result = current->started.select(matches);
+    const std::vector<LessonPtr> planned = current->planned.select(matches);
+    result.insert(result.end(), planned.begin(), planned.end());
+
+    return result;
+}
 
-    for (const auto &lesson : plannedLessons) {
-        if (lesson != nullptr && predicate(lesson)) result.push_back(lesson);
+std::shared_ptr<const LessonRepository::Lessons> LessonRepository::snapshot() const {
+    std::vector<std::shared_ptr<const Part>> started, planned;
+    started.reserve(shards.size());
+    planned.reserve(shards.size());
+
+    for (const Shard &shard : shards) {
+        const auto current = snapshotOf(shard);
+        started.emplace_back(current, &current->started);
+        planned.emplace_back(current, &current->planned);
     }
 
-    return result;
+    return std::make_shared<const Lessons>(Lessons{ShardedView<LessonPtr>(std::move(started)), ShardedView<LessonPtr>(std::move(planned))});
 }
 
 LessonPtr LessonRepository::findByIndex(int index) const {
-    auto result = findBy([index](const LessonPtr& lesson) {
-        return lesson->getID() == index;
-    });
+    const auto current = snapshotOf(shardOf(index));
+    LessonPtr result;
 
-    if (!result.empty()) {
-        return result.front();
-    }
+    auto match = [index, &result](const ShardedView<LessonPtr>::Entry &entry) {
+        if (result == nullptr && entry.value != nullptr && entry.value->getID() == index) result = entry.value;
+    };
+    current->started.forEach(match);
+    current->planned.forEach(match);
 
-    return nullptr;
+    return result;
 }
 
 int LessonRepository::remove(const LessonPtr &lesson) {
     if (lesson == nullptr) return 1;
+    Shard &shard = shardOf(lesson->getID());
+    {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-    if (const auto newEndStarted = std::remove(startedLessons.begin(), startedLessons.end(), lesson); newEndStarted != startedLessons.end()) {
-        startedLessons.erase(newEndStarted, startedLessons.end());
-        return 0;
-    }
+        auto same = [&lesson](const ShardedView<LessonPtr>::Entry &entry) { return entry.value == lesson; };
+        if (shard.lessons.started.eraseIf(same) == 0 && shard.lessons.planned.eraseIf(same) == 0) return 2;
 
-    if (const auto newEndPlanned = std::remove(plannedLessons.begin(), plannedLessons.end(),lesson); newEndPlanned != plannedLessons.end()) {
-        plannedLessons.erase(newEndPlanned, plannedLessons.end());
-        return 0;
+        unschedule(shard, lesson->getID());
+        shard.version++;
     }
 
-    return 2;
+    release(lesson);
+    return 0;
 }
 
 int LessonRepository::removeByIndex(const int &index) {
-    if (index >= 0 && index < startedLessons.size()) {
-        startedLessons.erase(startedLessons.begin() + index);
-        return 0;
+    if (index < 0) return 1;
+    const auto current = snapshot();
+
+    LessonPtr lesson;
+    if (static_cast<std::size_t>(index) < current->started.size()) lesson = current->started.at(index);
+    else if (static_cast<std::size_t>(index) < current->planned.size()) lesson = current->planned.at(index);
+
+    return lesson != nullptr && remove(lesson) == 0 ? 0 : 1;
+}
+
+int LessonRepository::add(const LessonPtr &lesson, const bool now) {
+    if (lesson == nullptr) return 1;
+    Shard &shard = shardOf(lesson->getID());
+    {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        insert(shard, lesson, now, sequence++);
+        shard.version++;
     }
 
-    if (index >= 0 && index < plannedLessons.size()) {
-        plannedLessons.erase(plannedLessons.begin() + index);
-        return 0;
+    book(lesson);
+    return 0;
+}
+
+void LessonRepository::insert(Shard &shard, const LessonPtr &lesson, const bool now, const std::uint64_t number) {
+    if (now) shard.lessons.started.pushBack({number, lesson});
+    else {
+        shard.lessons.planned.pushBack({number, lesson});
+        lesson->getTeacher()->addFutureLesson(lesson);
     }
 
-    return 1;
+    shard.schedule.push_back({toEpochSeconds(lesson->getBeginTime()), toEpochSeconds(lesson->getEndTime()), lesson->getID(), lesson->isStarted()});
 }
 
-int LessonRepository::add(const LessonPtr &lesson, const bool now) {
-    if (lesson != nullptr) {
-        if (now) startedLessons.push_back(lesson);
-        else {
-            plannedLessons.push_back(lesson);
-            lesson->getTeacher()->addFutureLesson(lesson);
+int LessonRepository::addAll(const std::vector<LessonPtr> &newLessons, const bool now) {
+    std::vector<std::vector<std::size_t>> byShard(shards.size());
+    for (std::size_t i = 0; i < newLessons.size(); i++) {
+        if (newLessons[i] != nullptr) byShard[Sharding::shardOf(newLessons[i]->getID(), shards.size())].push_back(i);
+    }
+
+    int added = 0;
+    {
+        // Every touched shard is locked before the batch is numbered, so every shard stays in sequence order.
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        for (std::size_t index = 0; index < shards.size(); index++) {
+            if (!byShard[index].empty()) locks.emplace_back(shards[index].mutex);
+        }
+        const std::uint64_t first = sequence.fetch_add(newLessons.size());
+
+        for (std::size_t index = 0; index < shards.size(); index++) {
+            if (byShard[index].empty()) continue;
+            Shard &shard = shards[index];
+
+            // Grow geometrically, so that many small batches do not reallocate on every call.
+            Part &collection = now ? shard.lessons.started : shard.lessons.planned;
+            collection.reserve(std::max(collection.size() + byShard[index].size(), collection.size() * 2));
+            const std::size_t needed = shard.schedule.size() + byShard[index].size();
+            if (needed > shard.schedule.capacity()) shard.schedule.reserve(std::max(needed, shard.schedule.capacity() * 2));
+
+            for (const std::size_t i : byShard[index]) {
+                insert(shard, newLessons[i], now, first + i);
+                added++;
+            }
+            shard.version++;
         }
-        return 0;
     }
 
-    return 1;
+    for (const LessonPtr &lesson : newLessons) {
+        if (lesson != nullptr) book(lesson);
+    }
+
+    return added;
 }
 
 int LessonRepository::size(const bool now) const {
-    if (now) return static_cast<int>(startedLessons.size());
-    return static_cast<int>(plannedLessons.size());
+    std::size_t total = 0;
+    for (const Shard &shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += now ? shard.lessons.started.size() : shard.lessons.planned.size();
+    }
+    return static_cast<int>(total);
 }
 
 int LessonRepository::totalSize() const {
-    return static_cast<int>(startedLessons.size() + plannedLessons.size());
+    std::size_t total = 0;
+    for (const Shard &shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.lessons.started.size() + shard.lessons.planned.size();
+    }
+    return static_cast<int>(total);
+}
+
+int LessonRepository::setStarted(const int id, const bool started) {
+    Shard &shard = shardOf(id);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    for (ScheduleEntry &entry : shard.schedule) {
+        if (entry.id == id) {
+            entry.started = started;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+std::vector<int> LessonRepository::findToStart(const pt::ptime &now) const {
+    const std::int64_t nowSeconds = toEpochSeconds(now);
+    std::vector<std::vector<int>> found(shards.size());
+
+    Sharding::fanOut(shards.size(), totalSize() >= static_cast<int>(Sharding::parallelThreshold), [this, nowSeconds, &found](const std::size_t index) {
+        std::shared_lock<std::shared_mutex> lock(shards[index].mutex);
+        for (const ScheduleEntry &entry : shards[index].schedule) {
+            if (!entry.started && entry.beginTime < nowSeconds) found[index].push_back(entry.id);
+        }
+    });
+
+    // Lessons get increasing IDs, so sorting returns them in the order they were created,
+    // whichever shards hold them.
+    std::vector<int> result;
+    for (const std::vector<int> &ids : found) {
+        result.insert(result.end(), ids.begin(), ids.end());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<int> LessonRepository::findToFinish(const pt::ptime &now) const {
+    const std::int64_t nowSeconds = toEpochSeconds(now);
+    std::vector<std::vector<int>> found(shards.size());
+
+    Sharding::fanOut(shards.size(), totalSize() >= static_cast<int>(Sharding::parallelThreshold), [this, nowSeconds, &found](const std::size_t index) {
+        std::shared_lock<std::shared_mutex> lock(shards[index].mutex);
+        for (const ScheduleEntry &entry : shards[index].schedule) {
+            if (entry.started && entry.endTime < nowSeconds) found[index].push_back(entry.id);
+        }
+    });
+
+    // Lessons get increasing IDs, so sorting returns them in the order they were created,
+    // whichever shards hold them.
+    std::vector<int> result;
+    for (const std::vector<int> &ids : found) {
+        result.insert(result.end(), ids.begin(), ids.end());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<LessonRepository::ScheduleEntry> LessonRepository::getSchedule() const {
+    std::vector<ScheduleEntry> result;
+    for (const Shard &shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        result.insert(result.end(), shard.schedule.begin(), shard.schedule.end());
+    }
+    return result;
+}
+
+bool LessonRepository::isClassRoomFree(const int number, const pt::ptime &beginTime, const pt::ptime &endTime) const {
+    return isClassRoomFree(number, toEpochSeconds(beginTime), toEpochSeconds(endTime));
+}
+
+bool LessonRepository::isClassRoomFree(const int number, const std::int64_t beginTime, const std::int64_t endTime) const {
+    {
+        const OccupancyShard &occupancy = classRoomOccupancy[Sharding::shardOf(number, classRoomOccupancy.size())];
+        std::shared_lock<std::shared_mutex> lock(occupancy.mutex);
+        if (!occupancy.index.isFree(number, beginTime, endTime)) return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(seriesMutex);
+    return series.empty() || isFreeOfSeries([number](const LessonSeries &lessonSeries) {
+        return lessonSeries.getClassRoom() != nullptr && lessonSeries.getClassRoom()->getNumber() == number;
+    }, beginTime, endTime);
+}
+
+bool LessonRepository::isTeacherFree(const int personId, const pt::ptime &beginTime, const pt::ptime &endTime) const {
+    return isTeacherFree(personId, toEpochSeconds(beginTime), toEpochSeconds(endTime));
+}
+
+bool LessonRepository::isTeacherFree(const int personId, const std::int64_t beginTime, const std::int64_t endTime) const {
+    {
+        const OccupancyShard &occupancy = teacherOccupancy[Sharding::shardOf(personId, teacherOccupancy.size())];
+        std::shared_lock<std::shared_mutex> lock(occupancy.mutex);
+        if (!occupancy.index.isFree(personId, beginTime, endTime)) return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(seriesMutex);
+    return series.empty() || isFreeOfSeries([personId](const LessonSeries &lessonSeries) {
+        return lessonSeries.getTeacher() != nullptr && lessonSeries.getTeacher()->getId() == personId;
+    }, beginTime, endTime);
+}
+
+bool LessonRepository::isFreeOfSeries(const std::function<bool(const LessonSeries&)> &matches, const std::int64_t beginTime,
+                                      const std::int64_t endTime) const {
+    for (const LessonSeriesPtr &lessonSeries : series) {
+        if (matches(*lessonSeries) && !lessonSeries->findOccurrences(fromEpochSeconds(beginTime), fromEpochSeconds(endTime)).empty()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int LessonRepository::addSeries(const LessonSeriesPtr &lessonSeries) {
+    if (lessonSeries == nullptr) return 1;
+    std::unique_lock<std::shared_mutex> lock(seriesMutex);
+
+    series.push_back(lessonSeries);
+    return 0;
+}
+
+int LessonRepository::removeSeries(const LessonSeriesPtr &lessonSeries) {
+    if (lessonSeries == nullptr) return 1;
+    std::unique_lock<std::shared_mutex> lock(seriesMutex);
+
+    const auto it = std::find(series.begin(), series.end(), lessonSeries);
+    if (it == series.end()) return 2;
+
+    series.erase(it);
+    return 0;
+}
+
+LessonSeriesPtr LessonRepository::findSeriesById(const int id) const {
+    std::shared_lock<std::shared_mutex> lock(seriesMutex);
+    for (const LessonSeriesPtr &lessonSeries : series) {
+        if (lessonSeries->getID() == id) return lessonSeries;
+    }
+
+    return nullptr;
+}
+
+std::vector<LessonSeriesPtr> LessonRepository::getSeries() const {
+    std::shared_lock<std::shared_mutex> lock(seriesMutex);
+    return series;
+}
+
+void LessonRepository::unschedule(Shard &shard, const int id) {
+    for (std::size_t i = 0; i < shard.schedule.size(); i++) {
+        if (shard.schedule[i].id == id) {
+            shard.schedule[i] = shard.schedule.back();
+            shard.schedule.pop_back();
+            return;
+        }
+    }
+}
+
+void LessonRepository::book(const LessonPtr &lesson) {
+    const std::int64_t beginTime = toEpochSeconds(lesson->getBeginTime());
+    const std::int64_t endTime = toEpochSeconds(lesson->getEndTime());
+
+    if (const ClassRoomPtr &classRoom = lesson->getClassRoom(); classRoom != nullptr) {
+        OccupancyShard &occupancy = classRoomOccupancy[Sharding::shardOf(classRoom->getNumber(), classRoomOccupancy.size())];
+        std::unique_lock<std::shared_mutex> lock(occupancy.mutex);
+        occupancy.index.add(classRoom->getNumber(), beginTime, endTime, lesson->getID());
+    }
+    if (const PersonPtr &teacher = lesson->getTeacher(); teacher != nullptr) {
+        OccupancyShard &occupancy = teacherOccupancy[Sharding::shardOf(teacher->getId(), teacherOccupancy.size())];
+        std::unique_lock<std::shared_mutex> lock(occupancy.mutex);
+        occupancy.index.add(teacher->getId(), beginTime, endTime, lesson->getID());
+    }
+}
+
+void LessonRepository::release(const LessonPtr &lesson) {
+    const std::int64_t beginTime = toEpochSeconds(lesson->getBeginTime());
+
+    if (const ClassRoomPtr &classRoom = lesson->getClassRoom(); classRoom != nullptr) {
+        OccupancyShard &occupancy = classRoomOccupancy[Sharding::shardOf(classRoom->getNumber(), classRoomOccupancy.size())];
+        std::unique_lock<std::shared_mutex> lock(occupancy.mutex);
+        occupancy.index.remove(classRoom->getNumber(), beginTime, lesson->getID());
+    }
+    if (const PersonPtr &teacher = lesson->getTeacher(); teacher != nullptr) {
+        OccupancyShard &occupancy = teacherOccupancy[Sharding::shardOf(teacher->getId(), teacherOccupancy.size())];
+        std::unique_lock<std::shared_mutex> lock(occupancy.mutex);
+        occupancy.index.remove(teacher->getId(), beginTime, lesson->getID());
+    }
 }
@@ -0,0 +1,74 @@
+#include "repositories/OccupancyIndex.h"
+#include <algorithm>
+#include <limits>
+
+
+namespace {
+    bool beginsBefore(const OccupancyIndex::Interval &interval, const std::int64_t time) {
+        return interval.beginTime < time;
+    }
+}
+
+void OccupancyIndex::add(const int resource, const std::int64_t beginTime, const std::int64_t endTime, const int lessonId) {
+    Timeline &timeline = timelines[resource];
+
+    if (endTime == std::numeric_limits<std::int64_t>::max()) {
+        timeline.openEnded.push_back({beginTime, endTime, lessonId});
+        return;
+    }
+
+    const auto it = std::lower_bound(timeline.intervals.begin(), timeline.intervals.end(), beginTime, beginsBefore);
+    timeline.intervals.insert(it, {beginTime, endTime, lessonId});
+    timeline.longest = std::max(timeline.longest, endTime - beginTime);
+}
+
+int OccupancyIndex::remove(const int resource, const std::int64_t beginTime, const int lessonId) {
+    const auto found = timelines.find(resource);
+    if (found == timelines.end()) return 1;
+
+    Timeline &timeline = found->second;
+    auto matches = [lessonId](const Interval &interval) { return interval.lessonId == lessonId; };
+
+    auto it = std::lower_bound(timeline.intervals.begin(), timeline.intervals.end(), beginTime, beginsBefore);
+    for (; it != timeline.intervals.end() && it->beginTime == beginTime; ++it) {
+        if (matches(*it)) {
+            timeline.intervals.erase(it);
+            return 0;
+        }
+    }
+
+    if (const auto open = std::find_if(timeline.openEnded.begin(), timeline.openEnded.end(), matches); open != timeline.openEnded.end()) {
+        *open = timeline.openEnded.back();
+        timeline.openEnded.pop_back();
+        return 0;
+    }
+
+    return 1;
+}
+
+bool OccupancyIndex::isFree(const int resource, const std::int64_t beginTime, const std::int64_t endTime) const {
+    const auto found = timelines.find(resource);
+    if (found == timelines.end()) return true;
+
+    const Timeline &timeline = found->second;
+
+    for (const Interval &interval : timeline.openEnded) {
+        if (interval.beginTime < endTime) return false;
+    }
+
+    // An interval ending after beginTime cannot start more than `longest` seconds before it.
+    auto it = std::upper_bound(timeline.intervals.begin(), timeline.intervals.end(), beginTime - timeline.longest,
+                               [](const std::int64_t time, const Interval &interval) { return time < interval.beginTime; });
+    for (; it != timeline.intervals.end() && it->beginTime < endTime; ++it) {
+        if (it->endTime > beginTime) return false;
+    }
+
+    return true;
+}
+
+int OccupancyIndex::size(const int resource) const {
+    const auto found = timelines.find(resource);
+    if (found == timelines.end()) return 0;
+
+    return static_cast<int>(found->second.intervals.size() + found->second.openEnded.size());
+}
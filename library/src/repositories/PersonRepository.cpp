@@ -1,48 +1,125 @@
 #include "repositories/PersonRepository.h"
 #include <algorithm>
+#include <mutex>
 #include <fstream>
 
 
+PersonRepository::PersonRepository(const std::size_t shardsCount) : shards(std::max<std::size_t>(1, shardsCount)) {
+}
+
+PersonRepository::Shard& PersonRepository::shardOf(const int id) {
+    return shards[Sharding::shardOf(id, shards.size())];
+}
+
+const PersonRepository::Shard& PersonRepository::shardOf(const int id) const {
+    return shards[Sharding::shardOf(id, shards.size())];
+}
+
 void PersonRepository::remove(const PersonPtr& person) {
     if (person != nullptr) {
-        persons.erase(std::remove(persons.begin(), persons.end(), person), persons.end());
+        Shard &shard = shardOf(person->getId());
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        shard.persons.eraseIf([&person](const Snapshot::Entry &entry) { return entry.value == person; });
+
+        if (const auto it = shard.personsById.find(person->getId()); it != shard.personsById.end() && it->second == person) {
+            shard.personsById.erase(it);
+            shard.persons.forEach([&shard, &person](const Snapshot::Entry &other) {
+                if (other.value->getId() == person->getId()) shard.personsById.emplace(other.value->getId(), other.value);
+            });
+        }
+        shard.version++;
     }
 }
 
 void PersonRepository::add(const PersonPtr& person) {
-    if (person != nullptr) {
-        persons.push_back(person);
+    if (person == nullptr) return;
+
+    Shard &shard = shardOf(person->getId());
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    insert(shard, person, sequence++);
+    shard.version++;
+}
+
+void PersonRepository::insert(Shard &shard, const PersonPtr& person, const std::uint64_t number) {
+    shard.persons.pushBack({number, person});
+    shard.personsById.emplace(person->getId(), person);
+}
+
+void PersonRepository::addAll(const std::vector<PersonPtr>& newPersons) {
+    std::vector<std::vector<std::size_t>> byShard(shards.size());
+    for (std::size_t i = 0; i < newPersons.size(); i++) {
+        if (newPersons[i] != nullptr) byShard[Sharding::shardOf(newPersons[i]->getId(), shards.size())].push_back(i);
+    }
+
+    // Every touched shard is locked, in index order, before the batch is numbered, so no shard can
+    // receive a later-numbered person first and every shard stays in sequence order.
+    std::vector<std::unique_lock<std::shared_mutex>> locks;
+    for (std::size_t index = 0; index < shards.size(); index++) {
+        if (!byShard[index].empty()) locks.emplace_back(shards[index].mutex);
+    }
+    const std::uint64_t first = sequence.fetch_add(newPersons.size());
+
+    for (std::size_t index = 0; index < shards.size(); index++) {
+        if (byShard[index].empty()) continue;
+        Shard &shard = shards[index];
+
+        // Grow geometrically, so that many small batches do not reallocate on every call.
+        const std::size_t needed = shard.persons.size() + byShard[index].size();
+        shard.persons.reserve(std::max(needed, shard.persons.size() * 2));
+        if (needed > shard.personsById.bucket_count() * shard.personsById.max_load_factor()) {
+            shard.personsById.reserve(std::max(needed, shard.personsById.size() * 2));
+        }
+
+        for (const std::size_t i : byShard[index]) {
+            insert(shard, newPersons[i], first + i);
+        }
+        shard.version++;
     }
 }
 
 int PersonRepository::size() const {
-    return static_cast<int>(persons.size());
+    std::size_t total = 0;
+    for (const Shard &shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.persons.size();
+    }
+    return static_cast<int>(total);
 }
 
 PersonPtr PersonRepository::findPersonById(int id) const {
-    auto result = findBy([id](const PersonPtr& person) {
-        return person->getId() == id;
-    });
-
-    if (!result.empty()) {
-        return result.front();
+    const Shard &shard = shardOf(id);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    if (const auto it = shard.personsById.find(id); it != shard.personsById.end()) {
+        return it->second;
     }
 
     return nullptr;
 }
 
 std::vector<PersonPtr> PersonRepository::findBy(const PersonPredicate& predicate) const {
-    std::vector<PersonPtr> result;
+    return snapshot()->select([&predicate](const PersonPtr &person) {
+        return person != nullptr && predicate(person);
+    });
+}
+
+std::vector<PersonPtr> PersonRepository::findAll() const {
+    return snapshot()->toVector();
+}
+
+std::shared_ptr<const PersonRepository::Snapshot> PersonRepository::snapshot() const {
+    std::vector<std::shared_ptr<const Snapshot::Part>> parts;
+    parts.reserve(shards.size());
 
-    for (auto& person : persons) {
-        if (predicate(person) && person != nullptr) {
-            result.push_back(person);
+    for (const Shard &shard : shards) {
+        if (auto current = shard.snapshots.get(shard.version.load()); current != nullptr) {
+            parts.push_back(std::move(current));
+            continue;
         }
-    }
 
-    return result;
-}
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        parts.push_back(shard.snapshots.publish(shard.version.load(), shard.persons));
+    }
 
-std::vector<PersonPtr> PersonRepository::findAll() const {
-    return findBy([](const PersonPtr&){ return true;});
+    return std::make_shared<const Snapshot>(std::move(parts));
 }
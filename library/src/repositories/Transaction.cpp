@@ -0,0 +1,50 @@
+#include "repositories/Transaction.h"
+#include <algorithm>
+
+
+Transaction::Transaction(VersionTablePtr versions) : versions(std::move(versions)) {
+}
+
+void Transaction::read(const VersionTable::Kind kind, const int id, const std::function<void()> &inspect) {
+    if (state != State::Open) return;
+    const VersionTable::Key key{kind, id};
+    const std::uint64_t version = versions->read(key, inspect);
+    if (std::any_of(readSet.begin(), readSet.end(), [&key](const auto &entry) { return entry.first == key; })) return;
+
+    readSet.emplace_back(key, version);
+}
+
+int Transaction::stage(std::function<void()> change) {
+    if (state != State::Open) return 1;
+
+    changes.push_back(std::move(change));
+    return 0;
+}
+
+int Transaction::commit() {
+    if (state != State::Open) return 2;
+
+    const bool applied = versions->commit(readSet, [this] {
+        for (const auto &change : changes) {
+            change();
+        }
+    });
+
+    state = applied ? State::Committed : State::Aborted;
+    changes.clear();
+
+    return applied ? 0 : 1;
+}
+
+int Transaction::abort() {
+    if (state != State::Open) return 1;
+
+    state = State::Aborted;
+    changes.clear();
+
+    return 0;
+}
+
+Transaction::State Transaction::getState() const {
+    return state;
+}
@@ -0,0 +1,58 @@
+#include "repositories/VersionTable.h"
+#include <algorithm>
+
+
+std::uint64_t VersionTable::pack(const Key &key) {
+    return static_cast<std::uint64_t>(key.kind) << 32 | static_cast<std::uint32_t>(key.id);
+}
+
+std::size_t VersionTable::stripeOf(const Key &key) {
+    // Fibonacci hashing spreads consecutive IDs of every kind over all stripes.
+    return static_cast<std::size_t>(pack(key) * 0x9E3779B97F4A7C15ull >> 32) % stripesCount;
+}
+
+std::uint64_t VersionTable::read(const Key &key, const std::function<void()> &inspect) {
+    Stripe &stripe = stripes[stripeOf(key)];
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    if (inspect) inspect();
+
+    const auto it = stripe.versions.find(pack(key));
+    return it != stripe.versions.end() ? it->second : 0;
+}
+
+bool VersionTable::commit(const std::vector<std::pair<Key, std::uint64_t>> &readSet, const std::function<void()> &apply) {
+    std::vector<std::size_t> locked;
+    locked.reserve(readSet.size());
+    for (const auto &entry : readSet) {
+        locked.push_back(stripeOf(entry.first));
+    }
+    std::sort(locked.begin(), locked.end());
+    locked.erase(std::unique(locked.begin(), locked.end()), locked.end());
+
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(locked.size());
+    for (const std::size_t index : locked) {
+        locks.emplace_back(stripes[index].mutex);
+    }
+
+    for (const auto &[key, version] : readSet) {
+        const auto &versions = stripes[stripeOf(key)].versions;
+        const auto it = versions.find(pack(key));
+        if ((it != versions.end() ? it->second : 0) != version) {
+            conflicts++;
+            return false;
+        }
+    }
+
+    apply();
+
+    for (const auto &entry : readSet) {
+        stripes[stripeOf(entry.first)].versions[pack(entry.first)]++;
+    }
+
+    return true;
+}
+
+long VersionTable::getConflicts() const {
+    return conflicts;
+}
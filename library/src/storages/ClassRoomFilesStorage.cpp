@@ -1,7 +1,7 @@
 #include "storages/ClassRoomFilesStorage.h"
-#include "model/ITClassRoom.h"
-#include "model/EngClassRoom.h"
-#include "model/MathClassRoom.h"
+#include "storages/Flusher.h"
+#include "model/ClassRoomTypeFactory.h"
+#include "model/ClassRoomType.h"
 #include <sstream>
 #include <fstream>
 #include <iostream>
@@ -9,23 +9,26 @@
 #include <vector>
 
 
-bool ClassRoomFilesStorage::saveToFile(const ClassRoomRepositoryPtr &classRoomRepo) {
-    const std::string fileName = "./../../database/classrooms/Classroom.txt";
-    std::ofstream outputFile(fileName);
+std::string ClassRoomFilesStorage::serialize(const ClassRoomRepositoryPtr &classRoomRepo) {
+    std::ostringstream contents;
 
-    if (!outputFile) {
-        throw std::runtime_error("Blad tworzenia pliku " + fileName);
+    for (const auto& room : classRoomRepo->findAll()) {
+        contents << room->getAttributes() << '\n';
     }
 
-    for (const auto& room : classRoomRepo->findAll()) {
-        outputFile << room->getAttributes() << std::endl;
+    return contents.str();
+}
+
+bool ClassRoomFilesStorage::saveToFile(const ClassRoomRepositoryPtr &classRoomRepo) {
+    if (!Flusher::writeFile(databaseFile, serialize(classRoomRepo))) {
+        throw std::runtime_error("Blad tworzenia pliku " + std::string(databaseFile));
     }
-    outputFile.close();
+
     return true;
 }
 
 bool ClassRoomFilesStorage::load(ClassRoomRepositoryPtr &classRoomRepo) {
-    const std::string fileName = "./../../database/classrooms/Classroom.txt";
+    const std::string fileName = databaseFile;
     std::ifstream inputFile(fileName);
 
     if (!inputFile) {
@@ -67,16 +70,8 @@ bool ClassRoomFilesStorage::load(ClassRoomRepositoryPtr &classRoomRepo) {
             std::getline(iss, token, ',');
             int extraInt = std::stoi(token);
 
-            ClassRoomTypePtr classRoomType;
-            if (type == "IT") {
-                classRoomType = std::make_shared<ITClassRoom>(extraInt);
-            } else if (type == "MATH") {
-                classRoomType = std::make_shared<MathClassRoom>(extraInt == 1);
-            } else if (type == "ENG") {
-                classRoomType = std::make_shared<EngClassRoom>(extraInt == 1);
-            } else {
-                continue;
-            }
+            const ClassRoomTypePtr classRoomType = ClassRoomTypeFactory::create(type, extraInt);
+            if (classRoomType == nullptr) continue;
 
             auto classRoom = std::make_shared<ClassRoom>(
                 number, available, seatsNumber, rentCost, classRoomType);
@@ -198,16 +193,8 @@ std::vector<ClassRoomPtr> ClassRoomFilesStorage::getArchive() {
             std::getline(iss, token, ',');
             int extraInt = std::stoi(token);
 
-            ClassRoomTypePtr classRoomType;
-            if (type == "IT") {
-                classRoomType = std::make_shared<ITClassRoom>(extraInt);
-            } else if (type == "MATH") {
-                classRoomType = std::make_shared<MathClassRoom>(extraInt == 1);
-            } else if (type == "ENG") {
-                classRoomType = std::make_shared<EngClassRoom>(extraInt == 1);
-            } else {
-                continue;
-            }
+            const ClassRoomTypePtr classRoomType = ClassRoomTypeFactory::create(type, extraInt);
+            if (classRoomType == nullptr) continue;
 
             auto classRoom = std::make_shared<ClassRoom>(
                 number, available, seatsNumber, rentCost, classRoomType);
@@ -0,0 +1,39 @@
+#include "storages/FileIO.h"
+#include "storages/ThreadPoolFileIO.h"
+#include "storages/UringFileIO.h"
+#include <stdexcept>
+#include <utility>
+
+
+std::future<bool> FileIO::replace(const std::string &fileName, std::string contents) {
+    const auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = promise->get_future();
+    submitReplace(fileName, std::move(contents), [promise](const bool saved) { promise->set_value(saved); });
+
+    return result;
+}
+
+std::future<bool> FileIO::append(const std::string &fileName, std::string contents) {
+    const auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = promise->get_future();
+    submitAppend(fileName, std::move(contents), [promise](const bool saved) { promise->set_value(saved); });
+
+    return result;
+}
+
+std::future<std::string> FileIO::read(const std::string &fileName) {
+    const auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> result = promise->get_future();
+    submitRead(fileName, [promise, fileName](const bool read, std::string contents) {
+        if (read) promise->set_value(std::move(contents));
+        else promise->set_exception(std::make_exception_ptr(std::runtime_error("Nie udalo sie odczytac pliku " + fileName)));
+    });
+
+    return result;
+}
+
+FileIOPtr FileIO::create(const TaskPoolPtr &taskPool) {
+    if (FileIOPtr fileIO = UringFileIO::create()) return fileIO;
+
+    return std::make_shared<ThreadPoolFileIO>(taskPool);
+}
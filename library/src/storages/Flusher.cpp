@@ -0,0 +1,142 @@
+#include "storages/Flusher.h"
+#include "storages/FileIO.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+
+Flusher::Flusher(FileIOPtr fileIO) : fileIO(std::move(fileIO)) {
+}
+
+Flusher::~Flusher() {
+    waitAll();
+}
+
+std::shared_future<bool> Flusher::flush(const std::string &fileName, std::string contents) {
+    return enqueue(fileName, std::move(contents), false);
+}
+
+std::shared_future<bool> Flusher::append(const std::string &fileName, std::string contents) {
+    return enqueue(fileName, std::move(contents), true);
+}
+
+std::shared_future<bool> Flusher::enqueue(const std::string &fileName, std::string contents, const bool append) {
+    std::unique_lock<std::mutex> lock(mutex);
+    File &file = files[fileName];
+
+    // Only a replacement queued last can take newer contents; replacing one queued before an
+    // append would reorder them.
+    if (!append && !file.pending.empty() && !file.pending.back()->append) {
+        file.pending.back()->contents = std::move(contents);
+        coalesced++;
+        return file.pending.back()->result;
+    }
+
+    auto pending = std::make_shared<Pending>();
+    pending->append = append;
+    pending->contents = std::move(contents);
+    pending->result = pending->promise.get_future().share();
+    const std::shared_future<bool> result = pending->result;
+    outstanding++;
+
+    if (file.writing != nullptr) {
+        file.pending.push_back(std::move(pending));
+        return result;
+    }
+
+    file.writing = pending;
+    lock.unlock();
+    start(fileName, pending);
+
+    return result;
+}
+
+void Flusher::start(const std::string &fileName, const std::shared_ptr<Pending> &pending) {
+    auto done = [this, fileName, pending](const bool saved) { finish(fileName, pending, saved); };
+    if (pending->append) fileIO->submitAppend(fileName, std::move(pending->contents), std::move(done));
+    else fileIO->submitReplace(fileName, std::move(pending->contents), std::move(done));
+}
+
+void Flusher::finish(const std::string &fileName, const std::shared_ptr<Pending> &pending, const bool saved) {
+    if (!saved) std::cerr << "Nie udalo sie zapisac pliku " << fileName << std::endl;
+
+    std::shared_ptr<Pending> next;
+    std::vector<std::function<void(bool)>> callbacks;
+    {
+        // The next write is taken in the same critical section that counts this one as done, so
+        // waitAll() cannot return while this callback still needs the Flusher.
+        std::lock_guard<std::mutex> lock(mutex);
+        if (saved) written++;
+        else failed++;
+        pending->promise.set_value(saved);
+        callbacks.swap(pending->callbacks);
+        File &file = files[fileName];
+        if (!file.pending.empty()) {
+            next = std::move(file.pending.front());
+            file.pending.pop_front();
+        }
+        file.writing = next;
+        if (--outstanding == 0) drained.notify_all();
+    }
+
+    for (const std::function<void(bool)> &callback : callbacks) {
+        callback(saved);
+    }
+
+    if (next != nullptr) start(fileName, next);
+}
+
+void Flusher::whenWritten(const std::string &fileName, std::function<void(bool)> done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        File &file = files[fileName];
+        // Writes of a file finish in order, so the last one queued finishes after all the others.
+        const std::shared_ptr<Pending> &last = file.pending.empty() ? file.writing : file.pending.back();
+        if (last != nullptr) {
+            last->callbacks.push_back(std::move(done));
+            return;
+        }
+    }
+
+    done(true);
+}
+
+void Flusher::waitAll() {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return outstanding == 0; });
+}
+
+std::size_t Flusher::getOutstanding() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return outstanding;
+}
+
+std::uint64_t Flusher::getWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+std::uint64_t Flusher::getCoalesced() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return coalesced;
+}
+
+std::uint64_t Flusher::getFailed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+bool Flusher::writeFile(const std::string &fileName, const std::string &contents) {
+    const std::string temporaryName = fileName + ".tmp";
+    {
+        std::ofstream outFile(temporaryName, std::ios::trunc);
+        if (!outFile.is_open()) return false;
+
+        outFile << contents;
+        outFile.close();
+        if (!outFile) return false;
+    }
+
+    return std::rename(temporaryName.c_str(), fileName.c_str()) == 0;
+}
@@ -1,15 +1,19 @@
 #include "typedefs.h"
 #include "storages/LessonFilesStorage.h"
+#include "storages/Flusher.h"
 #include "model/ClassRoom.h"
 #include "model/Person.h"
-#include "model/ITClassRoom.h"
-#include "model/EngClassRoom.h"
-#include "model/MathClassRoom.h"
+#include "model/ClassRoomTypeFactory.h"
 #include "model/IndividualLesson.h"
 #include "model/GroupLesson.h"
+#include "model/LessonSeries.h"
 #include "repositories/LessonRepository.h"
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 namespace pt = boost::posix_time;
@@ -19,21 +23,26 @@ LessonFilesStorage::LessonFilesStorage() = default;
 
 LessonFilesStorage::~LessonFilesStorage() = default;
 
-bool LessonFilesStorage::saveToFile(const LessonRepositoryPtr& repository) {
-    const std::string fileName = "./../../database/lessons/Lesson.txt";
-    std::ofstream outFile(fileName);
-    if (!outFile.is_open()) {
-        throw std::runtime_error("Blad otwierania pliku " + fileName);
-    }
+std::string LessonFilesStorage::serialize(const LessonRepositoryPtr& repository) {
+    std::ostringstream contents;
     for (const auto& lesson : repository->findAll()) {
-        outFile << lesson->getAttributes() << std::endl;
+        contents << lesson->getAttributes() << '\n';
+    }
+    for (const auto& lessonSeries : repository->getSeries()) {
+        contents << lessonSeries->getAttributes() << '\n';
+    }
+    return contents.str();
+}
+
+bool LessonFilesStorage::saveToFile(const LessonRepositoryPtr& repository) {
+    if (!Flusher::writeFile(databaseFile, serialize(repository))) {
+        throw std::runtime_error("Blad otwierania pliku " + std::string(databaseFile));
     }
-    outFile.close();
     return true;
 }
 
 bool LessonFilesStorage::load(LessonRepositoryPtr& repository) {
-    const std::string fileName = "./../../database/lessons/Lesson.txt";
+    const std::string fileName = databaseFile;
     std::ifstream inputFile(fileName);
 
     if (!inputFile) {
@@ -47,6 +56,11 @@ bool LessonFilesStorage::load(LessonRepositoryPtr& repository) {
     }
     inputFile.seekg(0, std::ios::beg);
 
+    // Series get new IDs on load and are stored after the lessons expanded from them, so the
+    // lessons are added once the whole file is read and their links can be remapped.
+    std::vector<std::pair<LessonPtr, int>> lessons;
+    std::unordered_map<int, int> seriesIds;
+
     std::string line;
     while (std::getline(inputFile, line)) {
         std::istringstream iss(line);
@@ -59,6 +73,7 @@ bool LessonFilesStorage::load(LessonRepositoryPtr& repository) {
             std::string subject;
             pt::ptime beginTime;
             pt::ptime endTime;
+            int storedId;
             int lessonId;
             int baseCost;
             std::string teacherFirstName;
@@ -72,7 +87,7 @@ bool LessonFilesStorage::load(LessonRepositoryPtr& repository) {
             std::string classType;
             int classEquipment;
 
-            std::getline(iss, token, ','); lessonId = atoi(token.c_str());
+            std::getline(iss, token, ','); storedId = atoi(token.c_str());
             std::getline(iss, token, ','); baseCost = atoi(token.c_str());
             std::getline(iss, token, ','); subject = token;
             std::getline(iss, token, ','); beginTime = pt::time_from_string(token);
@@ -90,18 +105,17 @@ bool LessonFilesStorage::load(LessonRepositoryPtr& repository) {
             std::getline(iss, token, ','); lessonId = atoi(token.c_str());
 
             auto teacher = std::make_shared<Person>(teacherFirstName, teacherLastName, teacherId, teacherDuringLesson, lessonId);
-            ClassRoomTypePtr classRoomType;
-            if (classType == "IT") {
-                classRoomType = std::make_shared<ITClassRoom>(classEquipment);
-            } else if (classType == "MATH") {
-                classRoomType = std::make_shared<MathClassRoom>(classEquipment == 1);
-            } else if (classType == "ENG") {
-                classRoomType = std::make_shared<EngClassRoom>(classEquipment == 1);
+            const ClassRoomTypePtr classRoomType = ClassRoomTypeFactory::create(classType, classEquipment);
+            if (classRoomType == nullptr) {
+                throw std::runtime_error("Nieznany typ sali: " + classType);
             }
 
             auto classRoom = std::make_shared<ClassRoom>(classNumber, available, seatsNumber, classRentCost, classRoomType);
 
             if (lessonType == "INDIVIDUAL") {
+                std::getline(iss, token, ',');
+                const int seriesId = std::stoi(token);
+
                 std::string studentFirstName, studentLastName;
                 int studentId;
                 bool studentDuringLesson;
@@ -114,29 +128,84 @@ bool LessonFilesStorage::load(LessonRepositoryPtr& repository) {
 
                 PersonPtr student = std::make_shared<Person>(studentFirstName, studentLastName, studentId, studentDuringLesson, lessonId);
                 LessonPtr lesson = std::make_shared<IndividualLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom, student);
-                repository->add(lesson, true);
+                lessons.emplace_back(lesson, seriesId);
 
             } else if (lessonType == "GROUP") {
-                std::vector<PersonPtr> students;
-                while (true) {
-                    std::string firstName, lastName;
-                    int idStr, lessonIdStr;
-                    bool duringStr;
-                    if (!std::getline(iss, token, ',')){ break; } firstName = token;
-                    std::getline(iss, token, ','); lastName = token;
-                    std::getline(iss, token, ','); idStr = atoi(token.c_str());
-                    std::getline(iss, token, ','); duringStr = atoi(token.c_str());
-                    std::getline(iss, token, ','); lessonIdStr = atoi(token.c_str());
-
-                    auto student = std::make_shared<Person>(firstName, lastName, idStr, duringStr, lessonIdStr);
-                    students.push_back(student);
-                }
+                std::getline(iss, token, ',');
+                const int seriesId = std::stoi(token);
+
+                const auto readStudents = [&iss, &token]() {
+                    std::getline(iss, token, ',');
+                    const int count = std::stoi(token);
+                    if (count < 0) throw std::invalid_argument("ujemna liczba uczniow");
+
+                    std::vector<PersonPtr> list;
+                    for (int i = 0; i < count; i++) {
+                        std::string firstName, lastName;
+                        int studentId, studentLessonId;
+                        bool studentDuringLesson;
+                        std::getline(iss, firstName, ',');
+                        std::getline(iss, lastName, ',');
+                        std::getline(iss, token, ','); studentId = std::stoi(token);
+                        std::getline(iss, token, ','); studentDuringLesson = std::stoi(token);
+                        std::getline(iss, token, ','); studentLessonId = std::stoi(token);
+
+                        list.push_back(std::make_shared<Person>(firstName, lastName, studentId, studentDuringLesson, studentLessonId));
+                    }
+                    return list;
+                };
+                const std::vector<PersonPtr> students = readStudents();
+                const std::vector<PersonPtr> waitlist = readStudents();
 
                 auto lesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
                 for (auto& s : students) {
                     lesson->addStudent(s);
                 }
-                repository->add(lesson, true);
+                for (auto& s : waitlist) {
+                    lesson->addStudent(s);
+                }
+                lessons.emplace_back(lesson, seriesId);
+            } else if (lessonType == "SERIES") {
+                int intervalWeeks, count, expanded, exceptionsCount;
+                bool individual;
+
+                std::getline(iss, token, ','); intervalWeeks = std::stoi(token);
+                std::getline(iss, token, ','); count = std::stoi(token);
+                std::getline(iss, token, ','); expanded = std::stoi(token);
+                std::getline(iss, token, ','); individual = std::stoi(token);
+                std::getline(iss, token, ','); exceptionsCount = std::stoi(token);
+
+                std::vector<int> exceptions;
+                for (int i = 0; i < exceptionsCount; i++) {
+                    std::getline(iss, token, ','); exceptions.push_back(std::stoi(token));
+                }
+
+                std::vector<PersonPtr> students;
+                while (std::getline(iss, token, ',')) {
+                    std::string firstName = token, lastName;
+                    int studentId, studentLessonId;
+                    bool studentDuringLesson;
+
+                    std::getline(iss, lastName, ',');
+                    std::getline(iss, token, ','); studentId = atoi(token.c_str());
+                    std::getline(iss, token, ','); studentDuringLesson = atoi(token.c_str());
+                    std::getline(iss, token, ','); studentLessonId = atoi(token.c_str());
+
+                    students.push_back(std::make_shared<Person>(firstName, lastName, studentId, studentDuringLesson, studentLessonId));
+                }
+
+                if (intervalWeeks <= 0 || count <= 0 || endTime <= beginTime || (individual && students.size() != 1)) {
+                    throw std::invalid_argument("niepoprawna seria lekcji");
+                }
+
+                auto lessonSeries = std::make_shared<LessonSeries>(teacher, beginTime, endTime, baseCost, subject, classRoom, students,
+                                                                   individual, intervalWeeks, count);
+                for (const int index : exceptions) {
+                    lessonSeries->skipOccurrence(index);
+                }
+                lessonSeries->setExpandedCount(expanded);
+                repository->addSeries(lessonSeries);
+                seriesIds[storedId] = lessonSeries->getID();
             } else {
                 throw std::runtime_error("Nieznany typ lekcji: " + lessonType);
             }
@@ -149,23 +218,36 @@ bool LessonFilesStorage::load(LessonRepositoryPtr& repository) {
     }
 
     inputFile.close();
+
+    for (const auto& [lesson, seriesId] : lessons) {
+        // A link to a series that is no longer stored is dropped; the lesson then books its slot itself.
+        if (const auto it = seriesIds.find(seriesId); it != seriesIds.end()) {
+            lesson->setSeriesId(it->second);
+        }
+        repository->add(lesson, true);
+    }
+
     return true;
 }
 
 void LessonFilesStorage::saveArchive(const LessonRepositoryPtr &lessonRepo, const int id) {
-    const std::string fileName = "./../../archive/lessons/Lesson.txt";
-    std::ofstream outFile(fileName, std::ios::app);
-
-    if (!outFile.is_open()) {
-        throw std::runtime_error("Blad otwierania pliku " + fileName);
-    }
-
     const LessonPtr lesson = lessonRepo->findByIndex(id);
 
     if (lesson ==  nullptr) {
         throw std::logic_error("Blad, nie ma takiej lekcji");
     }
 
+    saveArchive(lesson);
+}
+
+void LessonFilesStorage::saveArchive(const LessonPtr &lesson) {
+    const std::string fileName = archiveFile;
+    std::ofstream outFile(fileName, std::ios::app);
+
+    if (!outFile.is_open()) {
+        throw std::runtime_error("Blad otwierania pliku " + fileName);
+    }
+
     outFile << lesson->getAttributes() << std::endl;
     outFile.close();
 
@@ -173,7 +255,7 @@ void LessonFilesStorage::saveArchive(const LessonRepositoryPtr &lessonRepo, cons
 }
 
 void LessonFilesStorage::showArchive() {
-    const std::string fileName = "./../../archive/lessons/Lesson.txt";
+    const std::string fileName = archiveFile;
     std::ifstream inputFile(fileName);
 
     if (!inputFile) {
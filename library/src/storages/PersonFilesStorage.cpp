@@ -1,4 +1,5 @@
 #include "storages/PersonFilesStorage.h"
+#include "storages/Flusher.h"
 #include "typedefs.h"
 #include <sstream>
 #include <fstream>
@@ -7,24 +8,26 @@
 #include <vector>
 
 
-bool PersonFilesStorage::saveToFile(const PersonRepositoryPtr& personRepo) {
-    const std::string fileName = "./../../database/students/Person.txt";
-    std::ofstream outFile(fileName);
+std::string PersonFilesStorage::serialize(const PersonRepositoryPtr& personRepo) {
+    std::ostringstream contents;
 
-    if (!outFile.is_open()) {
-        throw std::runtime_error("Blad otwierania pliku " + fileName);
+    for (const auto& person : personRepo->findAll()) {
+        contents << person->getAttributes() << '\n';
     }
 
-    for (const auto& person : personRepo->findAll()) {
-        outFile << person->getAttributes() << std::endl;
+    return contents.str();
+}
+
+bool PersonFilesStorage::saveToFile(const PersonRepositoryPtr& personRepo) {
+    if (!Flusher::writeFile(databaseFile, serialize(personRepo))) {
+        throw std::runtime_error("Blad otwierania pliku " + std::string(databaseFile));
     }
 
-    outFile.close();
     return true;
 }
 
 bool PersonFilesStorage::load(PersonRepositoryPtr& personRepo) {
-    const std::string fileName = "./../../database/students/Person.txt";
+    const std::string fileName = databaseFile;
     std::ifstream inFile(fileName);
 
     if (!inFile) {
@@ -97,8 +100,8 @@ void PersonFilesStorage::loadArchive(const PersonRepositoryPtr &personRepo, cons
             const auto allPersons = personRepo->findAll();
 
             for (const auto& person : allPersons) {
-                if (person->getFirstName() == (it)->getFirstName() &&
-                    person->getLastName() == (it)->getLastName()) {
+                if (person->getFirstNameId() == (it)->getFirstNameId() &&
+                    person->getLastNameId() == (it)->getLastNameId()) {
                     std::cout << "W systemie jest juz identyczna osoba" << std::endl;
                     return;
                 }
@@ -0,0 +1,86 @@
+#include "storages/ThreadPoolFileIO.h"
+#include "concurrency/TaskPool.h"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+
+ThreadPoolFileIO::ThreadPoolFileIO(TaskPoolPtr taskPool) : taskPool(std::move(taskPool)) {
+}
+
+void ThreadPoolFileIO::submitReplace(const std::string &fileName, std::string contents, WriteCallback done) {
+    taskPool->post([fileName, contents = std::move(contents), done = std::move(done)] {
+        const std::string temporaryName = fileName + ".tmp";
+        const int fd = ::open(temporaryName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        bool saved = fd >= 0 && writeAll(fd, contents, false);
+        if (fd >= 0 && ::close(fd) != 0) saved = false;
+
+        if (saved) saved = std::rename(temporaryName.c_str(), fileName.c_str()) == 0;
+        else if (fd >= 0) ::unlink(temporaryName.c_str());
+        done(saved);
+    });
+}
+
+void ThreadPoolFileIO::submitAppend(const std::string &fileName, std::string contents, WriteCallback done) {
+    taskPool->post([fileName, contents = std::move(contents), done = std::move(done)] {
+        const int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        bool saved = fd >= 0 && writeAll(fd, contents, true);
+        if (fd >= 0 && ::close(fd) != 0) saved = false;
+        done(saved);
+    });
+}
+
+void ThreadPoolFileIO::submitRead(const std::string &fileName, ReadCallback done) {
+    taskPool->post([fileName, done = std::move(done)] {
+        std::string contents;
+        const int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        const bool read = fd >= 0 && readAll(fd, contents);
+        if (fd >= 0) ::close(fd);
+        done(read, read ? std::move(contents) : std::string());
+    });
+}
+
+std::string ThreadPoolFileIO::getName() const {
+    return "thread pool";
+}
+
+bool ThreadPoolFileIO::writeAll(const int fd, const std::string &contents, const bool append) {
+    std::size_t written = 0;
+    while (written < contents.size()) {
+        const ssize_t result = append
+            ? ::write(fd, contents.data() + written, contents.size() - written)
+            : ::pwrite(fd, contents.data() + written, contents.size() - written, static_cast<off_t>(written));
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+
+    return true;
+}
+
+bool ThreadPoolFileIO::readAll(const int fd, std::string &contents) {
+    struct stat status{};
+    if (::fstat(fd, &status) != 0) return false;
+    contents.resize(static_cast<std::size_t>(status.st_size));
+
+    std::size_t read = 0;
+    while (true) {
+        // The file may have grown since fstat(); keep reading until pread() reports its end.
+        if (read == contents.size()) contents.resize(contents.size() + 4096);
+        const ssize_t result = ::pread(fd, &contents[read], contents.size() - read, static_cast<off_t>(read));
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (result == 0) break;
+        read += static_cast<std::size_t>(result);
+    }
+    contents.resize(read);
+
+    return true;
+}
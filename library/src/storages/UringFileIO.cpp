@@ -0,0 +1,353 @@
+#include "storages/UringFileIO.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+// IORING_FEAT_FAST_POLL arrived with the kernel headers that also define IORING_OP_READ and IORING_OP_WRITE.
+#if defined(IORING_FEAT_FAST_POLL) && defined(__NR_io_uring_setup)
+#define LEARNINGCENTER_IO_URING 1
+#endif
+
+
+/**
+ * @brief A replace, append or read in flight.
+ */
+struct UringFileIO::Operation {
+    /**
+     * @brief What the operation does.
+     */
+    enum class Kind { Replace, Append, Read };
+
+    Kind kind; /**< What the operation does. */
+    std::string fileName; /**< The name of the file. */
+    int fd = -1; /**< The open file; for a replace, the temporary file. */
+    std::string buffer; /**< The data written, or the data read so far. */
+    std::size_t done = 0; /**< Number of bytes transferred so far. */
+    int retries = 0; /**< Number of times in a row the kernel refused the next transfer. */
+    WriteCallback written; /**< Callback of a replace or an append. */
+    ReadCallback read; /**< Callback of a read. */
+};
+
+
+std::shared_ptr<UringFileIO> UringFileIO::create(const unsigned queueDepth) {
+    std::shared_ptr<UringFileIO> fileIO(new UringFileIO());
+    if (!fileIO->setUp(queueDepth)) return nullptr;
+
+    return fileIO;
+}
+
+void UringFileIO::submitReplace(const std::string &fileName, std::string contents, WriteCallback done) {
+    auto operation = std::make_unique<Operation>();
+    operation->kind = Operation::Kind::Replace;
+    operation->fileName = fileName;
+    operation->buffer = std::move(contents);
+    operation->written = std::move(done);
+    start(std::move(operation));
+}
+
+void UringFileIO::submitAppend(const std::string &fileName, std::string contents, WriteCallback done) {
+    auto operation = std::make_unique<Operation>();
+    operation->kind = Operation::Kind::Append;
+    operation->fileName = fileName;
+    operation->buffer = std::move(contents);
+    operation->written = std::move(done);
+    start(std::move(operation));
+}
+
+void UringFileIO::submitRead(const std::string &fileName, ReadCallback done) {
+    auto operation = std::make_unique<Operation>();
+    operation->kind = Operation::Kind::Read;
+    operation->fileName = fileName;
+    operation->read = std::move(done);
+    start(std::move(operation));
+}
+
+std::string UringFileIO::getName() const {
+    return "io_uring";
+}
+
+void UringFileIO::start(std::unique_ptr<Operation> operation) {
+    inFlight++;
+    Operation *started = operation.release();
+
+    switch (started->kind) {
+        case Operation::Kind::Replace:
+            started->fd = ::open((started->fileName + ".tmp").c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            break;
+        case Operation::Kind::Append:
+            started->fd = ::open(started->fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            break;
+        case Operation::Kind::Read: {
+            started->fd = ::open(started->fileName.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat status{};
+            if (started->fd >= 0 && ::fstat(started->fd, &status) == 0) {
+                started->buffer.resize(static_cast<std::size_t>(status.st_size));
+            }
+            break;
+        }
+    }
+
+    if (started->fd < 0) {
+        finish(started, false);
+        return;
+    }
+    if (started->kind != Operation::Kind::Read && started->buffer.empty()) {
+        finish(started, true);
+        return;
+    }
+    if (!queue(started)) finish(started, false);
+}
+
+void UringFileIO::complete(Operation *operation, const int result) {
+    if (result == -EINTR || result == -EAGAIN) {
+        if (!queue(operation)) finish(operation, false);
+        return;
+    }
+    if (result < 0) {
+        finish(operation, false);
+        return;
+    }
+
+    if (operation->kind == Operation::Kind::Read) {
+        if (result == 0) {
+            operation->buffer.resize(operation->done);
+            finish(operation, true);
+            return;
+        }
+        operation->done += static_cast<std::size_t>(result);
+    } else {
+        if (result == 0) {
+            finish(operation, false);
+            return;
+        }
+        operation->done += static_cast<std::size_t>(result);
+        if (operation->done == operation->buffer.size()) {
+            finish(operation, true);
+            return;
+        }
+    }
+
+    if (!queue(operation)) finish(operation, false);
+}
+
+void UringFileIO::finish(Operation *operation, bool succeeded) {
+    const std::unique_ptr<Operation> finished(operation);
+
+    if (operation->fd >= 0 && ::close(operation->fd) != 0 && operation->kind != Operation::Kind::Read) succeeded = false;
+    if (operation->kind == Operation::Kind::Replace && operation->fd >= 0) {
+        const std::string temporaryName = operation->fileName + ".tmp";
+        if (succeeded) succeeded = std::rename(temporaryName.c_str(), operation->fileName.c_str()) == 0;
+        else ::unlink(temporaryName.c_str());
+    }
+
+    if (operation->kind == Operation::Kind::Read) {
+        operation->read(succeeded, succeeded ? std::move(operation->buffer) : std::string());
+    } else {
+        operation->written(succeeded);
+    }
+
+    // Counted down only after the callback, which may start further operations, so the
+    // destructor never sees zero while a callback is still running.
+    std::lock_guard<std::mutex> lock(inFlightMutex);
+    if (--inFlight == 0) this->finished.notify_all();
+}
+
+
+#ifdef LEARNINGCENTER_IO_URING
+
+UringFileIO::~UringFileIO() {
+    if (reaper.joinable()) {
+        {
+            std::unique_lock<std::mutex> lock(inFlightMutex);
+            finished.wait(lock, [this] { return inFlight.load() == 0; });
+        }
+
+        // Nothing is in flight, so the reaper can stop; an eventfd cannot be refused like a queued no-op.
+        const std::uint64_t stop = 1;
+        while (::write(stopFd, &stop, sizeof(stop)) < 0 && errno == EINTR) {
+        }
+        reaper.join();
+    }
+
+    if (stopFd >= 0) ::close(stopFd);
+    if (entries != nullptr) ::munmap(entries, entriesSize);
+    if (completionRing != nullptr && completionRing != submissionRing) ::munmap(completionRing, completionRingSize);
+    if (submissionRing != nullptr) ::munmap(submissionRing, submissionRingSize);
+    if (ringFd >= 0) ::close(ringFd);
+}
+
+bool UringFileIO::setUp(const unsigned queueDepth) {
+    io_uring_params parameters{};
+    ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, queueDepth, &parameters));
+    if (ringFd < 0) return false;
+
+    // Without IORING_FEAT_NODROP completions beyond the size of the ring would be lost; without
+    // IORING_FEAT_FAST_POLL the kernel predates IORING_OP_READ and IORING_OP_WRITE.
+    if ((parameters.features & IORING_FEAT_NODROP) == 0 || (parameters.features & IORING_FEAT_FAST_POLL) == 0) return false;
+
+    submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+    completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMapping = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping) submissionRingSize = completionRingSize = std::max(submissionRingSize, completionRingSize);
+
+    void *mapped = ::mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (mapped == MAP_FAILED) return false;
+    submissionRing = mapped;
+
+    if (singleMapping) {
+        completionRing = submissionRing;
+    } else {
+        mapped = ::mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (mapped == MAP_FAILED) return false;
+        completionRing = mapped;
+    }
+
+    entriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+    mapped = ::mmap(nullptr, entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (mapped == MAP_FAILED) return false;
+    entries = mapped;
+
+    auto *submissionBase = static_cast<char*>(submissionRing);
+    submissionTail = reinterpret_cast<unsigned*>(submissionBase + parameters.sq_off.tail);
+    submissionMask = reinterpret_cast<unsigned*>(submissionBase + parameters.sq_off.ring_mask);
+    submissionArray = reinterpret_cast<unsigned*>(submissionBase + parameters.sq_off.array);
+
+    auto *completionBase = static_cast<char*>(completionRing);
+    completionHead = reinterpret_cast<unsigned*>(completionBase + parameters.cq_off.head);
+    completionTail = reinterpret_cast<unsigned*>(completionBase + parameters.cq_off.tail);
+    completionMask = reinterpret_cast<unsigned*>(completionBase + parameters.cq_off.ring_mask);
+    completions = completionBase + parameters.cq_off.cqes;
+
+    stopFd = ::eventfd(0, EFD_CLOEXEC);
+    if (stopFd < 0) return false;
+
+    reaper = std::thread([this] { reap(); });
+    return true;
+}
+
+bool UringFileIO::queue(Operation *operation) {
+    if (operation->kind == Operation::Kind::Read && operation->done == operation->buffer.size()) {
+        // The file may have grown since fstat(); keep reading until a read reports its end.
+        operation->buffer.resize(operation->buffer.size() + 4096);
+    }
+    const std::size_t remaining = std::min<std::size_t>(operation->buffer.size() - operation->done, 1u << 30);
+
+    const bool onReaper = std::this_thread::get_id() == reaper.get_id();
+
+    std::unique_lock<std::mutex> lock(submitMutex);
+    while (true) {
+        const unsigned tail = *submissionTail;
+        const unsigned index = tail & *submissionMask;
+        auto *entry = static_cast<io_uring_sqe*>(entries) + index;
+        std::memset(entry, 0, sizeof(io_uring_sqe));
+        entry->opcode = operation->kind == Operation::Kind::Read ? IORING_OP_READ : IORING_OP_WRITE;
+        entry->fd = operation->fd;
+        entry->addr = reinterpret_cast<std::uint64_t>(&operation->buffer[operation->done]);
+        entry->len = static_cast<std::uint32_t>(remaining);
+        // Ignored for an append, whose file is opened with O_APPEND.
+        entry->off = operation->done;
+        entry->user_data = reinterpret_cast<std::uint64_t>(operation);
+        submissionArray[index] = index;
+        __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE);
+
+        const long submitted = ::syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, nullptr, 0);
+        if (submitted == 1) {
+            operation->retries = 0;
+            return true;
+        }
+        const int error = submitted < 0 ? errno : 0;
+
+        // The kernel reads the ring only inside io_uring_enter(), so an entry it refused can be taken back.
+        __atomic_store_n(submissionTail, tail, __ATOMIC_RELEASE);
+        if (error == EINTR) continue;
+        if ((error != EAGAIN && error != EBUSY) || ++operation->retries > maxSubmitRetries) return false;
+
+        if (onReaper) {
+            retrying.push_back(operation);
+            return true;
+        }
+
+        const unsigned long seen = drains.load();
+        lock.unlock();
+        {
+            std::unique_lock<std::mutex> drainLock(inFlightMutex);
+            drained.wait_for(drainLock, std::chrono::milliseconds(10), [this, seen] { return drains.load() != seen; });
+        }
+        lock.lock();
+    }
+}
+
+void UringFileIO::reap() {
+    pollfd watched[2] = {{ringFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+    while (true) {
+        // Refused transfers are retried after a short wait even if nothing completes meanwhile.
+        if (::poll(watched, 2, retrying.empty() ? -1 : 1) < 0 && errno != EINTR) {
+            std::perror("poll");
+        }
+        if ((watched[1].revents & POLLIN) != 0) return;
+
+        // Also moves completions the kernel held back while the completion ring was full into it.
+        if (::syscall(__NR_io_uring_enter, ringFd, 0, 0, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+            errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            std::perror("io_uring_enter");
+        }
+
+        unsigned head = *completionHead;
+        bool collected = false;
+        while (head != __atomic_load_n(completionTail, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe &completion = static_cast<io_uring_cqe*>(completions)[head & *completionMask];
+            const std::uint64_t userData = completion.user_data;
+            const int result = completion.res;
+            __atomic_store_n(completionHead, ++head, __ATOMIC_RELEASE);
+            collected = true;
+
+            complete(reinterpret_cast<Operation*>(userData), result);
+        }
+
+        if (collected) {
+            {
+                std::lock_guard<std::mutex> lock(inFlightMutex);
+                drains++;
+            }
+            drained.notify_all();
+        }
+
+        std::vector<Operation*> refused;
+        refused.swap(retrying);
+        for (Operation *operation : refused) {
+            if (!queue(operation)) finish(operation, false);
+        }
+    }
+}
+
+#else
+
+UringFileIO::~UringFileIO() = default;
+
+bool UringFileIO::setUp(unsigned) {
+    return false;
+}
+
+bool UringFileIO::queue(Operation*) {
+    return false;
+}
+
+void UringFileIO::reap() {
+}
+
+#endif
@@ -0,0 +1,33 @@
+#include "utils/TextParser.h"
+#include <stdexcept>
+
+namespace gr = boost::gregorian;
+
+
+bool TextParser::parseTime(const std::string_view text, pt::ptime &time) {
+    if (text.size() != 16 && text.size() != 19) return false;
+    if (text[4] != '-' || text[7] != '-' || (text[10] != ' ' && text[10] != 'T') || text[13] != ':' ||
+        (text.size() == 19 && text[16] != ':')) {
+        return false;
+    }
+
+    int year, month, day, hour, minute, second = 0;
+    if (!parseNumber(text.substr(0, 4), year) || !parseNumber(text.substr(5, 2), month) || !parseNumber(text.substr(8, 2), day) ||
+        !parseNumber(text.substr(11, 2), hour) || !parseNumber(text.substr(14, 2), minute) ||
+        (text.size() == 19 && !parseNumber(text.substr(17, 2), second))) {
+        return false;
+    }
+    // from_chars accepts a leading '-', so "-1" fits a two-digit field.
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 || minute < 0 || minute > 59 ||
+        second < 0 || second > 59) {
+        return false;
+    }
+
+    try {
+        time = pt::ptime(gr::date(year, month, day), pt::time_duration(hour, minute, second));
+    } catch (const std::out_of_range &) {
+        return false;
+    }
+
+    return true;
+}
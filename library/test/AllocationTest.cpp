@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/date_time.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "typedefs.h"
+#include "model/ClassRoom.h"
+#include "model/ClassRoomTypeFactory.h"
+#include "model/GroupLesson.h"
+#include "model/Person.h"
+
+namespace pt = boost::posix_time;
+
+namespace {
+    // Counted by every thread of the test binary, so it must be atomic.
+    std::atomic<std::size_t> allocations{0};
+}
+
+void* operator new(const std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+struct TestSuiteAllocationFixture {
+    PersonPtr teacher;
+    PersonPtr student;
+    PersonPtr student2;
+    ClassRoomPtr classRoom;
+    GroupLessonPtr groupLesson;
+
+    TestSuiteAllocationFixture() {
+        teacher = std::make_shared<Person>("Jan", "Kowalski", 1);
+        student = std::make_shared<Person>("Kasia", "Iksinska", 2);
+        student2 = std::make_shared<Person>("Anna", "Nowak", 3);
+        classRoom = std::make_shared<ClassRoom>(1, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10));
+        const pt::ptime begin = pt::second_clock::local_time() + pt::hours(1);
+        groupLesson = std::make_shared<GroupLesson>(teacher, begin, begin + pt::hours(1), 100, "Programowanie obiektowe", classRoom);
+        groupLesson->addStudent(student);
+        groupLesson->addStudent(student2);
+        student->addFutureLesson(groupLesson);
+        student2->addFutureLesson(groupLesson);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestSuiteAllocation, TestSuiteAllocationFixture)
+
+BOOST_AUTO_TEST_CASE(AccessorsDoNotAllocateTest) {
+    std::size_t length = 0;
+    std::size_t count = 0;
+
+    const std::size_t before = allocations.load(std::memory_order_relaxed);
+    for (int i = 0; i < 1000; i++) {
+        length += teacher->getFirstName().size() + teacher->getLastName().size();
+        length += groupLesson->getSubject().size();
+        for (const PersonPtr &person : groupLesson->getStudents()) {
+            count += person->getFutureLessons().size();
+        }
+    }
+    const std::size_t after = allocations.load(std::memory_order_relaxed);
+
+    BOOST_TEST(after == before);
+    BOOST_TEST(length == 1000u * (3 + 8 + 23));
+    BOOST_TEST(count == 2000u);
+}
+
+BOOST_AUTO_TEST_CASE(InternedRenameDoesNotAllocateTest) {
+    const std::size_t before = allocations.load(std::memory_order_relaxed);
+    student->setFirstName("Jan");
+    student->setLastName("Kowalski");
+    const std::size_t after = allocations.load(std::memory_order_relaxed);
+
+    BOOST_TEST(after == before);
+    BOOST_TEST(student->getFirstNameId() == teacher->getFirstNameId());
+    BOOST_TEST(&student->getLastName() == &teacher->getLastName());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,10 @@
 #include "model/MathClassRoom.h"
 #include "model/ITClassRoom.h"
 #include "storages/ClassRoomFilesStorage.h"
+#include "model/ClassRoomTypeFactory.h"
+#include "model/WeeklyOccupancy.h"
+#include <thread>
+#include <vector>
 
 struct TestSuiteClassRoomFixture {
     int number = 0;
@@ -113,4 +117,88 @@ BOOST_AUTO_TEST_CASE(ClassRoomRepositoryAndManagerMethods) {
     //BOOST_TEST(availableRooms.size() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(ClassRoomTypeFactorySharesInstancesTest) {
+    ClassRoomTypePtr it = ClassRoomTypeFactory::getITClassRoom(15);
+    ClassRoomTypePtr math = ClassRoomTypeFactory::getMathClassRoom(true);
+    ClassRoomTypePtr eng = ClassRoomTypeFactory::getEngClassRoom(false);
+    const int size = ClassRoomTypeFactory::size();
+
+    BOOST_TEST(ClassRoomTypeFactory::getITClassRoom(15) == it);
+    BOOST_TEST(ClassRoomTypeFactory::getMathClassRoom(true) == math);
+    BOOST_TEST(ClassRoomTypeFactory::getEngClassRoom(false) == eng);
+    BOOST_TEST(ClassRoomTypeFactory::size() == size);
+
+    BOOST_TEST(ClassRoomTypeFactory::getITClassRoom(16) != it);
+    BOOST_TEST(ClassRoomTypeFactory::getMathClassRoom(false) != math);
+    BOOST_TEST(it->getAttributes() == "IT,15");
+    BOOST_TEST(math->getAttributes() == "MATH,1");
+
+    // Threads asking for the same new types at once get the same instances.
+    std::vector<std::vector<ClassRoomTypePtr>> types(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < types.size(); t++) {
+        threads.emplace_back([&types, t] {
+            for (int computers = 1000; computers < 1200; computers++) {
+                types[t].push_back(ClassRoomTypeFactory::getITClassRoom(computers));
+            }
+            types[t].push_back(ClassRoomTypeFactory::getEngClassRoom(true));
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (std::size_t t = 1; t < types.size(); t++) {
+        BOOST_TEST(types[t] == types[0]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ClassRoomTypeFactoryCreateByTagTest) {
+    BOOST_TEST(ClassRoomTypeFactory::create("IT", 12) == ClassRoomTypeFactory::getITClassRoom(12));
+    BOOST_TEST(ClassRoomTypeFactory::create("MATH", 1) == ClassRoomTypeFactory::getMathClassRoom(true));
+    BOOST_TEST(ClassRoomTypeFactory::create("ENG", 0) == ClassRoomTypeFactory::getEngClassRoom(false));
+
+    BOOST_TEST(ClassRoomTypeFactory::isRegistered("ENG"));
+    BOOST_TEST(!ClassRoomTypeFactory::isRegistered("BIO"));
+    BOOST_TEST(!ClassRoomTypeFactory::isRegistered(""));
+    BOOST_TEST(ClassRoomTypeFactory::create("it", 12) == nullptr);
+    BOOST_TEST(ClassRoomTypeFactory::create("BIO", 1) == nullptr);
+
+    for (const auto& type : {ClassRoomTypeFactory::getITClassRoom(3), ClassRoomTypeFactory::getMathClassRoom(false), ClassRoomTypeFactory::getEngClassRoom(true)}) {
+        const std::string attributes = type->getAttributes();
+        const auto comma = attributes.find(',');
+        BOOST_TEST(ClassRoomTypeFactory::create(attributes.substr(0, comma), std::stoi(attributes.substr(comma + 1))) == type);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ClassRoomWeeklyOccupancyTest) {
+    ClassRoom classRoom(number, available, seatsNumber, rentCost, classRoomType);
+    WeeklyOccupancy &occupancy = classRoom.getOccupancy();
+    const pt::ptime monday = pt::time_from_string("2030-02-04 10:00:00");
+
+    BOOST_TEST(WeeklyOccupancy::slotOf(monday) == 120);
+    BOOST_TEST(WeeklyOccupancy::slotOf(monday + pt::hours(24 * 6 + 13)) == WeeklyOccupancy::slotsPerWeek - 1 - 11);
+
+    occupancy.occupy(monday, monday + pt::minutes(42));
+    occupancy.occupy(monday + pt::hours(24 * 7), monday + pt::hours(24 * 7) + pt::minutes(30));
+    BOOST_TEST(!classRoom.getOccupancy().isFree(monday + pt::minutes(40), monday + pt::minutes(41)));
+    BOOST_TEST(classRoom.getOccupancy().isFree(monday + pt::minutes(45), monday + pt::hours(2)));
+    BOOST_TEST((classRoom.getOccupancy().getBits()[1] >> (120 - 64)) == 0xff);
+    BOOST_TEST(classRoom.getOccupancy().getBits()[2] == 1);
+
+    occupancy.release(monday, monday + pt::minutes(42));
+    BOOST_TEST(!classRoom.getOccupancy().isFree(monday, monday + pt::minutes(5)));
+    BOOST_TEST(classRoom.getOccupancy().isFree(monday + pt::minutes(30), monday + pt::minutes(45)));
+
+    WeeklyOccupancy other;
+    other.occupy(monday + pt::minutes(30), monday + pt::minutes(60));
+    BOOST_TEST(WeeklyOccupancy::findCommonFreeSlot({&occupancy, &other}, 3, 118) == 132);
+    BOOST_TEST(WeeklyOccupancy::findCommonFreeSlot({&occupancy, nullptr}, 2, 115) == 115);
+
+    const pt::ptime sunday = pt::time_from_string("2030-02-10 23:50:00");
+    other.occupy(sunday, sunday + pt::minutes(20));
+    BOOST_TEST(!other.isFree(monday - pt::minutes(600), monday - pt::minutes(595)));
+    BOOST_TEST(WeeklyOccupancy::findCommonFreeSlot({&other}, 4, WeeklyOccupancy::slotsPerWeek - 2) == 2);
+    BOOST_TEST(WeeklyOccupancy::findCommonFreeSlot({&other}, WeeklyOccupancy::slotsPerWeek, 0) == -1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "typedefs.h"
+#include "concurrency/TaskPool.h"
+#include "managers/PersonManager.h"
+#include "model/Person.h"
+#include "repositories/PersonRepository.h"
+
+BOOST_AUTO_TEST_SUITE(TestSuiteConcurrency)
+
+BOOST_AUTO_TEST_CASE(TaskPoolTest) {
+    const auto pool = std::make_shared<TaskPool>(2);
+    BOOST_TEST(pool->getThreadsCount() == 2u);
+
+    std::vector<std::future<int>> squares;
+    for (int i = 0; i < 100; i++) {
+        squares.push_back(pool->submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; i++) {
+        BOOST_TEST(squares[i].get() == i * i);
+    }
+
+    std::future<int> failing = pool->submit([]() -> int { throw std::runtime_error("blad"); });
+    BOOST_CHECK_THROW(failing.get(), std::runtime_error);
+    pool->post([] { throw std::runtime_error("blad"); });
+
+    // A loop started from inside a task finishes even though the other worker is kept busy.
+    std::atomic<bool> blocked{true};
+    pool->post([&blocked] { while (blocked) std::this_thread::yield(); });
+    std::future<int> nested = pool->submit([&pool] {
+        std::atomic<int> sum{0};
+        pool->parallelFor(10, [&sum](const std::size_t index) { sum += static_cast<int>(index); });
+        return sum.load();
+    });
+    BOOST_TEST(nested.get() == 45);
+    blocked = false;
+
+    pool->waitIdle();
+    const TaskPool::Statistics statistics = pool->getStatistics();
+    BOOST_TEST(statistics.queueDepth == 0u);
+    BOOST_TEST(statistics.completed == statistics.submitted);
+    BOOST_TEST(statistics.failed == 1u);
+    BOOST_TEST(statistics.maxQueueDepth >= 1u);
+
+    auto personRepository = std::make_shared<PersonRepository>();
+    PersonManager personManager(personRepository, nullptr);
+    personRepository->add(std::make_shared<Person>("Jan", "Kowalski", 123, false, -1));
+    const std::string report = personManager.report();
+    BOOST_TEST(personManager.reportAsync().get() == report);
+    personManager.setTaskPool(pool);
+    BOOST_TEST(personManager.reportAsync().get() == report);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,16 +1,82 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/date_time.hpp>
 #include <string>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <map>
+#include <mutex>
 #include "typedefs.h"
 #include "model/ClassRoom.h"
 #include "model/IndividualLesson.h"
 #include "model/GroupLesson.h"
+#include "model/LessonSeries.h"
 #include "model/ITClassRoom.h"
+#include "model/ClassRoomTypeFactory.h"
 #include "model/Person.h"
+#include "model/WeeklyOccupancy.h"
+#include "concurrency/TaskPool.h"
+#include "concurrency/Executor.h"
+#include "concurrency/Task.h"
+#include "repositories/LessonRepository.h"
+#include "repositories/Transaction.h"
+#include "repositories/PersonRepository.h"
+#include "repositories/ClassRoomRepository.h"
+#include "managers/LessonManager.h"
+#include "managers/RoomAssignmentManager.h"
+#include "managers/TimetableManager.h"
+#include "managers/ImportManager.h"
+#include "managers/PersonManager.h"
+#include "managers/ClassRoomManager.h"
+#include "managers/LessonService.h"
+#include "storages/FileIO.h"
+#include "storages/Flusher.h"
+#include "storages/LessonFilesStorage.h"
+#include "interfaces/CommandUI.h"
 
 namespace pt = boost::posix_time;
 namespace bdt = boost::date_time;
 
+/**
+ * @brief FileIO keeping the files in memory and completing every operation on a TaskPool.
+ */
+class MemoryFileIO : public FileIO {
+public:
+    std::mutex mutex;
+    std::map<std::string, std::string> files;
+    TaskPool pool{1};
+
+    void submitReplace(const std::string &fileName, std::string contents, WriteCallback done) override {
+        pool.post([this, fileName, contents = std::move(contents), done = std::move(done)] {
+            { std::lock_guard<std::mutex> lock(mutex); files[fileName] = contents; }
+            done(true);
+        });
+    }
+
+    void submitAppend(const std::string &fileName, std::string contents, WriteCallback done) override {
+        pool.post([this, fileName, contents = std::move(contents), done = std::move(done)] {
+            { std::lock_guard<std::mutex> lock(mutex); files[fileName] += contents; }
+            done(true);
+        });
+    }
+
+    void submitRead(const std::string &fileName, ReadCallback done) override {
+        pool.post([this, fileName, done = std::move(done)] {
+            std::unique_lock<std::mutex> lock(mutex);
+            const auto file = files.find(fileName);
+            const bool found = file != files.end();
+            std::string contents = found ? file->second : std::string();
+            lock.unlock();
+            done(found, std::move(contents));
+        });
+    }
+
+    [[nodiscard]] std::string getName() const override {
+        return "memory";
+    }
+};
+
 struct TestSuiteLessonFixture {
     pt::ptime beginTime = bdt::not_a_date_time;
     pt::ptime endTime;
@@ -37,7 +103,7 @@ struct TestSuiteLessonFixture {
 BOOST_FIXTURE_TEST_SUITE(TestSuiteLesson, TestSuiteLessonFixture)
 
 BOOST_AUTO_TEST_CASE(LessonConstructorTest_Positive) {
-    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, baseCost, subject, classRoom, student);
+    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom, student);
 
     BOOST_TEST(lesson->getBaseCost() == baseCost);
     BOOST_TEST((pt::second_clock::local_time() - lesson->getBeginTime()).total_seconds() < 1);
@@ -49,7 +115,7 @@ BOOST_AUTO_TEST_CASE(LessonConstructorTest_Positive) {
 }
 
 BOOST_AUTO_TEST_CASE(FinishLessonTest_Positive_IndividualLesson) {
-    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, baseCost, subject, classRoom, student);
+    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom, student);
     lesson->finishLesson();
 
     BOOST_TEST(lesson->getEndTime() != bdt::not_a_date_time);
@@ -60,38 +126,39 @@ BOOST_AUTO_TEST_CASE(FinishLessonTest_Positive_IndividualLesson) {
 }
 
 BOOST_AUTO_TEST_CASE(FinishLessonTest_Negative_InvalidTime) {
-    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, baseCost, subject, classRoom, student);
+    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom, student);
     lesson->finishLesson();
-    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, baseCost, subject, classRoom, student);
+    lesson = std::make_shared<IndividualLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom, student);
     lesson->finishLesson();
     BOOST_TEST(lesson->getTotalCost() == -1);
 }
 
 BOOST_AUTO_TEST_CASE(CalculateTotalCostTest_Positive) {
     pt::ptime start = pt::second_clock::local_time();
-    lesson = std::make_shared<IndividualLesson>(teacher, start, baseCost, subject, classRoom, student);
+    lesson = std::make_shared<IndividualLesson>(teacher, start, endTime, baseCost, subject, classRoom, student);
     lesson->finishLesson();
     BOOST_TEST(lesson->calculateTotalCost() == -1);
 }
 
 BOOST_AUTO_TEST_CASE(CalculateTotalCostTest_Negative_InvalidTime) {
     pt::ptime start = pt::second_clock::local_time();
-    lesson = std::make_shared<IndividualLesson>(teacher, start, baseCost, subject, classRoom, student);
+    lesson = std::make_shared<IndividualLesson>(teacher, start, endTime, baseCost, subject, classRoom, student);
     BOOST_TEST(lesson->calculateTotalCost() == -1);
 }
 
 BOOST_AUTO_TEST_CASE(GroupLessonAddStudentTest_Positive) {
-    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, baseCost, subject, classRoom);
+    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
     int result = groupLesson->addStudent(student);
     BOOST_TEST(result == 0);
     auto students = groupLesson->getStudents();
     BOOST_TEST(students.size() == 1);
     BOOST_TEST(students[0] == student);
-    BOOST_TEST(student->isDuringLesson());
+    BOOST_TEST(groupLesson->hasStudent(student->getId()));
+    BOOST_TEST(groupLesson->addStudent(student) == 2);
 }
 
 BOOST_AUTO_TEST_CASE(GroupLessonAddStudentTest_Negative_NullStudent) {
-    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, baseCost, subject, classRoom);
+    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
     int result = groupLesson->addStudent(nullptr);
     BOOST_TEST(result != 0);
     BOOST_TEST(groupLesson->getStudents().empty());
@@ -103,7 +170,7 @@ BOOST_AUTO_TEST_CASE(GroupLessonAddStudentTest_Negative_NullStudent) {
 }
 
 BOOST_AUTO_TEST_CASE(GroupLessonRemoveStudentTest_Positive) {
-    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, baseCost, subject, classRoom);
+    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
     groupLesson->addStudent(student);
     int result = groupLesson->removeStudent(student);
     BOOST_TEST(result == 0);
@@ -112,7 +179,7 @@ BOOST_AUTO_TEST_CASE(GroupLessonRemoveStudentTest_Positive) {
 }
 
 BOOST_AUTO_TEST_CASE(GroupLessonRemoveStudentTest_Negative_NullStudent) {
-    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, baseCost, subject, classRoom);
+    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
     int result = groupLesson->removeStudent(nullptr);
     BOOST_TEST(result != 0);
 
@@ -121,8 +188,549 @@ BOOST_AUTO_TEST_CASE(GroupLessonRemoveStudentTest_Negative_NullStudent) {
     BOOST_TEST(result1 == 2);
 }
 
+BOOST_AUTO_TEST_CASE(GroupLessonBatchStudentsTest) {
+    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
+    PersonPtr student3 = std::make_shared<Person>("Piotr", "Zielinski", 100, false, -1);
+
+    BOOST_TEST(groupLesson->addStudent(student2) == 0);
+    BOOST_TEST(groupLesson->addStudent(student2) == 2);
+    BOOST_TEST(groupLesson->addStudents({student, nullptr, student2, student3, student}) == 2);
+    BOOST_TEST(groupLesson->getStudents().size() == 3);
+    BOOST_TEST(groupLesson->getStudents()[0] == student3);
+    BOOST_TEST(groupLesson->getStudents()[1] == student);
+    BOOST_TEST(groupLesson->getStudents()[2] == student2);
+    BOOST_TEST(groupLesson->hasStudent(student->getId()));
+
+    BOOST_TEST(groupLesson->removeStudents({student3, student2, teacher}) == 2);
+    BOOST_TEST(groupLesson->getStudents().size() == 1);
+    BOOST_TEST(!groupLesson->hasStudent(student2->getId()));
+    BOOST_TEST(groupLesson->removeStudent(student2) == 2);
+}
+
+BOOST_AUTO_TEST_CASE(PersonFutureLessonsSortedTest) {
+    const pt::ptime now = pt::second_clock::local_time();
+    LessonPtr first = std::make_shared<GroupLesson>(teacher, now, now + pt::hours(1), baseCost, subject, classRoom);
+    LessonPtr second = std::make_shared<GroupLesson>(teacher, now, now + pt::hours(1), baseCost, subject, classRoom);
+
+    student->addFutureLesson(second);
+    student->addFutureLesson(first);
+    student->addFutureLesson(second);
+    BOOST_TEST(student->getFutureLessons().size() == 2);
+    BOOST_TEST(student->getFutureLessons().front() == first);
+    BOOST_TEST(student->hasFutureLesson(second->getID()));
+
+    BOOST_TEST(student->removeFutureLesson(second) == 0);
+    BOOST_TEST(!student->hasFutureLesson(second->getID()));
+    BOOST_TEST(student->getFutureLessons().size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(LessonManagerEnrollStudentsTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    LessonManager manager(lessonRepo, nullptr, personRepo, std::make_shared<ClassRoomRepository>());
+    PersonPtr student3 = std::make_shared<Person>("Ola", "Lis", 789, false, -1);
+    personRepo->add(teacher);
+    personRepo->add(student);
+    personRepo->add(student2);
+    personRepo->add(student3);
+
+    const pt::ptime now = pt::second_clock::local_time();
+    auto smallRoom = std::make_shared<ClassRoom>(2, true, 2, 100.0, classRoomType);
+    LessonPtr newLesson = manager.addGroupLesson(teacher, now + pt::hours(1), now + pt::hours(2), baseCost, subject, smallRoom, false);
+
+    // Enrolling is a transaction on the lesson, so a start or finish that read it before conflicts.
+    Transaction stale = manager.beginTransaction();
+    stale.read(VersionTable::Kind::Lesson, newLesson->getID());
+    BOOST_TEST(stale.stage([] {}) == 0);
+
+    BOOST_TEST(manager.enrollStudents(newLesson->getID(), std::vector<int>{student->getId(), 999, student->getId(), teacher->getId()}) ==
+               std::vector<int>({0, 4, 2, 2}));
+    BOOST_TEST(manager.enrollStudents(newLesson->getID(), std::vector<int>{student->getId(), student2->getId(), student3->getId()}) ==
+               std::vector<int>({2, 0, 6}));
+    BOOST_TEST(manager.enrollStudents(-1, std::vector<int>{student->getId()}) == std::vector<int>({3}));
+    BOOST_TEST(stale.commit() == 1);
+
+    const auto enrolled = std::dynamic_pointer_cast<GroupLesson>(newLesson);
+    BOOST_TEST(enrolled->getStudents().size() == 2);
+    BOOST_TEST(enrolled->isWaitlisted(student3->getId()));
+    BOOST_TEST(student2->hasFutureLesson(newLesson->getID()));
+    BOOST_TEST(!student3->hasFutureLesson(newLesson->getID()));
+    BOOST_TEST(personRepo->findPersonById(student3->getId()) == student3);
+
+    BOOST_TEST(manager.removeStudentFromGroupLesson(newLesson->getID(), student) == 0);
+    BOOST_TEST(enrolled->hasStudent(student3->getId()));
+    BOOST_TEST(enrolled->getWaitlist().empty());
+    BOOST_TEST(student3->hasFutureLesson(newLesson->getID()));
+    BOOST_TEST(manager.addStudentToGroupLesson(newLesson->getID(), student) == 6);
+    BOOST_TEST(!student->hasFutureLesson(newLesson->getID()));
+
+    const std::vector<int> leaving{student2->getId(), 999, student2->getId(), teacher->getId()};
+    BOOST_TEST(manager.removeStudentsFromGroupLesson(newLesson->getID(), leaving) ==
+               std::vector<int>({0, 4, 5, 5}));
+    BOOST_TEST(manager.removeStudentsFromGroupLesson(-1, std::vector<int>{student->getId()}) == std::vector<int>({3}));
+    BOOST_TEST(!enrolled->hasStudent(student2->getId()));
+    BOOST_TEST(!student2->hasFutureLesson(newLesson->getID()));
+    BOOST_TEST(student2->getOccupancy().isFree(now + pt::hours(1), now + pt::hours(2)));
+    BOOST_TEST(enrolled->hasStudent(student->getId()));
+    BOOST_TEST(student->hasFutureLesson(newLesson->getID()));
+    BOOST_TEST(!student->getOccupancy().isFree(now + pt::hours(1), now + pt::hours(2)));
+
+    // A student promoted into a running lesson attends it at once, like the others did at its start.
+    BOOST_TEST(manager.addStudentToGroupLesson(newLesson->getID(), student2) == 6);
+    BOOST_TEST(manager.startLesson(newLesson->getID()));
+    BOOST_TEST(manager.removeStudentFromGroupLesson(newLesson->getID(), student3) == 0);
+    BOOST_TEST(!student3->isDuringLesson());
+    BOOST_TEST(student3->getLessonId() == -1);
+    BOOST_TEST(enrolled->hasStudent(student2->getId()));
+    BOOST_TEST(student2->isDuringLesson());
+    BOOST_TEST(student2->getLessonId() == newLesson->getID());
+    BOOST_TEST(!student2->hasFutureLesson(newLesson->getID()));
+}
+
+BOOST_AUTO_TEST_CASE(GroupLessonWaitlistTest) {
+    PersonPtr student3 = std::make_shared<Person>("Ola", "Lis", 789, false, -1);
+    auto smallRoom = std::make_shared<ClassRoom>(2, true, 1, 100.0, classRoomType);
+    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, smallRoom);
+
+    BOOST_TEST(groupLesson->getFreeSeats() == 1);
+    BOOST_TEST(groupLesson->addStudents({student, student2, student3, student2}) == 1);
+    BOOST_TEST(groupLesson->getFreeSeats() == 0);
+    BOOST_TEST(groupLesson->getWaitlist().size() == 2);
+    BOOST_TEST(groupLesson->getWaitlist().front() == student2);
+    BOOST_TEST(groupLesson->addStudent(student3) == 2);
+    BOOST_TEST(groupLesson->getAttributes().find(",1," + student->getAttributes() + ",2," + student2->getAttributes() + "," + student3->getAttributes()) !=
+               std::string::npos);
+
+    BOOST_TEST(groupLesson->removeStudent(student) == 0);
+    BOOST_TEST(groupLesson->hasStudent(student2->getId()));
+    BOOST_TEST(groupLesson->getWaitlist().front() == student3);
+
+    BOOST_TEST(groupLesson->removeStudent(student3) == 0);
+    BOOST_TEST(!groupLesson->isWaitlisted(student3->getId()));
+    BOOST_TEST(groupLesson->addStudent(student) == 3);
+
+    smallRoom->setSeatsNumber(2);
+    BOOST_TEST(groupLesson->removeStudents({student3, student2}) == 1);
+    BOOST_TEST(groupLesson->getStudents().size() == 1);
+    BOOST_TEST(groupLesson->getStudents()[0] == student);
+    BOOST_TEST(groupLesson->getWaitlist().empty());
+}
+
+BOOST_AUTO_TEST_CASE(LessonManagerFreeSlotsTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonManager manager(lessonRepo, nullptr, personRepo, classRoomRepo);
+    auto smallRoom = std::make_shared<ClassRoom>(2, true, 10, 100.0, ClassRoomTypeFactory::getMathClassRoom(true));
+    classRoomRepo->add(classRoom);
+    classRoomRepo->add(smallRoom);
+    personRepo->add(teacher);
+    personRepo->add(student);
+
+    const pt::ptime begin = pt::second_clock::local_time() + pt::hours(24);
+    LessonPtr booked = manager.addGroupLesson(teacher, begin, begin + pt::hours(1), baseCost, subject, classRoom, false);
+
+    BOOST_TEST(manager.findFreeClassRooms(begin + pt::minutes(30), begin + pt::hours(2), 1, "") == std::vector<ClassRoomPtr>({smallRoom}));
+    BOOST_TEST(manager.findFreeClassRooms(begin + pt::hours(1), begin + pt::hours(2), 20, "").size() == 1);
+    BOOST_TEST(manager.findFreeClassRooms(begin + pt::hours(1), begin + pt::hours(2), 1, "MATH") == std::vector<ClassRoomPtr>({smallRoom}));
+    BOOST_TEST(manager.findFreeClassRooms(begin, begin, 1, "").empty());
+    BOOST_TEST(manager.findFreeTeachers(begin - pt::minutes(30), begin + pt::minutes(1)) == std::vector<PersonPtr>({student}));
+
+    BOOST_TEST(lessonRepo->remove(booked) == 0);
+    BOOST_TEST(manager.findFreeClassRooms(begin, begin + pt::hours(1), 1, "").size() == 2);
+    BOOST_TEST(manager.findFreeTeachers(begin, begin + pt::hours(1)).size() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(LessonManagerCommonFreeSlotTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonManager manager(lessonRepo, nullptr, personRepo, classRoomRepo);
+    auto otherRoom = std::make_shared<ClassRoom>(2, true, 30, 100.0, classRoomType);
+    classRoomRepo->add(classRoom);
+    classRoomRepo->add(otherRoom);
+    personRepo->add(teacher);
+    personRepo->add(student);
+    personRepo->add(student2);
+    PersonPtr student3 = std::make_shared<Person>("Ola", "Lis", 789, false, -1);
+    personRepo->add(student3);
+
+    const pt::ptime monday = pt::time_from_string("2030-02-04 08:00:00");
+    LessonPtr roomLesson = manager.addIndividualLesson(student2, monday, monday + pt::hours(1), baseCost, subject, classRoom, student3, false);
+    LessonPtr groupLesson = manager.addGroupLesson(teacher, monday + pt::hours(1), monday + pt::hours(2), baseCost, subject, otherRoom, false);
+    BOOST_TEST(manager.enrollStudents(groupLesson->getID(), std::vector<int>{student->getId()}) == std::vector<int>({0}));
+
+    BOOST_TEST(!classRoom->getOccupancy().isFree(monday, monday + pt::minutes(5)));
+    BOOST_TEST(!student->getOccupancy().isFree(monday + pt::hours(1), monday + pt::hours(2)));
+    BOOST_TEST(manager.findCommonFreeSlot(classRoom->getNumber(), teacher->getId(), {student->getId()}, pt::minutes(45), monday) ==
+               monday + pt::hours(2));
+    BOOST_TEST(manager.findCommonFreeSlot(classRoom->getNumber(), -1, {}, pt::minutes(45), monday + pt::minutes(2)) ==
+               monday + pt::hours(1));
+    BOOST_TEST(manager.findCommonFreeSlot(classRoom->getNumber(), -1, {}, pt::hours(24 * 8), monday).is_not_a_date_time());
+
+    BOOST_TEST(manager.removeStudentFromGroupLesson(groupLesson->getID(), student) == 0);
+    BOOST_TEST(student->getOccupancy().isFree(monday + pt::hours(1), monday + pt::hours(2)));
+    BOOST_TEST(!teacher->getOccupancy().isFree(monday + pt::hours(1), monday + pt::hours(2)));
+    BOOST_TEST(lessonRepo->remove(roomLesson) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(LessonSeriesOccurrencesTest) {
+    const pt::ptime first = pt::time_from_string("2030-02-04 08:00:00");
+    LessonSeries series(teacher, first, first + pt::hours(1), baseCost, subject, classRoom, {student}, true, 2, 5);
+
+    BOOST_TEST(series.getOccurrenceBegin(4) == first + pt::hours(24 * 7 * 8));
+    BOOST_TEST(series.getOccurrenceBegin(5).is_not_a_date_time());
+
+    std::vector<LessonSeries::Occurrence> occurrences = series.findOccurrences(first + pt::minutes(30), first + pt::hours(24 * 28));
+    BOOST_TEST(occurrences.size() == 2);
+    BOOST_TEST(occurrences[0].index == 0);
+    BOOST_TEST(occurrences[1].beginTime == first + pt::hours(24 * 14));
+    BOOST_TEST(series.findOccurrences(first + pt::hours(1), first + pt::hours(24 * 14)).empty());
+    BOOST_TEST(series.findOccurrences(first + pt::hours(24 * 400), first + pt::hours(24 * 500)).empty());
+
+    BOOST_TEST(series.skipOccurrence(1) == 0);
+    BOOST_TEST(series.skipOccurrence(1) == 2);
+    BOOST_TEST(series.skipOccurrence(5) == 1);
+    occurrences = series.expandUntil(first + pt::hours(24 * 28));
+    BOOST_TEST(occurrences.size() == 2);
+    BOOST_TEST(occurrences[1].index == 2);
+    BOOST_TEST(series.getExpandedCount() == 3);
+    BOOST_TEST(series.skipOccurrence(0) == 2);
+    BOOST_TEST(series.expandUntil(first + pt::hours(24 * 28)).empty());
+    BOOST_TEST(!series.isExhausted());
+    BOOST_TEST(series.getAttributes().rfind("SERIES," + std::to_string(series.getID()) + ",", 0) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(LessonManagerLessonSeriesTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonManager manager(lessonRepo, nullptr, personRepo, classRoomRepo);
+    classRoomRepo->add(classRoom);
+    personRepo->add(teacher);
+    personRepo->add(student);
+    personRepo->add(student2);
+
+    const pt::ptime monday = pt::time_from_string("2030-02-04 08:00:00");
+    const pt::hours week(24 * 7);
+    BOOST_TEST(manager.addGroupLessonSeries(teacher, monday, monday + pt::hours(1), baseCost, subject, classRoom, {student}, 1, 0) == nullptr);
+    BOOST_TEST(manager.addIndividualLessonSeries(teacher, monday, monday + pt::hours(1), baseCost, subject, classRoom, nullptr, 1, 3) == nullptr);
+
+    const LessonSeriesPtr series = manager.addGroupLessonSeries(teacher, monday, monday + pt::hours(1), baseCost, subject, classRoom,
+                                                                {student, nullptr, student2}, 1, 10);
+    BOOST_TEST_REQUIRE(series != nullptr);
+    BOOST_TEST(series->getStudents().size() == 2);
+    BOOST_TEST(lessonRepo->getSeries().size() == 1);
+    BOOST_TEST(lessonRepo->totalSize() == 0);
+    BOOST_TEST(!classRoom->getOccupancy().isFree(monday, monday + pt::hours(1)));
+    BOOST_TEST(!student2->getOccupancy().isFree(monday, monday + pt::hours(1)));
+
+    BOOST_TEST(manager.findSeriesOccurrences(monday + week - pt::hours(1), monday + week * 3).size() == 2);
+    BOOST_TEST(manager.skipSeriesOccurrence(series->getID(), 2) == 0);
+    BOOST_TEST(manager.skipSeriesOccurrence(series->getID(), 2) == 3);
+    BOOST_TEST(manager.skipSeriesOccurrence(series->getID(), 10) == 2);
+    BOOST_TEST(manager.skipSeriesOccurrence(-1, 0) == 1);
+    BOOST_TEST(manager.findSeriesOccurrences(monday + week - pt::hours(1), monday + week * 3).size() == 1);
+    BOOST_TEST(!lessonRepo->isClassRoomFree(classRoom->getNumber(), monday + week, monday + week + pt::minutes(30)));
+    BOOST_TEST(lessonRepo->isClassRoomFree(classRoom->getNumber(), monday + week * 2, monday + week * 2 + pt::minutes(30)));
+    BOOST_TEST(!lessonRepo->isTeacherFree(teacher->getId(), monday + week * 9, monday + week * 9 + pt::hours(1)));
+    BOOST_TEST(lessonRepo->isTeacherFree(teacher->getId(), monday + week * 10, monday + week * 10 + pt::hours(1)));
+
+    const std::vector<LessonPtr> created = manager.expandDueSeries(monday + week);
+    BOOST_TEST(created.size() == 2);
+    BOOST_TEST(std::dynamic_pointer_cast<GroupLesson>(created[1])->getStudents().size() == 2);
+    BOOST_TEST(created[1]->getBeginTime() == monday + week);
+    BOOST_TEST(lessonRepo->totalSize() == 2);
+    BOOST_TEST(manager.expandDueSeries(monday + week).empty());
+    BOOST_TEST(manager.findLessonsToStart(monday + week * 2 + pt::minutes(1)).size() == 2);
+    BOOST_TEST(series->getExpandedCount() == 2);
+    BOOST_TEST(manager.expandDueSeries(monday + week * 2 + pt::minutes(1)).empty());
+    BOOST_TEST(series->getExpandedCount() == 3);
+    BOOST_TEST(lessonRepo->totalSize() == 2);
+
+    // The expanded lessons share the weekly slot the series books, so one release frees it.
+    WeeklyOccupancy probe = classRoom->getOccupancy();
+    probe.release(monday, monday + pt::hours(1));
+    BOOST_TEST(probe.isFree(monday, monday + pt::hours(1)));
+    probe = student2->getOccupancy();
+    probe.release(monday, monday + pt::hours(1));
+    BOOST_TEST(probe.isFree(monday, monday + pt::hours(1)));
+
+    const LessonSeriesPtr individual = manager.addIndividualLessonSeries(teacher, monday + pt::hours(2), monday + pt::hours(3), baseCost,
+                                                                         subject, classRoom, student, 2, 1);
+    BOOST_TEST_REQUIRE(individual != nullptr);
+    const std::vector<LessonPtr> single = manager.expandDueSeries(monday + week * 52);
+    BOOST_TEST(single.size() == 8);
+    BOOST_TEST(std::dynamic_pointer_cast<IndividualLesson>(single.back()) != nullptr);
+    BOOST_TEST(lessonRepo->findSeriesById(individual->getID()) == nullptr);
+    BOOST_TEST(lessonRepo->findSeriesById(series->getID()) == nullptr);
+    BOOST_TEST(classRoom->getOccupancy().isFree(monday + pt::hours(2), monday + pt::hours(3)) == false);
+
+    BOOST_TEST(manager.removeLessonSeries(series->getID()) == 1);
+    for (const LessonPtr &planned : lessonRepo->findAll()) {
+        BOOST_TEST(manager.removeLesson(planned->getID()) == 0);
+    }
+    BOOST_TEST(classRoom->getOccupancy().isFree(monday, monday + pt::hours(3)));
+    BOOST_TEST(teacher->getOccupancy().isFree(monday, monday + pt::hours(3)));
+    BOOST_TEST(student2->getOccupancy().isFree(monday, monday + pt::hours(1)));
+}
+
+BOOST_AUTO_TEST_CASE(LessonManagerSeriesSkippedSlotTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonManager manager(lessonRepo, nullptr, personRepo, classRoomRepo);
+    classRoomRepo->add(classRoom);
+    personRepo->add(teacher);
+    personRepo->add(student);
+
+    const pt::ptime monday = pt::time_from_string("2031-03-03 08:00:00");
+    const pt::hours week(24 * 7);
+    const LessonSeriesPtr series = manager.addGroupLessonSeries(teacher, monday, monday + pt::hours(1), baseCost, subject, classRoom,
+                                                                {student}, 1, 3);
+    BOOST_TEST_REQUIRE(series != nullptr);
+    BOOST_TEST(manager.skipSeriesOccurrence(series->getID(), 1) == 0);
+
+    // A one-off lesson in the skipped slot is not part of the series, even once expansion has passed it.
+    const LessonPtr oneOff = manager.addGroupLesson(teacher, monday + week, monday + week + pt::hours(1), baseCost, subject, classRoom, false);
+    const std::vector<LessonPtr> created = manager.expandDueSeries(monday + week);
+    BOOST_TEST_REQUIRE(created.size() == 1);
+    BOOST_TEST(created[0]->getSeriesId() == series->getID());
+    BOOST_TEST(oneOff->getSeriesId() == -1);
+    BOOST_TEST(created[0]->getAttributes().find("," + std::to_string(series->getID()) + ",1," + student->getAttributes()) != std::string::npos);
+
+    BOOST_TEST(manager.removeLesson(oneOff->getID()) == 0);
+    BOOST_TEST(manager.removeLessonSeries(series->getID()) == 0);
+    BOOST_TEST(manager.removeLesson(created[0]->getID()) == 0);
+    BOOST_TEST(classRoom->getOccupancy().isFree(monday, monday + pt::hours(1)));
+    BOOST_TEST(teacher->getOccupancy().isFree(monday, monday + pt::hours(1)));
+    BOOST_TEST(student->getOccupancy().isFree(monday, monday + pt::hours(1)));
+}
+
+BOOST_AUTO_TEST_CASE(RoomAssignmentManagerTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    auto smallRoom = std::make_shared<ClassRoom>(1, true, 10, 100.0, ClassRoomTypeFactory::getITClassRoom(10));
+    auto itRoom = std::make_shared<ClassRoom>(2, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10));
+    auto mathRoom = std::make_shared<ClassRoom>(3, true, 30, 100.0, ClassRoomTypeFactory::getMathClassRoom(true));
+    classRoomRepo->add(mathRoom);
+    classRoomRepo->add(itRoom);
+    classRoomRepo->add(smallRoom);
+
+    const pt::ptime ten = pt::time_from_string("2030-02-04 10:00:00");
+    lessonRepo->add(std::make_shared<GroupLesson>(teacher, ten + pt::hours(2), ten + pt::hours(3), baseCost, subject, smallRoom), false);
+
+    RoomAssignmentManager manager(classRoomRepo, lessonRepo, 100.0);
+    const std::vector<ClassRoomPtr> rooms = manager.assignRooms({
+        {ten, ten + pt::hours(1), 25, "MATH"},
+        {ten, ten + pt::hours(1), 8, "IT"},
+        {ten, ten + pt::hours(1), 25, "IT"},
+        {ten + pt::minutes(30), ten + pt::minutes(90), 5, ""},
+        {ten + pt::hours(1), ten + pt::hours(2), 5, ""},
+        {ten + pt::minutes(150), ten + pt::hours(3), 5, ""},
+        {ten + pt::hours(1), ten, 5, ""},
+        {ten + pt::hours(1), ten + pt::hours(2), 40, ""},
+    });
+
+    BOOST_TEST(rooms.size() == 8);
+    BOOST_TEST(rooms[0] == mathRoom);
+    BOOST_TEST(rooms[1] == smallRoom);
+    BOOST_TEST(rooms[2] == itRoom);
+    BOOST_TEST(rooms[3] == nullptr);
+    BOOST_TEST(rooms[4] == smallRoom);
+    BOOST_TEST((rooms[5] != nullptr && rooms[5] != smallRoom));
+    BOOST_TEST(rooms[6] == nullptr);
+    BOOST_TEST(rooms[7] == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(TimetableManagerGenerateTest) {
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    auto teacher2 = std::make_shared<Person>("Adam", "Zielinski", 789, false, -1);
+    auto student3 = std::make_shared<Person>("Ola", "Wisniewska", 654, false, -1);
+    for (const PersonPtr &person : {teacher, teacher2, student, student2, student3}) personRepo->add(person);
+    auto itRoom = std::make_shared<ClassRoom>(1, true, 10, 100.0, ClassRoomTypeFactory::getITClassRoom(10));
+    auto mathRoom = std::make_shared<ClassRoom>(2, true, 10, 100.0, ClassRoomTypeFactory::getMathClassRoom(true));
+    classRoomRepo->add(itRoom);
+    classRoomRepo->add(mathRoom);
+
+    const pt::ptime monday = pt::time_from_string("2030-02-04 00:00:00");
+    teacher->getOccupancy().occupy(monday + pt::hours(8), monday + pt::hours(9));
+
+    TimetableManager::Options options;
+    options.weekStart = monday + pt::hours(24 * 2);
+    options.days = 2;
+    options.dayStartHour = 8;
+    options.dayEndHour = 12;
+    options.threads = 2;
+    options.iterations = 20000;
+    options.progressInterval = 5000;
+    int reports = 0;
+    options.onProgress = [&reports](const TimetableManager::Progress &) { reports++; };
+
+    TimetableManager manager(personRepo, classRoomRepo);
+    const TimetableManager::Result result = manager.generate({
+        {"IT", teacher->getId(), {student->getId(), student2->getId()}, 3, 90, baseCost, "IT"},
+        {"ENG", teacher2->getId(), {student->getId()}, 2, 60, baseCost, ""},
+        {"MATH", teacher->getId(), {student2->getId(), student3->getId()}, 2, 60, baseCost, "MATH"},
+        {"BIO", 9999, {student->getId()}, 1, 60, baseCost, ""},
+    }, options);
+
+    BOOST_TEST(result.conflicts == 0);
+    BOOST_TEST(result.skipped == 1);
+    BOOST_TEST(result.lessons.size() == 7);
+    BOOST_TEST(reports == 2 * 4);
+    BOOST_TEST(!result.bestOverTime.empty());
+    BOOST_TEST(result.bestOverTime.back().cost == result.cost);
+    BOOST_TEST(std::dynamic_pointer_cast<IndividualLesson>(result.lessons[3]) != nullptr);
+    BOOST_TEST(std::dynamic_pointer_cast<GroupLesson>(result.lessons[0])->getStudents().size() == 2);
+
+    auto participants = [](const LessonPtr &planned) {
+        std::vector<const void*> resources{planned->getTeacher().get(), planned->getClassRoom().get()};
+        if (auto group = std::dynamic_pointer_cast<GroupLesson>(planned)) {
+            for (const PersonPtr &attendee : group->getStudents()) resources.push_back(attendee.get());
+        } else {
+            resources.push_back(std::dynamic_pointer_cast<IndividualLesson>(planned)->getStudent().get());
+        }
+        return resources;
+    };
+
+    for (std::size_t i = 0; i < result.lessons.size(); i++) {
+        const LessonPtr &first = result.lessons[i];
+        BOOST_TEST(first->getBeginTime() >= monday + pt::hours(8));
+        BOOST_TEST(first->getEndTime() <= monday + pt::hours(24 + 12));
+        if (first->getTeacher() == teacher) {
+            BOOST_TEST(teacher->getOccupancy().isFree(first->getBeginTime(), first->getEndTime()));
+        }
+
+        for (std::size_t j = i + 1; j < result.lessons.size(); j++) {
+            const LessonPtr &second = result.lessons[j];
+            if (first->getEndTime() <= second->getBeginTime() || second->getEndTime() <= first->getBeginTime()) continue;
+
+            std::vector<const void*> shared = participants(first);
+            const std::vector<const void*> others = participants(second);
+            shared.erase(std::remove_if(shared.begin(), shared.end(), [&others](const void *resource) {
+                return std::find(others.begin(), others.end(), resource) == others.end();
+            }), shared.end());
+            BOOST_TEST(shared.empty());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ImportManagerTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    auto lessonManager = std::make_shared<LessonManager>(lessonRepo, nullptr, personRepo, classRoomRepo);
+    ImportManager importer(personRepo, classRoomRepo, lessonManager, 2);
+
+    std::istringstream persons("firstName,lastName,id\nJan,Nowak,1\nAnna,Kowalska,2\n# komentarz\n\nEwa,Lis,3\nBad,Row\n"
+                               "Adam,Zly,x\nJan,Duplikat,1\nOla,Nowa,4\r\n");
+    const ImportManager::Report personsReport = importer.importPersons(persons);
+    BOOST_TEST(personsReport.rows == 7);
+    BOOST_TEST(personsReport.imported == 4);
+    BOOST_TEST_REQUIRE(personsReport.rejected.size() == 3);
+    BOOST_TEST(personsReport.rejected[0].line == 7);
+    BOOST_TEST(personsReport.rejected[2].reason == "Osoba o tym ID juz istnieje");
+    BOOST_TEST(personRepo->size() == 4);
+    BOOST_TEST(personRepo->findPersonById(4)->getLastName() == "Nowa");
+
+    std::istringstream classRooms("10,20,100.5,IT,15\n11,5,50,MATH,1\n12,5,50,CHEM,1\n10,30,10,ENG,0\n13,0,10,ENG,0\n");
+    const ImportManager::Report classRoomsReport = importer.importClassRooms(classRooms);
+    BOOST_TEST(classRoomsReport.imported == 2);
+    BOOST_TEST(classRoomsReport.rejected.size() == 3);
+    BOOST_TEST(classRoomRepo->findClassRoomByNumber(10)->getRentCost() == 100.5);
+
+    std::istringstream lessons(
+        "GROUP,1,10,2030-02-04 08:00,2030-02-04 09:00,100,IT,2;3\n"
+        "INDIVIDUAL,1,11,2030-02-04 08:30:00,2030-02-04 09:30:00,100,MATH,4\n"
+        "INDIVIDUAL,4,10,2030-02-04 08:30,2030-02-04 09:00,100,MATH,2\n"
+        "INDIVIDUAL,4,11,2030-02-04 08:30,2030-02-04 09:00,100,MATH,2;3\n"
+        "GROUP,4,11,2030-02-30 08:30,2030-02-30 09:00,100,MATH,\n"
+        "GROUP,4,11,2030-02-04 10:00,2030-02-04 09:00,100,MATH,\n"
+        "GROUP,4,99,2030-02-04 08:00,2030-02-04 09:00,100,MATH,\n"
+        "GROUP,4,11,2030-02-04 08:00,2030-02-04 09:00,100,MATH,2;7\n"
+        "INDIVIDUAL,4,11,2030-02-04T09:00:00,2030-02-04 10:00,100,MATH,3\n"
+        "GROUP,1,10,2030-02-04 09:00,2030-02-04 10:00,100,IT,\n"
+        "GROUP,4,10,2030-02-04 08:15,2030-02-04 08:45,100,IT,\n");
+    const ImportManager::Report lessonsReport = importer.importLessons(lessons);
+    BOOST_TEST(lessonsReport.rows == 11);
+    BOOST_TEST(lessonsReport.imported == 3);
+    BOOST_TEST_REQUIRE(lessonsReport.rejected.size() == 8);
+    BOOST_TEST(lessonsReport.rejected[0].reason == "Nauczyciel jest zajety w tym czasie");
+    BOOST_TEST(lessonsReport.rejected[1].reason == "Sala jest zajeta w tym czasie");
+    BOOST_TEST(lessonsReport.rejected[2].reason == "Lekcja indywidualna wymaga jednego ucznia");
+    BOOST_TEST(lessonsReport.rejected[3].reason == "Niepoprawny czas");
+    BOOST_TEST(lessonsReport.rejected[6].reason == "Nie znaleziono ucznia");
+    BOOST_TEST(lessonsReport.rejected[7].line == 11);
+    BOOST_TEST(lessonsReport.rejected[7].reason == "Sala jest zajeta w tym czasie");
+    BOOST_TEST(lessonRepo->totalSize() == 3);
+
+    const pt::ptime monday = pt::time_from_string("2030-02-04 08:00:00");
+    BOOST_TEST(!personRepo->findPersonById(3)->getOccupancy().isFree(monday, monday + pt::hours(1)));
+    BOOST_TEST(!classRoomRepo->findClassRoomByNumber(11)->getOccupancy().isFree(monday + pt::hours(1), monday + pt::hours(2)));
+    BOOST_TEST(lessonsReport.rowsPerSecond() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(CommandUIRunTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    auto personManager = std::make_shared<PersonManager>(personRepo, nullptr);
+    auto classRoomManager = std::make_shared<ClassRoomManager>(classRoomRepo, nullptr);
+    auto lessonManager = std::make_shared<LessonManager>(lessonRepo, nullptr, personRepo, classRoomRepo);
+    CommandUI commandUI(personManager, classRoomManager, lessonManager);
+
+    std::istringstream script("# skrypt testowy\n"
+                              "add-person Jan Nowak 1\n"
+                              "add-person Anna Kowalska 2\n"
+                              "add-person Ewa Lis 2\n"
+                              "add-room 10 1 100 IT 15\n"
+                              "add-room 11 20 50 CHEM 1\n"
+                              "\n"
+                              "plan-lesson group 1 10 2030-02-04T08:00 2030-02-04T09:00 100 IT 2 1\n"
+                              "plan-lesson individual 1 10 2030-02-04T08:30 2030-02-04T09:30 100 IT 2\n"
+                              "plan-lesson individual 2 10 2030-02-31T08:30 2030-02-31T09:30 100 IT 1\n"
+                              "start @\n"
+                              "start @\n"
+                              "report lessons\n"
+                              "fly 1\n");
+    std::ostringstream output;
+    const CommandUI::Summary summary = commandUI.run(script, output);
+
+    BOOST_TEST(summary.commands == 12);
+    BOOST_TEST(summary.failed == 6);
+
+    std::vector<std::string> lines;
+    std::istringstream records(output.str());
+    for (std::string line; std::getline(records, line);) {
+        if (line.rfind("# ", 0) != 0) lines.push_back(line.substr(0, line.rfind('\t')));
+    }
+    BOOST_TEST_REQUIRE(lines.size() == 13);
+    BOOST_TEST(lines[0] == "ok\t2\tadd-person\t1");
+    BOOST_TEST(lines[2] == "error\t4\tadd-person\tOsoba o tym ID juz istnieje");
+    BOOST_TEST(lines[4] == "error\t6\tadd-room\tNieznany typ sali");
+    BOOST_TEST(lines[5].rfind("ok\t8\tplan-lesson\t", 0) == 0);
+    BOOST_TEST(lines[6] == "error\t9\tplan-lesson\tSala jest zajeta w tym czasie");
+    BOOST_TEST(lines[7] == "error\t10\tplan-lesson\tNiepoprawny czas");
+    BOOST_TEST(lines[9] == "error\t12\tstart\tLekcja juz trwa");
+    BOOST_TEST(lines[10] == "ok\t13\treport\t1");
+    BOOST_TEST(lines[11] == "error\t14\tfly\tNieznane polecenie");
+    BOOST_TEST(lines[12].rfind("summary\t12\t6\t", 0) == 0);
+
+    std::string result;
+    BOOST_TEST(!commandUI.executeLine("finish @", result));
+    BOOST_TEST(result == "Odwolanie @ jest dostepne tylko w skryptach");
+
+    const LessonPtr lesson = lessonRepo->findAll().front();
+    BOOST_TEST(lesson->isStarted());
+    BOOST_TEST(personRepo->findPersonById(2)->isDuringLesson());
+    BOOST_TEST(std::dynamic_pointer_cast<GroupLesson>(lesson)->getStudents().size() == 1);
+    lessonRepo->remove(lesson);
+}
+
 BOOST_AUTO_TEST_CASE(GroupLessonFinishLessonTest_Positive) {
-    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, baseCost, subject, classRoom);
+    groupLesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
     groupLesson->addStudent(student);
     groupLesson->addStudent(student2);
     groupLesson->finishLesson();
@@ -134,10 +742,205 @@ BOOST_AUTO_TEST_CASE(GroupLessonFinishLessonTest_Positive) {
 
 BOOST_AUTO_TEST_CASE(LessonFinishLessonWithInvalidTimeTest) {
     pt::ptime future = pt::second_clock::local_time() + pt::hours(1);
-    lesson = std::make_shared<IndividualLesson>(teacher, future, baseCost, subject, classRoom, student);
+    lesson = std::make_shared<IndividualLesson>(teacher, future, endTime, baseCost, subject, classRoom, student);
     lesson->finishLesson();
 
     BOOST_TEST(lesson->getEndTime().is_not_a_date_time());
 }
 
+BOOST_AUTO_TEST_CASE(RepositoryConcurrencyStressTest) {
+    constexpr int writers = 2;
+    constexpr int readers = 4;
+    constexpr int lessonsPerWriter = 500;
+
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonRepository repository;
+    std::vector<PersonPtr> teachers;
+    std::vector<ClassRoomPtr> classRooms;
+    for (int i = 0; i < writers; i++) {
+        teachers.push_back(std::make_shared<Person>("Nauczyciel", std::to_string(i), 1000 + i));
+        classRooms.push_back(std::make_shared<ClassRoom>(1000 + i, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10)));
+        personRepo->add(teachers.back());
+        classRoomRepo->add(classRooms.back());
+    }
+
+    const pt::ptime base = pt::time_from_string("2030-02-04 08:00:00");
+    std::atomic<int> writersDone{0};
+    std::atomic<long> reads{0};
+    std::atomic<long> missing{0};
+    std::vector<std::vector<int>> ids(writers);
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&, w] {
+            std::vector<LessonPtr> lessons;
+            for (int i = 0; i < lessonsPerWriter; i++) {
+                const pt::ptime begin = base + pt::hours(i);
+                lessons.push_back(std::make_shared<GroupLesson>(teachers[w], begin, begin + pt::hours(1), baseCost, subject, classRooms[w]));
+                ids[w].push_back(lessons.back()->getID());
+                repository.add(lessons.back(), false);
+                if (i % 2 == 1) repository.setStarted(lessons[i - 1]->getID(), true);
+            }
+            for (const LessonPtr &lesson : lessons) {
+                repository.remove(lesson);
+            }
+            writersDone++;
+        });
+    }
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            while (writersDone < writers) {
+                const pt::ptime begin = base + pt::hours(r * 37 % lessonsPerWriter);
+                (void) repository.isClassRoomFree(1000 + r % writers, begin, begin + pt::minutes(30));
+                (void) repository.isTeacherFree(1000 + r % writers, begin, begin + pt::minutes(30));
+                (void) repository.findToStart(begin);
+                (void) repository.findBy([](const LessonPtr &lesson) { return lesson->getBaseCost() > 0; });
+                // Boost.Test assertions are not thread-safe, so failures are only counted here.
+                if (personRepo->findPersonById(1000 + r % writers) == nullptr) missing++;
+                if (classRoomRepo->findClassRoomByNumber(1000 + r % writers) == nullptr) missing++;
+                reads++;
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    BOOST_TEST(reads > 0);
+    BOOST_TEST(missing == 0);
+    std::vector<int> allIds = ids[0];
+    allIds.insert(allIds.end(), ids[1].begin(), ids[1].end());
+    std::sort(allIds.begin(), allIds.end());
+    BOOST_TEST((std::adjacent_find(allIds.begin(), allIds.end()) == allIds.end()));
+    BOOST_TEST(repository.totalSize() == 0);
+    BOOST_TEST(repository.getSchedule().empty());
+    BOOST_TEST(repository.isClassRoomFree(1000, base, base + pt::hours(lessonsPerWriter)));
+    BOOST_TEST(repository.isTeacherFree(1001, base, base + pt::hours(lessonsPerWriter)));
+}
+
+BOOST_AUTO_TEST_CASE(LessonServiceTest) {
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    auto manager = std::make_shared<LessonManager>(lessonRepo, nullptr, personRepo, classRoomRepo);
+    personRepo->add(teacher);
+    personRepo->add(student);
+    personRepo->add(student2);
+    classRoomRepo->add(classRoom);
+
+    const auto fileIO = std::make_shared<MemoryFileIO>();
+    const auto flusher = std::make_shared<Flusher>(fileIO);
+    manager->setFlusher(flusher);
+    const LessonService service(manager, flusher, fileIO);
+    Executor executor(2);
+    BOOST_TEST(executor.getLoopsCount() == 2u);
+
+    // Each operation suspends until the lessons are written, and resumes on the loop it started on.
+    const pt::ptime now = pt::second_clock::local_time();
+    const LessonPtr planned = executor.spawn(service.plan(teacher, now + pt::hours(1), now + pt::hours(2), baseCost, subject, classRoom)).get();
+    BOOST_REQUIRE(planned != nullptr);
+    BOOST_TEST(executor.spawn(service.enroll(planned->getID(), {student->getId(), 999})).get() == std::vector<int>({0, 4}));
+    {
+        std::lock_guard<std::mutex> lock(fileIO->mutex);
+        BOOST_TEST(fileIO->files[LessonFilesStorage::databaseFile] == LessonFilesStorage::serialize(lessonRepo));
+    }
+
+    std::vector<std::future<std::string>> reports;
+    for (int i = 0; i < 50; i++) {
+        reports.push_back(executor.spawn(service.report()));
+    }
+    for (std::future<std::string> &report : reports) {
+        BOOST_TEST(report.get() == manager->report());
+    }
+
+    BOOST_TEST(executor.spawn(service.start(planned->getID())).get());
+    BOOST_TEST(student->isDuringLesson());
+    BOOST_TEST(executor.spawn(service.finish(planned->getID())).get());
+    BOOST_TEST(!executor.spawn(service.finish(planned->getID())).get());
+    BOOST_TEST(lessonRepo->findByIndex(planned->getID()) == nullptr);
+
+    // Awaited Tasks pass exceptions up the chain to the future of the spawned one.
+    BOOST_CHECK_THROW(executor.spawn(service.archive()).get(), std::runtime_error);
+    {
+        std::lock_guard<std::mutex> lock(fileIO->mutex);
+        fileIO->files[LessonFilesStorage::archiveFile] = "Lekcja\n";
+    }
+    BOOST_TEST(executor.spawn(service.archive()).get() == "Lekcja\n");
+    const auto chained = [&service]() -> Task<std::size_t> {
+        const std::string report = co_await service.report();
+        co_return report.size();
+    };
+    BOOST_TEST(executor.spawn(chained()).get() == manager->report().size());
+    BOOST_TEST(flusher->getFailed() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(LessonManagerConcurrentStartFinishTest) {
+    constexpr int lessonsCount = 200;
+    constexpr int resourcesCount = 20;
+
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    LessonManager manager(std::make_shared<LessonRepository>(), nullptr, personRepo, classRoomRepo);
+    for (int i = 0; i < resourcesCount; i++) {
+        personRepo->add(std::make_shared<Person>("Nauczyciel", std::to_string(i), 2000 + i));
+        classRoomRepo->add(std::make_shared<ClassRoom>(2000 + i, true, 30, 100.0, ClassRoomTypeFactory::getITClassRoom(10)));
+    }
+
+    const pt::ptime base = pt::time_from_string("2030-03-04 08:00:00");
+    std::vector<int> ids;
+    for (int i = 0; i < lessonsCount; i++) {
+        const pt::ptime begin = base + pt::hours(i);
+        const LessonPtr lesson = manager.addGroupLesson(personRepo->findPersonById(2000 + i % resourcesCount), begin, begin + pt::hours(1), baseCost,
+                                                        subject, classRoomRepo->findClassRoomByNumber(2000 + i % resourcesCount), false);
+        BOOST_REQUIRE(lesson != nullptr);
+        ids.push_back(lesson->getID());
+    }
+
+    // Starts race with finishes of the same lessons: a start either lands before the finish, which
+    // then releases everything, or finds the lesson gone. No room may stay unavailable.
+    std::thread starter([&] {
+        for (const int id : ids) (void) manager.startLesson(id);
+    });
+    std::thread finisher([&] {
+        for (const int id : ids) {
+            while (!manager.finishLesson(id)) {}
+        }
+    });
+    starter.join();
+    finisher.join();
+
+    BOOST_TEST(manager.getLessonRepo()->totalSize() == 0);
+    for (int i = 0; i < resourcesCount; i++) {
+        BOOST_TEST(classRoomRepo->findClassRoomByNumber(2000 + i)->isAvailable());
+        BOOST_TEST(!personRepo->findPersonById(2000 + i)->isDuringLesson());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LessonRepositoryScheduleTest) {
+    LessonRepository repository;
+    const pt::ptime now = pt::second_clock::local_time();
+    LessonPtr past = std::make_shared<GroupLesson>(teacher, now - pt::hours(2), now - pt::hours(1), baseCost, subject, classRoom);
+    LessonPtr current = std::make_shared<GroupLesson>(teacher, now - pt::minutes(5), now + pt::hours(1), baseCost, subject, classRoom);
+    LessonPtr future = std::make_shared<IndividualLesson>(teacher, now + pt::hours(1), now + pt::hours(2), baseCost, subject, classRoom, student);
+    repository.add(past, true);
+    repository.add(current, false);
+    repository.add(future, false);
+
+    BOOST_TEST(repository.getSchedule().size() == 3);
+    BOOST_TEST(repository.findToStart(now) == std::vector<int>({past->getID(), current->getID()}));
+    BOOST_TEST(repository.findToFinish(now).empty());
+
+    past->startLesson(true);
+    BOOST_TEST(repository.setStarted(past->getID(), true) == 0);
+    BOOST_TEST(repository.setStarted(-1, true) == 1);
+    BOOST_TEST(repository.findToStart(now) == std::vector<int>({current->getID()}));
+    BOOST_TEST(repository.findToFinish(now) == std::vector<int>({past->getID()}));
+
+    BOOST_TEST(repository.remove(past) == 0);
+    BOOST_TEST(repository.getSchedule().size() == 2);
+    BOOST_TEST(repository.findToFinish(now).empty());
+    BOOST_TEST(repository.findToStart(now + pt::hours(3)).size() == 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,17 @@
 #include "typedefs.h"
 #include <memory>
 #include "storages/PersonFilesStorage.h"
+#include "storages/Flusher.h"
+#include "storages/ThreadPoolFileIO.h"
+#include "storages/UringFileIO.h"
+#include "concurrency/TaskPool.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 struct TestSuitePersonFixture {
     std::string firstName = "Jan";
@@ -74,4 +85,118 @@ BOOST_AUTO_TEST_CASE(PersonManagerMethodsTest) {
     BOOST_TEST(found1.front()->getLastName() == "Kowalski");
 }
 
+BOOST_AUTO_TEST_CASE(PersonInternedNamesTest) {
+    PersonPtr person = std::make_shared<Person>(firstName, lastName, id);
+    PersonPtr person2 = std::make_shared<Person>(firstName, "Nowak", id + 1);
+
+    BOOST_TEST(person->getFirstNameId() == person2->getFirstNameId());
+    BOOST_TEST(person->getLastNameId() != person2->getLastNameId());
+    BOOST_TEST(person->getFirstNameId() == StringPool::intern(firstName));
+    BOOST_TEST(StringPool::get(person2->getLastNameId()) == "Nowak");
+
+    const int poolSize = StringPool::size();
+    PersonPtr person3 = std::make_shared<Person>(firstName, lastName, id + 2);
+    BOOST_TEST(StringPool::size() == poolSize);
+
+    // Threads interning the same new names get the same identifiers and read them back intact.
+    std::vector<std::vector<StringPool::Id>> ids(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < ids.size(); t++) {
+        threads.emplace_back([&ids, t] {
+            for (int i = 0; i < 1000; i++) {
+                const std::string name = "Watek" + std::to_string(i);
+                ids[t].push_back(StringPool::intern(name));
+                if (StringPool::get(ids[t].back()) != name) ids[t].back() = static_cast<StringPool::Id>(-1);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (std::size_t t = 1; t < ids.size(); t++) {
+        BOOST_TEST(ids[t] == ids[0]);
+    }
+    BOOST_TEST(StringPool::size() == poolSize + 1000);
+}
+
+BOOST_AUTO_TEST_CASE(FlusherCoalescingTest) {
+    const auto pool = std::make_shared<TaskPool>(1);
+    const std::string fileName = "/tmp/learningcenter-flusher-" + std::to_string(getpid()) + ".txt";
+    auto flusher = std::make_shared<Flusher>(std::make_shared<ThreadPoolFileIO>(pool));
+
+    // While the only worker is busy the first write cannot finish, so the third one replaces the
+    // second, which waits behind it; an append is queued after them and never merged.
+    std::atomic<bool> blocked{true};
+    pool->post([&blocked] { while (blocked) std::this_thread::yield(); });
+    const std::shared_future<bool> first = flusher->flush(fileName, "pierwsza\n");
+    const std::shared_future<bool> second = flusher->flush(fileName, "stara\n");
+    const std::shared_future<bool> third = flusher->flush(fileName, "nowa\n");
+    const std::shared_future<bool> appended = flusher->append(fileName, "dopisana\n");
+    BOOST_TEST(flusher->getOutstanding() == 3u);
+    blocked = false;
+
+    BOOST_TEST(first.get());
+    BOOST_TEST(second.get());
+    BOOST_TEST(third.get());
+    BOOST_TEST(appended.get());
+    flusher->waitAll();
+    std::ifstream written(fileName);
+    std::stringstream contents;
+    contents << written.rdbuf();
+    BOOST_TEST(contents.str() == "nowa\ndopisana\n");
+    BOOST_TEST(flusher->getWritten() == 3u);
+    BOOST_TEST(flusher->getCoalesced() == 1u);
+
+    BOOST_TEST(!flusher->flush("/nonexistent-directory/Person.txt", "x\n").get());
+    BOOST_TEST(flusher->getFailed() == 1u);
+    BOOST_TEST(flusher->getOutstanding() == 0u);
+    std::remove(fileName.c_str());
+
+    auto personRepository = std::make_shared<PersonRepository>();
+    personRepository->add(std::make_shared<Person>(firstName, lastName, id));
+    personRepository->add(std::make_shared<Person>("Anna", "Nowak", id + 1));
+    std::string expected;
+    for (const PersonPtr &person : personRepository->findAll()) {
+        expected += person->getAttributes() + "\n";
+    }
+    BOOST_TEST(PersonFilesStorage::serialize(personRepository) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(FileIOBackendsTest) {
+    const std::string fileName = "/tmp/learningcenter-fileio-" + std::to_string(getpid()) + ".txt";
+    std::vector<FileIOPtr> backends{std::make_shared<ThreadPoolFileIO>(std::make_shared<TaskPool>(2))};
+    if (FileIOPtr uring = UringFileIO::create()) backends.push_back(uring);
+
+    for (const FileIOPtr &fileIO : backends) {
+        BOOST_TEST_MESSAGE(fileIO->getName());
+        std::string large(200000, 'x');
+        large.back() = '\n';
+
+        BOOST_TEST(fileIO->replace(fileName, large).get());
+        BOOST_TEST(fileIO->read(fileName).get() == large);
+        BOOST_TEST(fileIO->replace(fileName, "Jan Kowalski\n").get());
+        BOOST_TEST(fileIO->append(fileName, "Anna Nowak\n").get());
+        BOOST_TEST(fileIO->read(fileName).get() == "Jan Kowalski\nAnna Nowak\n");
+        BOOST_TEST(fileIO->replace(fileName, "").get());
+        BOOST_TEST(fileIO->read(fileName).get().empty());
+
+        BOOST_TEST(!fileIO->replace("/nonexistent-directory/Person.txt", "x\n").get());
+        BOOST_CHECK_THROW(fileIO->read("/nonexistent-directory/Person.txt").get(), std::runtime_error);
+        std::ifstream temporary(fileName + ".tmp");
+        BOOST_TEST(!temporary.is_open());
+
+        // Many files in flight at once, more than the ring has entries.
+        std::vector<std::future<bool>> writes;
+        for (int i = 0; i < 200; i++) {
+            writes.push_back(fileIO->replace(fileName + std::to_string(i), std::to_string(i) + "\n"));
+        }
+        for (int i = 0; i < 200; i++) {
+            BOOST_TEST(writes[i].get());
+            BOOST_TEST(fileIO->read(fileName + std::to_string(i)).get() == std::to_string(i) + "\n");
+            std::remove((fileName + std::to_string(i)).c_str());
+        }
+    }
+    std::remove(fileName.c_str());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/date_time.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "typedefs.h"
+#include "model/ClassRoom.h"
+#include "model/GroupLesson.h"
+#include "model/ITClassRoom.h"
+#include "model/Person.h"
+#include "repositories/LessonRepository.h"
+#include "repositories/OccupancyIndex.h"
+#include "repositories/PersistentVector.h"
+#include "repositories/PersonRepository.h"
+#include "repositories/Transaction.h"
+
+namespace pt = boost::posix_time;
+namespace bdt = boost::date_time;
+
+struct TestSuiteRepositoryFixture {
+    pt::ptime beginTime = bdt::not_a_date_time;
+    pt::ptime endTime;
+    int baseCost = 100;
+    std::string subject = "IT";
+    PersonPtr teacher;
+    ClassRoomPtr classRoom;
+
+    TestSuiteRepositoryFixture() {
+        teacher = std::make_shared<Person>("Jan", "Kowalski", 123, false, -1);
+        classRoom = std::make_shared<ClassRoom>(1, true, 144, 1000.0, std::make_shared<ITClassRoom>(20));
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestSuiteRepository, TestSuiteRepositoryFixture)
+
+BOOST_AUTO_TEST_CASE(PersistentVectorCopyOnWriteTest) {
+    PersistentVector<int> original;
+    for (int i = 0; i < 600; i++) {
+        original.pushBack(i);
+    }
+
+    PersistentVector<int> copy = original;
+    BOOST_TEST(copy.erase(5) == 1u);
+    copy.eraseAt(300);
+    copy.pushBack(1000);
+
+    BOOST_TEST(original.size() == 600u);
+    BOOST_TEST(original.at(5) == 5);
+    BOOST_TEST(original.at(300) == 300);
+    BOOST_TEST(original.at(599) == 599);
+    BOOST_TEST(copy.size() == 599u);
+    BOOST_TEST(copy.at(5) == 6);
+    BOOST_TEST(copy.at(299) == 300);
+    BOOST_TEST(copy.at(300) == 302);
+    BOOST_TEST(copy.at(598) == 1000);
+
+    long sum = 0;
+    original.forEach([&sum](const int value) { sum += value; });
+    BOOST_TEST(sum == 599L * 600 / 2);
+    BOOST_TEST(copy.toVector().size() == copy.size());
+}
+
+BOOST_AUTO_TEST_CASE(RepositorySnapshotIsolationTest) {
+    PersonRepository personRepository;
+    const auto first = std::make_shared<Person>("Jan", "Kowalski", 1);
+    const auto second = std::make_shared<Person>("Anna", "Nowak", 2);
+    personRepository.add(first);
+
+    const auto before = personRepository.snapshot();
+    BOOST_TEST(personRepository.snapshot()->at(0) == before->at(0));
+    personRepository.add(second);
+    personRepository.remove(first);
+
+    BOOST_TEST(before->size() == 1u);
+    BOOST_TEST(before->at(0) == first);
+    const auto after = personRepository.snapshot();
+    BOOST_TEST(after->size() == 1u);
+    BOOST_TEST(after->at(0) == second);
+    BOOST_TEST(personRepository.findPersonById(1) == nullptr);
+
+    LessonRepository lessonRepository;
+    const auto lesson = std::make_shared<GroupLesson>(teacher, beginTime, endTime, baseCost, subject, classRoom);
+    lessonRepository.add(lesson, false);
+    const auto lessons = lessonRepository.snapshot();
+    lessonRepository.remove(lesson);
+
+    BOOST_TEST(lessons->planned.size() == 1u);
+    BOOST_TEST(lessonRepository.snapshot()->planned.empty());
+    BOOST_TEST(lessonRepository.findAll().empty());
+}
+
+BOOST_AUTO_TEST_CASE(ShardedRepositoryOrderTest) {
+    PersonRepository personRepository(4);
+    std::vector<PersonPtr> persons;
+    for (int id = 0; id < 100; id++) {
+        persons.push_back(std::make_shared<Person>("Jan", "Kowalski", 99 - id));
+    }
+    for (int i = 0; i < 50; i++) {
+        personRepository.add(persons[i]);
+    }
+    personRepository.addAll(std::vector<PersonPtr>(persons.begin() + 50, persons.end()));
+
+    BOOST_TEST(personRepository.size() == 100);
+    BOOST_TEST((personRepository.findAll() == persons));
+    BOOST_TEST(personRepository.findPersonById(0) == persons[99]);
+    const auto even = personRepository.findBy([](const PersonPtr &person) { return person->getId() % 2 == 0; });
+    BOOST_TEST(even.size() == 50u);
+    BOOST_TEST(even.front() == persons[1]);
+    BOOST_TEST(even.back() == persons[99]);
+
+    personRepository.remove(persons[0]);
+    BOOST_TEST(personRepository.snapshot()->at(0) == persons[1]);
+    BOOST_TEST(personRepository.findPersonById(99) == nullptr);
+
+    const pt::ptime monday = pt::time_from_string("2030-02-04 08:00:00");
+    LessonRepository lessonRepository(4);
+    std::vector<LessonPtr> lessons;
+    for (int i = 0; i < 20; i++) {
+        lessons.push_back(std::make_shared<GroupLesson>(teacher, monday + pt::hours(3 * i), monday + pt::hours(3 * i) + pt::minutes(45),
+                                                        baseCost, subject, classRoom));
+    }
+    for (int i = 0; i < 10; i++) {
+        BOOST_TEST(lessonRepository.add(lessons[i], true) == 0);
+    }
+    BOOST_TEST(lessonRepository.addAll(std::vector<LessonPtr>(lessons.begin() + 10, lessons.end()), true) == 10);
+
+    BOOST_TEST((lessonRepository.getStartedLessons() == lessons));
+    BOOST_TEST(lessonRepository.getByIndex(7) == lessons[7]);
+    BOOST_TEST(lessonRepository.findByIndex(lessons[13]->getID()) == lessons[13]);
+    BOOST_TEST(lessonRepository.getSchedule().size() == 20u);
+    BOOST_TEST(!lessonRepository.isClassRoomFree(classRoom->getNumber(), monday, monday + pt::minutes(45)));
+    BOOST_TEST(lessonRepository.remove(lessons[0]) == 0);
+    BOOST_TEST(lessonRepository.isClassRoomFree(classRoom->getNumber(), monday, monday + pt::minutes(45)));
+    BOOST_TEST(lessonRepository.getByIndex(0) == lessons[1]);
+    BOOST_TEST(lessonRepository.totalSize() == 19);
+}
+
+BOOST_AUTO_TEST_CASE(OccupancyIndexTest) {
+    OccupancyIndex index;
+    index.add(1, 100, 200, 10);
+    index.add(1, 1000, 5000, 11);
+    index.add(1, 6000, 6100, 12);
+
+    BOOST_TEST(index.isFree(1, 200, 1000));
+    BOOST_TEST(index.isFree(2, 0, 10000));
+    BOOST_TEST(!index.isFree(1, 150, 160));
+    BOOST_TEST(!index.isFree(1, 4900, 5900));
+    BOOST_TEST(!index.isFree(1, 0, 101));
+    BOOST_TEST(index.isFree(1, 5000, 6000));
+
+    BOOST_TEST(index.remove(1, 1000, 11) == 0);
+    BOOST_TEST(index.remove(1, 1000, 11) == 1);
+    BOOST_TEST(index.isFree(1, 4900, 5900));
+
+    index.add(1, 7000, std::numeric_limits<std::int64_t>::max(), 13);
+    BOOST_TEST(index.isFree(1, 6500, 7000));
+    BOOST_TEST(!index.isFree(1, 9000, 9100));
+    BOOST_TEST(index.size(1) == 3);
+}
+
+BOOST_AUTO_TEST_CASE(TransactionConflictTest) {
+    const auto versions = std::make_shared<VersionTable>();
+    int value = 0;
+
+    Transaction first(versions);
+    Transaction second(versions);
+    first.read(VersionTable::Kind::Lesson, 1);
+    second.read(VersionTable::Kind::Lesson, 1);
+    BOOST_TEST(second.stage([&value] { value = 2; }) == 0);
+    BOOST_TEST(second.commit() == 0);
+    BOOST_TEST(first.stage([&value] { value = 1; }) == 0);
+    BOOST_TEST(first.commit() == 1);
+    BOOST_TEST(value == 2);
+    BOOST_TEST((first.getState() == Transaction::State::Aborted));
+    BOOST_TEST(first.commit() == 2);
+    BOOST_TEST(versions->getConflicts() == 1);
+
+    Transaction dropped(versions);
+    dropped.read(VersionTable::Kind::Lesson, 1);
+    dropped.stage([&value] { value = 3; });
+    BOOST_TEST(dropped.abort() == 0);
+    BOOST_TEST(dropped.stage([&value] { value = 4; }) == 1);
+    BOOST_TEST(value == 2);
+
+    Transaction other(versions);
+    other.read(VersionTable::Kind::Person, 1);
+    other.read(VersionTable::Kind::ClassRoom, 1);
+    other.stage([&value] { value = 5; });
+    BOOST_TEST(other.commit() == 0);
+    BOOST_TEST(value == 5);
+    BOOST_TEST(versions->read({VersionTable::Kind::Lesson, 1}) == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "typedefs.h"
+#include "interfaces/CommandUI.h"
+#include "interfaces/SocketServer.h"
+#include "managers/ClassRoomManager.h"
+#include "managers/LessonManager.h"
+#include "managers/PersonManager.h"
+#include "model/Person.h"
+#include "repositories/ClassRoomRepository.h"
+#include "repositories/LessonRepository.h"
+#include "repositories/PersonRepository.h"
+
+BOOST_AUTO_TEST_SUITE(TestSuiteServer)
+
+BOOST_AUTO_TEST_CASE(SocketServerFrameTest) {
+    const std::string frame = SocketServer::encodeFrame(258, "ping");
+    BOOST_TEST(frame.size() == SocketServer::headerSize + 4);
+
+    std::string buffer = frame.substr(0, 6);
+    std::size_t offset = 0;
+    std::uint32_t requestId;
+    std::string payload;
+    BOOST_TEST(SocketServer::decodeFrame(buffer, offset, requestId, payload) == 0);
+
+    buffer = frame + SocketServer::encodeFrame(7, "") + frame.substr(0, 9);
+    BOOST_TEST(SocketServer::decodeFrame(buffer, offset, requestId, payload) == 1);
+    BOOST_TEST(requestId == 258);
+    BOOST_TEST(payload == "ping");
+    BOOST_TEST(SocketServer::decodeFrame(buffer, offset, requestId, payload) == 1);
+    BOOST_TEST(requestId == 7);
+    BOOST_TEST(payload.empty());
+    BOOST_TEST(SocketServer::decodeFrame(buffer, offset, requestId, payload) == 0);
+    BOOST_TEST(offset == 2 * SocketServer::headerSize + 4);
+
+    std::string oversized(SocketServer::headerSize, '\xff');
+    offset = 0;
+    BOOST_TEST(SocketServer::decodeFrame(oversized, offset, requestId, payload) == -1);
+}
+
+BOOST_AUTO_TEST_CASE(SocketServerRequestTest) {
+    auto personRepo = std::make_shared<PersonRepository>();
+    auto classRoomRepo = std::make_shared<ClassRoomRepository>();
+    auto lessonRepo = std::make_shared<LessonRepository>();
+    auto personManager = std::make_shared<PersonManager>(personRepo, nullptr);
+    auto classRoomManager = std::make_shared<ClassRoomManager>(classRoomRepo, nullptr);
+    auto lessonManager = std::make_shared<LessonManager>(lessonRepo, nullptr, personRepo, classRoomRepo);
+    const std::string socketPath = "/tmp/learningcenter-test-" + std::to_string(getpid()) + ".sock";
+
+    SocketServer server(std::make_shared<CommandUI>(personManager, classRoomManager, lessonManager), socketPath, 2);
+    BOOST_TEST_REQUIRE(server.start() == 0);
+    BOOST_TEST(server.start() == 1);
+    BOOST_TEST(server.isRunning());
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    BOOST_TEST_REQUIRE(connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+
+    // Three pipelined requests, the last one split across two writes.
+    const std::string requests = SocketServer::encodeFrame(1, "add-person Jan Nowak 1") + SocketServer::encodeFrame(2, "fly") +
+                                 SocketServer::encodeFrame(3, "ping");
+    BOOST_TEST(write(fd, requests.data(), requests.size() - 3) == static_cast<ssize_t>(requests.size() - 3));
+    usleep(20000);
+    BOOST_TEST(write(fd, requests.data() + requests.size() - 3, 3) == 3);
+
+    std::vector<std::pair<std::uint32_t, std::string>> responses;
+    std::string buffer;
+    std::size_t offset = 0;
+    char chunk[256];
+    while (responses.size() < 3) {
+        const ssize_t received = read(fd, chunk, sizeof(chunk));
+        BOOST_TEST_REQUIRE(received > 0);
+        buffer.append(chunk, static_cast<std::size_t>(received));
+
+        std::uint32_t requestId;
+        std::string payload;
+        while (SocketServer::decodeFrame(buffer, offset, requestId, payload) == 1) {
+            responses.emplace_back(requestId, payload);
+        }
+    }
+    close(fd);
+    std::sort(responses.begin(), responses.end());
+
+    BOOST_TEST(responses[0].second == "ok\t1");
+    BOOST_TEST(responses[1].second == "error\tNieznane polecenie");
+    BOOST_TEST(responses[2].second == "ok\tpong");
+    BOOST_TEST(personRepo->findPersonById(1)->getLastName() == "Nowak");
+
+    // Far more pipelined requests than a connection may have in flight: reading pauses and resumes
+    // until every one of them is answered.
+    const int flooded = 4 * static_cast<int>(SocketServer::maxPendingRequests);
+    std::string flood;
+    for (int i = 0; i < flooded; i++) {
+        flood += SocketServer::encodeFrame(static_cast<std::uint32_t>(i), "ping");
+    }
+    const int floodFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    BOOST_TEST_REQUIRE(connect(floodFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+    BOOST_TEST(write(floodFd, flood.data(), flood.size()) == static_cast<ssize_t>(flood.size()));
+
+    buffer.clear();
+    offset = 0;
+    int answered = 0;
+    while (answered < flooded) {
+        const ssize_t received = read(floodFd, chunk, sizeof(chunk));
+        BOOST_TEST_REQUIRE(received > 0);
+        buffer.append(chunk, static_cast<std::size_t>(received));
+
+        std::uint32_t requestId;
+        std::string payload;
+        while (SocketServer::decodeFrame(buffer, offset, requestId, payload) == 1) {
+            BOOST_TEST(payload == "ok\tpong");
+            answered++;
+        }
+    }
+    close(floodFd);
+
+    server.stop();
+    BOOST_TEST(!server.isRunning());
+    BOOST_TEST(access(socketPath.c_str(), F_OK) != 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,35 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/date_time.hpp>
+#include "utils/TextParser.h"
+
+namespace pt = boost::posix_time;
+
+BOOST_AUTO_TEST_SUITE(TestSuiteUtils)
+
+BOOST_AUTO_TEST_CASE(TextParserTest) {
+    int number = 7;
+    BOOST_TEST(TextParser::parseNumber("-42", number));
+    BOOST_TEST(number == -42);
+    for (const char *rejected : {"", "+1", " 1", "1 ", "1x", "0x10", "99999999999"}) {
+        BOOST_TEST(!TextParser::parseNumber(rejected, number));
+    }
+    BOOST_TEST(number == -42);
+
+    double cost = 0;
+    BOOST_TEST(TextParser::parseNumber("12.5", cost));
+    BOOST_TEST(cost == 12.5);
+    BOOST_TEST(!TextParser::parseNumber("12,5", cost));
+
+    pt::ptime time;
+    BOOST_TEST(TextParser::parseTime("2030-02-04T08:00", time));
+    BOOST_TEST(time == pt::time_from_string("2030-02-04 08:00:00"));
+    BOOST_TEST(TextParser::parseTime("2030-02-04 08:00:30", time));
+    BOOST_TEST(time == pt::time_from_string("2030-02-04 08:00:30"));
+    for (const char *rejected : {"2030-02-31T08:00", "2030-02-04T24:00", "2030-02-04T08:00:00.5", "2030-2-4T08:00", "2030-02-04",
+                                 "2030-01-01 -1:00", "2030-01-01 08:-5", "2030-01-01 08:00:-1", "2030--1-01 08:00", "2030-13-01 08:00",
+                                 "2030-00-10 08:00"}) {
+        BOOST_TEST(!TextParser::parseTime(rejected, time));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
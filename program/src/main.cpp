@@ -1,11 +1,18 @@
 #include <iostream>
+#include <fstream>
+#include <future>
 #include <limits>
+#include <string>
 #include "../../program/include/peopleFunctions.h"
 #include "../../program/include/classRoomFunctions.h"
 #include "../../program/include/lessonFunctions.h"
 #include "interfaces/LessonUI.h"
 #include "interfaces/PersonUI.h"
 #include "interfaces/ClassRoomUI.h"
+#include "interfaces/CommandUI.h"
+#include "concurrency/TaskPool.h"
+#include "storages/FileIO.h"
+#include "storages/Flusher.h"
 #include "managers/LessonManager.h"
 #include "managers/PersonManager.h"
 #include "managers/ClassRoomManager.h"
@@ -19,8 +26,16 @@ using namespace std;
 
 void clearCinBuffer();
 void mainMenu();
+void saveAll(const PersonManagerPtr& personManager, const ClassRoomManagerPtr& classRoomManager, const LessonManagerPtr& lessonManager);
+int runBatch(const PersonManagerPtr& personManager, const ClassRoomManagerPtr& classRoomManager,
+             const LessonManagerPtr& lessonManager, const char* scriptPath);
 
-int main(){
+int main(int argc, char* argv[]){
+
+    // Zapisy, archiwum i raporty moga dzialac w tle, poza watkiem interfejsu.
+    const auto taskPool = std::make_shared<TaskPool>();
+    // Pliki zapisuje io_uring, a gdy jadro go nie obsluguje - pula watkow.
+    const auto flusher = std::make_shared<Flusher>(FileIO::create(taskPool));
 
     auto personRepository = std::make_shared<PersonRepository>();
     auto personFiles = std::make_shared<PersonFilesStorage>();
@@ -37,6 +52,20 @@ int main(){
     auto lessonManager = std::make_shared<LessonManager>(lessonRepository, lessonFiles, personRepository, classRoomRepository);
     const auto lessonUI = std::make_shared<LessonUI>(lessonManager);
 
+    personManager->setTaskPool(taskPool);
+    classRoomManager->setTaskPool(taskPool);
+    lessonManager->setTaskPool(taskPool);
+    personManager->setFlusher(flusher);
+    classRoomManager->setFlusher(flusher);
+    lessonManager->setFlusher(flusher);
+
+    // Tryb wsadowy: Program --batch [plik] wykonuje skrypt polecen (lub stdin) bez menu.
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        const int result = runBatch(personManager, classRoomManager, lessonManager, argc > 2 ? argv[2] : nullptr);
+        taskPool->waitIdle();
+        return result;
+    }
+
     personUI->load();
     classRoomUI->load();
     lessonUI->load();
@@ -77,9 +106,9 @@ int main(){
 
         case 0:
                 std::cout << std::endl;
-                personUI->save();
-                classRoomUI->save();
-                lessonUI->save();
+                saveAll(personManager, classRoomManager, lessonManager);
+                flusher->waitAll();
+                taskPool->waitIdle();
                 cout << "Wylaczanie aplikacji..." << endl;
                 return 0;
 
@@ -91,6 +120,45 @@ int main(){
 }
 
 
+int runBatch(const PersonManagerPtr& personManager, const ClassRoomManagerPtr& classRoomManager,
+             const LessonManagerPtr& lessonManager, const char* scriptPath) {
+    personManager->loadPersons();
+    classRoomManager->loadClassRooms();
+    lessonManager->load();
+
+    CommandUI commandUI(personManager, classRoomManager, lessonManager);
+    CommandUI::Summary summary{};
+
+    if (scriptPath == nullptr || std::string(scriptPath) == "-") {
+        summary = commandUI.run(cin, cout);
+    } else {
+        ifstream script(scriptPath);
+        if (!script) {
+            cerr << "Nie mozna otworzyc pliku " << scriptPath << endl;
+            return 2;
+        }
+        summary = commandUI.run(script, cout);
+    }
+
+    return summary.failed == 0 ? 0 : 1;
+}
+
+void saveAll(const PersonManagerPtr& personManager, const ClassRoomManagerPtr& classRoomManager, const LessonManagerPtr& lessonManager) {
+    // Migawki trafiaja do flushera, a trzy pliki zapisuja sie jednoczesnie.
+    std::shared_future<bool> personsSaved = personManager->savePersonsAsync();
+    std::shared_future<bool> classRoomsSaved = classRoomManager->saveClassRoomsAsync();
+    std::shared_future<bool> lessonsSaved = lessonManager->saveAsync();
+
+    if (personsSaved.get()) cout << "Zapis osob przebiegl pomyslnie" << endl;
+    else cerr << "Nie udalo sie zapisac osob" << endl;
+
+    if (classRoomsSaved.get()) cout << "Zapis sal przebiegl pomyslnie" << endl;
+    else cerr << "Nie udalo sie zapisac sal" << endl;
+
+    if (lessonsSaved.get()) cout << "Zapis lekcji przebiegl pomyslnie" << endl;
+    else cerr << "Nie udalo sie zapisac lekcji" << endl;
+}
+
 void clearCinBuffer() {
     cin.clear();
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "interfaces/SocketServer.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+
+// Klient w petli zamknietej: wysyla kolejne zapytanie dopiero po otrzymaniu odpowiedzi na poprzednie.
+struct Client {
+    int fd = -1;
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    Clock::time_point sentAt;
+    string input;
+    string output;
+};
+
+bool connectClient(const string& socketPath, Client& client) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    client.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (client.fd < 0 || connect(client.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return false;
+
+    return fcntl(client.fd, F_SETFL, fcntl(client.fd, F_GETFL) | O_NONBLOCK) == 0;
+}
+
+// Zwraca false, jezeli polaczenie zostalo zerwane.
+bool flush(Client& client, const int epollFd) {
+    while (!client.output.empty()) {
+        const ssize_t written = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT;
+            event.data.ptr = &client;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+            return true;
+        }
+        client.output.erase(0, static_cast<size_t>(written));
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = &client;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+    return true;
+}
+
+bool sendRequest(Client& client, const string& command, const int epollFd) {
+    client.output += SocketServer::encodeFrame(client.sent++, command);
+    client.sentAt = Clock::now();
+    return flush(client, epollFd);
+}
+
+double percentile(const vector<double>& sorted, const double fraction) {
+    if (sorted.empty()) return 0.0;
+    return sorted[min(sorted.size() - 1, static_cast<size_t>(fraction * static_cast<double>(sorted.size())))];
+}
+
+// Uzycie: LoadGenerator [sciezka gniazda] [liczba klientow] [zapytania na klienta] [polecenie]
+int main(int argc, char* argv[]) {
+    const string socketPath = argc > 1 ? argv[1] : "/tmp/learningcenter.sock";
+    const int clientsCount = argc > 2 ? stoi(argv[2]) : 1000;
+    const uint32_t requestsPerClient = argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : 100;
+    const string command = argc > 4 ? argv[4] : "ping";
+
+    // Kazdy klient zajmuje deskryptor, wiec podnosimy miekki limit do twardego.
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    vector<Client> clients(static_cast<size_t>(clientsCount));
+    for (Client& client : clients) {
+        if (!connectClient(socketPath, client)) {
+            cerr << "Nie mozna polaczyc z " << socketPath << ": " << strerror(errno) << endl;
+            return 2;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = &client;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+    }
+
+    vector<double> latencies;
+    latencies.reserve(static_cast<size_t>(clientsCount) * requestsPerClient);
+    long errors = 0;
+    int active = clientsCount;
+    const auto started = Clock::now();
+
+    for (Client& client : clients) {
+        if (requestsPerClient == 0 || !sendRequest(client, command, epollFd)) active--;
+    }
+
+    vector<epoll_event> events(256);
+    string payload;
+    char buffer[16 * 1024];
+    while (active > 0) {
+        const int ready = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 10000);
+        if (ready <= 0) {
+            cerr << "Brak odpowiedzi serwera" << endl;
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            Client& client = *static_cast<Client*>(events[i].data.ptr);
+            if (client.received == requestsPerClient) continue;
+
+            if (events[i].events & EPOLLOUT) flush(client, epollFd);
+            if (!(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) continue;
+
+            ssize_t count;
+            while ((count = read(client.fd, buffer, sizeof(buffer))) > 0) {
+                client.input.append(buffer, static_cast<size_t>(count));
+            }
+            if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                errors += requestsPerClient - client.received;
+                client.received = requestsPerClient;
+                active--;
+                continue;
+            }
+
+            size_t offset = 0;
+            uint32_t requestId;
+            while (SocketServer::decodeFrame(client.input, offset, requestId, payload) == 1) {
+                latencies.push_back(chrono::duration<double, micro>(Clock::now() - client.sentAt).count());
+                if (payload.rfind("ok", 0) != 0) errors++;
+
+                if (++client.received == requestsPerClient) {
+                    active--;
+                } else {
+                    sendRequest(client, command, epollFd);
+                }
+            }
+            client.input.erase(0, offset);
+        }
+    }
+
+    const double seconds = chrono::duration<double>(Clock::now() - started).count();
+    for (Client& client : clients) {
+        close(client.fd);
+    }
+    close(epollFd);
+
+    sort(latencies.begin(), latencies.end());
+    cout << "clients\t" << clientsCount << "\trequests\t" << latencies.size() << "\terrors\t" << errors
+         << "\tseconds\t" << seconds << "\tthroughput\t" << (seconds > 0 ? latencies.size() / seconds : 0.0) << endl;
+    cout << "latency_us\tp50\t" << percentile(latencies, 0.50) << "\tp90\t" << percentile(latencies, 0.90)
+         << "\tp99\t" << percentile(latencies, 0.99) << "\tp999\t" << percentile(latencies, 0.999)
+         << "\tmax\t" << (latencies.empty() ? 0.0 : latencies.back()) << endl;
+
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#include <csignal>
+#include <future>
+#include <iostream>
+#include <string>
+#include "concurrency/TaskPool.h"
+#include "interfaces/CommandUI.h"
+#include "interfaces/SocketServer.h"
+#include "managers/LessonManager.h"
+#include "managers/PersonManager.h"
+#include "managers/ClassRoomManager.h"
+#include "repositories/LessonRepository.h"
+#include "repositories/PersonRepository.h"
+#include "repositories/ClassRoomRepository.h"
+#include "storages/FileIO.h"
+#include "storages/Flusher.h"
+#include "storages/LessonFilesStorage.h"
+#include "storages/PersonFilesStorage.h"
+#include "storages/ClassRoomFilesStorage.h"
+
+using namespace std;
+
+
+// Uzycie: Server [sciezka gniazda] [liczba watkow roboczych]
+int main(int argc, char* argv[]) {
+    const string socketPath = argc > 1 ? argv[1] : "/tmp/learningcenter.sock";
+    const unsigned workers = argc > 2 ? static_cast<unsigned>(stoul(argv[2])) : 0;
+
+    auto personRepository = std::make_shared<PersonRepository>();
+    auto personManager = std::make_shared<PersonManager>(personRepository, std::make_shared<PersonFilesStorage>());
+
+    auto classRoomRepository = std::make_shared<ClassRoomRepository>();
+    auto classRoomManager = std::make_shared<ClassRoomManager>(classRoomRepository, std::make_shared<ClassRoomFilesStorage>());
+
+    auto lessonRepository = std::make_shared<LessonRepository>();
+    auto lessonManager = std::make_shared<LessonManager>(lessonRepository, std::make_shared<LessonFilesStorage>(), personRepository,
+                                                         classRoomRepository);
+
+    personManager->loadPersons();
+    classRoomManager->loadClassRooms();
+    lessonManager->load();
+
+    // Sygnaly zakonczenia sa odbierane synchronicznie przez sigwait, wiec watki serwera musza je blokowac.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    // Pula powstaje po zablokowaniu sygnalow, wiec jej watki dziedzicza maske.
+    const auto taskPool = std::make_shared<TaskPool>();
+    personManager->setTaskPool(taskPool);
+    classRoomManager->setTaskPool(taskPool);
+    lessonManager->setTaskPool(taskPool);
+    // Pliki zapisuje io_uring, a gdy jadro go nie obsluguje - pula watkow.
+    const auto flusher = std::make_shared<Flusher>(FileIO::create(taskPool));
+    personManager->setFlusher(flusher);
+    classRoomManager->setFlusher(flusher);
+    lessonManager->setFlusher(flusher);
+
+    SocketServer server(std::make_shared<CommandUI>(personManager, classRoomManager, lessonManager), socketPath, workers);
+    if (server.start() != 0) {
+        cerr << "Nie mozna nasluchiwac na " << socketPath << endl;
+        return 2;
+    }
+    cout << "Nasluchiwanie na " << socketPath << endl;
+
+    int signal;
+    sigwait(&signals, &signal);
+
+    server.stop();
+    std::shared_future<bool> personsSaved = personManager->savePersonsAsync();
+    std::shared_future<bool> classRoomsSaved = classRoomManager->saveClassRoomsAsync();
+    std::shared_future<bool> lessonsSaved = lessonManager->saveAsync();
+    if (!personsSaved.get()) cerr << "Nie udalo sie zapisac osob" << endl;
+    if (!classRoomsSaved.get()) cerr << "Nie udalo sie zapisac sal" << endl;
+    if (!lessonsSaved.get()) cerr << "Nie udalo sie zapisac lekcji" << endl;
+    flusher->waitAll();
+    taskPool->waitIdle();
+    cout << "Wylaczanie serwera..." << endl;
+
+    return 0;
+}